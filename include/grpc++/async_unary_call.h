@@ -101,31 +101,43 @@ class ServerAsyncResponseWriter GRPC_FINAL
   }
 
   void Finish(const W& msg, const Status& status, void* tag) {
+    FinishWithMessage(msg, status, tag);
+  }
+
+  // Finish with a response serialized ahead of time, e.g. by
+  // SerializeToByteBuffer().
+  void FinishSerialized(const ByteBuffer& msg, const Status& status,
+                        void* tag) {
+    FinishWithMessage(msg, status, tag);
+  }
+
+  void FinishWithError(const Status& status, void* tag) {
+    GPR_ASSERT(!status.IsOk());
     finish_buf_.Reset(tag);
     if (!ctx_->sent_initial_metadata_) {
       finish_buf_.AddSendInitialMetadata(&ctx_->initial_metadata_);
       ctx_->sent_initial_metadata_ = true;
     }
-    // The response is dropped if the status is not OK.
-    if (status.IsOk()) {
-      finish_buf_.AddSendMessage(msg);
-    }
     finish_buf_.AddServerSendStatus(&ctx_->trailing_metadata_, status);
     call_.PerformOps(&finish_buf_);
   }
 
-  void FinishWithError(const Status& status, void* tag) {
-    GPR_ASSERT(!status.IsOk());
+ private:
+  template <class M>
+  void FinishWithMessage(const M& msg, const Status& status, void* tag) {
     finish_buf_.Reset(tag);
     if (!ctx_->sent_initial_metadata_) {
       finish_buf_.AddSendInitialMetadata(&ctx_->initial_metadata_);
       ctx_->sent_initial_metadata_ = true;
     }
+    // The response is dropped if the status is not OK.
+    if (status.IsOk()) {
+      finish_buf_.AddSendMessage(msg);
+    }
     finish_buf_.AddServerSendStatus(&ctx_->trailing_metadata_, status);
     call_.PerformOps(&finish_buf_);
   }
 
- private:
   void BindCall(Call* call) GRPC_OVERRIDE { call_ = *call; }
 
   Call call_;
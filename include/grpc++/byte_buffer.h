@@ -49,6 +49,10 @@ class ByteBuffer GRPC_FINAL {
 
   ByteBuffer(Slice* slices, size_t nslices);
 
+  // Copies share the underlying slices; no bytes are copied.
+  ByteBuffer(const ByteBuffer& other);
+  ByteBuffer& operator=(const ByteBuffer& other);
+
   ~ByteBuffer() {
     if (buffer_) {
       grpc_byte_buffer_destroy(buffer_);
@@ -62,6 +66,8 @@ class ByteBuffer GRPC_FINAL {
 
  private:
   friend class CallOpBuffer;
+  friend bool SerializeToByteBuffer(const grpc::protobuf::Message& message,
+                                    ByteBuffer* buffer);
 
   // takes ownership
   void set_buffer(grpc_byte_buffer* buf) {
@@ -77,6 +83,11 @@ class ByteBuffer GRPC_FINAL {
   grpc_byte_buffer* buffer_;
 };
 
+// Serialize message into buffer, replacing its contents. The result can be
+// sent any number of times without being serialized again.
+bool SerializeToByteBuffer(const grpc::protobuf::Message& message,
+                           ByteBuffer* buffer);
+
 }  // namespace grpc
 
 #endif  // GRPCXX_BYTE_BUFFER_H
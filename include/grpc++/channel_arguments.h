@@ -34,8 +34,9 @@
 #ifndef GRPCXX_CHANNEL_ARGUMENTS_H
 #define GRPCXX_CHANNEL_ARGUMENTS_H
 
-#include <vector>
 #include <list>
+#include <utility>
+#include <vector>
 
 #include <grpc++/config.h>
 #include <grpc/grpc.h>
@@ -58,6 +59,10 @@ class ChannelArguments {
   void SetSslTargetNameOverride(const grpc::string& name);
   // TODO(yangg) add flow control options
 
+  // Metadata sent with every call made on the channel, ahead of the call's
+  // own metadata. The channel keeps a single copy that all calls refer to.
+  void AddConstantMetadata(const grpc::string& key, const grpc::string& value);
+
   // Generic channel argument setters. Only for advanced use cases.
   void SetInt(const grpc::string& key, int value);
   void SetString(const grpc::string& key, const grpc::string& value);
@@ -66,6 +71,7 @@ class ChannelArguments {
   void SetChannelArgs(grpc_channel_args* channel_args) const;
 
  private:
+  friend class Channel;
   friend class SecureCredentials;
   friend class testing::ChannelArgumentsTest;
 
@@ -78,6 +84,7 @@ class ChannelArguments {
 
   std::vector<grpc_arg> args_;
   std::list<grpc::string> strings_;
+  std::vector<std::pair<grpc::string, grpc::string> > constant_metadata_;
 };
 
 }  // namespace grpc
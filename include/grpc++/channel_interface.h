@@ -36,8 +36,10 @@
 
 #include <memory>
 
+#include <grpc/grpc.h>
 #include <grpc++/status.h>
 #include <grpc++/impl/call.h>
+#include <grpc++/time.h>
 
 struct grpc_call;
 
@@ -57,6 +59,32 @@ class ChannelInterface : public CallHook,
   virtual void* RegisterMethod(const char* method_name) = 0;
   virtual Call CreateCall(const RpcMethod& method, ClientContext* context,
                           CompletionQueue* cq) = 0;
+
+  // The queue on which calls that complete by running a callback are
+  // created. It is polled by threads the channel owns, and shut down when the
+  // channel is destroyed.
+  virtual CompletionQueue* CallbackCompletionQueue() = 0;
+
+  // Get the current connectivity state of the channel. If the channel is idle
+  // and try_to_connect is true, start connecting it, so that the first call
+  // does not have to wait for the connection to be established.
+  // Channels without a connection of their own are always ready.
+  virtual grpc_connectivity_state GetState(bool try_to_connect) {
+    return GRPC_CHANNEL_READY;
+  }
+
+  // Start connecting the channel if it is idle, and block until it is ready
+  // or deadline passes. Returns true if the channel became ready.
+  template <typename T>
+  bool WaitForReady(const T& deadline) {
+    TimePoint<T> deadline_tp(deadline);
+    return WaitForReadyInternal(deadline_tp.raw_time());
+  }
+
+ private:
+  virtual bool WaitForReadyInternal(gpr_timespec deadline) {
+    return GetState(true) == GRPC_CHANNEL_READY;
+  }
 };
 
 }  // namespace grpc
@@ -36,6 +36,7 @@
 
 #include <memory>
 
+#include <grpc/grpc_security.h>
 #include <grpc++/config.h>
 #include <grpc++/impl/grpc_library.h>
 
@@ -79,6 +80,16 @@ struct SslCredentialsOptions {
   grpc::string pem_cert_chain;
 };
 
+// Options for resuming TLS sessions on the channels of SslCredentials
+// max_sessions is the maximum number of sessions, one per server address,
+// kept for resumption by the channels created with the credentials. 0 disables
+// session resumption.
+struct SslSessionCacheOptions {
+  SslSessionCacheOptions()
+      : max_sessions(GRPC_SSL_DEFAULT_SESSION_CACHE_SIZE) {}
+  size_t max_sessions;
+};
+
 // Factories for building different types of Credentials
 // The functions may return empty unique_ptr when credentials cannot be created.
 // If a Credentials pointer is returned, it can still be invalid when used to
@@ -91,6 +102,9 @@ std::unique_ptr<Credentials> GoogleDefaultCredentials();
 // Builds SSL Credentials given SSL specific options
 std::unique_ptr<Credentials> SslCredentials(
     const SslCredentialsOptions& options);
+std::unique_ptr<Credentials> SslCredentials(
+    const SslCredentialsOptions& options,
+    const SslSessionCacheOptions& session_cache_options);
 
 // Builds credentials for use when running in GCE
 std::unique_ptr<Credentials> ComputeEngineCredentials();
@@ -37,10 +37,10 @@
 #include <grpc/grpc.h>
 #include <grpc++/completion_queue.h>
 #include <grpc++/config.h>
+#include <grpc++/metadata.h>
 #include <grpc++/status.h>
 
 #include <memory>
-#include <map>
 
 struct grpc_call;
 struct grpc_op;
@@ -58,8 +58,7 @@ class CallOpBuffer : public CompletionQueueTag {
   void Reset(void* next_return_tag);
 
   // Does not take ownership.
-  void AddSendInitialMetadata(
-      std::multimap<grpc::string, grpc::string>* metadata);
+  void AddSendInitialMetadata(OutgoingMetadata* metadata);
   void AddSendInitialMetadata(ClientContext* ctx);
   void AddRecvInitialMetadata(ClientContext* ctx);
   void AddSendMessage(const grpc::protobuf::Message& message);
@@ -68,8 +67,7 @@ class CallOpBuffer : public CompletionQueueTag {
   void AddRecvMessage(ByteBuffer* message);
   void AddClientSendClose();
   void AddClientRecvStatus(ClientContext* ctx, Status* status);
-  void AddServerSendStatus(std::multimap<grpc::string, grpc::string>* metadata,
-                           const Status& status);
+  void AddServerSendStatus(OutgoingMetadata* metadata, const Status& status);
   void AddServerRecvClose(bool* cancelled);
 
   // INTERNAL API:
@@ -89,7 +87,7 @@ class CallOpBuffer : public CompletionQueueTag {
   size_t initial_metadata_count_;
   grpc_metadata* initial_metadata_;
   // Recv initial metadta
-  std::multimap<grpc::string, grpc::string>* recv_initial_metadata_;
+  MetadataMap* recv_initial_metadata_;
   grpc_metadata_array recv_initial_metadata_arr_;
   // Send message
   const grpc::protobuf::Message* send_message_;
@@ -102,7 +100,7 @@ class CallOpBuffer : public CompletionQueueTag {
   // Client send close
   bool client_send_close_;
   // Client recv status
-  std::multimap<grpc::string, grpc::string>* recv_trailing_metadata_;
+  MetadataMap* recv_trailing_metadata_;
   Status* recv_status_;
   grpc_metadata_array recv_trailing_metadata_arr_;
   grpc_status_code status_code_;
@@ -34,6 +34,8 @@
 #ifndef GRPCXX_IMPL_CLIENT_UNARY_CALL_H
 #define GRPCXX_IMPL_CLIENT_UNARY_CALL_H
 
+#include <functional>
+
 #include <grpc++/config.h>
 
 namespace grpc {
@@ -50,6 +52,16 @@ Status BlockingUnaryCall(ChannelInterface* channel, const RpcMethod& method,
                          const grpc::protobuf::Message& request,
                          grpc::protobuf::Message* result);
 
+// Wrapper that starts a unary call and returns immediately. on_done is run
+// with the final status on a thread owned by the channel once the call
+// completes; it must not block. context, request and result must stay alive
+// until then.
+void CallbackUnaryCall(ChannelInterface* channel, const RpcMethod& method,
+                       ClientContext* context,
+                       const grpc::protobuf::Message& request,
+                       grpc::protobuf::Message* result,
+                       std::function<void(Status)> on_done);
+
 }  // namespace grpc
 
 #endif  // GRPCXX_IMPL_CLIENT_UNARY_CALL_H
@@ -41,6 +41,8 @@
 
 #include <grpc++/config.h>
 #include <grpc++/impl/rpc_method.h>
+#include <grpc++/impl/service_type.h>
+#include <grpc++/impl/sync.h>
 #include <grpc++/status.h>
 #include <grpc++/stream.h>
 
@@ -159,6 +161,96 @@ class BidiStreamingHandler : public MethodHandler {
   ServiceType* service_;
 };
 
+// Base class for running the handler of a callback service method.
+class CallbackMethodHandler {
+ public:
+  virtual ~CallbackMethodHandler() {}
+  virtual void RunHandler(ServerContext* context,
+                          const grpc::protobuf::Message* request,
+                          grpc::protobuf::Message* response,
+                          ServerUnaryReactor* reactor) = 0;
+};
+
+// A wrapper class of an application provided callback unary handler.
+template <class ServiceType, class RequestType, class ResponseType>
+class CallbackUnaryHandler : public CallbackMethodHandler {
+ public:
+  CallbackUnaryHandler(
+      std::function<void(ServiceType*, ServerContext*, const RequestType*,
+                         ResponseType*, ServerUnaryReactor*)> func,
+      ServiceType* service)
+      : func_(func), service_(service) {}
+
+  void RunHandler(ServerContext* context,
+                  const grpc::protobuf::Message* request,
+                  grpc::protobuf::Message* response,
+                  ServerUnaryReactor* reactor) GRPC_FINAL {
+    func_(service_, context, dynamic_cast<const RequestType*>(request),
+          dynamic_cast<ResponseType*>(response), reactor);
+  }
+
+ private:
+  std::function<void(ServiceType*, ServerContext*, const RequestType*,
+                     ResponseType*, ServerUnaryReactor*)> func_;
+  ServiceType* service_;
+};
+
+// Recycles the request or response messages of one method. A returned message
+// is Clear()ed, which keeps the memory of its strings and repeated fields, so
+// parsing the next request of a similar shape hardly allocates.
+class MessagePool {
+ public:
+  // Takes ownership of the prototype.
+  explicit MessagePool(grpc::protobuf::Message* prototype)
+      : prototype_(prototype) {}
+  ~MessagePool() {
+    for (auto it = free_.begin(); it != free_.end(); ++it) {
+      delete *it;
+    }
+  }
+
+  grpc::protobuf::Message* New() const { return prototype_->New(); }
+
+  grpc::protobuf::Message* Get() {
+    {
+      grpc::lock_guard<grpc::mutex> lock(mu_);
+      if (!free_.empty()) {
+        grpc::protobuf::Message* message = free_.back();
+        free_.pop_back();
+        return message;
+      }
+    }
+    return prototype_->New();
+  }
+
+  void Put(grpc::protobuf::Message* message) {
+    // A message that once held a huge request would pin that memory forever.
+    if (message->SpaceUsed() > kMaxRetainedBytes) {
+      delete message;
+      return;
+    }
+    message->Clear();
+    {
+      grpc::lock_guard<grpc::mutex> lock(mu_);
+      if (free_.size() < kMaxFree) {
+        free_.push_back(message);
+        return;
+      }
+    }
+    delete message;
+  }
+
+ private:
+  // Bounds the memory held by messages of a past burst.
+  static const size_t kMaxFree = 64;
+  // Larger messages are freed rather than kept for reuse.
+  static const int kMaxRetainedBytes = 64 * 1024;
+
+  std::unique_ptr<grpc::protobuf::Message> prototype_;
+  grpc::mutex mu_;
+  std::vector<grpc::protobuf::Message*> free_;
+};
+
 // Server side rpc method class
 class RpcServiceMethod : public RpcMethod {
  public:
@@ -169,22 +261,40 @@ class RpcServiceMethod : public RpcMethod {
                    grpc::protobuf::Message* response_prototype)
       : RpcMethod(name, type, nullptr),
         handler_(handler),
-        request_prototype_(request_prototype),
-        response_prototype_(response_prototype) {}
+        request_pool_(request_prototype),
+        response_pool_(response_prototype) {}
+
+  // A method of a callback service. Only unary methods have a handler; the
+  // others are answered with UNIMPLEMENTED.
+  RpcServiceMethod(const char* name, RpcMethod::RpcType type,
+                   CallbackMethodHandler* handler,
+                   grpc::protobuf::Message* request_prototype,
+                   grpc::protobuf::Message* response_prototype)
+      : RpcMethod(name, type, nullptr),
+        callback_handler_(handler),
+        request_pool_(request_prototype),
+        response_pool_(response_prototype) {}
 
   MethodHandler* handler() { return handler_.get(); }
+  CallbackMethodHandler* callback_handler() { return callback_handler_.get(); }
 
   grpc::protobuf::Message* AllocateRequestProto() {
-    return request_prototype_->New();
+    return request_pool_.New();
   }
   grpc::protobuf::Message* AllocateResponseProto() {
-    return response_prototype_->New();
+    return response_pool_.New();
   }
 
+  // Pools of messages reused across calls; messages taken with Get() go back
+  // with Put() once the call no longer needs them.
+  MessagePool* request_pool() { return &request_pool_; }
+  MessagePool* response_pool() { return &response_pool_; }
+
  private:
   std::unique_ptr<MethodHandler> handler_;
-  std::unique_ptr<grpc::protobuf::Message> request_prototype_;
-  std::unique_ptr<grpc::protobuf::Message> response_prototype_;
+  std::unique_ptr<CallbackMethodHandler> callback_handler_;
+  MessagePool request_pool_;
+  MessagePool response_pool_;
 };
 
 // This class contains all the method information for an rpc service. It is
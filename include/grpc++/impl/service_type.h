@@ -50,6 +50,27 @@ class SynchronousService {
   virtual RpcService* service() = 0;
 };
 
+// Handlers of a callback service run directly on the server's polling
+// threads, as soon as the request has arrived. They must not block: a
+// handler completes its rpc by calling Finish() on the reactor it was given,
+// either before returning or later from any thread.
+class CallbackService {
+ public:
+  virtual ~CallbackService() {}
+  virtual RpcService* service() = 0;
+};
+
+// Completes a unary rpc of a callback service. Finish() must be called
+// exactly once; afterwards neither the reactor nor the request and response
+// passed alongside it may be touched.
+class ServerUnaryReactor {
+ public:
+  virtual void Finish(const Status& status) = 0;
+
+ protected:
+  virtual ~ServerUnaryReactor() {}
+};
+
 class ServerAsyncStreamingInterface {
  public:
   virtual ~ServerAsyncStreamingInterface() {}
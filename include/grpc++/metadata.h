@@ -0,0 +1,125 @@
+/*
+ *
+ * Copyright 2015, Google Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer
+ * in the documentation and/or other materials provided with the
+ * distribution.
+ *     * Neither the name of Google Inc. nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+
+#ifndef GRPCXX_METADATA_H
+#define GRPCXX_METADATA_H
+
+#include <utility>
+#include <vector>
+
+#include <grpc/grpc.h>
+#include <grpc++/config.h>
+#include <grpc++/string_ref.h>
+
+namespace grpc {
+
+// Metadata received from the peer. Keys and values refer to the bytes held
+// by the underlying call, so filling the map costs one allocation however
+// many entries arrive, and nothing is copied. The references stay valid for
+// the lifetime of the context the map belongs to.
+// Lookups are linear scans: calls carry a handful of entries, for which a
+// flat array beats a tree.
+class MetadataMap {
+ public:
+  typedef std::pair<string_ref, string_ref> value_type;
+  typedef std::vector<value_type>::const_iterator const_iterator;
+  typedef const_iterator iterator;
+
+  const_iterator begin() const { return entries_.begin(); }
+  const_iterator end() const { return entries_.end(); }
+  size_t size() const { return entries_.size(); }
+  bool empty() const { return entries_.empty(); }
+
+  // Returns the first entry with the given key, or end() if there is none.
+  const_iterator find(string_ref key) const;
+  size_t count(string_ref key) const;
+
+  // INTERNAL API:
+
+  // Replaces the contents with references to the given entries.
+  void Fill(const grpc_metadata* metadata, size_t count);
+
+ private:
+  std::vector<value_type> entries_;
+};
+
+// Metadata to be sent to the peer. Entries are packed into a single buffer
+// and the grpc_metadata array handed to the core is rebuilt in place, so
+// sending does not allocate once the buffers have grown to fit.
+// A set of constant entries shared between calls (the per-channel metadata)
+// can be prepended without being copied into every call.
+class OutgoingMetadata {
+ public:
+  OutgoingMetadata() : constant_(nullptr) {}
+  // Copies the entries; the filled array is not shared and is rebuilt by the
+  // next Fill().
+  OutgoingMetadata(const OutgoingMetadata& other);
+  OutgoingMetadata& operator=(const OutgoingMetadata& other);
+
+  void Add(string_ref key, string_ref value);
+
+  // Number of entries that will be sent, constant entries included.
+  size_t size() const {
+    return entries_.size() + (constant_ ? constant_->entries_.size() : 0);
+  }
+  bool empty() const { return size() == 0; }
+
+  // INTERNAL API:
+
+  // Sends the entries of *constant ahead of the ones added here. constant
+  // must not be modified and must outlive this object.
+  void set_constant(const OutgoingMetadata* constant) { constant_ = constant; }
+
+  // Returns an array of size() entries referring to this object's storage,
+  // or nullptr when there are none. Valid until the next call to Add().
+  grpc_metadata* Fill();
+
+ private:
+  struct Entry {
+    size_t key;    // offset of the NUL terminated key in storage_
+    size_t value;  // offset of the value in storage_
+    size_t value_length;
+  };
+
+  void AppendTo(std::vector<grpc_metadata>* array) const;
+
+  grpc::string storage_;
+  std::vector<Entry> entries_;
+  std::vector<grpc_metadata> array_;
+  const OutgoingMetadata* constant_;
+};
+
+}  // namespace grpc
+
+#endif  // GRPCXX_METADATA_H
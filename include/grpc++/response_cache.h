@@ -0,0 +1,86 @@
+/*
+ *
+ * Copyright 2015, Google Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer
+ * in the documentation and/or other materials provided with the
+ * distribution.
+ *     * Neither the name of Google Inc. nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef GRPCXX_RESPONSE_CACHE_H
+#define GRPCXX_RESPONSE_CACHE_H
+
+#include <unordered_map>
+
+#include <grpc/support/time.h>
+#include <grpc++/byte_buffer.h>
+#include <grpc++/config.h>
+#include <grpc++/impl/sync.h>
+
+namespace grpc {
+
+// A cache of serialized responses for servers that answer many requests with
+// the same bytes. Hits are returned as ByteBuffers sharing the cached slices,
+// ready for WriteSerialized() or FinishSerialized(). Entries are keyed by the
+// serialized request (or a caller provided key) and expire ttl after they were
+// inserted. Thread safe.
+class ResponseCache GRPC_FINAL {
+ public:
+  // At most max_entries responses are kept; inserting into a full cache first
+  // drops the expired entries, then an arbitrary one.
+  ResponseCache(gpr_timespec ttl, size_t max_entries);
+
+  // Return true and set response if a live entry exists for the request.
+  bool Lookup(const grpc::protobuf::Message& request, ByteBuffer* response);
+  bool Lookup(const grpc::string& key, ByteBuffer* response);
+
+  // Serialize response and cache it for the request. If serialized is not
+  // null it receives the serialized response as well. Returns false if the
+  // response could not be serialized.
+  bool Insert(const grpc::protobuf::Message& request,
+              const grpc::protobuf::Message& response, ByteBuffer* serialized);
+  void Insert(const grpc::string& key, const ByteBuffer& response);
+
+  size_t size();
+
+ private:
+  struct Entry {
+    ByteBuffer response;
+    gpr_timespec expiry;
+  };
+
+  void EvictLocked(gpr_timespec now);
+
+  const gpr_timespec ttl_;
+  const size_t max_entries_;
+  grpc::mutex mu_;
+  std::unordered_map<grpc::string, Entry> entries_;
+};
+
+}  // namespace grpc
+
+#endif  // GRPCXX_RESPONSE_CACHE_H
@@ -36,6 +36,7 @@
 
 #include <list>
 #include <memory>
+#include <vector>
 
 #include <grpc++/completion_queue.h>
 #include <grpc++/config.h>
@@ -43,6 +44,7 @@
 #include <grpc++/impl/grpc_library.h>
 #include <grpc++/impl/service_type.h>
 #include <grpc++/impl/sync.h>
+#include <grpc++/impl/thd.h>
 #include <grpc++/status.h>
 
 struct grpc_server;
@@ -77,12 +79,15 @@ class Server GRPC_FINAL : public GrpcLibrary,
 
   class SyncRequest;
   class AsyncRequest;
+  class CallbackRequest;
 
   // ServerBuilder use only
-  Server(ThreadPoolInterface* thread_pool, bool thread_pool_owned);
+  Server(ThreadPoolInterface* thread_pool, bool thread_pool_owned,
+         int callback_threads, int sync_request_depth);
   // Register a service. This call does not take ownership of the service.
   // The service must exist for the lifetime of the Server instance.
   bool RegisterService(RpcService* service);
+  bool RegisterCallbackService(RpcService* service);
   bool RegisterAsyncService(AsynchronousService* service);
   void RegisterAsyncGenericService(AsyncGenericService* service);
   // Add a listening port. Can be called multiple times.
@@ -94,6 +99,9 @@ class Server GRPC_FINAL : public GrpcLibrary,
   void RunRpc();
   void ScheduleCallback();
 
+  void RunCallbackPoller();
+  void CallbackDone();
+
   void PerformOpsOnCall(CallOpBuffer* ops, Call* call) GRPC_OVERRIDE;
 
   // DispatchImpl
@@ -117,7 +125,20 @@ class Server GRPC_FINAL : public GrpcLibrary,
   int num_running_cb_;
   grpc::condition_variable callback_cv_;
 
-  std::list<SyncRequest>* sync_methods_;
+  // sync_request_depth_ requests per method, requested again as soon as
+  // their call arrives. Tags point straight at the entries, which do not move
+  // once registration is done.
+  std::vector<SyncRequest>* sync_methods_;
+  const int sync_request_depth_;
+
+  // Completion queue of the callback services, polled by callback_threads_.
+  // Handlers run inline on those threads.
+  CompletionQueue callback_cq_;
+  std::list<CallbackRequest>* callback_methods_;
+  std::vector<grpc::thread> callback_threads_;
+  const int num_callback_threads_;
+  // Pending requests plus rpcs whose handler has not finished yet.
+  int callback_outstanding_;
 
   // Pointer to the c grpc server.
   grpc_server* const server_;
@@ -126,7 +147,10 @@ class Server GRPC_FINAL : public GrpcLibrary,
   // Whether the thread pool is created and owned by the server.
   bool thread_pool_owned_;
  private:
-  Server() : server_(NULL) { abort(); }
+  Server()
+      : sync_request_depth_(0), num_callback_threads_(0), server_(NULL) {
+    abort();
+  }
 };
 
 }  // namespace grpc
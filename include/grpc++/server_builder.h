@@ -43,6 +43,7 @@ namespace grpc {
 
 class AsyncGenericService;
 class AsynchronousService;
+class CallbackService;
 class CompletionQueue;
 class RpcService;
 class Server;
@@ -65,6 +66,12 @@ class ServerBuilder {
   // instance returned by BuildAndStart().
   void RegisterAsyncService(AsynchronousService* service);
 
+  // Register a callback service. Its handlers run on the server's own
+  // polling threads and must not block. This call does not take ownership of
+  // the service, which must exist for the lifetime of the Server instance
+  // returned by BuildAndStart().
+  void RegisterCallbackService(CallbackService* service);
+
   // Register a generic service.
   void RegisterAsyncGenericService(AsyncGenericService* service);
 
@@ -77,6 +84,15 @@ class ServerBuilder {
   // Does not take ownership.
   void SetThreadPool(ThreadPoolInterface* thread_pool);
 
+  // Set how many calls of each synchronous method are requested from the
+  // core at a time. Defaults to 1; larger values let bursts of calls start
+  // without waiting for each previous call to be picked up.
+  void SetSyncRequestDepth(int depth);
+
+  // Set the number of threads polling for callback service rpcs. Defaults to
+  // the number of cores.
+  void SetCallbackThreads(int threads);
+
   // Return a running server which is ready for processing rpcs.
   std::unique_ptr<Server> BuildAndStart();
 
@@ -89,10 +105,13 @@ class ServerBuilder {
 
   std::vector<RpcService*> services_;
   std::vector<AsynchronousService*> async_services_;
+  std::vector<RpcService*> callback_services_;
   std::vector<Port> ports_;
   std::shared_ptr<ServerCredentials> creds_;
   AsyncGenericService* generic_service_;
   ThreadPoolInterface* thread_pool_;
+  int callback_threads_;
+  int sync_request_depth_;
 };
 
 }  // namespace grpc
@@ -34,10 +34,11 @@
 #ifndef GRPCXX_SERVER_CONTEXT_H
 #define GRPCXX_SERVER_CONTEXT_H
 
-#include <map>
+#include <functional>
 
 #include <grpc/support/time.h>
 #include <grpc++/config.h>
+#include <grpc++/metadata.h>
 #include <grpc++/time.h>
 
 struct gpr_timespec;
@@ -85,7 +86,8 @@ class ServerContext {
 
   bool IsCancelled();
 
-  const std::multimap<grpc::string, grpc::string>& client_metadata() {
+  // The returned keys and values refer to memory owned by this context.
+  const MetadataMap& client_metadata() {
     return client_metadata_;
   }
 
@@ -109,6 +111,8 @@ class ServerContext {
   class CompletionOp;
 
   void BeginCompletionOp(Call* call);
+  // Also runs on_done once the client has closed the call or cancelled it.
+  void BeginCompletionOp(Call* call, std::function<void()> on_done);
 
   ServerContext(gpr_timespec deadline, grpc_metadata* metadata,
                 size_t metadata_count);
@@ -119,9 +123,9 @@ class ServerContext {
   grpc_call* call_;
   CompletionQueue* cq_;
   bool sent_initial_metadata_;
-  std::multimap<grpc::string, grpc::string> client_metadata_;
-  std::multimap<grpc::string, grpc::string> initial_metadata_;
-  std::multimap<grpc::string, grpc::string> trailing_metadata_;
+  MetadataMap client_metadata_;
+  OutgoingMetadata initial_metadata_;
+  OutgoingMetadata trailing_metadata_;
 };
 
 }  // namespace grpc
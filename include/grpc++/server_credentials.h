@@ -37,6 +37,7 @@
 #include <memory>
 #include <vector>
 
+#include <grpc/grpc_security.h>
 #include <grpc++/config.h>
 
 struct grpc_server;
@@ -66,9 +67,22 @@ struct SslServerCredentialsOptions {
   std::vector<PemKeyCertPair> pem_key_cert_pairs;
 };
 
+// Options for the TLS session tickets issued by SslServerCredentials
+// key_rotation_secs is the lifetime of the keys encrypting the tickets;
+// tickets issued under the previous key are still accepted for one more
+// period. 0 disables session tickets.
+struct SslSessionTicketOptions {
+  SslSessionTicketOptions()
+      : key_rotation_secs(GRPC_SSL_DEFAULT_SESSION_TICKET_KEY_ROTATION_SECS) {}
+  int key_rotation_secs;
+};
+
 // Builds SSL ServerCredentials given SSL specific options
 std::shared_ptr<ServerCredentials> SslServerCredentials(
     const SslServerCredentialsOptions& options);
+std::shared_ptr<ServerCredentials> SslServerCredentials(
+    const SslServerCredentialsOptions& options,
+    const SslSessionTicketOptions& session_ticket_options);
 
 std::shared_ptr<ServerCredentials> InsecureServerCredentials();
 
@@ -112,13 +112,13 @@ class ClientReader GRPC_FINAL : public ClientStreamingInterface,
   }
 
   virtual bool Read(R* msg) GRPC_OVERRIDE {
-    CallOpBuffer buf;
+    read_buf_.Reset(&read_buf_);
     if (!context_->initial_metadata_received_) {
-      buf.AddRecvInitialMetadata(context_);
+      read_buf_.AddRecvInitialMetadata(context_);
     }
-    buf.AddRecvMessage(msg);
-    call_.PerformOps(&buf);
-    return cq_.Pluck(&buf) && buf.got_message;
+    read_buf_.AddRecvMessage(msg);
+    call_.PerformOps(&read_buf_);
+    return cq_.Pluck(&read_buf_) && read_buf_.got_message;
   }
 
   virtual Status Finish() GRPC_OVERRIDE {
@@ -134,6 +134,8 @@ class ClientReader GRPC_FINAL : public ClientStreamingInterface,
   ClientContext* context_;
   CompletionQueue cq_;
   Call call_;
+  // Reused for every read.
+  CallOpBuffer read_buf_;
 };
 
 template <class W>
@@ -153,17 +155,17 @@ class ClientWriter GRPC_FINAL : public ClientStreamingInterface,
   }
 
   virtual bool Write(const W& msg) GRPC_OVERRIDE {
-    CallOpBuffer buf;
-    buf.AddSendMessage(msg);
-    call_.PerformOps(&buf);
-    return cq_.Pluck(&buf);
+    write_buf_.Reset(&write_buf_);
+    write_buf_.AddSendMessage(msg);
+    call_.PerformOps(&write_buf_);
+    return cq_.Pluck(&write_buf_);
   }
 
   virtual bool WritesDone() {
-    CallOpBuffer buf;
-    buf.AddClientSendClose();
-    call_.PerformOps(&buf);
-    return cq_.Pluck(&buf);
+    write_buf_.Reset(&write_buf_);
+    write_buf_.AddClientSendClose();
+    call_.PerformOps(&write_buf_);
+    return cq_.Pluck(&write_buf_);
   }
 
   // Read the final response and wait for the final status.
@@ -182,6 +184,8 @@ class ClientWriter GRPC_FINAL : public ClientStreamingInterface,
   grpc::protobuf::Message* const response_;
   CompletionQueue cq_;
   Call call_;
+  // Reused for every write.
+  CallOpBuffer write_buf_;
 };
 
 // Client-side interface for bi-directional streaming.
@@ -214,27 +218,27 @@ class ClientReaderWriter GRPC_FINAL : public ClientStreamingInterface,
   }
 
   virtual bool Read(R* msg) GRPC_OVERRIDE {
-    CallOpBuffer buf;
+    read_buf_.Reset(&read_buf_);
     if (!context_->initial_metadata_received_) {
-      buf.AddRecvInitialMetadata(context_);
+      read_buf_.AddRecvInitialMetadata(context_);
     }
-    buf.AddRecvMessage(msg);
-    call_.PerformOps(&buf);
-    return cq_.Pluck(&buf) && buf.got_message;
+    read_buf_.AddRecvMessage(msg);
+    call_.PerformOps(&read_buf_);
+    return cq_.Pluck(&read_buf_) && read_buf_.got_message;
   }
 
   virtual bool Write(const W& msg) GRPC_OVERRIDE {
-    CallOpBuffer buf;
-    buf.AddSendMessage(msg);
-    call_.PerformOps(&buf);
-    return cq_.Pluck(&buf);
+    write_buf_.Reset(&write_buf_);
+    write_buf_.AddSendMessage(msg);
+    call_.PerformOps(&write_buf_);
+    return cq_.Pluck(&write_buf_);
   }
 
   virtual bool WritesDone() {
-    CallOpBuffer buf;
-    buf.AddClientSendClose();
-    call_.PerformOps(&buf);
-    return cq_.Pluck(&buf);
+    write_buf_.Reset(&write_buf_);
+    write_buf_.AddClientSendClose();
+    call_.PerformOps(&write_buf_);
+    return cq_.Pluck(&write_buf_);
   }
 
   virtual Status Finish() GRPC_OVERRIDE {
@@ -250,6 +254,9 @@ class ClientReaderWriter GRPC_FINAL : public ClientStreamingInterface,
   ClientContext* context_;
   CompletionQueue cq_;
   Call call_;
+  // Reused for every read and every write respectively.
+  CallOpBuffer read_buf_;
+  CallOpBuffer write_buf_;
 };
 
 template <class R>
@@ -294,7 +301,14 @@ class ServerWriter GRPC_FINAL : public WriterInterface<W> {
     call_->cq()->Pluck(&buf);
   }
 
-  virtual bool Write(const W& msg) GRPC_OVERRIDE {
+  virtual bool Write(const W& msg) GRPC_OVERRIDE { return WriteMessage(msg); }
+
+  // Send a message serialized ahead of time, e.g. by SerializeToByteBuffer().
+  bool WriteSerialized(const ByteBuffer& msg) { return WriteMessage(msg); }
+
+ private:
+  template <class M>
+  bool WriteMessage(const M& msg) {
     CallOpBuffer buf;
     if (!ctx_->sent_initial_metadata_) {
       buf.AddSendInitialMetadata(&ctx_->initial_metadata_);
@@ -305,7 +319,6 @@ class ServerWriter GRPC_FINAL : public WriterInterface<W> {
     return call_->cq()->Pluck(&buf);
   }
 
- private:
   Call* const call_;
   ServerContext* const ctx_;
 };
@@ -334,7 +347,14 @@ class ServerReaderWriter GRPC_FINAL : public WriterInterface<W>,
     return call_->cq()->Pluck(&buf) && buf.got_message;
   }
 
-  virtual bool Write(const W& msg) GRPC_OVERRIDE {
+  virtual bool Write(const W& msg) GRPC_OVERRIDE { return WriteMessage(msg); }
+
+  // Send a message serialized ahead of time, e.g. by SerializeToByteBuffer().
+  bool WriteSerialized(const ByteBuffer& msg) { return WriteMessage(msg); }
+
+ private:
+  template <class M>
+  bool WriteMessage(const M& msg) {
     CallOpBuffer buf;
     if (!ctx_->sent_initial_metadata_) {
       buf.AddSendInitialMetadata(&ctx_->initial_metadata_);
@@ -345,7 +365,6 @@ class ServerReaderWriter GRPC_FINAL : public WriterInterface<W>,
     return call_->cq()->Pluck(&buf);
   }
 
- private:
   Call* const call_;
   ServerContext* const ctx_;
 };
@@ -573,31 +592,43 @@ class ServerAsyncReader GRPC_FINAL : public ServerAsyncStreamingInterface,
   }
 
   void Finish(const W& msg, const Status& status, void* tag) {
+    FinishWithMessage(msg, status, tag);
+  }
+
+  // Finish with a response serialized ahead of time, e.g. by
+  // SerializeToByteBuffer().
+  void FinishSerialized(const ByteBuffer& msg, const Status& status,
+                        void* tag) {
+    FinishWithMessage(msg, status, tag);
+  }
+
+  void FinishWithError(const Status& status, void* tag) {
+    GPR_ASSERT(!status.IsOk());
     finish_buf_.Reset(tag);
     if (!ctx_->sent_initial_metadata_) {
       finish_buf_.AddSendInitialMetadata(&ctx_->initial_metadata_);
       ctx_->sent_initial_metadata_ = true;
     }
-    // The response is dropped if the status is not OK.
-    if (status.IsOk()) {
-      finish_buf_.AddSendMessage(msg);
-    }
     finish_buf_.AddServerSendStatus(&ctx_->trailing_metadata_, status);
     call_.PerformOps(&finish_buf_);
   }
 
-  void FinishWithError(const Status& status, void* tag) {
-    GPR_ASSERT(!status.IsOk());
+ private:
+  template <class M>
+  void FinishWithMessage(const M& msg, const Status& status, void* tag) {
     finish_buf_.Reset(tag);
     if (!ctx_->sent_initial_metadata_) {
       finish_buf_.AddSendInitialMetadata(&ctx_->initial_metadata_);
       ctx_->sent_initial_metadata_ = true;
     }
+    // The response is dropped if the status is not OK.
+    if (status.IsOk()) {
+      finish_buf_.AddSendMessage(msg);
+    }
     finish_buf_.AddServerSendStatus(&ctx_->trailing_metadata_, status);
     call_.PerformOps(&finish_buf_);
   }
 
- private:
   void BindCall(Call* call) GRPC_OVERRIDE { call_ = *call; }
 
   Call call_;
@@ -624,13 +655,12 @@ class ServerAsyncWriter GRPC_FINAL : public ServerAsyncStreamingInterface,
   }
 
   void Write(const W& msg, void* tag) GRPC_OVERRIDE {
-    write_buf_.Reset(tag);
-    if (!ctx_->sent_initial_metadata_) {
-      write_buf_.AddSendInitialMetadata(&ctx_->initial_metadata_);
-      ctx_->sent_initial_metadata_ = true;
-    }
-    write_buf_.AddSendMessage(msg);
-    call_.PerformOps(&write_buf_);
+    WriteMessage(msg, tag);
+  }
+
+  // Send a message serialized ahead of time, e.g. by SerializeToByteBuffer().
+  void WriteSerialized(const ByteBuffer& msg, void* tag) {
+    WriteMessage(msg, tag);
   }
 
   void Finish(const Status& status, void* tag) {
@@ -644,6 +674,17 @@ class ServerAsyncWriter GRPC_FINAL : public ServerAsyncStreamingInterface,
   }
 
  private:
+  template <class M>
+  void WriteMessage(const M& msg, void* tag) {
+    write_buf_.Reset(tag);
+    if (!ctx_->sent_initial_metadata_) {
+      write_buf_.AddSendInitialMetadata(&ctx_->initial_metadata_);
+      ctx_->sent_initial_metadata_ = true;
+    }
+    write_buf_.AddSendMessage(msg);
+    call_.PerformOps(&write_buf_);
+  }
+
   void BindCall(Call* call) GRPC_OVERRIDE { call_ = *call; }
 
   Call call_;
@@ -678,13 +719,12 @@ class ServerAsyncReaderWriter GRPC_FINAL : public ServerAsyncStreamingInterface,
   }
 
   virtual void Write(const W& msg, void* tag) GRPC_OVERRIDE {
-    write_buf_.Reset(tag);
-    if (!ctx_->sent_initial_metadata_) {
-      write_buf_.AddSendInitialMetadata(&ctx_->initial_metadata_);
-      ctx_->sent_initial_metadata_ = true;
-    }
-    write_buf_.AddSendMessage(msg);
-    call_.PerformOps(&write_buf_);
+    WriteMessage(msg, tag);
+  }
+
+  // Send a message serialized ahead of time, e.g. by SerializeToByteBuffer().
+  void WriteSerialized(const ByteBuffer& msg, void* tag) {
+    WriteMessage(msg, tag);
   }
 
   void Finish(const Status& status, void* tag) {
@@ -698,6 +738,17 @@ class ServerAsyncReaderWriter GRPC_FINAL : public ServerAsyncStreamingInterface,
   }
 
  private:
+  template <class M>
+  void WriteMessage(const M& msg, void* tag) {
+    write_buf_.Reset(tag);
+    if (!ctx_->sent_initial_metadata_) {
+      write_buf_.AddSendInitialMetadata(&ctx_->initial_metadata_);
+      ctx_->sent_initial_metadata_ = true;
+    }
+    write_buf_.AddSendMessage(msg);
+    call_.PerformOps(&write_buf_);
+  }
+
   void BindCall(Call* call) GRPC_OVERRIDE { call_ = *call; }
 
   Call call_;
@@ -109,8 +109,70 @@ typedef struct {
 /* Maximum number of concurrent incoming streams to allow on a http2
    connection */
 #define GRPC_ARG_MAX_CONCURRENT_STREAMS "grpc.max_concurrent_streams"
-/* Maximum message length that the channel can receive */
+/* Maximum message length that the channel can receive. Compressed messages
+   which decompress to more than this fail the call with
+   GRPC_STATUS_RESOURCE_EXHAUSTED. */
 #define GRPC_ARG_MAX_MESSAGE_LENGTH "grpc.max_message_length"
+/* Number of connections a client channel keeps open to its target; calls are
+   spread across them by the load balancing policy (default 1) */
+#define GRPC_ARG_MAX_SUBCHANNELS "grpc.max_subchannels"
+/* Load balancing policy used by a client channel to pick a connection for
+   each new call: one of the GRPC_LB_POLICY_* strings below */
+#define GRPC_ARG_LB_POLICY "grpc.lb_policy"
+/* Send calls to each connection in turn (the default) */
+#define GRPC_LB_POLICY_ROUND_ROBIN "round_robin"
+/* Send calls to the connection with the fewest calls in flight */
+#define GRPC_LB_POLICY_LEAST_OUTSTANDING "least_outstanding"
+/* When connecting to a target that resolves to several addresses, how long
+   (in milliseconds) to wait for a connection attempt before also trying the
+   next address in parallel */
+#define GRPC_ARG_CONNECT_STAGGER_MS "grpc.connect_stagger_ms"
+/* How long (in milliseconds) a single connection attempt to one address may
+   take before it is abandoned */
+#define GRPC_ARG_CONNECT_ATTEMPT_TIMEOUT_MS "grpc.connect_attempt_timeout_ms"
+/* After a failed connection attempt, a client channel waits this long (in
+   milliseconds) before trying again; each further failure multiplies the wait
+   by GRPC_ARG_RECONNECT_BACKOFF_MULTIPLIER, up to
+   GRPC_ARG_MAX_RECONNECT_BACKOFF_MS. Every wait is randomly jittered by up to
+   20% so that clients disconnected together don't reconnect in lockstep. */
+#define GRPC_ARG_INITIAL_RECONNECT_BACKOFF_MS "grpc.initial_reconnect_backoff_ms"
+#define GRPC_ARG_MAX_RECONNECT_BACKOFF_MS "grpc.max_reconnect_backoff_ms"
+/* Integer, or string holding a decimal number such as "1.6" (the default) */
+#define GRPC_ARG_RECONNECT_BACKOFF_MULTIPLIER "grpc.reconnect_backoff_multiplier"
+/* Minimum time (in milliseconds) a connection attempt is allowed before it is
+   abandoned and retried; attempts made after a long backoff get as long as
+   the backoff */
+#define GRPC_ARG_MIN_CONNECT_TIMEOUT_MS "grpc.min_connect_timeout_ms"
+/* How long (in milliseconds) a client channel may go without any calls before
+   it closes its connections and becomes idle; 0 (the default) never does */
+#define GRPC_ARG_CLIENT_IDLE_TIMEOUT_MS "grpc.client_idle_timeout_ms"
+/* Algorithm used to compress the messages sent on a channel: "deflate",
+   "gzip" or "lz" (fast, lower ratio). The default, "identity", leaves messages
+   uncompressed. Only channels with an algorithm announce which algorithms
+   they accept, and messages are only compressed once the peer has announced
+   that it accepts the algorithm: clients therefore send the first messages
+   of a call uncompressed, until the server's initial metadata arrives. */
+#define GRPC_ARG_COMPRESSION_ALGORITHM "grpc.compression_algorithm"
+/* Messages shorter than this many bytes are never compressed (default 256) */
+#define GRPC_ARG_COMPRESSION_MIN_MESSAGE_SIZE \
+  "grpc.compression_min_message_size"
+/* Compression level, from 1 (fastest) to 9 (smallest output), for the
+   deflate and gzip algorithms */
+#define GRPC_ARG_COMPRESSION_LEVEL "grpc.compression_level"
+
+/* Connectivity state of a channel */
+typedef enum grpc_connectivity_state {
+  /* channel has no connection, and is not trying to make one */
+  GRPC_CHANNEL_IDLE,
+  /* channel is establishing a connection */
+  GRPC_CHANNEL_CONNECTING,
+  /* channel has a connection calls can be sent on */
+  GRPC_CHANNEL_READY,
+  /* the last attempt to connect failed; the channel keeps retrying */
+  GRPC_CHANNEL_TRANSIENT_FAILURE,
+  /* channel can never carry calls: it is lame, or has been destroyed */
+  GRPC_CHANNEL_FATAL_FAILURE
+} grpc_connectivity_state;
 
 /* Result of a grpc call. If the caller satisfies the prerequisites of a
    particular operation, the grpc_call_error returned will be GRPC_CALL_OK.
@@ -419,6 +481,25 @@ grpc_channel *grpc_lame_client_channel_create(void);
 /* Close and destroy a grpc channel */
 void grpc_channel_destroy(grpc_channel *channel);
 
+/* Return the connectivity state of a channel. If the channel is idle and
+   try_to_connect is non-zero, start connecting it (without waiting for a
+   call to need it). Lame channels always report GRPC_CHANNEL_FATAL_FAILURE,
+   and channels built directly on a transport always report
+   GRPC_CHANNEL_READY. */
+grpc_connectivity_state grpc_channel_check_connectivity_state(
+    grpc_channel *channel, int try_to_connect);
+
+/* Watch for a change in the connectivity state of a channel: once the state
+   differs from last_observed_state, tag is queued on cq with GRPC_OP_OK; if
+   deadline passes first, it is queued with GRPC_OP_ERROR. The state of lame
+   and direct-transport channels never changes; destroying any other channel
+   moves it to GRPC_CHANNEL_FATAL_FAILURE, completing its watches.
+   This does not start connecting an idle channel: see
+   grpc_channel_check_connectivity_state. */
+void grpc_channel_watch_connectivity_state(
+    grpc_channel *channel, grpc_connectivity_state last_observed_state,
+    gpr_timespec deadline, grpc_completion_queue *cq, void *tag);
+
 /* THREAD-SAFETY for grpc_call
    The following functions are thread-compatible for any given call:
      grpc_call_add_metadata
@@ -86,6 +86,20 @@ typedef struct {
 grpc_credentials *grpc_ssl_credentials_create(
     const char *pem_root_certs, grpc_ssl_pem_key_cert_pair *pem_key_cert_pair);
 
+/* Default number of TLS sessions cached by SSL credentials. */
+#define GRPC_SSL_DEFAULT_SESSION_CACHE_SIZE 64
+
+/* Same as grpc_ssl_credentials_create but with an explicit session cache size.
+   - session_cache_size is the maximum number of TLS sessions, one per target
+     host:port, kept by the credentials. All the channels created with these
+     credentials share the cache so that a new connection to a target already
+     connected to can resume the TLS session with an abbreviated handshake.
+     grpc_ssl_credentials_create uses GRPC_SSL_DEFAULT_SESSION_CACHE_SIZE. If
+     this parameter is 0, sessions are never resumed. */
+grpc_credentials *grpc_ssl_credentials_create_with_session_cache(
+    const char *pem_root_certs, grpc_ssl_pem_key_cert_pair *pem_key_cert_pair,
+    size_t session_cache_size);
+
 /* Creates a composite credentials object. */
 grpc_credentials *grpc_composite_credentials_create(grpc_credentials *creds1,
                                                     grpc_credentials *creds2);
@@ -172,6 +186,22 @@ grpc_server_credentials *grpc_ssl_server_credentials_create(
     const char *pem_root_certs, grpc_ssl_pem_key_cert_pair *pem_key_cert_pairs,
     size_t num_key_cert_pairs);
 
+/* Default lifetime of the keys encrypting the TLS session tickets issued by
+   SSL server credentials. */
+#define GRPC_SSL_DEFAULT_SESSION_TICKET_KEY_ROTATION_SECS 3600
+
+/* Same as grpc_ssl_server_credentials_create but with an explicit session
+   ticket key lifetime.
+   - session_ticket_key_rotation_secs is the number of seconds after which the
+     key encrypting new session tickets is replaced by a freshly generated one.
+     Tickets encrypted with the replaced key are still accepted, and renewed,
+     for one more period. grpc_ssl_server_credentials_create uses
+     GRPC_SSL_DEFAULT_SESSION_TICKET_KEY_ROTATION_SECS. If this parameter is 0,
+     no session tickets are issued. It cannot be negative. */
+grpc_server_credentials *grpc_ssl_server_credentials_create_with_ticket_rotation(
+    const char *pem_root_certs, grpc_ssl_pem_key_cert_pair *pem_key_cert_pairs,
+    size_t num_key_cert_pairs, int session_ticket_key_rotation_secs);
+
 /* Creates a fake server transport security credentials object for testing. */
 grpc_server_credentials *grpc_fake_transport_security_server_credentials_create(
     void);
@@ -184,6 +214,70 @@ grpc_server_credentials *grpc_fake_transport_security_server_credentials_create(
 int grpc_server_add_secure_http2_port(grpc_server *server, const char *addr,
                                       grpc_server_credentials *creds);
 
+/* --- Security handshake offloading. --- */
+
+/* When this integer channel argument is non-zero, the CPU intensive steps of
+   the security handshakes of the channel, or of all the connections accepted
+   by the server, run on a process-wide pool of handshake threads instead of
+   the polling thread that received the handshake data. This keeps bursts of
+   new connections from delaying the RPCs of established connections. */
+#define GRPC_ARG_OFFLOAD_HANDSHAKES "grpc.offload_handshakes"
+
+/* Default number of handshake threads: 0 stands for one per core. */
+#define GRPC_DEFAULT_HANDSHAKE_THREADS 0
+
+/* Default limit on the number of offloaded server handshakes in progress. */
+#define GRPC_DEFAULT_MAX_CONCURRENT_HANDSHAKES 256
+
+/* Default limit on the number of server handshakes waiting to start. */
+#define GRPC_DEFAULT_MAX_WAITING_HANDSHAKES 1024
+
+/* Default limit on the time a server handshake waits to start. */
+#define GRPC_DEFAULT_MAX_HANDSHAKE_WAIT_TIME_MS 20000
+
+/* Sets the number of handshake threads (0 for one per core) and the maximum
+   number of offloaded handshakes in progress at any time (0 for no limit).
+   Server handshakes beyond that limit wait for running ones to finish before
+   they start. Client handshakes are not limited, as a process connecting to
+   itself could otherwise deadlock. Handshakes already started are not
+   affected. The limits go back to their defaults on grpc_init. */
+void grpc_set_handshake_offload_limits(size_t max_threads,
+                                       size_t max_concurrent_handshakes);
+
+/* Sets the maximum number of server handshakes waiting to start and the
+   maximum time each of them waits (gpr_inf_future for no limit). Handshakes
+   beyond the first limit, or waiting past the second, fail and their
+   connection is closed, as do the handshakes still waiting on
+   grpc_shutdown. Handshakes already waiting keep their deadline. The limits
+   go back to their defaults on grpc_init. */
+void grpc_set_handshake_offload_queue_limits(size_t max_waiting_handshakes,
+                                             gpr_timespec max_wait_time);
+
+typedef struct {
+  /* Offloaded handshakes started and not finished yet. */
+  size_t handshakes_in_progress;
+  /* Handshakes waiting for the number in progress to drop below the limit. */
+  size_t handshakes_waiting;
+  /* Handshake steps waiting for a free handshake thread. */
+  size_t steps_queued;
+  /* Highest value steps_queued has reached. */
+  size_t max_steps_queued;
+  /* Number of offloaded handshakes that succeeded and that failed. */
+  gpr_uint64 handshakes_succeeded;
+  gpr_uint64 handshakes_failed;
+  /* Number of server handshakes failed before they started: the queue was
+     full, they waited for too long or the library shut down. */
+  gpr_uint64 handshakes_rejected;
+  /* Total time finished handshakes spent waiting to start, their steps spent
+     waiting for a thread and finished handshakes took from start to end. */
+  gpr_timespec total_wait_time;
+  gpr_timespec total_queue_time;
+  gpr_timespec total_handshake_time;
+} grpc_handshake_offload_stats;
+
+/* Fills stats with the counters of the handshake offload pool. */
+void grpc_get_handshake_offload_stats(grpc_handshake_offload_stats *stats);
+
 #ifdef __cplusplus
 }
 #endif
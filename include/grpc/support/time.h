@@ -65,6 +65,28 @@ extern const gpr_timespec gpr_inf_past;   /* The far past. */
 /* Return the current time measured from the system's default epoch. */
 gpr_timespec gpr_now(void);
 
+/* The clocks gpr_clock_now() can read. A gpr_timespec does not record the
+   clock it was read from: only compare or subtract times of the same clock.
+   */
+typedef enum {
+  /* The wall clock read by gpr_now(). All deadlines (of calls, completion
+     queues, alarms, gpr_cv_wait, gpr_sleep_until...) are times of this clock,
+     so they move when the system time is set. */
+  GPR_CLOCK_REALTIME,
+  /* Time from an unspecified starting point, which never jumps. Only meant
+     for measuring durations: no API takes deadlines on this clock. Falls back
+     to the wall clock on platforms without a monotonic clock. */
+  GPR_CLOCK_MONOTONIC
+} gpr_clock_type;
+
+/* Return the current time of the given clock. */
+gpr_timespec gpr_clock_now(gpr_clock_type clock);
+
+/* Convert t from clock "from" to clock "to", using the offset between the
+   two clocks at the time of the call. Infinities are preserved. */
+gpr_timespec gpr_clock_convert(gpr_timespec t, gpr_clock_type from,
+                               gpr_clock_type to);
+
 /* Return -ve, 0, or +ve according to whether a < b, a == b, or a > b
    respectively.  */
 int gpr_time_cmp(gpr_timespec a, gpr_timespec b);
@@ -153,6 +153,8 @@ grpc::string GetHeaderPrologue(const grpc::protobuf::FileDescriptor *file,
 grpc::string GetHeaderIncludes(const grpc::protobuf::FileDescriptor *file,
                                const Parameters &params) {
   grpc::string temp =
+      "#include <functional>\n"
+      "\n"
       "#include <grpc++/impl/internal_stub.h>\n"
       "#include <grpc++/impl/rpc_method.h>\n"
       "#include <grpc++/impl/service_type.h>\n"
@@ -228,6 +230,10 @@ void PrintHeaderClientMethod(grpc::protobuf::io::Printer *printer,
     printer->Print(*vars,
                    "::grpc::Status $Method$(::grpc::ClientContext* context, "
                    "const $Request$& request, $Response$* response);\n");
+    printer->Print(*vars,
+                   "void $Method$(::grpc::ClientContext* context, "
+                   "const $Request$& request, $Response$* response, "
+                   "std::function<void(::grpc::Status)> on_done);\n");
     printer->Print(
         *vars,
         "std::unique_ptr< ::grpc::ClientAsyncResponseReader< $Response$>> "
@@ -308,6 +314,24 @@ void PrintHeaderServerMethodSync(grpc::protobuf::io::Printer *printer,
   }
 }
 
+void PrintHeaderServerMethodCallback(
+    grpc::protobuf::io::Printer *printer,
+    const grpc::protobuf::MethodDescriptor *method,
+    std::map<grpc::string, grpc::string> *vars) {
+  (*vars)["Method"] = method->name();
+  (*vars)["Request"] =
+      grpc_cpp_generator::ClassName(method->input_type(), true);
+  (*vars)["Response"] =
+      grpc_cpp_generator::ClassName(method->output_type(), true);
+  if (NoStreaming(method)) {
+    printer->Print(*vars,
+                   "virtual void $Method$("
+                   "::grpc::ServerContext* context, const $Request$* request, "
+                   "$Response$* response, "
+                   "::grpc::ServerUnaryReactor* reactor);\n");
+  }
+}
+
 void PrintHeaderServerMethodAsync(
     grpc::protobuf::io::Printer *printer,
     const grpc::protobuf::MethodDescriptor *method,
@@ -397,6 +421,23 @@ void PrintHeaderService(grpc::protobuf::io::Printer *printer,
       "  ::grpc::RpcService* service_;\n");
   printer->Print("};\n");
 
+  // Server side - Callback
+  printer->Print(
+      "class CallbackService : public ::grpc::CallbackService {\n"
+      " public:\n");
+  printer->Indent();
+  printer->Print("CallbackService() : service_(nullptr) {}\n");
+  printer->Print("virtual ~CallbackService();\n");
+  for (int i = 0; i < service->method_count(); ++i) {
+    PrintHeaderServerMethodCallback(printer, service->method(i), vars);
+  }
+  printer->Print("::grpc::RpcService* service() GRPC_OVERRIDE GRPC_FINAL;\n");
+  printer->Outdent();
+  printer->Print(
+      " private:\n"
+      "  ::grpc::RpcService* service_;\n");
+  printer->Print("};\n");
+
   // Server side - Asynchronous
   printer->Print(
       "class AsyncService GRPC_FINAL : public ::grpc::AsynchronousService {\n"
@@ -533,6 +574,16 @@ void PrintSourceClientMethod(grpc::protobuf::io::Printer *printer,
                    "rpcmethod_$Method$_, "
                    "context, request, response);\n"
                    "}\n\n");
+    printer->Print(*vars,
+                   "void $ns$$Service$::Stub::$Method$("
+                   "::grpc::ClientContext* context, "
+                   "const $Request$& request, $Response$* response, "
+                   "std::function<void(::grpc::Status)> on_done) {\n");
+    printer->Print(*vars,
+                   "  ::grpc::CallbackUnaryCall(channel(), "
+                   "rpcmethod_$Method$_, "
+                   "context, request, response, on_done);\n"
+                   "}\n\n");
     printer->Print(
         *vars,
         "std::unique_ptr< ::grpc::ClientAsyncResponseReader< $Response$>> "
@@ -676,6 +727,28 @@ void PrintSourceServerMethod(grpc::protobuf::io::Printer *printer,
   }
 }
 
+void PrintSourceServerCallbackMethod(
+    grpc::protobuf::io::Printer *printer,
+    const grpc::protobuf::MethodDescriptor *method,
+    std::map<grpc::string, grpc::string> *vars) {
+  (*vars)["Method"] = method->name();
+  (*vars)["Request"] =
+      grpc_cpp_generator::ClassName(method->input_type(), true);
+  (*vars)["Response"] =
+      grpc_cpp_generator::ClassName(method->output_type(), true);
+  if (NoStreaming(method)) {
+    printer->Print(*vars,
+                   "void $ns$$Service$::CallbackService::$Method$("
+                   "::grpc::ServerContext* context, "
+                   "const $Request$* request, $Response$* response, "
+                   "::grpc::ServerUnaryReactor* reactor) {\n");
+    printer->Print(
+        "  reactor->Finish(::grpc::Status("
+        "::grpc::StatusCode::UNIMPLEMENTED));\n");
+    printer->Print("}\n\n");
+  }
+}
+
 void PrintSourceServerAsyncMethod(
     grpc::protobuf::io::Printer *printer,
     const grpc::protobuf::MethodDescriptor *method,
@@ -878,6 +951,71 @@ void PrintSourceService(grpc::protobuf::io::Printer *printer,
   printer->Print("}\n\n");
 }
 
+void PrintSourceCallbackService(
+    grpc::protobuf::io::Printer *printer,
+    const grpc::protobuf::ServiceDescriptor *service,
+    std::map<grpc::string, grpc::string> *vars) {
+  printer->Print(*vars,
+                 "$ns$$Service$::CallbackService::~CallbackService() {\n"
+                 "  delete service_;\n"
+                 "}\n\n");
+  for (int i = 0; i < service->method_count(); ++i) {
+    PrintSourceServerCallbackMethod(printer, service->method(i), vars);
+  }
+  printer->Print(
+      *vars,
+      "::grpc::RpcService* $ns$$Service$::CallbackService::service() {\n");
+  printer->Indent();
+  printer->Print(
+      "if (service_ != nullptr) {\n"
+      "  return service_;\n"
+      "}\n");
+  printer->Print("service_ = new ::grpc::RpcService();\n");
+  for (int i = 0; i < service->method_count(); ++i) {
+    const grpc::protobuf::MethodDescriptor *method = service->method(i);
+    (*vars)["Idx"] = as_string(i);
+    (*vars)["Method"] = method->name();
+    (*vars)["Request"] =
+        grpc_cpp_generator::ClassName(method->input_type(), true);
+    (*vars)["Response"] =
+        grpc_cpp_generator::ClassName(method->output_type(), true);
+    if (NoStreaming(method)) {
+      printer->Print(
+          *vars,
+          "service_->AddMethod(new ::grpc::RpcServiceMethod(\n"
+          "    $prefix$$Service$_method_names[$Idx$],\n"
+          "    ::grpc::RpcMethod::NORMAL_RPC,\n"
+          "    new ::grpc::CallbackUnaryHandler< "
+          "$ns$$Service$::CallbackService, $Request$, $Response$>(\n"
+          "        std::function<void($ns$$Service$::CallbackService*, "
+          "::grpc::ServerContext*, const $Request$*, $Response$*, "
+          "::grpc::ServerUnaryReactor*)>("
+          "&$ns$$Service$::CallbackService::$Method$), this),\n"
+          "    new $Request$, new $Response$));\n");
+    } else {
+      // Streaming methods have no callback form yet; the server answers
+      // them with UNIMPLEMENTED.
+      if (ClientOnlyStreaming(method)) {
+        (*vars)["StreamingType"] = "CLIENT_STREAMING";
+      } else if (ServerOnlyStreaming(method)) {
+        (*vars)["StreamingType"] = "SERVER_STREAMING";
+      } else {
+        (*vars)["StreamingType"] = "BIDI_STREAMING";
+      }
+      printer->Print(
+          *vars,
+          "service_->AddMethod(new ::grpc::RpcServiceMethod(\n"
+          "    $prefix$$Service$_method_names[$Idx$],\n"
+          "    ::grpc::RpcMethod::$StreamingType$,\n"
+          "    static_cast< ::grpc::CallbackMethodHandler*>(nullptr),\n"
+          "    new $Request$, new $Response$));\n");
+    }
+  }
+  printer->Print("return service_;\n");
+  printer->Outdent();
+  printer->Print("}\n\n");
+}
+
 grpc::string GetSourceServices(const grpc::protobuf::FileDescriptor *file,
                                const Parameters &params) {
   grpc::string output;
@@ -900,6 +1038,7 @@ grpc::string GetSourceServices(const grpc::protobuf::FileDescriptor *file,
 
   for (int i = 0; i < file->service_count(); ++i) {
     PrintSourceService(&printer, file->service(i), &vars);
+    PrintSourceCallbackService(&printer, file->service(i), &vars);
     printer.Print("\n");
   }
   return output;
@@ -40,6 +40,7 @@
 #include "src/core/channel/noop_filter.h"
 #include "src/core/statistics/census_interface.h"
 #include "src/core/statistics/census_rpc_stats.h"
+#include "src/core/statistics/census_tracing.h"
 #include <grpc/support/alloc.h>
 #include <grpc/support/log.h>
 #include <grpc/support/slice.h>
@@ -65,6 +66,23 @@ static void init_rpc_stats(census_rpc_stats* stats) {
   stats->cnt = 1;
 }
 
+static void destroy_method_id(void* unused) {}
+
+/* Returns the stats store id of the method named by the :path element md.
+   Method ids never go stale, so they are cached on the (interned) element
+   and most calls skip the lookup by name. */
+static census_method_id get_method_id(grpc_mdelem* md) {
+  void* cached = grpc_mdelem_get_user_data(md, destroy_method_id);
+  census_method_id id;
+  if (cached != NULL) return (census_method_id)((gpr_intptr)cached - 1);
+  id = census_stats_register_method(grpc_mdstr_as_c_string(md->value));
+  if (id != CENSUS_INVALID_METHOD_ID) {
+    grpc_mdelem_set_user_data(md, destroy_method_id,
+                              (void*)(gpr_intptr)(id + 1));
+  }
+  return id;
+}
+
 static void extract_and_annotate_method_tag(grpc_stream_op_buffer* sopb,
                                             call_data* calld,
                                             channel_data* chand) {
@@ -77,8 +95,9 @@ static void extract_and_annotate_method_tag(grpc_stream_op_buffer* sopb,
       if (m->md->key == chand->path_str) {
         gpr_log(GPR_DEBUG, "%s",
                 (const char*)GPR_SLICE_START_PTR(m->md->value->slice));
-        census_add_method_tag(calld->op_id, (const char*)GPR_SLICE_START_PTR(
-                                                m->md->value->slice));
+        census_add_method_tag_with_id(calld->op_id,
+                                      grpc_mdstr_as_c_string(m->md->value),
+                                      get_method_id(m->md));
       }
     }
   }
@@ -149,7 +168,7 @@ static void client_init_call_elem(grpc_call_element* elem,
   call_data* d = elem->call_data;
   GPR_ASSERT(d != NULL);
   init_rpc_stats(&d->stats);
-  d->start_ts = gpr_now();
+  d->start_ts = gpr_clock_now(GPR_CLOCK_MONOTONIC);
   d->op_id = census_tracing_start_op();
   if (initial_op) client_mutate_op(elem, initial_op);
 }
@@ -167,7 +186,7 @@ static void server_init_call_elem(grpc_call_element* elem,
   call_data* d = elem->call_data;
   GPR_ASSERT(d != NULL);
   init_rpc_stats(&d->stats);
-  d->start_ts = gpr_now();
+  d->start_ts = gpr_clock_now(GPR_CLOCK_MONOTONIC);
   d->op_id = census_tracing_start_op();
   if (initial_op) server_mutate_op(elem, initial_op);
 }
@@ -175,8 +194,8 @@ static void server_init_call_elem(grpc_call_element* elem,
 static void server_destroy_call_elem(grpc_call_element* elem) {
   call_data* d = elem->call_data;
   GPR_ASSERT(d != NULL);
-  d->stats.elapsed_time_ms =
-      gpr_timespec_to_micros(gpr_time_sub(gpr_now(), d->start_ts));
+  d->stats.elapsed_time_ms = gpr_timespec_to_micros(
+      gpr_time_sub(gpr_clock_now(GPR_CLOCK_MONOTONIC), d->start_ts));
   census_record_rpc_server_stats(d->op_id, &d->stats);
   census_tracing_end_op(d->op_id);
 }
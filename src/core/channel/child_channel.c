@@ -46,6 +46,8 @@ typedef struct {
   grpc_channel_element *back;
   /* # of active calls on the channel */
   gpr_uint32 active_calls;
+  /* # of calls ever started on the channel */
+  gpr_uint32 calls_started;
   /* has grpc_child_channel_destroy been called? */
   gpr_uint8 destroyed;
   /* has the transport reported itself disconnected? */
@@ -140,6 +142,7 @@ static void lb_init_channel_elem(grpc_channel_element *elem,
   chand->destroyed = 0;
   chand->disconnected = 0;
   chand->active_calls = 0;
+  chand->calls_started = 0;
   chand->sent_goaway = 0;
   chand->calling_back = 0;
   chand->sending_farewell = 0;
@@ -256,6 +259,24 @@ void grpc_child_channel_destroy(grpc_child_channel *channel,
   gpr_mu_unlock(&chand->mu);
 }
 
+gpr_uint32 grpc_child_channel_get_active_calls(grpc_child_channel *channel) {
+  lb_channel_data *chand = LINK_BACK_ELEM_FROM_CHANNEL(channel)->channel_data;
+  gpr_uint32 active_calls;
+  gpr_mu_lock(&chand->mu);
+  active_calls = chand->active_calls;
+  gpr_mu_unlock(&chand->mu);
+  return active_calls;
+}
+
+gpr_uint32 grpc_child_channel_get_calls_started(grpc_child_channel *channel) {
+  lb_channel_data *chand = LINK_BACK_ELEM_FROM_CHANNEL(channel)->channel_data;
+  gpr_uint32 calls_started;
+  gpr_mu_lock(&chand->mu);
+  calls_started = chand->calls_started;
+  gpr_mu_unlock(&chand->mu);
+  return calls_started;
+}
+
 void grpc_child_channel_handle_op(grpc_child_channel *channel,
                                   grpc_channel_op *op) {
   grpc_channel_next_op(LINK_BACK_ELEM_FROM_CHANNEL(channel), op);
@@ -277,6 +298,7 @@ grpc_child_call *grpc_child_channel_create_call(grpc_child_channel *channel,
 
   gpr_mu_lock(&lbchand->mu);
   lbchand->active_calls++;
+  lbchand->calls_started++;
   gpr_mu_unlock(&lbchand->mu);
 
   return stk;
@@ -55,6 +55,10 @@ grpc_channel_element *grpc_child_channel_get_bottom_element(
     grpc_child_channel *channel);
 void grpc_child_channel_destroy(grpc_child_channel *channel,
                                 int wait_for_callbacks);
+/* number of calls currently active on the channel */
+gpr_uint32 grpc_child_channel_get_active_calls(grpc_child_channel *channel);
+/* number of calls ever started on the channel */
+gpr_uint32 grpc_child_channel_get_calls_started(grpc_child_channel *channel);
 
 grpc_child_call *grpc_child_channel_create_call(grpc_child_channel *channel,
                                                 grpc_call_element *parent,
@@ -34,10 +34,12 @@
 #include "src/core/channel/client_channel.h"
 
 #include <stdio.h>
+#include <string.h>
 
 #include "src/core/channel/channel_args.h"
 #include "src/core/channel/child_channel.h"
 #include "src/core/channel/connected_channel.h"
+#include "src/core/iomgr/alarm.h"
 #include "src/core/iomgr/iomgr.h"
 #include "src/core/support/string.h"
 #include <grpc/support/alloc.h>
@@ -48,16 +50,30 @@
 /* Client channel implementation */
 
 typedef struct call_data call_data;
+typedef struct lb_policy lb_policy;
+typedef struct state_watcher state_watcher;
 
 typedef struct {
-  /* protects children, child_count, child_capacity, active_child,
-     transport_setup_initiated
+  /* protects children, child_count, child_capacity, next_child,
+     waiting_children, waiting_child_count, waiting_child_capacity,
+     transport_setup_initiated, transport_setup_failed, active_calls,
+     last_activity, idle_alarm_pending, shutting_down, disconnected,
+     state_watchers
      does not protect channel stacks held by children
      transport_setup is assumed to be set once during construction */
   gpr_mu mu;
-
-  /* the sending child (may be null) */
-  grpc_child_channel *active_child;
+  /* signalled when the idle alarm completes */
+  gpr_cv cv;
+
+  /* the connected children calls can be sent on (subchannels) */
+  grpc_child_channel **children;
+  size_t child_count;
+  size_t child_capacity;
+  /* how many children we try to keep connected */
+  size_t max_children;
+  /* how calls are spread across children, and its cursor into children */
+  const lb_policy *lb_policy;
+  size_t next_child;
   grpc_mdctx *mdctx;
 
   /* calls waiting for a channel to be ready */
@@ -68,10 +84,81 @@ typedef struct {
   /* transport setup for this channel */
   grpc_transport_setup *transport_setup;
   int transport_setup_initiated;
+  /* did the last connection attempt fail? */
+  int transport_setup_failed;
+
+  /* idle connection teardown: disabled if idle_timeout is zero, in which
+     case active_calls and last_activity are not maintained */
+  gpr_timespec idle_timeout;
+  size_t active_calls;
+  gpr_timespec last_activity;
+  grpc_alarm idle_alarm;
+  int idle_alarm_pending;
+  int shutting_down;
+
+  /* has the channel been told to disconnect? */
+  int disconnected;
+  /* watches waiting for the connectivity state to change */
+  state_watcher *state_watchers;
 
   grpc_channel_args *args;
 } channel_data;
 
+/* A pending grpc_client_channel_watch_connectivity_state */
+struct state_watcher {
+  channel_data *chand;
+  grpc_connectivity_state last_observed_state;
+  /* fires at the watch deadline */
+  grpc_alarm alarm;
+  /* one for the alarm callback, one for the notification of the result */
+  gpr_refcount refs;
+  /* did the state change (as opposed to the deadline passing)? */
+  int changed;
+  void (*cb)(void *arg, int changed);
+  void *cb_arg;
+  state_watcher *next;
+};
+
+static void notify_state_watchers_locked(channel_data *chand);
+
+/* A load balancing policy picks which connected child a new call is sent on.
+   pick is called with chand->mu held and at least one child connected. */
+struct lb_policy {
+  const char *name;
+  grpc_child_channel *(*pick)(channel_data *chand);
+};
+
+static grpc_child_channel *pick_round_robin(channel_data *chand) {
+  grpc_child_channel *child;
+  if (chand->next_child >= chand->child_count) chand->next_child = 0;
+  child = chand->children[chand->next_child++];
+  return child;
+}
+
+static grpc_child_channel *pick_least_outstanding(channel_data *chand) {
+  size_t i;
+  size_t idx;
+  size_t best = 0;
+  gpr_uint32 best_calls = 0;
+  gpr_uint32 calls;
+  /* scan starting after the last pick so that ties rotate between children */
+  for (i = 0; i < chand->child_count; i++) {
+    idx = (chand->next_child + i) % chand->child_count;
+    calls = grpc_child_channel_get_active_calls(chand->children[idx]);
+    if (i == 0 || calls < best_calls) {
+      best = idx;
+      best_calls = calls;
+    }
+  }
+  chand->next_child = best + 1;
+  return chand->children[best];
+}
+
+static const lb_policy lb_policies[] = {
+    {GRPC_LB_POLICY_ROUND_ROBIN, pick_round_robin},
+    {GRPC_LB_POLICY_LEAST_OUTSTANDING, pick_least_outstanding},
+};
+
 typedef enum {
   CALL_CREATED,
   CALL_WAITING,
@@ -139,6 +226,171 @@ static void remove_waiting_child(channel_data *chand, call_data *calld) {
   chand->waiting_child_count = new_count;
 }
 
+static void add_child(channel_data *chand, grpc_child_channel *child) {
+  if (chand->child_count == chand->child_capacity) {
+    chand->child_capacity = GPR_MAX(chand->child_capacity * 2, 4);
+    chand->children = gpr_realloc(
+        chand->children, chand->child_capacity * sizeof(grpc_child_channel *));
+  }
+  chand->children[chand->child_count++] = child;
+  notify_state_watchers_locked(chand);
+}
+
+/* returns 1 if child was one of our children (and is no longer): children
+   stay in the order they connected, so children[0] is always the oldest */
+static int remove_child(channel_data *chand, grpc_child_channel *child) {
+  size_t i;
+  for (i = 0; i < chand->child_count; i++) {
+    if (chand->children[i] == child) {
+      chand->child_count--;
+      memmove(&chand->children[i], &chand->children[i + 1],
+              (chand->child_count - i) * sizeof(grpc_child_channel *));
+      /* keep the round robin position on the same next child */
+      if (chand->next_child > i) chand->next_child--;
+      notify_state_watchers_locked(chand);
+      return 1;
+    }
+  }
+  return 0;
+}
+
+/* takes ownership of all children: returns them, and how many there were in
+   *count */
+static grpc_child_channel **take_children(channel_data *chand, size_t *count) {
+  grpc_child_channel **children = chand->children;
+  *count = chand->child_count;
+  chand->children = NULL;
+  chand->child_count = 0;
+  chand->child_capacity = 0;
+  notify_state_watchers_locked(chand);
+  return children;
+}
+
+/* should a new connection be started? if so, mark one as started: the caller
+   must then initiate transport setup outside the lock */
+static int begin_transport_setup_if_needed(channel_data *chand) {
+  if (chand->transport_setup_initiated ||
+      chand->child_count >= chand->max_children) {
+    return 0;
+  }
+  chand->transport_setup_initiated = 1;
+  notify_state_watchers_locked(chand);
+  return 1;
+}
+
+static grpc_connectivity_state connectivity_state(channel_data *chand) {
+  if (chand->disconnected) return GRPC_CHANNEL_FATAL_FAILURE;
+  if (chand->child_count > 0) return GRPC_CHANNEL_READY;
+  if (!chand->transport_setup_initiated) return GRPC_CHANNEL_IDLE;
+  return chand->transport_setup_failed ? GRPC_CHANNEL_TRANSIENT_FAILURE
+                                       : GRPC_CHANNEL_CONNECTING;
+}
+
+static void unref_state_watcher(state_watcher *w) {
+  if (gpr_unref(&w->refs)) {
+    w->cb(w->cb_arg, w->changed);
+    gpr_free(w);
+  }
+}
+
+/* run from the iomgr callback queue once a watcher has seen a change: the
+   watch owns no channel locks there */
+static void on_state_watcher_notified(void *arg, int success) {
+  state_watcher *w = arg;
+  grpc_alarm_cancel(&w->alarm);
+  unref_state_watcher(w);
+}
+
+static void on_state_watcher_alarm(void *arg, int success) {
+  state_watcher *w = arg;
+  channel_data *chand = w->chand;
+  state_watcher **prev;
+  int timed_out = 0;
+  if (success) {
+    gpr_mu_lock(&chand->mu);
+    for (prev = &chand->state_watchers; *prev; prev = &(*prev)->next) {
+      if (*prev == w) {
+        *prev = w->next;
+        timed_out = 1;
+        break;
+      }
+    }
+    gpr_mu_unlock(&chand->mu);
+  }
+  if (timed_out) {
+    unref_state_watcher(w);
+  }
+  unref_state_watcher(w);
+}
+
+/* complete the watches whose last observed state is no longer current: call
+   with chand->mu held whenever the connectivity state may have changed */
+static void notify_state_watchers_locked(channel_data *chand) {
+  grpc_connectivity_state state = connectivity_state(chand);
+  state_watcher **prev = &chand->state_watchers;
+  state_watcher *w;
+  while ((w = *prev) != NULL) {
+    if (w->last_observed_state != state) {
+      *prev = w->next;
+      w->changed = 1;
+      grpc_iomgr_add_callback(on_state_watcher_notified, w);
+    } else {
+      prev = &w->next;
+    }
+  }
+}
+
+static int idle_timeout_enabled(channel_data *chand) {
+  return gpr_time_cmp(chand->idle_timeout, gpr_time_0) > 0;
+}
+
+static void on_idle_alarm(void *arg, int success);
+
+/* start the idle alarm if we hold connections that nothing is using and it
+   is not already running. Call with chand->mu held. */
+static void maybe_start_idle_alarm(channel_data *chand, gpr_timespec now) {
+  if (!idle_timeout_enabled(chand) || chand->idle_alarm_pending ||
+      chand->shutting_down || chand->active_calls > 0 ||
+      chand->child_count == 0) {
+    return;
+  }
+  chand->idle_alarm_pending = 1;
+  grpc_alarm_init(&chand->idle_alarm,
+                  gpr_time_add(chand->last_activity, chand->idle_timeout),
+                  on_idle_alarm, chand, now);
+}
+
+static void on_idle_alarm(void *arg, int success) {
+  channel_data *chand = arg;
+  grpc_child_channel **children = NULL;
+  size_t child_count = 0;
+  size_t i;
+  gpr_timespec now = gpr_now();
+
+  gpr_mu_lock(&chand->mu);
+  chand->idle_alarm_pending = 0;
+  /* don't tear down connections in the middle of (re)filling the pool: the
+     alarm will be restarted once the setup completes */
+  if (success && !chand->shutting_down && chand->active_calls == 0 &&
+      !chand->transport_setup_initiated) {
+    if (gpr_time_cmp(gpr_time_add(chand->last_activity, chand->idle_timeout),
+                     now) <= 0) {
+      children = take_children(chand, &child_count);
+    } else {
+      /* there was activity since the alarm was set: wait for the rest of the
+         timeout */
+      maybe_start_idle_alarm(chand, now);
+    }
+  }
+  gpr_cv_broadcast(&chand->cv);
+  gpr_mu_unlock(&chand->mu);
+
+  for (i = 0; i < child_count; i++) {
+    grpc_child_channel_destroy(children[i], 1);
+  }
+  gpr_free(children);
+}
+
 static void handle_op_after_cancellation(grpc_call_element *elem,
                                          grpc_transport_op *op) {
   call_data *calld = elem->call_data;
@@ -189,27 +441,25 @@ static void cc_start_transport_op(grpc_call_element *elem,
         gpr_mu_unlock(&chand->mu);
         handle_op_after_cancellation(elem, op);
       } else {
+        /* check to see if we should initiate a connection (if we're not
+           already, and are short of children), but don't do so until outside
+           the lock to avoid re-entrancy problems if the callback is
+           immediate */
+        int initiate_transport_setup = begin_transport_setup_if_needed(chand);
         calld->state = CALL_WAITING;
-        if (chand->active_child) {
-          /* channel is connected - use the connected stack */
-          if (prepare_activate(elem, chand->active_child)) {
+        if (chand->child_count > 0) {
+          /* channel is connected - use a connected stack */
+          if (prepare_activate(elem, chand->lb_policy->pick(chand))) {
             gpr_mu_unlock(&chand->mu);
             /* activate the request (pass it down) outside the lock */
             complete_activate(elem, op);
           } else {
             gpr_mu_unlock(&chand->mu);
           }
-        } else {
-          /* check to see if we should initiate a connection (if we're not
-             already),
-             but don't do so until outside the lock to avoid re-entrancy
-             problems if
-             the callback is immediate */
-          int initiate_transport_setup = 0;
-          if (!chand->transport_setup_initiated) {
-            chand->transport_setup_initiated = 1;
-            initiate_transport_setup = 1;
+          if (initiate_transport_setup) {
+            grpc_transport_setup_initiate(chand->transport_setup);
           }
+        } else {
           /* add this call to the waiting set to be resumed once we have a child
              channel stack, growing the waiting set if needed */
           if (chand->waiting_child_count == chand->waiting_child_capacity) {
@@ -269,45 +519,53 @@ static void channel_op(grpc_channel_element *elem,
                        grpc_channel_element *from_elem, grpc_channel_op *op) {
   channel_data *chand = elem->channel_data;
   grpc_child_channel *child_channel;
+  grpc_child_channel **children;
+  size_t child_count;
+  size_t i;
   grpc_channel_op rop;
   GPR_ASSERT(elem->filter == &grpc_client_channel_filter);
 
   switch (op->type) {
     case GRPC_CHANNEL_GOAWAY:
-      /* sending goaway: clear out the active child on the way through */
+      /* sending goaway: clear out the children on the way through */
       gpr_mu_lock(&chand->mu);
-      child_channel = chand->active_child;
-      chand->active_child = NULL;
+      children = take_children(chand, &child_count);
       gpr_mu_unlock(&chand->mu);
-      if (child_channel) {
-        grpc_child_channel_handle_op(child_channel, op);
-        grpc_child_channel_destroy(child_channel, 1);
-      } else {
+      if (child_count == 0) {
         gpr_slice_unref(op->data.goaway.message);
       }
+      for (i = 0; i < child_count; i++) {
+        /* each child consumes a ref to the message */
+        rop = *op;
+        if (i + 1 < child_count) {
+          gpr_slice_ref(rop.data.goaway.message);
+        }
+        grpc_child_channel_handle_op(children[i], &rop);
+        grpc_child_channel_destroy(children[i], 1);
+      }
+      gpr_free(children);
       break;
     case GRPC_CHANNEL_DISCONNECT:
-      /* sending disconnect: clear out the active child on the way through */
+      /* sending disconnect: clear out the children on the way through */
       gpr_mu_lock(&chand->mu);
-      child_channel = chand->active_child;
-      chand->active_child = NULL;
+      chand->disconnected = 1;
+      children = take_children(chand, &child_count);
       gpr_mu_unlock(&chand->mu);
-      if (child_channel) {
-        grpc_child_channel_destroy(child_channel, 1);
+      for (i = 0; i < child_count; i++) {
+        grpc_child_channel_destroy(children[i], 1);
       }
+      gpr_free(children);
       /* fake a transport closed to satisfy the refcounting in client */
       rop.type = GRPC_TRANSPORT_CLOSED;
       rop.dir = GRPC_CALL_UP;
       grpc_channel_next_op(elem, &rop);
       break;
     case GRPC_TRANSPORT_GOAWAY:
-      /* receiving goaway: if it's from our active child, drop the active child;
-         in all cases consume the event here */
+      /* receiving goaway: if it's from one of our children, stop sending new
+         calls to it; in all cases consume the event here */
       gpr_mu_lock(&chand->mu);
       child_channel = grpc_channel_stack_from_top_element(from_elem);
-      if (child_channel == chand->active_child) {
-        chand->active_child = NULL;
-      } else {
+      if (!remove_child(chand, child_channel)) {
         child_channel = NULL;
       }
       gpr_mu_unlock(&chand->mu);
@@ -317,13 +575,11 @@ static void channel_op(grpc_channel_element *elem,
       gpr_slice_unref(op->data.goaway.message);
       break;
     case GRPC_TRANSPORT_CLOSED:
-      /* receiving disconnect: if it's from our active child, drop the active
-         child; in all cases consume the event here */
+      /* receiving disconnect: if it's from one of our children, drop it; in
+         all cases consume the event here */
       gpr_mu_lock(&chand->mu);
       child_channel = grpc_channel_stack_from_top_element(from_elem);
-      if (child_channel == chand->active_child) {
-        chand->active_child = NULL;
-      } else {
+      if (!remove_child(chand, child_channel)) {
         child_channel = NULL;
       }
       gpr_mu_unlock(&chand->mu);
@@ -359,6 +615,13 @@ static void init_call_elem(grpc_call_element *elem,
   calld->elem = elem;
   calld->state = CALL_CREATED;
   calld->deadline = gpr_inf_future;
+
+  if (idle_timeout_enabled(elem->channel_data)) {
+    channel_data *chand = elem->channel_data;
+    gpr_mu_lock(&chand->mu);
+    chand->active_calls++;
+    gpr_mu_unlock(&chand->mu);
+  }
 }
 
 /* Destructor for call_data */
@@ -372,6 +635,16 @@ static void destroy_call_elem(grpc_call_element *elem) {
     grpc_child_call_destroy(calld->s.active.child_call);
   }
   GPR_ASSERT(calld->state != CALL_WAITING);
+
+  if (idle_timeout_enabled(elem->channel_data)) {
+    channel_data *chand = elem->channel_data;
+    gpr_mu_lock(&chand->mu);
+    if (--chand->active_calls == 0) {
+      chand->last_activity = grpc_iomgr_now();
+      maybe_start_idle_alarm(chand, chand->last_activity);
+    }
+    gpr_mu_unlock(&chand->mu);
+  }
 }
 
 /* Constructor for channel_data */
@@ -380,37 +653,117 @@ static void init_channel_elem(grpc_channel_element *elem,
                               grpc_mdctx *metadata_context, int is_first,
                               int is_last) {
   channel_data *chand = elem->channel_data;
+  size_t i;
+  size_t j;
 
   GPR_ASSERT(!is_first);
   GPR_ASSERT(is_last);
   GPR_ASSERT(elem->filter == &grpc_client_channel_filter);
 
   gpr_mu_init(&chand->mu);
-  chand->active_child = NULL;
+  gpr_cv_init(&chand->cv);
+  chand->children = NULL;
+  chand->child_count = 0;
+  chand->child_capacity = 0;
+  chand->max_children = 1;
+  chand->lb_policy = &lb_policies[0];
+  chand->next_child = 0;
   chand->waiting_children = NULL;
   chand->waiting_child_count = 0;
   chand->waiting_child_capacity = 0;
   chand->transport_setup = NULL;
   chand->transport_setup_initiated = 0;
+  chand->transport_setup_failed = 0;
+  chand->idle_timeout = gpr_time_0;
+  chand->active_calls = 0;
+  chand->last_activity = grpc_iomgr_now();
+  chand->idle_alarm_pending = 0;
+  chand->shutting_down = 0;
+  chand->disconnected = 0;
+  chand->state_watchers = NULL;
   chand->args = grpc_channel_args_copy(args);
   chand->mdctx = metadata_context;
+
+  if (args) {
+    for (i = 0; i < args->num_args; i++) {
+      if (0 == strcmp(args->args[i].key, GRPC_ARG_MAX_SUBCHANNELS)) {
+        if (args->args[i].type != GRPC_ARG_INTEGER) {
+          gpr_log(GPR_ERROR, "%s ignored: it must be an integer",
+                  GRPC_ARG_MAX_SUBCHANNELS);
+        } else if (args->args[i].value.integer < 1) {
+          gpr_log(GPR_ERROR, "%s ignored: it must be >= 1",
+                  GRPC_ARG_MAX_SUBCHANNELS);
+        } else {
+          chand->max_children = (size_t)args->args[i].value.integer;
+        }
+      } else if (0 == strcmp(args->args[i].key, GRPC_ARG_LB_POLICY)) {
+        if (args->args[i].type != GRPC_ARG_STRING) {
+          gpr_log(GPR_ERROR, "%s ignored: it must be a string",
+                  GRPC_ARG_LB_POLICY);
+        } else {
+          for (j = 0; j < GPR_ARRAY_SIZE(lb_policies); j++) {
+            if (0 == strcmp(args->args[i].value.string, lb_policies[j].name)) {
+              break;
+            }
+          }
+          if (j == GPR_ARRAY_SIZE(lb_policies)) {
+            gpr_log(GPR_ERROR, "%s ignored: unknown policy '%s'",
+                    GRPC_ARG_LB_POLICY, args->args[i].value.string);
+          } else {
+            chand->lb_policy = &lb_policies[j];
+          }
+        }
+      } else if (0 == strcmp(args->args[i].key,
+                             GRPC_ARG_CLIENT_IDLE_TIMEOUT_MS)) {
+        if (args->args[i].type != GRPC_ARG_INTEGER) {
+          gpr_log(GPR_ERROR, "%s ignored: it must be an integer",
+                  GRPC_ARG_CLIENT_IDLE_TIMEOUT_MS);
+        } else if (args->args[i].value.integer < 0) {
+          gpr_log(GPR_ERROR, "%s ignored: it must be >= 0",
+                  GRPC_ARG_CLIENT_IDLE_TIMEOUT_MS);
+        } else {
+          chand->idle_timeout =
+              gpr_time_from_millis(args->args[i].value.integer);
+        }
+      }
+    }
+  }
 }
 
 /* Destructor for channel_data */
 static void destroy_channel_elem(grpc_channel_element *elem) {
   channel_data *chand = elem->channel_data;
+  size_t i;
+  int cancel_idle_alarm;
+
+  /* stop the idle alarm, and wait for its callback if it is running */
+  gpr_mu_lock(&chand->mu);
+  chand->shutting_down = 1;
+  cancel_idle_alarm = chand->idle_alarm_pending;
+  gpr_mu_unlock(&chand->mu);
+  if (cancel_idle_alarm) {
+    grpc_alarm_cancel(&chand->idle_alarm);
+  }
+  gpr_mu_lock(&chand->mu);
+  while (chand->idle_alarm_pending) {
+    gpr_cv_wait(&chand->cv, &chand->mu, gpr_inf_future);
+  }
+  gpr_mu_unlock(&chand->mu);
 
   grpc_transport_setup_cancel(chand->transport_setup);
 
-  if (chand->active_child) {
-    grpc_child_channel_destroy(chand->active_child, 1);
-    chand->active_child = NULL;
+  for (i = 0; i < chand->child_count; i++) {
+    grpc_child_channel_destroy(chand->children[i], 1);
   }
+  gpr_free(chand->children);
 
   grpc_channel_args_destroy(chand->args);
 
   gpr_mu_destroy(&chand->mu);
+  gpr_cv_destroy(&chand->cv);
   GPR_ASSERT(chand->waiting_child_count == 0);
+  /* watches keep the channel alive */
+  GPR_ASSERT(chand->state_watchers == NULL);
   gpr_free(chand->waiting_children);
 }
 
@@ -430,7 +783,9 @@ grpc_transport_setup_result grpc_client_channel_transport_setup_complete(
   size_t num_child_filters = 2 + num_channel_filters;
   grpc_channel_filter const **child_filters;
   grpc_transport_setup_result result;
-  grpc_child_channel *old_active = NULL;
+  grpc_child_channel *new_child;
+  grpc_child_channel *evicted = NULL;
+  int initiate_transport_setup;
   call_data **waiting_children;
   size_t waiting_child_count;
   size_t i;
@@ -451,14 +806,17 @@ grpc_transport_setup_result grpc_client_channel_transport_setup_complete(
   /* BEGIN LOCKING CHANNEL */
   gpr_mu_lock(&chand->mu);
   chand->transport_setup_initiated = 0;
+  chand->transport_setup_failed = 0;
 
-  if (chand->active_child) {
-    old_active = chand->active_child;
+  /* if we somehow overshot our pool size, retire the oldest child */
+  if (chand->child_count >= chand->max_children) {
+    evicted = chand->children[0];
+    remove_child(chand, evicted);
   }
-  chand->active_child = grpc_child_channel_create(
-      elem, child_filters, num_child_filters, chand->args, mdctx);
-  result =
-      grpc_connected_channel_bind_transport(chand->active_child, transport);
+  new_child = grpc_child_channel_create(elem, child_filters, num_child_filters,
+                                        chand->args, mdctx);
+  add_child(chand, new_child);
+  result = grpc_connected_channel_bind_transport(new_child, transport);
 
   /* capture the waiting children - we'll activate them outside the lock
      to avoid re-entrancy problems */
@@ -474,12 +832,19 @@ grpc_transport_setup_result grpc_client_channel_transport_setup_complete(
 
   for (i = 0; i < waiting_child_count; i++) {
     call_ops[i] = waiting_children[i]->s.waiting_op;
-    if (!prepare_activate(waiting_children[i]->elem, chand->active_child)) {
+    if (!prepare_activate(waiting_children[i]->elem, new_child)) {
       waiting_children[i] = NULL;
       grpc_transport_op_finish_with_failure(&call_ops[i]);
     }
   }
 
+  /* keep connecting until the pool is full */
+  initiate_transport_setup = begin_transport_setup_if_needed(chand);
+
+  /* a fresh connection gets a full idle timeout before it can be closed */
+  chand->last_activity = grpc_iomgr_now();
+  maybe_start_idle_alarm(chand, chand->last_activity);
+
   /* END LOCKING CHANNEL */
   gpr_mu_unlock(&chand->mu);
 
@@ -495,8 +860,12 @@ grpc_transport_setup_result grpc_client_channel_transport_setup_complete(
   gpr_free(call_ops);
   gpr_free(child_filters);
 
-  if (old_active) {
-    grpc_child_channel_destroy(old_active, 1);
+  if (evicted) {
+    grpc_child_channel_destroy(evicted, 1);
+  }
+
+  if (initiate_transport_setup) {
+    grpc_transport_setup_initiate(chand->transport_setup);
   }
 
   return result;
@@ -510,3 +879,76 @@ void grpc_client_channel_set_transport_setup(grpc_channel_stack *channel_stack,
   GPR_ASSERT(!chand->transport_setup);
   chand->transport_setup = setup;
 }
+
+void grpc_client_channel_transport_setup_failed(
+    grpc_channel_stack *channel_stack) {
+  grpc_channel_element *elem = grpc_channel_stack_last_element(channel_stack);
+  channel_data *chand = elem->channel_data;
+  gpr_mu_lock(&chand->mu);
+  chand->transport_setup_failed = 1;
+  notify_state_watchers_locked(chand);
+  gpr_mu_unlock(&chand->mu);
+}
+
+grpc_connectivity_state grpc_client_channel_check_connectivity_state(
+    grpc_channel_stack *channel_stack, int try_to_connect) {
+  grpc_channel_element *elem = grpc_channel_stack_last_element(channel_stack);
+  channel_data *chand = elem->channel_data;
+  grpc_connectivity_state state;
+  int initiate_transport_setup = 0;
+
+  gpr_mu_lock(&chand->mu);
+  state = connectivity_state(chand);
+  if (try_to_connect && state == GRPC_CHANNEL_IDLE) {
+    initiate_transport_setup = begin_transport_setup_if_needed(chand);
+    state = connectivity_state(chand);
+  }
+  gpr_mu_unlock(&chand->mu);
+
+  if (initiate_transport_setup) {
+    grpc_transport_setup_initiate(chand->transport_setup);
+  }
+  return state;
+}
+
+void grpc_client_channel_watch_connectivity_state(
+    grpc_channel_stack *channel_stack,
+    grpc_connectivity_state last_observed_state, gpr_timespec deadline,
+    void (*cb)(void *arg, int changed), void *arg) {
+  grpc_channel_element *elem = grpc_channel_stack_last_element(channel_stack);
+  channel_data *chand = elem->channel_data;
+  state_watcher *w = gpr_malloc(sizeof(state_watcher));
+
+  w->chand = chand;
+  w->last_observed_state = last_observed_state;
+  gpr_ref_init(&w->refs, 2);
+  w->changed = 0;
+  w->cb = cb;
+  w->cb_arg = arg;
+
+  gpr_mu_lock(&chand->mu);
+  w->next = chand->state_watchers;
+  chand->state_watchers = w;
+  grpc_alarm_init(&w->alarm, deadline, on_state_watcher_alarm, w,
+                  grpc_iomgr_now());
+  /* the state may already differ from what the caller last saw */
+  notify_state_watchers_locked(chand);
+  gpr_mu_unlock(&chand->mu);
+}
+
+size_t grpc_client_channel_get_calls_per_connection(
+    grpc_channel_stack *channel_stack, gpr_uint32 *calls,
+    size_t max_connections) {
+  grpc_channel_element *elem = grpc_channel_stack_last_element(channel_stack);
+  channel_data *chand = elem->channel_data;
+  size_t count;
+  size_t i;
+
+  gpr_mu_lock(&chand->mu);
+  count = chand->child_count;
+  for (i = 0; i < count && i < max_connections; i++) {
+    calls[i] = grpc_child_channel_get_calls_started(chand->children[i]);
+  }
+  gpr_mu_unlock(&chand->mu);
+  return count;
+}
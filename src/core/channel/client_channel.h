@@ -41,7 +41,17 @@
    connected to again later.
 
    Calls on a disconnected client channel are queued until a connection is
-   established. */
+   established.
+
+   Up to GRPC_ARG_MAX_SUBCHANNELS connections are kept open at once: each new
+   call is sent on one of them as chosen by the GRPC_ARG_LB_POLICY policy, and
+   connections that report goaway or disconnection are dropped from the pool
+   and replaced on demand.
+
+   A channel can also be connected ahead of its first call (see
+   grpc_client_channel_check_connectivity_state), and with
+   GRPC_ARG_CLIENT_IDLE_TIMEOUT_MS set it closes its connections after going
+   that long without calls, returning to idle. */
 
 extern const grpc_channel_filter grpc_client_channel_filter;
 
@@ -59,4 +69,30 @@ grpc_transport_setup_result grpc_client_channel_transport_setup_complete(
     grpc_channel_filter const **channel_filters, size_t num_channel_filters,
     grpc_mdctx *mdctx);
 
+/* called by the transport setup when a connection attempt fails (it will
+   retry by itself): reported as GRPC_CHANNEL_TRANSIENT_FAILURE until a
+   connection is established */
+void grpc_client_channel_transport_setup_failed(
+    grpc_channel_stack *channel_stack);
+
+/* see grpc_channel_check_connectivity_state */
+grpc_connectivity_state grpc_client_channel_check_connectivity_state(
+    grpc_channel_stack *channel_stack, int try_to_connect);
+
+/* call cb with arg once the connectivity state differs from
+   last_observed_state (changed=1), or once deadline passes (changed=0): see
+   grpc_channel_watch_connectivity_state. The channel stack must outlive the
+   watch. */
+void grpc_client_channel_watch_connectivity_state(
+    grpc_channel_stack *channel_stack,
+    grpc_connectivity_state last_observed_state, gpr_timespec deadline,
+    void (*cb)(void *arg, int changed), void *arg);
+
+/* for tests: returns how many connections are in the pool, and fills calls[i]
+   (for i < max_connections) with the number of calls started on the i-th
+   oldest connection */
+size_t grpc_client_channel_get_calls_per_connection(
+    grpc_channel_stack *channel_stack, gpr_uint32 *calls,
+    size_t max_connections);
+
 #endif  /* GRPC_INTERNAL_CORE_CHANNEL_CLIENT_CHANNEL_H */
@@ -39,6 +39,20 @@
 #include <grpc/support/log.h>
 #include <grpc/support/time.h>
 
+#include <stdlib.h>
+#include <string.h>
+
+#define DEFAULT_CONNECT_STAGGER_MS 250
+#define DEFAULT_CONNECT_ATTEMPT_TIMEOUT_MS 20000
+#define DEFAULT_INITIAL_RECONNECT_BACKOFF_MS 1000
+#define DEFAULT_MAX_RECONNECT_BACKOFF_MS 120000
+#define DEFAULT_RECONNECT_BACKOFF_MULTIPLIER 1.6
+#define DEFAULT_MIN_CONNECT_TIMEOUT_MS 20000
+/* each backoff is randomly stretched or shrunk by up to this fraction, so
+   that clients which lost their connections together don't all come back at
+   the same moment */
+#define RECONNECT_JITTER 0.2
+
 struct grpc_client_setup {
   grpc_transport_setup base; /* must be first */
   void (*initiate)(void *user_data, grpc_client_setup_request *request);
@@ -46,8 +60,20 @@ struct grpc_client_setup {
   void *user_data;
   grpc_channel_args *args;
   grpc_mdctx *mdctx;
+  /* the channel we're connecting: notified of failed attempts */
+  grpc_channel_stack *channel_stack;
   grpc_alarm backoff_alarm;
-  gpr_timespec current_backoff_interval;
+  /* reconnect backoff, before jitter is applied */
+  double initial_backoff_ms;
+  double max_backoff_ms;
+  double backoff_multiplier;
+  double current_backoff_ms;
+  /* state of the random generator used for jitter */
+  gpr_uint32 jitter_seed;
+  /* a connection attempt is given at least this long to complete */
+  gpr_timespec min_connect_timeout;
+  gpr_timespec connect_stagger;
+  gpr_timespec connect_attempt_timeout;
   int in_alarm;
   int in_cb;
   int cancelled;
@@ -68,6 +94,23 @@ gpr_timespec grpc_client_setup_request_deadline(grpc_client_setup_request *r) {
   return r->deadline;
 }
 
+/* a uniformly distributed value in [-1, 1] */
+static double next_jitter(grpc_client_setup *s) {
+  /* linear congruential generator: constants from Numerical Recipes */
+  s->jitter_seed = s->jitter_seed * 1664525u + 1013904223u;
+  return (double)s->jitter_seed / 2147483647.5 - 1.0;
+}
+
+/* deadline for a connection attempt starting now: the longer of the minimum
+   connect timeout and the current backoff. Call with s->mu held. */
+static gpr_timespec attempt_deadline(grpc_client_setup *s, gpr_timespec now) {
+  gpr_timespec timeout = gpr_time_from_millis((long)s->current_backoff_ms);
+  if (gpr_time_cmp(timeout, s->min_connect_timeout) < 0) {
+    timeout = s->min_connect_timeout;
+  }
+  return gpr_time_add(now, timeout);
+}
+
 static void destroy_setup(grpc_client_setup *s) {
   gpr_mu_destroy(&s->mu);
   gpr_cv_destroy(&s->cv);
@@ -83,11 +126,10 @@ static void setup_initiate(grpc_transport_setup *sp) {
   int in_alarm = 0;
 
   r->setup = s;
-  /* TODO(klempner): Actually set a deadline */
-  r->deadline = gpr_inf_future;
 
   gpr_mu_lock(&s->mu);
   GPR_ASSERT(s->refs > 0);
+  r->deadline = attempt_deadline(s, gpr_now());
   /* there might be more than one request outstanding if the caller calls
      initiate in some kind of rapid-fire way: we try to connect each time,
      and keep track of the latest request (which is the only one that gets
@@ -155,6 +197,70 @@ void grpc_client_setup_cb_end(grpc_client_setup_request *r) {
   gpr_mu_unlock(&r->setup->mu);
 }
 
+/* read a non-negative integer from args */
+static int get_non_negative_int_arg(const grpc_channel_args *args,
+                                    const char *key, int default_value) {
+  size_t i;
+  int value = default_value;
+  if (args) {
+    for (i = 0; i < args->num_args; i++) {
+      if (0 == strcmp(args->args[i].key, key)) {
+        if (args->args[i].type != GRPC_ARG_INTEGER) {
+          gpr_log(GPR_ERROR, "%s ignored: it must be an integer", key);
+        } else if (args->args[i].value.integer < 0) {
+          gpr_log(GPR_ERROR, "%s ignored: it must be >= 0", key);
+        } else {
+          value = args->args[i].value.integer;
+        }
+      }
+    }
+  }
+  return value;
+}
+
+/* read a non-negative duration in milliseconds from args */
+static gpr_timespec get_millis_arg(const grpc_channel_args *args,
+                                   const char *key, int default_value) {
+  return gpr_time_from_millis(
+      get_non_negative_int_arg(args, key, default_value));
+}
+
+/* read a backoff multiplier (>= 1) from args: either an integer, or a string
+   holding a decimal number such as "1.6" */
+static double get_multiplier_arg(const grpc_channel_args *args,
+                                 const char *key, double default_value) {
+  size_t i;
+  double value = default_value;
+  double parsed;
+  char *end;
+  if (args) {
+    for (i = 0; i < args->num_args; i++) {
+      if (0 == strcmp(args->args[i].key, key)) {
+        if (args->args[i].type == GRPC_ARG_INTEGER) {
+          parsed = args->args[i].value.integer;
+        } else if (args->args[i].type == GRPC_ARG_STRING) {
+          parsed = strtod(args->args[i].value.string, &end);
+          if (end == args->args[i].value.string || *end != 0) {
+            gpr_log(GPR_ERROR, "%s ignored: '%s' is not a number", key,
+                    args->args[i].value.string);
+            continue;
+          }
+        } else {
+          gpr_log(GPR_ERROR, "%s ignored: it must be an integer or a string",
+                  key);
+          continue;
+        }
+        if (parsed < 1) {
+          gpr_log(GPR_ERROR, "%s ignored: it must be >= 1", key);
+        } else {
+          value = parsed;
+        }
+      }
+    }
+  }
+  return value;
+}
+
 /* vtable for transport setup */
 static const grpc_transport_setup_vtable setup_vtable = {setup_initiate,
                                                          setup_cancel};
@@ -165,18 +271,41 @@ void grpc_client_setup_create_and_attach(
     void (*initiate)(void *user_data, grpc_client_setup_request *request),
     void (*done)(void *user_data), void *user_data) {
   grpc_client_setup *s = gpr_malloc(sizeof(grpc_client_setup));
+  gpr_timespec now = gpr_now();
 
   s->base.vtable = &setup_vtable;
   gpr_mu_init(&s->mu);
   gpr_cv_init(&s->cv);
   s->refs = 1;
   s->mdctx = mdctx;
+  s->channel_stack = newly_minted_channel;
   s->initiate = initiate;
   s->done = done;
   s->user_data = user_data;
   s->active_request = NULL;
   s->args = grpc_channel_args_copy(args);
-  s->current_backoff_interval = gpr_time_from_micros(1000000);
+  s->initial_backoff_ms =
+      get_non_negative_int_arg(args, GRPC_ARG_INITIAL_RECONNECT_BACKOFF_MS,
+                               DEFAULT_INITIAL_RECONNECT_BACKOFF_MS);
+  s->max_backoff_ms =
+      get_non_negative_int_arg(args, GRPC_ARG_MAX_RECONNECT_BACKOFF_MS,
+                               DEFAULT_MAX_RECONNECT_BACKOFF_MS);
+  if (s->max_backoff_ms < s->initial_backoff_ms) {
+    s->max_backoff_ms = s->initial_backoff_ms;
+  }
+  s->backoff_multiplier =
+      get_multiplier_arg(args, GRPC_ARG_RECONNECT_BACKOFF_MULTIPLIER,
+                         DEFAULT_RECONNECT_BACKOFF_MULTIPLIER);
+  s->current_backoff_ms = s->initial_backoff_ms;
+  /* seed differently for each channel, even if several are created at once */
+  s->jitter_seed = (gpr_uint32)now.tv_nsec ^ (gpr_uint32)(gpr_uintptr)s;
+  s->min_connect_timeout = get_millis_arg(
+      args, GRPC_ARG_MIN_CONNECT_TIMEOUT_MS, DEFAULT_MIN_CONNECT_TIMEOUT_MS);
+  s->connect_stagger = get_millis_arg(args, GRPC_ARG_CONNECT_STAGGER_MS,
+                                      DEFAULT_CONNECT_STAGGER_MS);
+  s->connect_attempt_timeout =
+      get_millis_arg(args, GRPC_ARG_CONNECT_ATTEMPT_TIMEOUT_MS,
+                     DEFAULT_CONNECT_ATTEMPT_TIMEOUT_MS);
   s->in_alarm = 0;
   s->in_cb = 0;
   s->cancelled = 0;
@@ -199,10 +328,9 @@ static void backoff_alarm_done(void *arg /* grpc_client_setup */, int success) {
   grpc_client_setup *s = arg;
   grpc_client_setup_request *r = gpr_malloc(sizeof(grpc_client_setup_request));
   r->setup = s;
-  /* TODO(klempner): Set this to something useful */
-  r->deadline = gpr_inf_future;
   /* Handle status cancelled? */
   gpr_mu_lock(&s->mu);
+  r->deadline = attempt_deadline(s, gpr_now());
   s->active_request = r;
   s->in_alarm = 0;
   if (!success) {
@@ -228,6 +356,10 @@ void grpc_client_setup_request_finish(grpc_client_setup_request *r,
   gpr_mu_lock(&s->mu);
   if (s->active_request == r) {
     s->active_request = NULL;
+    if (was_successful) {
+      /* connected: the next disconnection starts backing off afresh */
+      s->current_backoff_ms = s->initial_backoff_ms;
+    }
   } else {
     retry = 0;
   }
@@ -241,18 +373,20 @@ void grpc_client_setup_request_finish(grpc_client_setup_request *r,
   gpr_free(r);
 
   if (retry) {
-    /* TODO(klempner): Replace these values with further consideration. 2x is
-       probably too aggressive of a backoff. */
-    gpr_timespec max_backoff = gpr_time_from_minutes(2);
     gpr_timespec now = gpr_now();
-    gpr_timespec deadline = gpr_time_add(s->current_backoff_interval, now);
+    double backoff_ms =
+        s->current_backoff_ms * (1 + RECONNECT_JITTER * next_jitter(s));
+    gpr_timespec deadline =
+        gpr_time_add(now, gpr_time_from_millis((long)backoff_ms));
+    /* holding s->mu keeps the channel alive: setup_cancel takes it before
+       the channel is destroyed */
+    grpc_client_channel_transport_setup_failed(s->channel_stack);
     GPR_ASSERT(!s->in_alarm);
     s->in_alarm = 1;
     grpc_alarm_init(&s->backoff_alarm, deadline, backoff_alarm_done, s, now);
-    s->current_backoff_interval =
-        gpr_time_add(s->current_backoff_interval, s->current_backoff_interval);
-    if (gpr_time_cmp(s->current_backoff_interval, max_backoff) > 0) {
-      s->current_backoff_interval = max_backoff;
+    s->current_backoff_ms *= s->backoff_multiplier;
+    if (s->current_backoff_ms > s->max_backoff_ms) {
+      s->current_backoff_ms = s->max_backoff_ms;
     }
   }
 
@@ -267,3 +401,13 @@ const grpc_channel_args *grpc_client_setup_get_channel_args(
 grpc_mdctx *grpc_client_setup_get_mdctx(grpc_client_setup_request *r) {
   return r->setup->mdctx;
 }
+
+gpr_timespec grpc_client_setup_get_connect_stagger(
+    grpc_client_setup_request *r) {
+  return r->setup->connect_stagger;
+}
+
+gpr_timespec grpc_client_setup_get_connect_attempt_timeout(
+    grpc_client_setup_request *r) {
+  return r->setup->connect_attempt_timeout;
+}
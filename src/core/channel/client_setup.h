@@ -70,4 +70,13 @@ gpr_timespec grpc_client_setup_request_deadline(grpc_client_setup_request *r);
 
 grpc_mdctx *grpc_client_setup_get_mdctx(grpc_client_setup_request *r);
 
+/* How long to wait on a connection attempt to one address before also trying
+   the next one (GRPC_ARG_CONNECT_STAGGER_MS) */
+gpr_timespec grpc_client_setup_get_connect_stagger(
+    grpc_client_setup_request *r);
+/* How long a connection attempt to one address may take
+   (GRPC_ARG_CONNECT_ATTEMPT_TIMEOUT_MS) */
+gpr_timespec grpc_client_setup_get_connect_attempt_timeout(
+    grpc_client_setup_request *r);
+
 #endif  /* GRPC_INTERNAL_CORE_CHANNEL_CLIENT_SETUP_H */
@@ -0,0 +1,531 @@
+/*
+ *
+ * Copyright 2015, Google Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer
+ * in the documentation and/or other materials provided with the
+ * distribution.
+ *     * Neither the name of Google Inc. nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include "src/core/channel/compress_filter.h"
+
+#include <string.h>
+
+#include <grpc/support/alloc.h>
+#include <grpc/support/log.h>
+#include <grpc/support/slice_buffer.h>
+
+#include "src/core/compression/message_compress.h"
+#include "src/core/support/string.h"
+
+#define DEFAULT_MIN_MESSAGE_SIZE 256
+/* same default as the channel's */
+#define DEFAULT_MAX_MESSAGE_LENGTH (100 * 1024 * 1024)
+
+typedef struct call_data {
+  int is_server;
+
+  /* sending */
+  int sent_initial_metadata;
+  /* algorithm named by our grpc-encoding: messages are only compressed with
+     it once the peer's grpc-accept-encoding lists it (peer_accepts) */
+  grpc_compression_algorithm send_algorithm;
+  int peer_accepts;
+  grpc_msg_codec *compressor;
+  gpr_slice_buffer send_input;
+  gpr_slice_buffer send_output;
+  grpc_linked_mdelem encoding;
+  grpc_linked_mdelem accept_encoding;
+
+  /* receiving */
+  int got_initial_metadata;
+  grpc_compression_algorithm recv_algorithm;
+  grpc_msg_codec *decompressor;
+  /* a compressed message whose bytes are still arriving */
+  int receiving_compressed;
+  gpr_uint32 incoming_flags;
+  gpr_uint32 incoming_remaining;
+  gpr_slice_buffer incoming;
+  gpr_slice_buffer decompressed;
+
+  grpc_stream_op_buffer *recv_ops;
+  void (*on_done_recv)(void *user_data, int success);
+  void *recv_user_data;
+} call_data;
+
+typedef struct channel_data {
+  /* algorithm this side compresses with */
+  grpc_compression_algorithm algorithm;
+  int level;
+  gpr_uint32 min_message_size;
+  /* incoming messages decompressing to more than this fail the call */
+  gpr_uint32 max_message_length;
+  grpc_mdctx *mdctx;
+  grpc_mdstr *encoding_key;
+  grpc_mdstr *accept_encoding_key;
+  /* grpc-encoding elements indexed by algorithm (none for
+     GRPC_COMPRESS_NONE) */
+  grpc_mdelem *encoding[GRPC_COMPRESS_ALGORITHMS_COUNT];
+  grpc_mdelem *accept_encoding;
+} channel_data;
+
+/* Returns 1 if the comma separated list of algorithm names in value contains
+   algorithm. */
+static int accepts_algorithm(grpc_mdstr *value,
+                             grpc_compression_algorithm algorithm) {
+  const char *name = grpc_compression_algorithm_name(algorithm);
+  size_t name_length = strlen(name);
+  const char *p = (const char *)GPR_SLICE_START_PTR(value->slice);
+  const char *end = p + GPR_SLICE_LENGTH(value->slice);
+  while (p < end) {
+    const char *comma = memchr(p, ',', end - p);
+    const char *item_end = comma != NULL ? comma : end;
+    const char *item_begin = p;
+    while (item_begin < item_end && *item_begin == ' ') item_begin++;
+    while (item_end > item_begin && item_end[-1] == ' ') item_end--;
+    if ((size_t)(item_end - item_begin) == name_length &&
+        memcmp(item_begin, name, name_length) == 0) {
+      return 1;
+    }
+    if (comma == NULL) break;
+    p = comma + 1;
+  }
+  return 0;
+}
+
+static grpc_mdelem *recv_metadata_filter(void *user_data, grpc_mdelem *md) {
+  grpc_call_element *elem = user_data;
+  call_data *calld = elem->call_data;
+  channel_data *channeld = elem->channel_data;
+  if (md->key == channeld->encoding_key) {
+    if (!grpc_compression_algorithm_parse(
+            (const char *)GPR_SLICE_START_PTR(md->value->slice),
+            GPR_SLICE_LENGTH(md->value->slice), &calld->recv_algorithm)) {
+      gpr_log(GPR_ERROR, "Unknown grpc-encoding '%s'",
+              grpc_mdstr_as_c_string(md->value));
+      calld->recv_algorithm = GRPC_COMPRESS_NONE;
+    }
+    return NULL;
+  } else if (md->key == channeld->accept_encoding_key) {
+    if (channeld->algorithm != GRPC_COMPRESS_NONE &&
+        accepts_algorithm(md->value, channeld->algorithm)) {
+      calld->peer_accepts = 1;
+    }
+    return NULL;
+  }
+  return md;
+}
+
+static void cancel_call(grpc_call_element *elem, grpc_status_code status,
+                        const char *message) {
+  channel_data *channeld = elem->channel_data;
+  grpc_transport_op op;
+  memset(&op, 0, sizeof(op));
+  grpc_transport_op_add_cancellation(
+      &op, status, grpc_mdstr_from_string(channeld->mdctx, message));
+  grpc_call_next_op(elem, &op);
+}
+
+static void finish_incoming_message(grpc_call_element *elem,
+                                    grpc_stream_op_buffer *out) {
+  call_data *calld = elem->call_data;
+  channel_data *channeld = elem->channel_data;
+  size_t i;
+  grpc_msg_decompress_result result = GRPC_MSG_DECOMPRESS_ERROR;
+
+  calld->receiving_compressed = 0;
+  if (calld->recv_algorithm != GRPC_COMPRESS_NONE) {
+    if (calld->decompressor == NULL) {
+      calld->decompressor = grpc_msg_codec_create(calld->recv_algorithm);
+    }
+    result = grpc_msg_codec_decompress_with_limit(
+        calld->decompressor, &calld->incoming, &calld->decompressed,
+        channeld->max_message_length);
+  }
+  if (result == GRPC_MSG_DECOMPRESS_TOO_LARGE) {
+    char *message;
+    gpr_asprintf(&message,
+                 "Decompressed message larger than the maximum of %d bytes",
+                 (int)channeld->max_message_length);
+    gpr_log(GPR_ERROR, "%s", message);
+    cancel_call(elem, GRPC_STATUS_RESOURCE_EXHAUSTED, message);
+    gpr_free(message);
+  } else if (result == GRPC_MSG_DECOMPRESS_OK) {
+    grpc_sopb_add_begin_message(
+        out, calld->decompressed.length,
+        calld->incoming_flags & ~GRPC_WRITE_INTERNAL_COMPRESS);
+    for (i = 0; i < calld->decompressed.count; i++) {
+      grpc_sopb_add_slice(out, gpr_slice_ref(calld->decompressed.slices[i]));
+    }
+  } else {
+    gpr_log(GPR_ERROR, "Failed to decompress a message (grpc-encoding '%s')",
+            grpc_compression_algorithm_name(calld->recv_algorithm));
+    grpc_call_element_send_cancel(elem);
+  }
+  gpr_slice_buffer_reset_and_unref(&calld->incoming);
+  gpr_slice_buffer_reset_and_unref(&calld->decompressed);
+}
+
+static void process_recv_ops(grpc_call_element *elem) {
+  call_data *calld = elem->call_data;
+  grpc_stream_op_buffer *recv_ops = calld->recv_ops;
+  grpc_stream_op_buffer in;
+  int needs_rewrite = calld->receiving_compressed;
+  size_t i;
+
+  for (i = 0; i < recv_ops->nops; i++) {
+    grpc_stream_op *sop = &recv_ops->ops[i];
+    if (sop->type == GRPC_OP_METADATA && !calld->got_initial_metadata) {
+      calld->got_initial_metadata = 1;
+      grpc_metadata_batch_filter(&sop->data.metadata, recv_metadata_filter,
+                                 elem);
+    } else if (sop->type == GRPC_OP_BEGIN_MESSAGE &&
+               (sop->data.begin_message.flags &
+                GRPC_WRITE_INTERNAL_COMPRESS)) {
+      needs_rewrite = 1;
+    }
+  }
+  if (!needs_rewrite) return;
+
+  /* move the ops aside, and put them back with compressed messages replaced
+     by their decompressed contents */
+  grpc_sopb_init(&in);
+  grpc_sopb_swap(&in, recv_ops);
+  for (i = 0; i < in.nops; i++) {
+    grpc_stream_op *sop = &in.ops[i];
+    if (calld->receiving_compressed && sop->type != GRPC_NO_OP) {
+      gpr_slice slice;
+      if (sop->type != GRPC_OP_SLICE ||
+          GPR_SLICE_LENGTH(sop->data.slice) > calld->incoming_remaining) {
+        gpr_log(GPR_ERROR, "Malformed compressed message");
+        calld->receiving_compressed = 0;
+        gpr_slice_buffer_reset_and_unref(&calld->incoming);
+        grpc_call_element_send_cancel(elem);
+        grpc_sopb_append(recv_ops, sop, 1);
+        continue;
+      }
+      slice = sop->data.slice;
+      calld->incoming_remaining -= GPR_SLICE_LENGTH(slice);
+      gpr_slice_buffer_add(&calld->incoming, slice);
+      if (calld->incoming_remaining == 0) {
+        finish_incoming_message(elem, recv_ops);
+      }
+    } else if (sop->type == GRPC_OP_BEGIN_MESSAGE &&
+               (sop->data.begin_message.flags &
+                GRPC_WRITE_INTERNAL_COMPRESS)) {
+      calld->receiving_compressed = 1;
+      calld->incoming_flags = sop->data.begin_message.flags;
+      calld->incoming_remaining = sop->data.begin_message.length;
+      if (calld->incoming_remaining == 0) {
+        finish_incoming_message(elem, recv_ops);
+      }
+    } else {
+      grpc_sopb_append(recv_ops, sop, 1);
+    }
+  }
+  /* everything was moved to recv_ops or to calld->incoming */
+  in.nops = 0;
+  grpc_sopb_destroy(&in);
+}
+
+static void compress_on_recv(void *user_data, int success) {
+  grpc_call_element *elem = user_data;
+  call_data *calld = elem->call_data;
+  if (success) process_recv_ops(elem);
+  calld->on_done_recv(calld->recv_user_data, success);
+}
+
+/* Returns 1 if the message starting at ops[begin] should be compressed, and
+   sets *end to the index of its last op. Messages which don't end within
+   this batch of ops go out uncompressed. */
+static int should_compress(channel_data *channeld, grpc_stream_op *ops,
+                           size_t nops, size_t begin, size_t *end) {
+  grpc_begin_message *msg = &ops[begin].data.begin_message;
+  gpr_uint32 remaining = msg->length;
+  size_t i;
+  if (msg->length == 0 || msg->length < channeld->min_message_size ||
+      (msg->flags & GRPC_WRITE_NO_COMPRESS)) {
+    return 0;
+  }
+  for (i = begin + 1; i < nops; i++) {
+    if (ops[i].type == GRPC_NO_OP) continue;
+    if (ops[i].type != GRPC_OP_SLICE ||
+        GPR_SLICE_LENGTH(ops[i].data.slice) > remaining) {
+      return 0;
+    }
+    remaining -= GPR_SLICE_LENGTH(ops[i].data.slice);
+    if (remaining == 0) {
+      *end = i;
+      return 1;
+    }
+  }
+  return 0;
+}
+
+static void compress_message(grpc_call_element *elem, grpc_stream_op *ops,
+                             size_t begin, size_t end,
+                             grpc_stream_op_buffer *out) {
+  call_data *calld = elem->call_data;
+  channel_data *channeld = elem->channel_data;
+  gpr_uint32 flags = ops[begin].data.begin_message.flags;
+  size_t i;
+
+  for (i = begin + 1; i <= end; i++) {
+    if (ops[i].type == GRPC_OP_SLICE) {
+      gpr_slice_buffer_add(&calld->send_input, ops[i].data.slice);
+    }
+  }
+  if (calld->compressor == NULL) {
+    calld->compressor = grpc_msg_codec_create_with_level(
+        calld->send_algorithm, channeld->level);
+  }
+  if (grpc_msg_codec_compress(calld->compressor, &calld->send_input,
+                              &calld->send_output)) {
+    flags |= GRPC_WRITE_INTERNAL_COMPRESS;
+  }
+  grpc_sopb_add_begin_message(out, calld->send_output.length, flags);
+  for (i = 0; i < calld->send_output.count; i++) {
+    grpc_sopb_add_slice(out, gpr_slice_ref(calld->send_output.slices[i]));
+  }
+  gpr_slice_buffer_reset_and_unref(&calld->send_input);
+  gpr_slice_buffer_reset_and_unref(&calld->send_output);
+}
+
+static void process_send_ops(grpc_call_element *elem,
+                             grpc_stream_op_buffer *send_ops) {
+  call_data *calld = elem->call_data;
+  channel_data *channeld = elem->channel_data;
+  grpc_stream_op_buffer in;
+  size_t i;
+  size_t end;
+  int any_compressed = 0;
+
+  for (i = 0; i < send_ops->nops; i++) {
+    grpc_stream_op *sop = &send_ops->ops[i];
+    if (sop->type == GRPC_OP_METADATA && !calld->sent_initial_metadata) {
+      calld->sent_initial_metadata = 1;
+      /* servers only compress for clients which accept it, and reply in
+         the same encoding; clients announce theirs up front but only use it
+         once the server accepts it too */
+      if (calld->is_server && !calld->peer_accepts) {
+        calld->send_algorithm = GRPC_COMPRESS_NONE;
+      }
+      if (calld->send_algorithm != GRPC_COMPRESS_NONE) {
+        grpc_metadata_batch_add_tail(
+            &sop->data.metadata, &calld->encoding,
+            grpc_mdelem_ref(channeld->encoding[calld->send_algorithm]));
+      }
+      if (channeld->algorithm != GRPC_COMPRESS_NONE) {
+        grpc_metadata_batch_add_tail(
+            &sop->data.metadata, &calld->accept_encoding,
+            grpc_mdelem_ref(channeld->accept_encoding));
+      }
+    } else if (sop->type == GRPC_OP_BEGIN_MESSAGE && calld->peer_accepts &&
+               calld->send_algorithm != GRPC_COMPRESS_NONE &&
+               should_compress(channeld, send_ops->ops, send_ops->nops, i,
+                               &end)) {
+      any_compressed = 1;
+      break;
+    }
+  }
+  if (!any_compressed) return;
+
+  grpc_sopb_init(&in);
+  grpc_sopb_swap(&in, send_ops);
+  for (i = 0; i < in.nops; i++) {
+    if (in.ops[i].type == GRPC_OP_BEGIN_MESSAGE && calld->peer_accepts &&
+        should_compress(channeld, in.ops, in.nops, i, &end)) {
+      compress_message(elem, in.ops, i, end, send_ops);
+      i = end;
+    } else {
+      grpc_sopb_append(send_ops, &in.ops[i], 1);
+    }
+  }
+  /* everything was moved to send_ops or released by compress_message */
+  in.nops = 0;
+  grpc_sopb_destroy(&in);
+}
+
+static void compress_mutate_op(grpc_call_element *elem,
+                               grpc_transport_op *op) {
+  call_data *calld = elem->call_data;
+
+  if (op->send_ops && (!calld->sent_initial_metadata ||
+                       calld->send_algorithm != GRPC_COMPRESS_NONE)) {
+    process_send_ops(elem, op->send_ops);
+  }
+
+  if (op->recv_ops) {
+    /* substitute our callback for the higher callback */
+    calld->recv_ops = op->recv_ops;
+    calld->on_done_recv = op->on_done_recv;
+    calld->recv_user_data = op->recv_user_data;
+    op->on_done_recv = compress_on_recv;
+    op->recv_user_data = elem;
+  }
+}
+
+static void compress_start_transport_op(grpc_call_element *elem,
+                                        grpc_transport_op *op) {
+  GRPC_CALL_LOG_OP(GPR_INFO, elem, op);
+  compress_mutate_op(elem, op);
+  grpc_call_next_op(elem, op);
+}
+
+static void channel_op(grpc_channel_element *elem,
+                       grpc_channel_element *from_elem, grpc_channel_op *op) {
+  grpc_channel_next_op(elem, op);
+}
+
+/* Constructor for call_data */
+static void init_call_elem(grpc_call_element *elem,
+                           const void *server_transport_data,
+                           grpc_transport_op *initial_op) {
+  call_data *calld = elem->call_data;
+  channel_data *channeld = elem->channel_data;
+
+  calld->is_server = server_transport_data != NULL;
+  calld->sent_initial_metadata = 0;
+  calld->send_algorithm = channeld->algorithm;
+  calld->peer_accepts = 0;
+  calld->compressor = NULL;
+  gpr_slice_buffer_init(&calld->send_input);
+  gpr_slice_buffer_init(&calld->send_output);
+  calld->got_initial_metadata = 0;
+  calld->recv_algorithm = GRPC_COMPRESS_NONE;
+  calld->decompressor = NULL;
+  calld->receiving_compressed = 0;
+  gpr_slice_buffer_init(&calld->incoming);
+  gpr_slice_buffer_init(&calld->decompressed);
+
+  if (initial_op) compress_mutate_op(elem, initial_op);
+}
+
+/* Destructor for call_data */
+static void destroy_call_elem(grpc_call_element *elem) {
+  call_data *calld = elem->call_data;
+  if (calld->compressor != NULL) grpc_msg_codec_destroy(calld->compressor);
+  if (calld->decompressor != NULL) {
+    grpc_msg_codec_destroy(calld->decompressor);
+  }
+  gpr_slice_buffer_destroy(&calld->send_input);
+  gpr_slice_buffer_destroy(&calld->send_output);
+  gpr_slice_buffer_destroy(&calld->incoming);
+  gpr_slice_buffer_destroy(&calld->decompressed);
+}
+
+/* Constructor for channel_data */
+static void init_channel_elem(grpc_channel_element *elem,
+                              const grpc_channel_args *args, grpc_mdctx *mdctx,
+                              int is_first, int is_last) {
+  channel_data *channeld = elem->channel_data;
+  gpr_strvec accepted;
+  char *accepted_string;
+  size_t i;
+
+  GPR_ASSERT(!is_first);
+  GPR_ASSERT(!is_last);
+
+  channeld->algorithm = GRPC_COMPRESS_NONE;
+  channeld->level = GRPC_MSG_COMPRESS_LEVEL_DEFAULT;
+  channeld->min_message_size = DEFAULT_MIN_MESSAGE_SIZE;
+  channeld->max_message_length = DEFAULT_MAX_MESSAGE_LENGTH;
+  channeld->mdctx = mdctx;
+  if (args != NULL) {
+    for (i = 0; i < args->num_args; i++) {
+      grpc_arg *arg = &args->args[i];
+      if (0 == strcmp(arg->key, GRPC_ARG_COMPRESSION_ALGORITHM)) {
+        if (arg->type != GRPC_ARG_STRING ||
+            !grpc_compression_algorithm_parse(arg->value.string,
+                                              strlen(arg->value.string),
+                                              &channeld->algorithm)) {
+          gpr_log(GPR_ERROR, "%s ignored: it must be an algorithm name",
+                  GRPC_ARG_COMPRESSION_ALGORITHM);
+          channeld->algorithm = GRPC_COMPRESS_NONE;
+        }
+      } else if (0 == strcmp(arg->key, GRPC_ARG_COMPRESSION_MIN_MESSAGE_SIZE)) {
+        if (arg->type != GRPC_ARG_INTEGER || arg->value.integer < 0) {
+          gpr_log(GPR_ERROR, "%s ignored: it must be a non-negative integer",
+                  GRPC_ARG_COMPRESSION_MIN_MESSAGE_SIZE);
+        } else {
+          channeld->min_message_size = (gpr_uint32)arg->value.integer;
+        }
+      } else if (0 == strcmp(arg->key, GRPC_ARG_MAX_MESSAGE_LENGTH)) {
+        /* the channel logs invalid values */
+        if (arg->type == GRPC_ARG_INTEGER && arg->value.integer >= 0) {
+          channeld->max_message_length = (gpr_uint32)arg->value.integer;
+        }
+      } else if (0 == strcmp(arg->key, GRPC_ARG_COMPRESSION_LEVEL)) {
+        if (arg->type != GRPC_ARG_INTEGER ||
+            arg->value.integer < GRPC_MSG_COMPRESS_LEVEL_FASTEST ||
+            arg->value.integer > GRPC_MSG_COMPRESS_LEVEL_BEST) {
+          gpr_log(GPR_ERROR, "%s ignored: it must be an integer from %d to %d",
+                  GRPC_ARG_COMPRESSION_LEVEL, GRPC_MSG_COMPRESS_LEVEL_FASTEST,
+                  GRPC_MSG_COMPRESS_LEVEL_BEST);
+        } else {
+          channeld->level = arg->value.integer;
+        }
+      }
+    }
+  }
+
+  channeld->encoding_key = grpc_mdstr_from_string(mdctx, "grpc-encoding");
+  channeld->accept_encoding_key =
+      grpc_mdstr_from_string(mdctx, "grpc-accept-encoding");
+  channeld->encoding[GRPC_COMPRESS_NONE] = NULL;
+  gpr_strvec_init(&accepted);
+  for (i = 1; i < GRPC_COMPRESS_ALGORITHMS_COUNT; i++) {
+    const char *name =
+        grpc_compression_algorithm_name((grpc_compression_algorithm)i);
+    channeld->encoding[i] =
+        grpc_mdelem_from_strings(mdctx, "grpc-encoding", name);
+    if (i > 1) gpr_strvec_add(&accepted, gpr_strdup(","));
+    gpr_strvec_add(&accepted, gpr_strdup(name));
+  }
+  accepted_string = gpr_strvec_flatten(&accepted, NULL);
+  channeld->accept_encoding =
+      grpc_mdelem_from_strings(mdctx, "grpc-accept-encoding", accepted_string);
+  gpr_free(accepted_string);
+  gpr_strvec_destroy(&accepted);
+}
+
+/* Destructor for channel data */
+static void destroy_channel_elem(grpc_channel_element *elem) {
+  channel_data *channeld = elem->channel_data;
+  size_t i;
+  grpc_mdstr_unref(channeld->encoding_key);
+  grpc_mdstr_unref(channeld->accept_encoding_key);
+  for (i = 1; i < GRPC_COMPRESS_ALGORITHMS_COUNT; i++) {
+    grpc_mdelem_unref(channeld->encoding[i]);
+  }
+  grpc_mdelem_unref(channeld->accept_encoding);
+}
+
+const grpc_channel_filter grpc_compress_filter = {
+    compress_start_transport_op, channel_op, sizeof(call_data),
+    init_call_elem, destroy_call_elem, sizeof(channel_data),
+    init_channel_elem, destroy_channel_elem, "compress"};
@@ -33,6 +33,8 @@
 
 #include "src/core/compression/algorithm.h"
 
+#include <string.h>
+
 const char *grpc_compression_algorithm_name(
     grpc_compression_algorithm algorithm) {
   switch (algorithm) {
@@ -42,8 +44,29 @@ const char *grpc_compression_algorithm_name(
       return "deflate";
     case GRPC_COMPRESS_GZIP:
       return "gzip";
+    case GRPC_COMPRESS_LZ:
+      return "lz";
     case GRPC_COMPRESS_ALGORITHMS_COUNT:
       return "error";
   }
   return "error";
 }
+
+int grpc_compression_algorithm_parse(const char *name, size_t name_length,
+                                     grpc_compression_algorithm *algorithm) {
+  int i;
+  if (name_length == 8 && memcmp(name, "identity", 8) == 0) {
+    *algorithm = GRPC_COMPRESS_NONE;
+    return 1;
+  }
+  for (i = 0; i < GRPC_COMPRESS_ALGORITHMS_COUNT; i++) {
+    const char *candidate =
+        grpc_compression_algorithm_name((grpc_compression_algorithm)i);
+    if (strlen(candidate) == name_length &&
+        memcmp(candidate, name, name_length) == 0) {
+      *algorithm = (grpc_compression_algorithm)i;
+      return 1;
+    }
+  }
+  return 0;
+}
@@ -34,16 +34,26 @@
 #ifndef GRPC_INTERNAL_CORE_COMPRESSION_ALGORITHM_H
 #define GRPC_INTERNAL_CORE_COMPRESSION_ALGORITHM_H
 
+#include <stddef.h>
+
 /* The various compression algorithms supported by GRPC */
 typedef enum {
   GRPC_COMPRESS_NONE = 0,
   GRPC_COMPRESS_DEFLATE,
   GRPC_COMPRESS_GZIP,
-  /* TODO(ctiller): snappy */
+  /* Fast LZ77 codec: an LZ4 block preceded by the 4 byte little endian
+     uncompressed length. Much cheaper than zlib for a lower ratio. */
+  GRPC_COMPRESS_LZ,
   GRPC_COMPRESS_ALGORITHMS_COUNT
 } grpc_compression_algorithm;
 
 const char *grpc_compression_algorithm_name(
     grpc_compression_algorithm algorithm);
 
+/* Parses an algorithm name as returned by grpc_compression_algorithm_name
+   ("identity" is also accepted for GRPC_COMPRESS_NONE). Returns 1 and sets
+   *algorithm on success, returns 0 if the name is unknown. */
+int grpc_compression_algorithm_parse(const char *name, size_t name_length,
+                                     grpc_compression_algorithm *algorithm);
+
 #endif  /* GRPC_INTERNAL_CORE_COMPRESSION_ALGORITHM_H */
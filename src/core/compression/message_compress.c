@@ -37,18 +37,74 @@
 
 #include <grpc/support/alloc.h>
 #include <grpc/support/log.h>
+#include <grpc/support/sync.h>
+#include <grpc/support/useful.h>
 
 #include <zlib.h>
 
+/* inflate output starts with blocks of OUTPUT_BLOCK_SIZE bytes (or more for
+   large inputs), and doubles the block size as it goes */
 #define OUTPUT_BLOCK_SIZE 1024
+#define MAX_OUTPUT_BLOCK_SIZE (256 * 1024)
 
-static int zlib_body(z_stream *zs, gpr_slice_buffer *input,
-                     gpr_slice_buffer *output,
-                     int (*flate)(z_stream *zs, int flush)) {
+/* Deflates input into a single slice sized with deflateBound, capped to one
+   byte less than the input: output that does not fit is not worth sending
+   compressed, and deflating stops as soon as that is known. */
+static int zlib_deflate_body(z_stream *zs, gpr_slice_buffer *input,
+                             gpr_slice_buffer *output) {
   int r;
   int flush;
   size_t i;
-  gpr_slice outbuf = gpr_slice_malloc(OUTPUT_BLOCK_SIZE);
+  size_t limit = input->length - 1;
+  gpr_slice outbuf =
+      gpr_slice_malloc(GPR_MIN(deflateBound(zs, input->length), limit));
+
+  zs->avail_out = GPR_SLICE_LENGTH(outbuf);
+  zs->next_out = GPR_SLICE_START_PTR(outbuf);
+  flush = Z_NO_FLUSH;
+  for (i = 0; i < input->count; i++) {
+    if (i == input->count - 1) flush = Z_FINISH;
+    zs->avail_in = GPR_SLICE_LENGTH(input->slices[i]);
+    zs->next_in = GPR_SLICE_START_PTR(input->slices[i]);
+    for (;;) {
+      r = deflate(zs, flush);
+      if (r == Z_STREAM_ERROR) {
+        gpr_log(GPR_INFO, "zlib: stream error");
+        goto error;
+      }
+      if (flush == Z_FINISH ? r == Z_STREAM_END : zs->avail_in == 0) break;
+      if (zs->avail_out == 0) goto error;
+    }
+  }
+
+  /* small outputs may be inlined */
+  GPR_SLICE_SET_LENGTH(outbuf, GPR_SLICE_LENGTH(outbuf) - zs->avail_out);
+  gpr_slice_buffer_add_indexed(output, outbuf);
+
+  return 1;
+
+error:
+  gpr_slice_unref(outbuf);
+  return 0;
+}
+
+/* Inflates input, failing with GRPC_MSG_DECOMPRESS_TOO_LARGE as soon as the
+   output grows past max_length: output blocks are never allocated beyond
+   max_length + 1 bytes in total. */
+static grpc_msg_decompress_result zlib_inflate_body(z_stream *zs,
+                                                    gpr_slice_buffer *input,
+                                                    gpr_slice_buffer *output,
+                                                    size_t max_length) {
+  int r;
+  int flush;
+  size_t i;
+  size_t block_size =
+      GPR_CLAMP(input->length * 4, OUTPUT_BLOCK_SIZE, MAX_OUTPUT_BLOCK_SIZE);
+  /* bytes in the blocks already added to output */
+  size_t produced = 0;
+  gpr_slice outbuf =
+      gpr_slice_malloc(max_length < block_size ? max_length + 1 : block_size);
+  grpc_msg_decompress_result result = GRPC_MSG_DECOMPRESS_ERROR;
 
   zs->avail_out = GPR_SLICE_LENGTH(outbuf);
   zs->next_out = GPR_SLICE_START_PTR(outbuf);
@@ -59,16 +115,25 @@ static int zlib_body(z_stream *zs, gpr_slice_buffer *input,
     zs->next_in = GPR_SLICE_START_PTR(input->slices[i]);
     do {
       if (zs->avail_out == 0) {
+        size_t remaining;
+        produced += GPR_SLICE_LENGTH(outbuf);
         gpr_slice_buffer_add_indexed(output, outbuf);
-        outbuf = gpr_slice_malloc(OUTPUT_BLOCK_SIZE);
+        block_size = GPR_MIN(block_size * 2, MAX_OUTPUT_BLOCK_SIZE);
+        remaining = max_length - produced;
+        outbuf = gpr_slice_malloc(remaining < block_size ? remaining + 1
+                                                         : block_size);
         zs->avail_out = GPR_SLICE_LENGTH(outbuf);
         zs->next_out = GPR_SLICE_START_PTR(outbuf);
       }
-      r = flate(zs, flush);
+      r = inflate(zs, flush);
       if (r == Z_STREAM_ERROR) {
         gpr_log(GPR_INFO, "zlib: stream error");
         goto error;
       }
+      if (produced + GPR_SLICE_LENGTH(outbuf) - zs->avail_out > max_length) {
+        result = GRPC_MSG_DECOMPRESS_TOO_LARGE;
+        goto error;
+      }
     } while (zs->avail_out == 0);
     if (zs->avail_in) {
       gpr_log(GPR_INFO, "zlib: not all input consumed");
@@ -80,64 +145,371 @@ static int zlib_body(z_stream *zs, gpr_slice_buffer *input,
   outbuf.data.refcounted.length -= zs->avail_out;
   gpr_slice_buffer_add_indexed(output, outbuf);
 
-  return 1;
+  return GRPC_MSG_DECOMPRESS_OK;
 
 error:
   gpr_slice_unref(outbuf);
-  return 0;
+  return result;
 }
 
-static int zlib_compress(gpr_slice_buffer *input, gpr_slice_buffer *output,
-                         int gzip) {
-  z_stream zs;
-  int r;
+static void rollback_output(gpr_slice_buffer *output, size_t count_before,
+                            size_t length_before) {
   size_t i;
+  for (i = count_before; i < output->count; i++) {
+    gpr_slice_unref(output->slices[i]);
+  }
+  output->count = count_before;
+  output->length = length_before;
+}
+
+/* -- zlib codec -- */
+
+typedef struct {
+  int gzip;
+  int level;
+  /* streams are initialized on first use, and reset for the next messages */
+  int deflater_initialized;
+  z_stream deflater;
+  int inflater_initialized;
+  z_stream inflater;
+} zlib_codec;
+
+static void *zlib_create(grpc_compression_algorithm algorithm, int level) {
+  zlib_codec *c = gpr_malloc(sizeof(zlib_codec));
+  memset(c, 0, sizeof(*c));
+  c->gzip = algorithm == GRPC_COMPRESS_GZIP;
+  c->level = level;
+  return c;
+}
+
+static void zlib_destroy(void *state) {
+  zlib_codec *c = state;
+  if (c->deflater_initialized) deflateEnd(&c->deflater);
+  if (c->inflater_initialized) inflateEnd(&c->inflater);
+  gpr_free(c);
+}
+
+static int zlib_compress(void *state, gpr_slice_buffer *input,
+                         gpr_slice_buffer *output) {
+  zlib_codec *c = state;
+  int r;
   size_t count_before = output->count;
   size_t length_before = output->length;
-  memset(&zs, 0, sizeof(zs));
-  r = deflateInit2(&zs, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 | (gzip ? 16 : 0),
-                   8, Z_DEFAULT_STRATEGY);
-  if (r != Z_OK) {
-    gpr_log(GPR_ERROR, "deflateInit2 returns %d", r);
-    return 0;
-  }
-  r = zlib_body(&zs, input, output, deflate) && output->length < input->length;
-  if (!r) {
-    for (i = count_before; i < output->count; i++) {
-      gpr_slice_unref(output->slices[i]);
+  if (input->length == 0) return 0;
+  if (c->deflater_initialized) {
+    deflateReset(&c->deflater);
+  } else {
+    r = deflateInit2(&c->deflater, c->level, Z_DEFLATED,
+                     15 | (c->gzip ? 16 : 0), 8, Z_DEFAULT_STRATEGY);
+    if (r != Z_OK) {
+      gpr_log(GPR_ERROR, "deflateInit2 returns %d", r);
+      return 0;
     }
-    output->count = count_before;
-    output->length = length_before;
+    c->deflater_initialized = 1;
   }
-  deflateEnd(&zs);
+  r = zlib_deflate_body(&c->deflater, input, output);
+  if (!r) rollback_output(output, count_before, length_before);
   return r;
 }
 
-static int zlib_decompress(gpr_slice_buffer *input, gpr_slice_buffer *output,
-                           int gzip) {
-  z_stream zs;
+static grpc_msg_decompress_result zlib_decompress(void *state,
+                                                  gpr_slice_buffer *input,
+                                                  gpr_slice_buffer *output,
+                                                  size_t max_length) {
+  zlib_codec *c = state;
   int r;
-  size_t i;
+  grpc_msg_decompress_result result;
   size_t count_before = output->count;
   size_t length_before = output->length;
-  memset(&zs, 0, sizeof(zs));
-  r = inflateInit2(&zs, 15 | (gzip ? 16 : 0));
-  if (r != Z_OK) {
-    gpr_log(GPR_ERROR, "inflateInit2 returns %d", r);
-    return 0;
+  if (c->inflater_initialized) {
+    inflateReset(&c->inflater);
+  } else {
+    r = inflateInit2(&c->inflater, 15 | (c->gzip ? 16 : 0));
+    if (r != Z_OK) {
+      gpr_log(GPR_ERROR, "inflateInit2 returns %d", r);
+      return GRPC_MSG_DECOMPRESS_ERROR;
+    }
+    c->inflater_initialized = 1;
+  }
+  result = zlib_inflate_body(&c->inflater, input, output, max_length);
+  if (result != GRPC_MSG_DECOMPRESS_OK) {
+    rollback_output(output, count_before, length_before);
   }
-  r = zlib_body(&zs, input, output, inflate);
-  if (!r) {
-    for (i = count_before; i < output->count; i++) {
-      gpr_slice_unref(output->slices[i]);
+  return result;
+}
+
+/* -- lz codec --
+
+   Greedy single probe LZ77 producing LZ4 blocks: each sequence is a token
+   (literal count, match length - 4), the literals, and a 16 bit little endian
+   match offset. The last sequence only carries literals. */
+
+#define LZ_HEADER_SIZE 4
+#define LZ_HASH_LOG 12
+#define LZ_MIN_MATCH 4
+/* the last 5 bytes are always literals, and the last match must start at
+   least 12 bytes before the end of the input */
+#define LZ_LAST_LITERALS 5
+#define LZ_MF_LIMIT 12
+#define LZ_MAX_OFFSET 65535
+
+typedef struct {
+  /* hash of 4 input bytes -> base + position where they were last seen.
+     Positions below base belong to previous messages, so the table never
+     needs to be cleared between messages. */
+  gpr_uint32 *table;
+  gpr_uint32 base;
+  /* holds inputs spread over several slices */
+  gpr_uint8 *scratch;
+  size_t scratch_capacity;
+} lz_codec;
+
+static void *lz_create(grpc_compression_algorithm algorithm, int level) {
+  lz_codec *c = gpr_malloc(sizeof(lz_codec));
+  memset(c, 0, sizeof(*c));
+  return c;
+}
+
+static void lz_destroy(void *state) {
+  lz_codec *c = state;
+  gpr_free(c->table);
+  gpr_free(c->scratch);
+  gpr_free(c);
+}
+
+static const gpr_uint8 *lz_flatten(lz_codec *c, gpr_slice_buffer *input) {
+  size_t i;
+  gpr_uint8 *p;
+  if (input->count == 1) return GPR_SLICE_START_PTR(input->slices[0]);
+  if (c->scratch_capacity < input->length) {
+    gpr_free(c->scratch);
+    c->scratch = gpr_malloc(input->length);
+    c->scratch_capacity = input->length;
+  }
+  p = c->scratch;
+  for (i = 0; i < input->count; i++) {
+    memcpy(p, GPR_SLICE_START_PTR(input->slices[i]),
+           GPR_SLICE_LENGTH(input->slices[i]));
+    p += GPR_SLICE_LENGTH(input->slices[i]);
+  }
+  return c->scratch;
+}
+
+static gpr_uint32 lz_read32(const gpr_uint8 *p) {
+  gpr_uint32 v;
+  memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+static gpr_uint32 lz_hash(gpr_uint32 sequence) {
+  return (sequence * 2654435761u) >> (32 - LZ_HASH_LOG);
+}
+
+static gpr_uint8 *lz_write_length(gpr_uint8 *op, size_t length) {
+  while (length >= 255) {
+    *op++ = 255;
+    length -= 255;
+  }
+  *op++ = (gpr_uint8)length;
+  return op;
+}
+
+/* Appends a sequence at *op. match_length is 0 for the final, literals only,
+   sequence. Returns 0 if the sequence does not fit before oend. */
+static int lz_emit(gpr_uint8 **op, gpr_uint8 *oend, const gpr_uint8 *literals,
+                   size_t literal_length, size_t offset,
+                   size_t match_length) {
+  gpr_uint8 *p = *op;
+  gpr_uint8 *token = p++;
+  size_t worst_case = 1 + literal_length / 255 + 1 + literal_length + 2 +
+                      match_length / 255 + 1;
+  if ((size_t)(oend - *op) < worst_case) return 0;
+  if (literal_length >= 15) {
+    *token = 15 << 4;
+    p = lz_write_length(p, literal_length - 15);
+  } else {
+    *token = (gpr_uint8)(literal_length << 4);
+  }
+  memcpy(p, literals, literal_length);
+  p += literal_length;
+  if (match_length > 0) {
+    size_t length_code = match_length - LZ_MIN_MATCH;
+    *p++ = (gpr_uint8)offset;
+    *p++ = (gpr_uint8)(offset >> 8);
+    if (length_code >= 15) {
+      *token |= 15;
+      p = lz_write_length(p, length_code - 15);
+    } else {
+      *token |= (gpr_uint8)length_code;
     }
-    output->count = count_before;
-    output->length = length_before;
   }
-  inflateEnd(&zs);
-  return r;
+  *op = p;
+  return 1;
 }
 
+static int lz_compress(void *state, gpr_slice_buffer *input,
+                       gpr_slice_buffer *output) {
+  lz_codec *c = state;
+  size_t n = input->length;
+  size_t ip = 0;
+  size_t anchor = 0;
+  const gpr_uint8 *in;
+  gpr_slice out;
+  gpr_uint8 *op;
+  gpr_uint8 *oend;
+
+  /* compressing only pays off if the output ends up smaller */
+  if (n <= LZ_HEADER_SIZE + 1 || n > 0x7fffffff) return 0;
+  in = lz_flatten(c, input);
+  if (c->table == NULL || c->base > 0x7fffffff - n) {
+    if (c->table == NULL) {
+      c->table = gpr_malloc(sizeof(gpr_uint32) << LZ_HASH_LOG);
+    }
+    memset(c->table, 0, sizeof(gpr_uint32) << LZ_HASH_LOG);
+    c->base = 1;
+  }
+
+  out = gpr_slice_malloc(n - 1);
+  op = GPR_SLICE_START_PTR(out);
+  oend = op + n - 1;
+  op[0] = (gpr_uint8)n;
+  op[1] = (gpr_uint8)(n >> 8);
+  op[2] = (gpr_uint8)(n >> 16);
+  op[3] = (gpr_uint8)(n >> 24);
+  op += LZ_HEADER_SIZE;
+
+  if (n > LZ_MF_LIMIT) {
+    size_t match_limit = n - LZ_LAST_LITERALS;
+    size_t input_limit = n - LZ_MF_LIMIT;
+    while (ip < input_limit) {
+      gpr_uint32 sequence = lz_read32(in + ip);
+      gpr_uint32 *slot = &c->table[lz_hash(sequence)];
+      gpr_uint32 ref = *slot;
+      gpr_uint32 cur = c->base + (gpr_uint32)ip;
+      *slot = cur;
+      if (ref >= c->base && cur - ref <= LZ_MAX_OFFSET &&
+          lz_read32(in + (ref - c->base)) == sequence) {
+        size_t match = ref - c->base;
+        size_t length = LZ_MIN_MATCH;
+        while (ip + length < match_limit &&
+               in[ip + length] == in[match + length]) {
+          length++;
+        }
+        if (!lz_emit(&op, oend, in + anchor, ip - anchor, cur - ref, length)) {
+          goto fail;
+        }
+        ip += length;
+        anchor = ip;
+        c->table[lz_hash(lz_read32(in + ip - 2))] =
+            c->base + (gpr_uint32)(ip - 2);
+      } else {
+        /* skip faster through data that does not compress */
+        ip += 1 + ((ip - anchor) >> 6);
+      }
+    }
+  }
+  if (!lz_emit(&op, oend, in + anchor, n - anchor, 0, 0)) goto fail;
+  c->base += (gpr_uint32)n;
+
+  out.data.refcounted.length = op - GPR_SLICE_START_PTR(out);
+  gpr_slice_buffer_add(output, out);
+  return 1;
+
+fail:
+  c->base += (gpr_uint32)n;
+  gpr_slice_unref(out);
+  return 0;
+}
+
+static grpc_msg_decompress_result lz_decompress(void *state,
+                                                gpr_slice_buffer *input,
+                                                gpr_slice_buffer *output,
+                                                size_t max_length) {
+  lz_codec *c = state;
+  size_t n = input->length;
+  size_t out_length;
+  const gpr_uint8 *ip;
+  const gpr_uint8 *iend;
+  gpr_slice out;
+  gpr_uint8 *obegin;
+  gpr_uint8 *op;
+  gpr_uint8 *oend;
+
+  if (n <= LZ_HEADER_SIZE) return GRPC_MSG_DECOMPRESS_ERROR;
+  ip = lz_flatten(c, input);
+  iend = ip + n;
+  out_length = (size_t)ip[0] | ((size_t)ip[1] << 8) | ((size_t)ip[2] << 16) |
+               ((size_t)ip[3] << 24);
+  ip += LZ_HEADER_SIZE;
+  if (out_length > max_length) return GRPC_MSG_DECOMPRESS_TOO_LARGE;
+  /* a sequence cannot describe more than ~255 output bytes per input byte:
+     don't let a corrupt header make us allocate more than that */
+  if (out_length / 256 > n) return GRPC_MSG_DECOMPRESS_ERROR;
+
+  out = gpr_slice_malloc(out_length);
+  obegin = op = GPR_SLICE_START_PTR(out);
+  oend = op + out_length;
+  for (;;) {
+    gpr_uint8 token;
+    gpr_uint8 b;
+    size_t length;
+    size_t offset;
+    const gpr_uint8 *match;
+
+    if (ip == iend) goto fail;
+    token = *ip++;
+    length = token >> 4;
+    if (length == 15) {
+      do {
+        if (ip == iend) goto fail;
+        b = *ip++;
+        length += b;
+      } while (b == 255);
+    }
+    if (length > (size_t)(iend - ip) || length > (size_t)(oend - op)) {
+      goto fail;
+    }
+    memcpy(op, ip, length);
+    op += length;
+    ip += length;
+    if (ip == iend) break;
+
+    if (iend - ip < 2) goto fail;
+    offset = (size_t)ip[0] | ((size_t)ip[1] << 8);
+    ip += 2;
+    if (offset == 0 || offset > (size_t)(op - obegin)) goto fail;
+    length = token & 15;
+    if (length == 15) {
+      do {
+        if (ip == iend) goto fail;
+        b = *ip++;
+        length += b;
+      } while (b == 255);
+    }
+    length += LZ_MIN_MATCH;
+    if (length > (size_t)(oend - op)) goto fail;
+    /* the match may overlap its own output: copy it in chunks that are
+       whole periods of the repeated pattern */
+    match = op - offset;
+    while (length > 0) {
+      size_t chunk = GPR_MIN(length, (size_t)(op - match));
+      memcpy(op, match, chunk);
+      op += chunk;
+      length -= chunk;
+    }
+  }
+  if (op != oend) goto fail;
+
+  gpr_slice_buffer_add(output, out);
+  return GRPC_MSG_DECOMPRESS_OK;
+
+fail:
+  gpr_slice_unref(out);
+  return GRPC_MSG_DECOMPRESS_ERROR;
+}
+
+/* -- codecs -- */
+
 static int copy(gpr_slice_buffer *input, gpr_slice_buffer *output) {
   size_t i;
   for (i = 0; i < input->count; i++) {
@@ -146,45 +518,190 @@ static int copy(gpr_slice_buffer *input, gpr_slice_buffer *output) {
   return 1;
 }
 
-int compress_inner(grpc_compression_algorithm algorithm,
-                   gpr_slice_buffer *input, gpr_slice_buffer *output) {
-  switch (algorithm) {
-    case GRPC_COMPRESS_NONE:
-      /* the fallback path always needs to be send uncompressed: we simply
-         rely on that here */
-      return 0;
-    case GRPC_COMPRESS_DEFLATE:
-      return zlib_compress(input, output, 0);
-    case GRPC_COMPRESS_GZIP:
-      return zlib_compress(input, output, 1);
-    case GRPC_COMPRESS_ALGORITHMS_COUNT:
-      break;
-  }
-  gpr_log(GPR_ERROR, "invalid compression algorithm %d", algorithm);
+static void *none_create(grpc_compression_algorithm algorithm, int level) {
+  return NULL;
+}
+
+static void none_destroy(void *state) {}
+
+static int none_compress(void *state, gpr_slice_buffer *input,
+                         gpr_slice_buffer *output) {
+  /* the fallback path always needs to be send uncompressed: we simply
+     rely on that here */
   return 0;
 }
 
+static grpc_msg_decompress_result none_decompress(void *state,
+                                                  gpr_slice_buffer *input,
+                                                  gpr_slice_buffer *output,
+                                                  size_t max_length) {
+  if (input->length > max_length) return GRPC_MSG_DECOMPRESS_TOO_LARGE;
+  copy(input, output);
+  return GRPC_MSG_DECOMPRESS_OK;
+}
+
+typedef struct {
+  void *(*create)(grpc_compression_algorithm algorithm, int level);
+  void (*destroy)(void *state);
+  /* on failure, both leave output unchanged */
+  int (*compress)(void *state, gpr_slice_buffer *input,
+                  gpr_slice_buffer *output);
+  grpc_msg_decompress_result (*decompress)(void *state,
+                                           gpr_slice_buffer *input,
+                                           gpr_slice_buffer *output,
+                                           size_t max_length);
+} codec_vtable;
+
+static const codec_vtable none_vtable = {none_create, none_destroy,
+                                         none_compress, none_decompress};
+static const codec_vtable zlib_vtable = {zlib_create, zlib_destroy,
+                                         zlib_compress, zlib_decompress};
+static const codec_vtable lz_vtable = {lz_create, lz_destroy, lz_compress,
+                                       lz_decompress};
+
+/* indexed by grpc_compression_algorithm */
+static const codec_vtable *const g_codecs[GRPC_COMPRESS_ALGORITHMS_COUNT] = {
+    &none_vtable, &zlib_vtable, &zlib_vtable, &lz_vtable};
+
+struct grpc_msg_codec {
+  grpc_compression_algorithm algorithm;
+  int level;
+  const codec_vtable *vtable;
+  void *state;
+};
+
+grpc_msg_codec *grpc_msg_codec_create(grpc_compression_algorithm algorithm) {
+  return grpc_msg_codec_create_with_level(algorithm,
+                                          GRPC_MSG_COMPRESS_LEVEL_DEFAULT);
+}
+
+grpc_msg_codec *grpc_msg_codec_create_with_level(
+    grpc_compression_algorithm algorithm, int level) {
+  grpc_msg_codec *codec;
+  if ((unsigned)algorithm >= GRPC_COMPRESS_ALGORITHMS_COUNT) {
+    gpr_log(GPR_ERROR, "invalid compression algorithm %d", algorithm);
+    return NULL;
+  }
+  if (level != GRPC_MSG_COMPRESS_LEVEL_DEFAULT &&
+      (level < GRPC_MSG_COMPRESS_LEVEL_FASTEST ||
+       level > GRPC_MSG_COMPRESS_LEVEL_BEST)) {
+    gpr_log(GPR_ERROR, "invalid compression level %d, using the default",
+            level);
+    level = GRPC_MSG_COMPRESS_LEVEL_DEFAULT;
+  }
+  codec = gpr_malloc(sizeof(grpc_msg_codec));
+  codec->algorithm = algorithm;
+  codec->level = level;
+  codec->vtable = g_codecs[algorithm];
+  codec->state = codec->vtable->create(algorithm, level);
+  return codec;
+}
+
+void grpc_msg_codec_destroy(grpc_msg_codec *codec) {
+  codec->vtable->destroy(codec->state);
+  gpr_free(codec);
+}
+
+grpc_compression_algorithm grpc_msg_codec_algorithm(grpc_msg_codec *codec) {
+  return codec->algorithm;
+}
+
+int grpc_msg_codec_level(grpc_msg_codec *codec) { return codec->level; }
+
+int grpc_msg_codec_compress(grpc_msg_codec *codec, gpr_slice_buffer *input,
+                            gpr_slice_buffer *output) {
+  if (!codec->vtable->compress(codec->state, input, output)) {
+    copy(input, output);
+    return 0;
+  }
+  return 1;
+}
+
+int grpc_msg_codec_decompress(grpc_msg_codec *codec, gpr_slice_buffer *input,
+                              gpr_slice_buffer *output) {
+  return grpc_msg_codec_decompress_with_limit(codec, input, output,
+                                              (size_t)-1) ==
+         GRPC_MSG_DECOMPRESS_OK;
+}
+
+grpc_msg_decompress_result grpc_msg_codec_decompress_with_limit(
+    grpc_msg_codec *codec, gpr_slice_buffer *input, gpr_slice_buffer *output,
+    size_t max_length) {
+  return codec->vtable->decompress(codec->state, input, output, max_length);
+}
+
+/* Idle default level codecs, shared by grpc_msg_compress and
+   grpc_msg_decompress so that one-shot calls reuse already set up zlib
+   streams and match tables instead of allocating them for every message.
+   Codecs hold no per message state between calls, so any thread can pick up
+   any idle codec. */
+#define CODEC_POOL_SIZE 8
+
+static gpr_once g_codec_pool_once = GPR_ONCE_INIT;
+static gpr_mu g_codec_pool_mu;
+static grpc_msg_codec *g_codec_pool[GRPC_COMPRESS_ALGORITHMS_COUNT]
+                                   [CODEC_POOL_SIZE];
+static size_t g_codec_pool_count[GRPC_COMPRESS_ALGORITHMS_COUNT];
+
+static void init_codec_pool(void) { gpr_mu_init(&g_codec_pool_mu); }
+
+static grpc_msg_codec *get_pooled_codec(grpc_compression_algorithm algorithm) {
+  grpc_msg_codec *codec = NULL;
+  if ((unsigned)algorithm >= GRPC_COMPRESS_ALGORITHMS_COUNT) {
+    gpr_log(GPR_ERROR, "invalid compression algorithm %d", algorithm);
+    return NULL;
+  }
+  gpr_once_init(&g_codec_pool_once, init_codec_pool);
+  gpr_mu_lock(&g_codec_pool_mu);
+  if (g_codec_pool_count[algorithm] > 0) {
+    codec = g_codec_pool[algorithm][--g_codec_pool_count[algorithm]];
+  }
+  gpr_mu_unlock(&g_codec_pool_mu);
+  return codec != NULL ? codec : grpc_msg_codec_create(algorithm);
+}
+
+void grpc_msg_codec_pool_shutdown(void) {
+  size_t i;
+  gpr_once_init(&g_codec_pool_once, init_codec_pool);
+  gpr_mu_lock(&g_codec_pool_mu);
+  for (i = 0; i < GRPC_COMPRESS_ALGORITHMS_COUNT; i++) {
+    while (g_codec_pool_count[i] > 0) {
+      grpc_msg_codec_destroy(g_codec_pool[i][--g_codec_pool_count[i]]);
+    }
+  }
+  gpr_mu_unlock(&g_codec_pool_mu);
+}
+
+static void put_pooled_codec(grpc_msg_codec *codec) {
+  grpc_compression_algorithm algorithm = codec->algorithm;
+  gpr_mu_lock(&g_codec_pool_mu);
+  if (g_codec_pool_count[algorithm] < CODEC_POOL_SIZE) {
+    g_codec_pool[algorithm][g_codec_pool_count[algorithm]++] = codec;
+    codec = NULL;
+  }
+  gpr_mu_unlock(&g_codec_pool_mu);
+  if (codec != NULL) grpc_msg_codec_destroy(codec);
+}
+
 int grpc_msg_compress(grpc_compression_algorithm algorithm,
                       gpr_slice_buffer *input, gpr_slice_buffer *output) {
-  if (!compress_inner(algorithm, input, output)) {
+  grpc_msg_codec *codec = get_pooled_codec(algorithm);
+  int r;
+  if (codec == NULL) {
     copy(input, output);
     return 0;
   }
-  return 1;
+  r = grpc_msg_codec_compress(codec, input, output);
+  put_pooled_codec(codec);
+  return r;
 }
 
 int grpc_msg_decompress(grpc_compression_algorithm algorithm,
                         gpr_slice_buffer *input, gpr_slice_buffer *output) {
-  switch (algorithm) {
-    case GRPC_COMPRESS_NONE:
-      return copy(input, output);
-    case GRPC_COMPRESS_DEFLATE:
-      return zlib_decompress(input, output, 0);
-    case GRPC_COMPRESS_GZIP:
-      return zlib_decompress(input, output, 1);
-    case GRPC_COMPRESS_ALGORITHMS_COUNT:
-      break;
-  }
-  gpr_log(GPR_ERROR, "invalid compression algorithm %d", algorithm);
-  return 0;
+  grpc_msg_codec *codec = get_pooled_codec(algorithm);
+  int r;
+  if (codec == NULL) return 0;
+  r = grpc_msg_codec_decompress(codec, input, output);
+  put_pooled_codec(codec);
+  return r;
 }
@@ -49,4 +49,53 @@ int grpc_msg_compress(grpc_compression_algorithm algorithm,
 int grpc_msg_decompress(grpc_compression_algorithm algorithm,
                         gpr_slice_buffer *input, gpr_slice_buffer *output);
 
+/* A codec keeps the state of one compression algorithm (zlib streams, match
+   tables...) alive so that it can be reused for all the messages of a call
+   instead of being set up again for every message. A codec is not thread
+   safe. */
+typedef struct grpc_msg_codec grpc_msg_codec;
+
+/* Compression levels trade speed for size, from GRPC_MSG_COMPRESS_LEVEL_FASTEST
+   to GRPC_MSG_COMPRESS_LEVEL_BEST (the zlib levels). The lz codec has a single
+   level and ignores them. */
+#define GRPC_MSG_COMPRESS_LEVEL_DEFAULT (-1)
+#define GRPC_MSG_COMPRESS_LEVEL_FASTEST 1
+#define GRPC_MSG_COMPRESS_LEVEL_BEST 9
+
+/* Returns NULL for an invalid algorithm. An invalid level falls back to
+   GRPC_MSG_COMPRESS_LEVEL_DEFAULT. */
+grpc_msg_codec *grpc_msg_codec_create(grpc_compression_algorithm algorithm);
+grpc_msg_codec *grpc_msg_codec_create_with_level(
+    grpc_compression_algorithm algorithm, int level);
+void grpc_msg_codec_destroy(grpc_msg_codec *codec);
+
+grpc_compression_algorithm grpc_msg_codec_algorithm(grpc_msg_codec *codec);
+int grpc_msg_codec_level(grpc_msg_codec *codec);
+
+/* Same contracts as grpc_msg_compress and grpc_msg_decompress, using (and
+   updating) the state held by the codec. */
+int grpc_msg_codec_compress(grpc_msg_codec *codec, gpr_slice_buffer *input,
+                            gpr_slice_buffer *output);
+int grpc_msg_codec_decompress(grpc_msg_codec *codec, gpr_slice_buffer *input,
+                              gpr_slice_buffer *output);
+
+typedef enum {
+  GRPC_MSG_DECOMPRESS_ERROR = 0,
+  GRPC_MSG_DECOMPRESS_OK,
+  /* the decompressed message would be longer than the limit */
+  GRPC_MSG_DECOMPRESS_TOO_LARGE
+} grpc_msg_decompress_result;
+
+/* Like grpc_msg_codec_decompress, but gives up once the output grows past
+   max_length bytes, without having allocated much more than that: peers
+   cannot make us inflate a small message into an arbitrarily large one. On
+   failure, output is unchanged. */
+grpc_msg_decompress_result grpc_msg_codec_decompress_with_limit(
+    grpc_msg_codec *codec, gpr_slice_buffer *input, gpr_slice_buffer *output,
+    size_t max_length);
+
+/* Destroys the idle codecs kept for grpc_msg_compress and
+   grpc_msg_decompress. Called by grpc_shutdown. */
+void grpc_msg_codec_pool_shutdown(void);
+
 #endif  /* GRPC_INTERNAL_CORE_COMPRESSION_MESSAGE_COMPRESS_H */
@@ -190,8 +190,8 @@ static void on_connected(void *arg, grpc_endpoint *tcp) {
     GPR_ASSERT(grpc_httpcli_ssl_channel_security_connector_create(
                    pem_root_certs, pem_root_certs_size, req->host, &sc) ==
                GRPC_SECURITY_OK);
-    grpc_setup_secure_transport(&sc->base, tcp, on_secure_transport_setup_done,
-                                req);
+    grpc_setup_secure_transport(&sc->base, tcp, NULL,
+                                on_secure_transport_setup_done, req);
     grpc_security_connector_unref(&sc->base);
   } else {
     start_write(req);
@@ -118,7 +118,7 @@ grpc_security_status grpc_httpcli_ssl_channel_security_connector_create(
   }
   result = tsi_create_ssl_client_handshaker_factory(
       NULL, 0, NULL, 0, pem_root_certs, pem_root_certs_size, NULL, NULL, NULL,
-      0, &c->handshaker_factory);
+      0, NULL, &c->handshaker_factory);
   if (result != TSI_OK) {
     gpr_log(GPR_ERROR, "Handshaker factory creation failed with %s.",
             tsi_result_to_string(result));
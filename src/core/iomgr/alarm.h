@@ -41,6 +41,7 @@
 typedef struct grpc_alarm {
   gpr_timespec deadline;
   gpr_uint32 heap_index; /* INVALID_HEAP_INDEX if not in heap */
+  gpr_uint32 wheel_index; /* owning wheel, for the timing wheel backend */
   struct grpc_alarm *next;
   struct grpc_alarm *prev;
   int triggered;
@@ -34,6 +34,7 @@
 #ifndef GRPC_INTERNAL_CORE_IOMGR_ALARM_INTERNAL_H
 #define GRPC_INTERNAL_CORE_IOMGR_ALARM_INTERNAL_H
 
+#include "src/core/iomgr/alarm.h"
 #include <grpc/support/sync.h>
 #include <grpc/support/time.h>
 
@@ -50,11 +51,47 @@
 
 int grpc_alarm_check(gpr_mu *drop_mu, gpr_timespec now, gpr_timespec *next);
 
+typedef enum {
+  /* Sharded heaps of the alarms due soon, backed by unsorted lists; the
+     default. */
+  GRPC_ALARM_LIST_HEAP,
+  /* Per-core hierarchical timing wheels with 1ms ticks: O(1) add and cancel,
+     and all the alarms of a tick expire as one batch.  Suits workloads that
+     add and cancel many alarms that never fire, such as call deadlines. */
+  GRPC_ALARM_LIST_WHEEL
+} grpc_alarm_list_backend;
+
+/* Initialize the alarm list with the backend chosen by
+   grpc_alarm_list_set_backend(), or else by the GRPC_ALARM_LIST environment
+   variable ("heap" or "wheel"), defaulting to the heap. */
 void grpc_alarm_list_init(gpr_timespec now);
 void grpc_alarm_list_shutdown(void);
 
+/* Override the backend used by subsequent grpc_alarm_list_init() calls. */
+void grpc_alarm_list_set_backend(grpc_alarm_list_backend backend);
+
 gpr_timespec grpc_alarm_list_next_timeout(void);
 
+/* Alarm list backend. grpc_alarm_init() and grpc_alarm_cancel() fill in and
+   call back the alarm; the backend only tracks pending alarms. */
+typedef struct grpc_alarm_list_vtable {
+  void (*init)(gpr_timespec now);
+  /* Called once every alarm has been popped. */
+  void (*destroy)(void);
+  void (*add)(grpc_alarm *alarm, gpr_timespec now);
+  /* Remove alarm if it has not been popped yet, returning non zero if so. */
+  int (*cancel)(grpc_alarm *alarm);
+  /* Mark up to max_alarms alarms due at now as triggered and store them in
+     alarms, returning how many. Pops every alarm when now is
+     gpr_inf_future. Updates *next as described for grpc_alarm_check. */
+  size_t (*pop_expired)(gpr_timespec now, gpr_timespec *next,
+                        grpc_alarm **alarms, size_t max_alarms);
+  gpr_timespec (*next_timeout)(void);
+} grpc_alarm_list_vtable;
+
+extern const grpc_alarm_list_vtable grpc_alarm_heap_list_vtable;
+extern const grpc_alarm_list_vtable grpc_alarm_wheel_list_vtable;
+
 /* the following must be implemented by each iomgr implementation */
 
 void grpc_kick_poller(void);
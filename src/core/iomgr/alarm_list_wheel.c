@@ -0,0 +1,370 @@
+/*
+ *
+ * Copyright 2015, Google Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer
+ * in the documentation and/or other materials provided with the
+ * distribution.
+ *     * Neither the name of Google Inc. nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+
+/* Alarm list backend built from hierarchical timing wheels, one per core.
+
+   Time is cut into 1ms ticks counted from grpc_alarm_list_init(). Each wheel
+   has NUM_LEVELS levels of LEVEL_SIZE slots: level L holds the alarms due
+   between LEVEL_SIZE^L and LEVEL_SIZE^(L+1) ticks after the wheel's current
+   tick, in the slot indexed by the matching digit of their due tick. Adding
+   or cancelling an alarm is a list insertion or removal. When the current
+   tick reaches a multiple of LEVEL_SIZE^L, the level L slot for the period
+   that starts there is cascaded, that is its alarms are redistributed to the
+   lower levels. A level 0 slot only ever holds alarms due on a single tick,
+   which expire as one batch.
+
+   Alarms are added to the wheel of the core they are added on, so that
+   threads adding and cancelling alarms rarely contend. Alarms fire on the
+   first tick that is not before their deadline. */
+
+#include "src/core/iomgr/alarm_internal.h"
+
+#include <grpc/support/alloc.h>
+#include <grpc/support/cpu.h>
+#include <grpc/support/sync.h>
+#include <grpc/support/useful.h>
+
+#define TICKS_PER_SECOND 1000
+#define NS_PER_TICK (GPR_NS_PER_SEC / TICKS_PER_SECOND)
+#define LEVEL_BITS 6
+#define LEVEL_SIZE (1 << LEVEL_BITS)
+#define LEVEL_MASK (LEVEL_SIZE - 1)
+#define NUM_LEVELS 5
+/* Alarms due further away than this (about 12 days) are parked in the last
+   level, and put back when their slot cascades. */
+#define MAX_TICK_DELTA ((gpr_int64)1 << (LEVEL_BITS * NUM_LEVELS))
+#define MAX_SECONDS ((gpr_int64)1 << 40)
+#define NEVER_TICK ((gpr_int64)1 << 62)
+#define MAX_WHEELS 32
+
+typedef struct {
+  gpr_mu mu;
+  /* Every alarm due before cur_tick has been popped, and the slots that
+     cascade on cur_tick have been cascaded. */
+  gpr_int64 cur_tick;
+  /* No alarm is due, and no slot holding alarms cascades, before this
+     tick. */
+  gpr_int64 next_tick;
+  size_t num_alarms;
+  /* List heads */
+  grpc_alarm slots[NUM_LEVELS][LEVEL_SIZE];
+} wheel_type;
+
+static gpr_timespec g_start;
+/* Protects g_next_tick */
+static gpr_mu g_mu;
+/* Allow only one wheel_pop_expired at once */
+static gpr_mu g_checker_mu;
+/* The minimum next_tick of the wheels */
+static gpr_int64 g_next_tick;
+static wheel_type *g_wheels;
+static size_t g_num_wheels;
+
+static gpr_int64 time_to_tick(gpr_timespec ts, int round_up) {
+  gpr_timespec delta = gpr_time_sub(ts, g_start);
+  gpr_int64 tick;
+  if (delta.tv_sec >= MAX_SECONDS) return NEVER_TICK;
+  if (delta.tv_sec <= -MAX_SECONDS) return -NEVER_TICK;
+  tick = (gpr_int64)delta.tv_sec * TICKS_PER_SECOND +
+         delta.tv_nsec / NS_PER_TICK;
+  if (round_up && delta.tv_nsec % NS_PER_TICK != 0) tick++;
+  return tick;
+}
+
+static gpr_timespec tick_to_time(gpr_int64 tick) {
+  gpr_timespec delta;
+  if (tick >= NEVER_TICK) return gpr_inf_future;
+  delta.tv_sec = (time_t)(tick / TICKS_PER_SECOND);
+  delta.tv_nsec = (int)(tick % TICKS_PER_SECOND) * NS_PER_TICK;
+  return gpr_time_add(g_start, delta);
+}
+
+static void list_join(grpc_alarm *head, grpc_alarm *alarm) {
+  alarm->next = head;
+  alarm->prev = head->prev;
+  alarm->next->prev = alarm->prev->next = alarm;
+}
+
+static void list_remove(grpc_alarm *alarm) {
+  alarm->next->prev = alarm->prev;
+  alarm->prev->next = alarm->next;
+}
+
+static int list_is_empty(grpc_alarm *head) { return head->next == head; }
+
+static void wheel_init(gpr_timespec now) {
+  size_t i;
+  int level;
+  int slot;
+
+  g_start = now;
+  gpr_mu_init(&g_mu);
+  gpr_mu_init(&g_checker_mu);
+  g_next_tick = NEVER_TICK;
+  g_num_wheels = GPR_CLAMP(gpr_cpu_num_cores(), 1, MAX_WHEELS);
+  g_wheels = gpr_malloc(g_num_wheels * sizeof(wheel_type));
+
+  for (i = 0; i < g_num_wheels; i++) {
+    wheel_type *wheel = &g_wheels[i];
+    gpr_mu_init(&wheel->mu);
+    wheel->cur_tick = 0;
+    wheel->next_tick = NEVER_TICK;
+    wheel->num_alarms = 0;
+    for (level = 0; level < NUM_LEVELS; level++) {
+      for (slot = 0; slot < LEVEL_SIZE; slot++) {
+        grpc_alarm *head = &wheel->slots[level][slot];
+        head->next = head->prev = head;
+      }
+    }
+  }
+}
+
+static void wheel_destroy(void) {
+  size_t i;
+  for (i = 0; i < g_num_wheels; i++) {
+    gpr_mu_destroy(&g_wheels[i].mu);
+  }
+  gpr_free(g_wheels);
+  gpr_mu_destroy(&g_mu);
+  gpr_mu_destroy(&g_checker_mu);
+}
+
+/* Links alarm, due on tick, into its slot and returns the tick at which that
+   slot will next be looked at.
+   REQUIRES: wheel->mu locked */
+static gpr_int64 wheel_insert(wheel_type *wheel, grpc_alarm *alarm,
+                              gpr_int64 tick) {
+  gpr_int64 delta;
+  int level = 0;
+  int shift;
+
+  tick = GPR_CLAMP(tick, wheel->cur_tick,
+                   wheel->cur_tick + MAX_TICK_DELTA - 1);
+  delta = tick - wheel->cur_tick;
+  while (delta >= (gpr_int64)1 << (LEVEL_BITS * (level + 1))) {
+    level++;
+  }
+  shift = LEVEL_BITS * level;
+  list_join(&wheel->slots[level][(tick >> shift) & LEVEL_MASK], alarm);
+  wheel->num_alarms++;
+  return (tick >> shift) << shift;
+}
+
+/* Redistributes the alarms of the slots that cascade on cur_tick.
+   REQUIRES: wheel->mu locked */
+static void cascade(wheel_type *wheel) {
+  int level;
+  for (level = 1; level < NUM_LEVELS; level++) {
+    int shift = LEVEL_BITS * level;
+    grpc_alarm *head;
+    if ((wheel->cur_tick & (((gpr_int64)1 << shift) - 1)) != 0) return;
+    head = &wheel->slots[level][(wheel->cur_tick >> shift) & LEVEL_MASK];
+    while (!list_is_empty(head)) {
+      grpc_alarm *alarm = head->next;
+      list_remove(alarm);
+      wheel->num_alarms--;
+      wheel_insert(wheel, alarm, time_to_tick(alarm->deadline, 1));
+    }
+  }
+}
+
+/* Returns the earliest tick that has alarms in level 0, or on which a slot
+   holding alarms cascades.
+   REQUIRES: wheel->mu locked */
+static gpr_int64 compute_next_tick(wheel_type *wheel) {
+  gpr_int64 next_tick = NEVER_TICK;
+  gpr_int64 i;
+  int level;
+
+  if (wheel->num_alarms == 0) return NEVER_TICK;
+  for (i = wheel->cur_tick; i < wheel->cur_tick + LEVEL_SIZE; i++) {
+    if (!list_is_empty(&wheel->slots[0][i & LEVEL_MASK])) {
+      next_tick = i;
+      break;
+    }
+  }
+  /* The first cascade of each level is no earlier than the previous level's,
+     so stop at the first level that cannot beat next_tick. */
+  for (level = 1; level < NUM_LEVELS; level++) {
+    int shift = LEVEL_BITS * level;
+    gpr_int64 period = wheel->cur_tick >> shift;
+    if ((period + 1) << shift >= next_tick) break;
+    for (i = period + 1; i <= period + LEVEL_SIZE; i++) {
+      if (!list_is_empty(&wheel->slots[level][i & LEVEL_MASK])) {
+        next_tick = GPR_MIN(next_tick, i << shift);
+        break;
+      }
+    }
+  }
+  return next_tick;
+}
+
+/* Pops up to max_alarms alarms due on or before tick target, moving the wheel
+   forward to target.
+   REQUIRES: wheel->mu locked, wheel->next_tick <= target */
+static size_t pop_due(wheel_type *wheel, gpr_int64 target,
+                      grpc_alarm **alarms, size_t max_alarms) {
+  size_t n = 0;
+  while (n < max_alarms) {
+    grpc_alarm *head = &wheel->slots[0][wheel->cur_tick & LEVEL_MASK];
+    if (!list_is_empty(head)) {
+      grpc_alarm *alarm = head->next;
+      list_remove(alarm);
+      wheel->num_alarms--;
+      alarm->triggered = 1;
+      alarms[n++] = alarm;
+    } else if (wheel->cur_tick < target) {
+      /* Nothing happens on the ticks in between, so skip them */
+      wheel->cur_tick = GPR_MIN(compute_next_tick(wheel), target);
+      cascade(wheel);
+    } else {
+      break;
+    }
+  }
+  wheel->next_tick = compute_next_tick(wheel);
+  return n;
+}
+
+/* Pops up to max_alarms alarms, whatever their deadline.
+   REQUIRES: wheel->mu locked */
+static size_t pop_all(wheel_type *wheel, grpc_alarm **alarms,
+                      size_t max_alarms) {
+  size_t n = 0;
+  int level;
+  int slot;
+  for (level = 0; level < NUM_LEVELS; level++) {
+    for (slot = 0; slot < LEVEL_SIZE; slot++) {
+      grpc_alarm *head = &wheel->slots[level][slot];
+      while (n < max_alarms && !list_is_empty(head)) {
+        grpc_alarm *alarm = head->next;
+        list_remove(alarm);
+        wheel->num_alarms--;
+        alarm->triggered = 1;
+        alarms[n++] = alarm;
+      }
+    }
+  }
+  wheel->next_tick = compute_next_tick(wheel);
+  return n;
+}
+
+static void wheel_add(grpc_alarm *alarm, gpr_timespec now) {
+  wheel_type *wheel;
+  gpr_int64 tick = time_to_tick(alarm->deadline, 1);
+  int is_first_alarm = 0;
+
+  alarm->wheel_index = gpr_cpu_current_cpu() % g_num_wheels;
+  wheel = &g_wheels[alarm->wheel_index];
+  gpr_mu_lock(&wheel->mu);
+  tick = wheel_insert(wheel, alarm, tick);
+  if (tick < wheel->next_tick) {
+    wheel->next_tick = tick;
+    is_first_alarm = 1;
+  }
+  gpr_mu_unlock(&wheel->mu);
+
+  /* wheel_pop_expired reads each wheel's next_tick while holding g_mu, so it
+     either sees the new next_tick or finishes before we lower g_next_tick
+     here. */
+  if (is_first_alarm) {
+    gpr_mu_lock(&g_mu);
+    if (tick < g_next_tick) {
+      g_next_tick = tick;
+      grpc_kick_poller();
+    }
+    gpr_mu_unlock(&g_mu);
+  }
+}
+
+static int wheel_cancel(grpc_alarm *alarm) {
+  wheel_type *wheel = &g_wheels[alarm->wheel_index];
+  int triggered = 0;
+  gpr_mu_lock(&wheel->mu);
+  if (!alarm->triggered) {
+    triggered = 1;
+    alarm->triggered = 1;
+    list_remove(alarm);
+    wheel->num_alarms--;
+  }
+  gpr_mu_unlock(&wheel->mu);
+  return triggered;
+}
+
+static size_t wheel_pop_expired(gpr_timespec now, gpr_timespec *next,
+                                grpc_alarm **alarms, size_t max_alarms) {
+  size_t n = 0;
+  size_t i;
+  gpr_int64 target = time_to_tick(now, 0);
+
+  if (gpr_mu_trylock(&g_checker_mu)) {
+    gpr_mu_lock(&g_mu);
+
+    if (g_next_tick <= target) {
+      gpr_int64 next_tick = NEVER_TICK;
+      for (i = 0; i < g_num_wheels; i++) {
+        wheel_type *wheel = &g_wheels[i];
+        gpr_mu_lock(&wheel->mu);
+        if (n < max_alarms && wheel->next_tick <= target) {
+          n += target == NEVER_TICK
+                   ? pop_all(wheel, alarms + n, max_alarms - n)
+                   : pop_due(wheel, target, alarms + n, max_alarms - n);
+        }
+        next_tick = GPR_MIN(next_tick, wheel->next_tick);
+        gpr_mu_unlock(&wheel->mu);
+      }
+      g_next_tick = next_tick;
+    }
+
+    if (next) {
+      *next = gpr_time_min(*next, tick_to_time(g_next_tick));
+    }
+
+    gpr_mu_unlock(&g_mu);
+    gpr_mu_unlock(&g_checker_mu);
+  }
+
+  return n;
+}
+
+static gpr_timespec wheel_next_timeout(void) {
+  gpr_timespec out;
+  gpr_mu_lock(&g_mu);
+  out = tick_to_time(g_next_tick);
+  gpr_mu_unlock(&g_mu);
+  return out;
+}
+
+const grpc_alarm_list_vtable grpc_alarm_wheel_list_vtable = {
+    wheel_init, wheel_destroy, wheel_add, wheel_cancel, wheel_pop_expired,
+    wheel_next_timeout};
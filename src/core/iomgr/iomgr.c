@@ -37,9 +37,11 @@
 
 #include "src/core/iomgr/iomgr_internal.h"
 #include "src/core/iomgr/alarm_internal.h"
+#include "src/core/iomgr/resolve_address.h"
 #include <grpc/support/alloc.h>
 #include <grpc/support/log.h>
 #include <grpc/support/thd.h>
+#include <grpc/support/tls.h>
 #include <grpc/support/sync.h>
 
 typedef struct delayed_callback {
@@ -58,12 +60,21 @@ static int g_shutdown;
 static int g_refs;
 static gpr_event g_background_callback_executor_done;
 
+/* The time cached by the poller running on this thread, if any */
+GPR_TLS_DECL(g_cached_now);
+/* Whether g_cached_now is initialized: grpc_iomgr_now() may be called
+   without iomgr. */
+static int g_cached_now_initialized;
+
 /* Execute followup callbacks continuously.
    Other threads may check in and help during pollset_work() */
 static void background_callback_executor(void *ignored) {
+  gpr_timespec now;
+  grpc_iomgr_set_cached_now(&now);
   gpr_mu_lock(&g_mu);
   while (!g_shutdown) {
     gpr_timespec deadline = gpr_inf_future;
+    now = gpr_now();
     if (g_cbs_head) {
       delayed_callback *cb = g_cbs_head;
       g_cbs_head = cb->next;
@@ -72,12 +83,13 @@ static void background_callback_executor(void *ignored) {
       cb->cb(cb->cb_arg, cb->success);
       gpr_free(cb);
       gpr_mu_lock(&g_mu);
-    } else if (grpc_alarm_check(&g_mu, gpr_now(), &deadline)) {
+    } else if (grpc_alarm_check(&g_mu, now, &deadline)) {
     } else {
       gpr_cv_wait(&g_cv, &g_mu, deadline);
     }
   }
   gpr_mu_unlock(&g_mu);
+  grpc_iomgr_set_cached_now(NULL);
   gpr_event_set(&g_background_callback_executor_done, (void *)1);
 }
 
@@ -88,8 +100,11 @@ void grpc_iomgr_init(void) {
   gpr_mu_init(&g_mu);
   gpr_cv_init(&g_cv);
   gpr_cv_init(&g_rcv);
+  gpr_tls_init(&g_cached_now);
+  g_cached_now_initialized = 1;
   grpc_alarm_list_init(gpr_now());
   g_refs = 0;
+  grpc_resolve_address_global_init();
   grpc_iomgr_platform_init();
   gpr_event_init(&g_background_callback_executor_done);
   gpr_thd_new(&id, background_callback_executor, NULL, NULL);
@@ -141,12 +156,35 @@ void grpc_iomgr_shutdown(void) {
   gpr_event_wait(&g_background_callback_executor_done, gpr_inf_future);
 
   grpc_iomgr_platform_shutdown();
+  grpc_resolve_address_global_shutdown();
   grpc_alarm_list_shutdown();
+  g_cached_now_initialized = 0;
+  gpr_tls_destroy(&g_cached_now);
   gpr_mu_destroy(&g_mu);
   gpr_cv_destroy(&g_cv);
   gpr_cv_destroy(&g_rcv);
 }
 
+gpr_timespec grpc_iomgr_now(void) {
+  gpr_timespec *now = g_cached_now_initialized
+                          ? (gpr_timespec *)gpr_tls_get(&g_cached_now)
+                          : NULL;
+  return now ? *now : gpr_now();
+}
+
+gpr_timespec *grpc_iomgr_set_cached_now(gpr_timespec *now) {
+  gpr_timespec *prev = (gpr_timespec *)gpr_tls_get(&g_cached_now);
+  gpr_tls_set(&g_cached_now, (gpr_intptr)now);
+  return prev;
+}
+
+void grpc_iomgr_refresh_cached_now(void) {
+  gpr_timespec *now = (gpr_timespec *)gpr_tls_get(&g_cached_now);
+  if (now) {
+    *now = gpr_now();
+  }
+}
+
 void grpc_iomgr_ref(void) {
   gpr_mu_lock(&g_mu);
   ++g_refs;
@@ -206,6 +244,8 @@ int grpc_maybe_call_delayed_callbacks(gpr_mu *drop_mu, int success) {
       retake_mu = drop_mu;
       drop_mu = NULL;
     }
+    /* the previous callback may have blocked */
+    if (n > 0) grpc_iomgr_refresh_cached_now();
     cb->cb(cb->cb_arg, success && cb->success);
     gpr_free(cb);
     n++;
@@ -34,6 +34,8 @@
 #ifndef GRPC_INTERNAL_CORE_IOMGR_IOMGR_H
 #define GRPC_INTERNAL_CORE_IOMGR_IOMGR_H
 
+#include <grpc/support/time.h>
+
 /* gRPC Callback definition */
 typedef void (*grpc_iomgr_cb_func)(void *arg, int success);
 
@@ -44,4 +46,11 @@ void grpc_iomgr_shutdown(void);
    and causes the invocation of a callback at some point in the future */
 void grpc_iomgr_add_callback(grpc_iomgr_cb_func cb, void *cb_arg);
 
+/* Returns the current time, as gpr_now() does. Callbacks run by a poller see
+   the time at which the poller last woke up, or at which the previous
+   callback returned, instead, which saves reading the clock on every use; it
+   is meant for deadline and expiry arithmetic, not for measuring durations.
+   */
+gpr_timespec grpc_iomgr_now(void);
+
 #endif  /* GRPC_INTERNAL_CORE_IOMGR_IOMGR_H */
@@ -42,6 +42,14 @@ int grpc_maybe_call_delayed_callbacks(gpr_mu *drop_mu, int success);
 void grpc_iomgr_add_delayed_callback(grpc_iomgr_cb_func cb, void *cb_arg,
                                      int success);
 
+/* Make grpc_iomgr_now() return *now on this thread, until the returned
+   previous value is put back. *now must stay valid until then. */
+gpr_timespec *grpc_iomgr_set_cached_now(gpr_timespec *now);
+/* Set the cached time of this thread, if any, to the current time. To be
+   called whenever the cached time may have gone stale: by pollers when they
+   wake up, and between callbacks, which may block. */
+void grpc_iomgr_refresh_cached_now(void);
+
 void grpc_iomgr_ref(void);
 void grpc_iomgr_unref(void);
 
@@ -41,6 +41,7 @@
 #include <unistd.h>
 
 #include "src/core/iomgr/fd_posix.h"
+#include "src/core/iomgr/iomgr_internal.h"
 #include <grpc/support/alloc.h>
 #include <grpc/support/log.h>
 
@@ -110,6 +111,7 @@ static int multipoll_with_epoll_pollset_maybe_work(
 
   do {
     ep_rv = epoll_wait(h->epoll_fd, ep_ev, GRPC_EPOLL_MAX_EVENTS, timeout_ms);
+    grpc_iomgr_refresh_cached_now();
     if (ep_rv < 0) {
       if (errno != EINTR) {
         gpr_log(GPR_ERROR, "epoll_wait() failed: %s", strerror(errno));
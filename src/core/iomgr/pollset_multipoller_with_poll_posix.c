@@ -172,6 +172,7 @@ static int multipoll_with_poll_pollset_maybe_work(
   }
 
   r = poll(h->pfds, h->pfd_count, timeout);
+  grpc_iomgr_refresh_cached_now();
 
   end_polling(pollset);
 
@@ -174,19 +174,23 @@ void grpc_pollset_del_fd(grpc_pollset *pollset, grpc_fd *fd) {
 int grpc_pollset_work(grpc_pollset *pollset, gpr_timespec deadline) {
   /* pollset->mu already held */
   gpr_timespec now = gpr_now();
+  gpr_timespec *prev_cached_now;
   int r;
   if (gpr_time_cmp(now, deadline) > 0) {
     return 0;
   }
+  /* Callbacks run below read now through grpc_iomgr_now() */
+  prev_cached_now = grpc_iomgr_set_cached_now(&now);
   if (grpc_maybe_call_delayed_callbacks(&pollset->mu, 1)) {
-    return 1;
-  }
-  if (grpc_alarm_check(&pollset->mu, now, &deadline)) {
-    return 1;
+    r = 1;
+  } else if (grpc_alarm_check(&pollset->mu, now, &deadline)) {
+    r = 1;
+  } else {
+    gpr_tls_set(&g_current_thread_poller, (gpr_intptr)pollset);
+    r = pollset->vtable->maybe_work(pollset, deadline, now, 1);
+    gpr_tls_set(&g_current_thread_poller, 0);
   }
-  gpr_tls_set(&g_current_thread_poller, (gpr_intptr)pollset);
-  r = pollset->vtable->maybe_work(pollset, deadline, now, 1);
-  gpr_tls_set(&g_current_thread_poller, 0);
+  grpc_iomgr_set_cached_now(prev_cached_now);
   return r;
 }
 
@@ -412,6 +416,7 @@ static int unary_poll_pollset_maybe_work(grpc_pollset *pollset,
 
   r = poll(pfd, GPR_ARRAY_SIZE(pfd), timeout);
   GRPC_TIMER_MARK(GRPC_PTAG_POLL_FINISHED, r);
+  grpc_iomgr_refresh_cached_now();
 
   grpc_fd_end_poll(&fd_watcher);
 
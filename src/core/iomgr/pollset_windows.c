@@ -59,17 +59,20 @@ void grpc_pollset_destroy(grpc_pollset *pollset) {
 
 int grpc_pollset_work(grpc_pollset *pollset, gpr_timespec deadline) {
   gpr_timespec now;
+  gpr_timespec *prev_cached_now;
+  int r = 0;
   now = gpr_now();
   if (gpr_time_cmp(now, deadline) > 0) {
     return 0;
   }
+  prev_cached_now = grpc_iomgr_set_cached_now(&now);
   if (grpc_maybe_call_delayed_callbacks(NULL, 1)) {
-    return 1;
+    r = 1;
+  } else if (grpc_alarm_check(NULL, now, &deadline)) {
+    r = 1;
   }
-  if (grpc_alarm_check(NULL, now, &deadline)) {
-    return 1;
-  }
-  return 0;
+  grpc_iomgr_set_cached_now(prev_cached_now);
+  return r;
 }
 
 void grpc_pollset_kick(grpc_pollset *p) { }
@@ -0,0 +1,334 @@
+/*
+ *
+ * Copyright 2015, Google Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer
+ * in the documentation and/or other materials provided with the
+ * distribution.
+ *     * Neither the name of Google Inc. nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include "src/core/iomgr/resolve_address.h"
+
+#include <string.h>
+
+#include "src/core/iomgr/iomgr_internal.h"
+#include "src/core/support/string.h"
+#include <grpc/support/alloc.h>
+#include <grpc/support/log.h>
+#include <grpc/support/sync.h>
+#include <grpc/support/thd.h>
+
+/* Upper bound on threads blocked in the platform resolver at any one time */
+#define MAX_WORKERS 4
+/* Upper bound on the number of cached resolutions */
+#define MAX_CACHE_ENTRIES 256
+
+#define DEFAULT_CACHE_TTL_SECONDS 30
+#define DEFAULT_NEGATIVE_CACHE_TTL_SECONDS 2
+
+typedef struct waiter {
+  grpc_resolve_cb cb;
+  void *arg;
+  struct waiter *next;
+} waiter;
+
+/* A queued or running lookup: requests for the same name that arrive while
+   it is pending are added to its waiters rather than starting a new one */
+typedef struct lookup {
+  char *name;
+  char *default_port;
+  int started;
+  waiter *waiters;
+  struct lookup *next;
+} lookup;
+
+typedef struct cache_entry {
+  char *name;
+  char *default_port;
+  /* NULL for a cached failure */
+  grpc_resolved_addresses *addrs;
+  gpr_timespec expires;
+  struct cache_entry *next;
+} cache_entry;
+
+/* A cache hit, waiting to be delivered from the iomgr callback queue */
+typedef struct {
+  grpc_resolve_cb cb;
+  void *arg;
+  grpc_resolved_addresses *addrs;
+} cache_hit;
+
+static gpr_mu g_mu;
+/* pending lookups, oldest first */
+static lookup *g_lookups_head;
+static lookup *g_lookups_tail;
+static int g_workers;
+/* cached resolutions, newest first */
+static cache_entry *g_cache;
+static size_t g_cache_size;
+static gpr_timespec g_ttl;
+static gpr_timespec g_negative_ttl;
+static grpc_blocking_resolver g_resolver;
+
+static int key_eq(const char *a, const char *b) {
+  if (a == NULL || b == NULL) return a == b;
+  return 0 == strcmp(a, b);
+}
+
+static grpc_resolved_addresses *copy_addresses(
+    const grpc_resolved_addresses *addrs) {
+  grpc_resolved_addresses *copy;
+  if (addrs == NULL) return NULL;
+  copy = gpr_malloc(sizeof(grpc_resolved_addresses));
+  copy->naddrs = addrs->naddrs;
+  copy->addrs = gpr_malloc(sizeof(grpc_resolved_address) * addrs->naddrs);
+  memcpy(copy->addrs, addrs->addrs,
+         sizeof(grpc_resolved_address) * addrs->naddrs);
+  return copy;
+}
+
+static void destroy_cache_entry(cache_entry *e) {
+  gpr_free(e->name);
+  gpr_free(e->default_port);
+  if (e->addrs) {
+    grpc_resolved_addresses_destroy(e->addrs);
+  }
+  gpr_free(e);
+}
+
+/* Find the live cache entry for a name, dropping any expired entries seen
+   along the way. Call with g_mu held. */
+static cache_entry *cache_find(const char *name, const char *default_port,
+                               gpr_timespec now) {
+  cache_entry **pe = &g_cache;
+  cache_entry *e;
+  while ((e = *pe) != NULL) {
+    if (gpr_time_cmp(e->expires, now) <= 0) {
+      *pe = e->next;
+      destroy_cache_entry(e);
+      g_cache_size--;
+    } else if (key_eq(e->name, name) && key_eq(e->default_port, default_port)) {
+      return e;
+    } else {
+      pe = &e->next;
+    }
+  }
+  return NULL;
+}
+
+/* Cache the result of a lookup. Call with g_mu held. */
+static void cache_insert(const char *name, const char *default_port,
+                         const grpc_resolved_addresses *addrs,
+                         gpr_timespec now) {
+  gpr_timespec ttl = addrs ? g_ttl : g_negative_ttl;
+  cache_entry *e;
+
+  if (gpr_time_cmp(ttl, gpr_time_0) <= 0) return;
+
+  e = gpr_malloc(sizeof(cache_entry));
+  e->name = gpr_strdup(name);
+  e->default_port = gpr_strdup(default_port);
+  e->addrs = copy_addresses(addrs);
+  e->expires = gpr_time_add(now, ttl);
+  e->next = g_cache;
+  g_cache = e;
+
+  if (++g_cache_size > MAX_CACHE_ENTRIES) {
+    /* evict the oldest entry */
+    cache_entry **pe = &g_cache;
+    while ((*pe)->next) pe = &(*pe)->next;
+    destroy_cache_entry(*pe);
+    *pe = NULL;
+    g_cache_size--;
+  }
+}
+
+static void unlink_lookup(lookup *l) {
+  lookup **pl = &g_lookups_head;
+  lookup *prev = NULL;
+  while (*pl != l) {
+    prev = *pl;
+    pl = &prev->next;
+  }
+  *pl = l->next;
+  if (g_lookups_tail == l) {
+    g_lookups_tail = prev;
+  }
+}
+
+/* Worker thread: runs queued lookups until there are none left, then exits.
+   Holds an iomgr ref for its whole lifetime so that shutdown waits for it. */
+static void worker(void *ignored) {
+  lookup *l;
+  waiter *w;
+  grpc_blocking_resolver resolver;
+  grpc_resolved_addresses *addrs;
+
+  gpr_mu_lock(&g_mu);
+  for (;;) {
+    for (l = g_lookups_head; l != NULL && l->started; l = l->next)
+      ;
+    if (l == NULL) break;
+    l->started = 1;
+    resolver = g_resolver;
+    gpr_mu_unlock(&g_mu);
+
+    addrs = resolver(l->name, l->default_port);
+
+    gpr_mu_lock(&g_mu);
+    cache_insert(l->name, l->default_port, addrs, gpr_now());
+    unlink_lookup(l);
+    gpr_mu_unlock(&g_mu);
+
+    /* the last waiter takes ownership of addrs, the rest get copies */
+    while ((w = l->waiters) != NULL) {
+      l->waiters = w->next;
+      w->cb(w->arg, l->waiters ? copy_addresses(addrs) : addrs);
+      gpr_free(w);
+      grpc_iomgr_unref();
+    }
+    gpr_free(l->name);
+    gpr_free(l->default_port);
+    gpr_free(l);
+
+    gpr_mu_lock(&g_mu);
+  }
+  g_workers--;
+  gpr_mu_unlock(&g_mu);
+  grpc_iomgr_unref();
+}
+
+static void deliver_cache_hit(void *arg, int success) {
+  cache_hit *h = arg;
+  h->cb(h->arg, h->addrs);
+  gpr_free(h);
+  grpc_iomgr_unref();
+}
+
+void grpc_resolve_address(const char *name, const char *default_port,
+                          grpc_resolve_cb cb, void *arg) {
+  cache_entry *e;
+  lookup *l;
+  waiter *w;
+  int spawn_worker = 0;
+  gpr_thd_id id;
+
+  grpc_iomgr_ref();
+  gpr_mu_lock(&g_mu);
+  e = cache_find(name, default_port, gpr_now());
+  if (e != NULL) {
+    cache_hit *h = gpr_malloc(sizeof(cache_hit));
+    h->cb = cb;
+    h->arg = arg;
+    h->addrs = copy_addresses(e->addrs);
+    gpr_mu_unlock(&g_mu);
+    grpc_iomgr_add_callback(deliver_cache_hit, h);
+    return;
+  }
+
+  for (l = g_lookups_head; l != NULL; l = l->next) {
+    if (key_eq(l->name, name) && key_eq(l->default_port, default_port)) {
+      break;
+    }
+  }
+  if (l == NULL) {
+    l = gpr_malloc(sizeof(lookup));
+    l->name = gpr_strdup(name);
+    l->default_port = gpr_strdup(default_port);
+    l->started = 0;
+    l->waiters = NULL;
+    l->next = NULL;
+    if (g_lookups_tail) {
+      g_lookups_tail->next = l;
+    } else {
+      g_lookups_head = l;
+    }
+    g_lookups_tail = l;
+    if (g_workers < MAX_WORKERS) {
+      g_workers++;
+      spawn_worker = 1;
+    }
+  }
+  w = gpr_malloc(sizeof(waiter));
+  w->cb = cb;
+  w->arg = arg;
+  w->next = l->waiters;
+  l->waiters = w;
+  gpr_mu_unlock(&g_mu);
+
+  if (spawn_worker) {
+    grpc_iomgr_ref();
+    gpr_thd_new(&id, worker, NULL, NULL);
+  }
+}
+
+void grpc_resolved_addresses_destroy(grpc_resolved_addresses *addrs) {
+  gpr_free(addrs->addrs);
+  gpr_free(addrs);
+}
+
+void grpc_resolve_address_set_cache_ttl(gpr_timespec ttl,
+                                        gpr_timespec negative_ttl) {
+  gpr_mu_lock(&g_mu);
+  g_ttl = ttl;
+  g_negative_ttl = negative_ttl;
+  gpr_mu_unlock(&g_mu);
+}
+
+void grpc_resolve_address_flush_cache(void) {
+  cache_entry *e;
+  gpr_mu_lock(&g_mu);
+  while ((e = g_cache) != NULL) {
+    g_cache = e->next;
+    destroy_cache_entry(e);
+  }
+  g_cache_size = 0;
+  gpr_mu_unlock(&g_mu);
+}
+
+void grpc_resolve_address_set_blocking_resolver(
+    grpc_blocking_resolver resolver) {
+  gpr_mu_lock(&g_mu);
+  g_resolver = resolver ? resolver : grpc_blocking_resolve_address;
+  gpr_mu_unlock(&g_mu);
+}
+
+void grpc_resolve_address_global_init(void) {
+  gpr_mu_init(&g_mu);
+  g_lookups_head = g_lookups_tail = NULL;
+  g_workers = 0;
+  g_cache = NULL;
+  g_cache_size = 0;
+  g_ttl = gpr_time_from_seconds(DEFAULT_CACHE_TTL_SECONDS);
+  g_negative_ttl = gpr_time_from_seconds(DEFAULT_NEGATIVE_CACHE_TTL_SECONDS);
+  g_resolver = grpc_blocking_resolve_address;
+}
+
+void grpc_resolve_address_global_shutdown(void) {
+  grpc_resolve_address_flush_cache();
+  gpr_mu_destroy(&g_mu);
+}
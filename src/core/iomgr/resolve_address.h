@@ -36,6 +36,8 @@
 
 #include <stddef.h>
 
+#include <grpc/support/time.h>
+
 #define GRPC_MAX_SOCKADDR_SIZE 128
 
 typedef struct {
@@ -54,7 +56,11 @@ typedef struct {
    On failure: addresses is NULL */
 typedef void (*grpc_resolve_cb)(void *arg, grpc_resolved_addresses *addresses);
 /* Asynchronously resolve addr. Use default_port if a port isn't designated
-   in addr, otherwise use the port in addr. */
+   in addr, otherwise use the port in addr.
+   Lookups run on a small bounded pool of worker threads; concurrent requests
+   for the same name are coalesced into a single lookup, and results (including
+   failures) are cached process-wide - see grpc_resolve_address_set_cache_ttl.
+   cb is always invoked from a thread other than the caller's. */
 /* TODO(ctiller): add a timeout here */
 void grpc_resolve_address(const char *addr, const char *default_port,
                           grpc_resolve_cb cb, void *arg);
@@ -66,4 +72,27 @@ void grpc_resolved_addresses_destroy(grpc_resolved_addresses *addresses);
 grpc_resolved_addresses *grpc_blocking_resolve_address(
     const char *addr, const char *default_port);
 
+/* Set how long successful (ttl) and failed (negative_ttl) resolutions are
+   cached for. A zero timespan disables caching of that kind of result.
+   Entries already in the cache keep the expiry they were inserted with. */
+void grpc_resolve_address_set_cache_ttl(gpr_timespec ttl,
+                                        gpr_timespec negative_ttl);
+
+/* Drop all cached resolutions */
+void grpc_resolve_address_flush_cache(void);
+
+/* Signature of a blocking resolver, as implemented by
+   grpc_blocking_resolve_address */
+typedef grpc_resolved_addresses *(*grpc_blocking_resolver)(
+    const char *addr, const char *default_port);
+
+/* For testing: route grpc_resolve_address lookups through resolver instead
+   of grpc_blocking_resolve_address. Passing NULL restores the default. */
+void grpc_resolve_address_set_blocking_resolver(
+    grpc_blocking_resolver resolver);
+
+/* Called from grpc_iomgr_init/grpc_iomgr_shutdown */
+void grpc_resolve_address_global_init(void);
+void grpc_resolve_address_global_shutdown(void);
+
 #endif  /* GRPC_INTERNAL_CORE_IOMGR_RESOLVE_ADDRESS_H */
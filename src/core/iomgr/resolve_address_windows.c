@@ -40,22 +40,13 @@
 #include <sys/types.h>
 #include <string.h>
 
-#include "src/core/iomgr/iomgr_internal.h"
 #include "src/core/iomgr/sockaddr_utils.h"
 #include "src/core/support/string.h"
 #include <grpc/support/alloc.h>
 #include <grpc/support/host_port.h>
 #include <grpc/support/log.h>
-#include <grpc/support/thd.h>
 #include <grpc/support/time.h>
 
-typedef struct {
-  char *name;
-  char *default_port;
-  grpc_resolve_cb cb;
-  void *arg;
-} request;
-
 grpc_resolved_addresses *grpc_blocking_resolve_address(
     const char *name, const char *default_port) {
   struct addrinfo hints;
@@ -124,35 +115,4 @@ done:
   return addrs;
 }
 
-/* Thread function to asynch-ify grpc_blocking_resolve_address */
-static void do_request(void *rp) {
-  request *r = rp;
-  grpc_resolved_addresses *resolved =
-      grpc_blocking_resolve_address(r->name, r->default_port);
-  void *arg = r->arg;
-  grpc_resolve_cb cb = r->cb;
-  gpr_free(r->name);
-  gpr_free(r->default_port);
-  gpr_free(r);
-  cb(arg, resolved);
-  grpc_iomgr_unref();
-}
-
-void grpc_resolved_addresses_destroy(grpc_resolved_addresses *addrs) {
-  gpr_free(addrs->addrs);
-  gpr_free(addrs);
-}
-
-void grpc_resolve_address(const char *name, const char *default_port,
-                          grpc_resolve_cb cb, void *arg) {
-  request *r = gpr_malloc(sizeof(request));
-  gpr_thd_id id;
-  grpc_iomgr_ref();
-  r->name = gpr_strdup(name);
-  r->default_port = gpr_strdup(default_port);
-  r->cb = cb;
-  r->arg = arg;
-  gpr_thd_new(&id, do_request, r, NULL);
-}
-
 #endif
@@ -35,6 +35,7 @@
 #define GRPC_INTERNAL_CORE_IOMGR_TCP_CLIENT_H
 
 #include "src/core/iomgr/endpoint.h"
+#include "src/core/iomgr/resolve_address.h"
 #include "src/core/iomgr/sockaddr.h"
 #include <grpc/support/time.h>
 
@@ -45,4 +46,37 @@ void grpc_tcp_client_connect(void (*cb)(void *arg, grpc_endpoint *tcp),
                              void *arg, const struct sockaddr *addr,
                              int addr_len, gpr_timespec deadline);
 
+/* An in-progress connection attempt */
+typedef struct grpc_tcp_client_connect_attempt grpc_tcp_client_connect_attempt;
+
+/* As grpc_tcp_client_connect, but returns a handle to the attempt, or NULL if
+   cb was already called before returning. The handle must be given back with
+   grpc_tcp_client_release_connect. */
+grpc_tcp_client_connect_attempt *grpc_tcp_client_connect_with_handle(
+    void (*cb)(void *arg, grpc_endpoint *tcp), void *arg,
+    const struct sockaddr *addr, int addr_len, gpr_timespec deadline);
+
+/* Release a handle from grpc_tcp_client_connect_with_handle. If cancel is set
+   and the attempt is still in progress, it is abandoned: its socket is shut
+   down and cb is promptly called with NULL. */
+void grpc_tcp_client_release_connect(grpc_tcp_client_connect_attempt *attempt,
+                                     int cancel);
+
+/* Asynchronously connect to any one of addrs, racing connection attempts in
+   the style of "happy eyeballs": attempts are made in order starting at
+   addrs->addrs[first] (wrapping around), and a new attempt is started every
+   stagger interval or as soon as the previous attempt fails, whichever comes
+   first, so that an unresponsive address does not hold up the others.
+   Each attempt is abandoned after attempt_timeout, and no attempt is started
+   after deadline.
+   cb is called once, with the first connection established, or with NULL
+   when every attempt has failed; attempts still in progress once the first
+   connection is established are cancelled, and any that complete anyway are
+   closed. Takes ownership of addrs. */
+void grpc_tcp_client_connect_to_any(void (*cb)(void *arg, grpc_endpoint *tcp),
+                                    void *arg, grpc_resolved_addresses *addrs,
+                                    size_t first, gpr_timespec stagger,
+                                    gpr_timespec attempt_timeout,
+                                    gpr_timespec deadline);
+
 #endif  /* GRPC_INTERNAL_CORE_IOMGR_TCP_CLIENT_H */
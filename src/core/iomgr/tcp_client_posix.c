@@ -52,16 +52,32 @@
 #include <grpc/support/log.h>
 #include <grpc/support/time.h>
 
-typedef struct {
+struct grpc_tcp_client_connect_attempt {
   void (*cb)(void *arg, grpc_endpoint *tcp);
   void *cb_arg;
   gpr_mu mu;
+  /* NULL once the attempt has completed */
   grpc_fd *fd;
+  /* has fd been shut down (by the alarm or a cancellation)? */
+  int shut_down;
   gpr_timespec deadline;
   grpc_alarm alarm;
+  /* one for the alarm, one for the write closure, one for a handle returned
+     by grpc_tcp_client_connect_with_handle */
   int refs;
   grpc_iomgr_closure write_closure;
-} async_connect;
+};
+
+typedef grpc_tcp_client_connect_attempt async_connect;
+
+static void async_connect_unref_locked(async_connect *ac) {
+  int done = (--ac->refs == 0);
+  gpr_mu_unlock(&ac->mu);
+  if (done) {
+    gpr_mu_destroy(&ac->mu);
+    gpr_free(ac);
+  }
+}
 
 static int prepare_socket(const struct sockaddr *addr, int fd) {
   if (fd < 0) {
@@ -84,19 +100,21 @@ error:
   return 0;
 }
 
+/* abandon the attempt: on_writable will be called with success=0 */
+static void shutdown_locked(async_connect *ac) {
+  if (ac->fd != NULL && !ac->shut_down) {
+    ac->shut_down = 1;
+    grpc_fd_shutdown(ac->fd);
+  }
+}
+
 static void on_alarm(void *acp, int success) {
-  int done;
   async_connect *ac = acp;
   gpr_mu_lock(&ac->mu);
-  if (ac->fd != NULL && success) {
-    grpc_fd_shutdown(ac->fd);
-  }
-  done = (--ac->refs == 0);
-  gpr_mu_unlock(&ac->mu);
-  if (done) {
-    gpr_mu_destroy(&ac->mu);
-    gpr_free(ac);
+  if (success) {
+    shutdown_locked(ac);
   }
+  async_connect_unref_locked(ac);
 }
 
 static void on_writable(void *acp, int success) {
@@ -105,7 +123,6 @@ static void on_writable(void *acp, int success) {
   socklen_t so_error_size;
   int err;
   int fd = ac->fd->fd;
-  int done;
   grpc_endpoint *ep = NULL;
   void (*cb)(void *arg, grpc_endpoint *tcp) = ac->cb;
   void *cb_arg = ac->cb_arg;
@@ -166,18 +183,33 @@ finish:
   if (!ep) {
     grpc_fd_orphan(ac->fd, NULL, NULL);
   }
-  done = (--ac->refs == 0);
-  gpr_mu_unlock(&ac->mu);
-  if (done) {
-    gpr_mu_destroy(&ac->mu);
-    gpr_free(ac);
-  }
+  ac->fd = NULL;
+  async_connect_unref_locked(ac);
   cb(cb_arg, ep);
 }
 
 void grpc_tcp_client_connect(void (*cb)(void *arg, grpc_endpoint *ep),
                              void *arg, const struct sockaddr *addr,
                              int addr_len, gpr_timespec deadline) {
+  grpc_tcp_client_connect_attempt *attempt =
+      grpc_tcp_client_connect_with_handle(cb, arg, addr, addr_len, deadline);
+  if (attempt != NULL) {
+    grpc_tcp_client_release_connect(attempt, 0);
+  }
+}
+
+void grpc_tcp_client_release_connect(grpc_tcp_client_connect_attempt *ac,
+                                     int cancel) {
+  gpr_mu_lock(&ac->mu);
+  if (cancel) {
+    shutdown_locked(ac);
+  }
+  async_connect_unref_locked(ac);
+}
+
+grpc_tcp_client_connect_attempt *grpc_tcp_client_connect_with_handle(
+    void (*cb)(void *arg, grpc_endpoint *ep), void *arg,
+    const struct sockaddr *addr, int addr_len, gpr_timespec deadline) {
   int fd;
   grpc_dualstack_mode dsmode;
   int err;
@@ -203,7 +235,7 @@ void grpc_tcp_client_connect(void (*cb)(void *arg, grpc_endpoint *ep),
   }
   if (!prepare_socket(addr, fd)) {
     cb(arg, NULL);
-    return;
+    return NULL;
   }
 
   do {
@@ -214,27 +246,29 @@ void grpc_tcp_client_connect(void (*cb)(void *arg, grpc_endpoint *ep),
     gpr_log(GPR_DEBUG, "instant connect");
     cb(arg,
        grpc_tcp_create(grpc_fd_create(fd), GRPC_TCP_DEFAULT_READ_SLICE_SIZE));
-    return;
+    return NULL;
   }
 
   if (errno != EWOULDBLOCK && errno != EINPROGRESS) {
     gpr_log(GPR_ERROR, "connect error: %s", strerror(errno));
     close(fd);
     cb(arg, NULL);
-    return;
+    return NULL;
   }
 
   ac = gpr_malloc(sizeof(async_connect));
   ac->cb = cb;
   ac->cb_arg = arg;
   ac->fd = grpc_fd_create(fd);
+  ac->shut_down = 0;
   gpr_mu_init(&ac->mu);
-  ac->refs = 2;
+  ac->refs = 3;
   ac->write_closure.cb = on_writable;
   ac->write_closure.cb_arg = ac;
 
-  grpc_alarm_init(&ac->alarm, deadline, on_alarm, ac, gpr_now());
+  grpc_alarm_init(&ac->alarm, deadline, on_alarm, ac, grpc_iomgr_now());
   grpc_fd_notify_on_write(ac->fd, &ac->write_closure);
+  return ac;
 }
 
 #endif
@@ -0,0 +1,291 @@
+/*
+ *
+ * Copyright 2015, Google Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer
+ * in the documentation and/or other materials provided with the
+ * distribution.
+ *     * Neither the name of Google Inc. nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include "src/core/iomgr/tcp_client.h"
+
+#include "src/core/iomgr/alarm.h"
+#include <grpc/support/alloc.h>
+#include <grpc/support/log.h>
+#include <grpc/support/sync.h>
+#include <grpc/support/time.h>
+#include <grpc/support/useful.h>
+
+typedef struct race race;
+
+/* One connection attempt in a race */
+typedef struct {
+  race *r;
+  /* handle of the attempt while it is in progress: NULL once it has
+     completed, or before grpc_tcp_client_connect_with_handle has returned */
+  grpc_tcp_client_connect_attempt *handle;
+  /* has the attempt's callback been called? */
+  int completed;
+} attempt;
+
+/* A race between connection attempts to several addresses: see
+   grpc_tcp_client_connect_to_any */
+struct race {
+  void (*cb)(void *arg, grpc_endpoint *tcp);
+  void *cb_arg;
+  grpc_resolved_addresses *addrs;
+  size_t first;
+  gpr_timespec stagger;
+  gpr_timespec attempt_timeout;
+  gpr_timespec deadline;
+
+  /* protects everything below */
+  gpr_mu mu;
+  /* one per address: the first attempts_started have been started */
+  attempt *attempts;
+  /* how many attempts have been started */
+  size_t attempts_started;
+  /* how many attempts have not yet completed */
+  size_t attempts_in_flight;
+  /* has cb been called (or is about to be)? */
+  int done;
+  /* is stagger_alarm set? */
+  int alarm_pending;
+  grpc_alarm stagger_alarm;
+  /* one for the initiator, one per attempt in flight, one for a pending
+     stagger_alarm */
+  int refs;
+};
+
+static void on_attempt_done(void *arg, grpc_endpoint *tcp);
+
+static void unref_race(race *r) {
+  int destroy;
+  gpr_mu_lock(&r->mu);
+  destroy = (--r->refs == 0);
+  gpr_mu_unlock(&r->mu);
+  if (destroy) {
+    grpc_resolved_addresses_destroy(r->addrs);
+    gpr_free(r->attempts);
+    gpr_mu_destroy(&r->mu);
+    gpr_free(r);
+  }
+}
+
+/* Start the next connection attempt: returns 0 if there is none to start
+   (every address has been tried, the deadline has passed or the race is
+   over) */
+static int start_next_attempt(race *r) {
+  grpc_resolved_address *addr;
+  attempt *a;
+  grpc_tcp_client_connect_attempt *handle;
+  int cancel = 0;
+  gpr_timespec now = gpr_now();
+  gpr_timespec attempt_deadline;
+
+  gpr_mu_lock(&r->mu);
+  if (r->done || r->attempts_started == r->addrs->naddrs ||
+      gpr_time_cmp(now, r->deadline) >= 0) {
+    gpr_mu_unlock(&r->mu);
+    return 0;
+  }
+  a = &r->attempts[r->attempts_started];
+  a->r = r;
+  a->handle = NULL;
+  a->completed = 0;
+  addr = &r->addrs->addrs[(r->first + r->attempts_started++) %
+                          r->addrs->naddrs];
+  r->attempts_in_flight++;
+  r->refs++;
+  gpr_mu_unlock(&r->mu);
+
+  attempt_deadline = gpr_time_add(now, r->attempt_timeout);
+  if (gpr_time_cmp(attempt_deadline, r->deadline) > 0) {
+    attempt_deadline = r->deadline;
+  }
+  handle = grpc_tcp_client_connect_with_handle(
+      on_attempt_done, a, (struct sockaddr *)addr->addr, addr->len,
+      attempt_deadline);
+  if (handle != NULL) {
+    gpr_mu_lock(&r->mu);
+    if (a->completed) {
+      /* nothing left to cancel */
+    } else if (r->done) {
+      /* the race was decided while we were starting the attempt */
+      cancel = 1;
+    } else {
+      a->handle = handle;
+      handle = NULL;
+    }
+    gpr_mu_unlock(&r->mu);
+    if (handle != NULL) {
+      grpc_tcp_client_release_connect(handle, cancel);
+    }
+  }
+  return 1;
+}
+
+/* If nothing is left in flight and nothing more can be started, the race has
+   been lost: report failure */
+static void maybe_finish_with_failure(race *r) {
+  int failed = 0;
+  gpr_mu_lock(&r->mu);
+  if (!r->done && r->attempts_in_flight == 0 &&
+      (r->attempts_started == r->addrs->naddrs ||
+       gpr_time_cmp(gpr_now(), r->deadline) >= 0)) {
+    r->done = 1;
+    failed = 1;
+  }
+  gpr_mu_unlock(&r->mu);
+  if (failed) {
+    r->cb(r->cb_arg, NULL);
+  }
+}
+
+static void on_stagger_alarm(void *arg, int success);
+
+/* Arrange for the next attempt to start after the stagger interval, if there
+   are addresses left to try */
+static void schedule_next_attempt(race *r) {
+  gpr_timespec now = gpr_now();
+  gpr_mu_lock(&r->mu);
+  if (!r->done && !r->alarm_pending &&
+      r->attempts_started < r->addrs->naddrs) {
+    r->alarm_pending = 1;
+    r->refs++;
+    grpc_alarm_init(&r->stagger_alarm, gpr_time_add(now, r->stagger),
+                    on_stagger_alarm, r, now);
+  }
+  gpr_mu_unlock(&r->mu);
+}
+
+static void on_stagger_alarm(void *arg, int success) {
+  race *r = arg;
+  gpr_mu_lock(&r->mu);
+  r->alarm_pending = 0;
+  gpr_mu_unlock(&r->mu);
+  if (success) {
+    if (start_next_attempt(r)) {
+      schedule_next_attempt(r);
+    } else {
+      maybe_finish_with_failure(r);
+    }
+  }
+  unref_race(r);
+}
+
+static void on_attempt_done(void *arg, grpc_endpoint *tcp) {
+  attempt *a = arg;
+  race *r = a->r;
+  grpc_tcp_client_connect_attempt *handle;
+  grpc_tcp_client_connect_attempt **losers = NULL;
+  size_t num_losers = 0;
+  size_t i;
+  int won = 0;
+  int lost = 0;
+  int cancel_alarm = 0;
+
+  gpr_mu_lock(&r->mu);
+  r->attempts_in_flight--;
+  a->completed = 1;
+  handle = a->handle;
+  a->handle = NULL;
+  if (r->done) {
+    lost = 1;
+  } else if (tcp) {
+    r->done = 1;
+    won = 1;
+    cancel_alarm = r->alarm_pending;
+    /* collect the attempts still in progress so they can be cancelled */
+    losers = gpr_malloc(sizeof(*losers) * r->attempts_started);
+    for (i = 0; i < r->attempts_started; i++) {
+      if (r->attempts[i].handle != NULL) {
+        losers[num_losers++] = r->attempts[i].handle;
+        r->attempts[i].handle = NULL;
+      }
+    }
+  }
+  gpr_mu_unlock(&r->mu);
+
+  if (handle != NULL) {
+    grpc_tcp_client_release_connect(handle, 0);
+  }
+
+  if (won) {
+    if (cancel_alarm) {
+      grpc_alarm_cancel(&r->stagger_alarm);
+    }
+    for (i = 0; i < num_losers; i++) {
+      grpc_tcp_client_release_connect(losers[i], 1);
+    }
+    gpr_free(losers);
+    r->cb(r->cb_arg, tcp);
+  } else if (lost) {
+    /* somebody else got there first */
+    if (tcp) {
+      grpc_endpoint_shutdown(tcp);
+      grpc_endpoint_destroy(tcp);
+    }
+  } else if (start_next_attempt(r)) {
+    /* this attempt failed: don't wait for the stagger interval to try the
+       next address */
+    schedule_next_attempt(r);
+  } else {
+    maybe_finish_with_failure(r);
+  }
+
+  unref_race(r);
+}
+
+void grpc_tcp_client_connect_to_any(void (*cb)(void *arg, grpc_endpoint *tcp),
+                                    void *arg, grpc_resolved_addresses *addrs,
+                                    size_t first, gpr_timespec stagger,
+                                    gpr_timespec attempt_timeout,
+                                    gpr_timespec deadline) {
+  race *r = gpr_malloc(sizeof(race));
+  r->cb = cb;
+  r->cb_arg = arg;
+  r->addrs = addrs;
+  r->first = addrs->naddrs == 0 ? 0 : first % addrs->naddrs;
+  r->stagger = stagger;
+  r->attempt_timeout = attempt_timeout;
+  r->deadline = deadline;
+  r->attempts = gpr_malloc(sizeof(attempt) * GPR_MAX(addrs->naddrs, 1));
+  gpr_mu_init(&r->mu);
+  r->attempts_started = 0;
+  r->attempts_in_flight = 0;
+  r->done = 0;
+  r->alarm_pending = 0;
+  r->refs = 1;
+
+  if (start_next_attempt(r)) {
+    schedule_next_attempt(r);
+  } else {
+    maybe_finish_with_failure(r);
+  }
+  unref_race(r);
+}
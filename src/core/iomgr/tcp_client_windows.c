@@ -51,15 +51,20 @@
 #include "src/core/iomgr/sockaddr_utils.h"
 #include "src/core/iomgr/socket_windows.h"
 
-typedef struct {
+struct grpc_tcp_client_connect_attempt {
   void(*cb)(void *arg, grpc_endpoint *tcp);
   void *cb_arg;
   gpr_mu mu;
+  /* NULL once the attempt has completed */
   grpc_winsocket *socket;
   gpr_timespec deadline;
   grpc_alarm alarm;
+  /* one for the alarm, one for the connect callback, one for a handle
+     returned by grpc_tcp_client_connect_with_handle */
   int refs;
-} async_connect;
+};
+
+typedef grpc_tcp_client_connect_attempt async_connect;
 
 static void async_connect_cleanup(async_connect *ac) {
   int done = (--ac->refs == 0);
@@ -117,6 +122,7 @@ finish:
   if (!ep) {
     grpc_winsocket_orphan(ac->socket);
   }
+  ac->socket = NULL;
   async_connect_cleanup(ac);
   cb(cb_arg, ep);
 }
@@ -124,6 +130,25 @@ finish:
 void grpc_tcp_client_connect(void(*cb)(void *arg, grpc_endpoint *tcp),
                              void *arg, const struct sockaddr *addr,
                              int addr_len, gpr_timespec deadline) {
+  grpc_tcp_client_connect_attempt *attempt =
+      grpc_tcp_client_connect_with_handle(cb, arg, addr, addr_len, deadline);
+  if (attempt != NULL) {
+    grpc_tcp_client_release_connect(attempt, 0);
+  }
+}
+
+void grpc_tcp_client_release_connect(grpc_tcp_client_connect_attempt *ac,
+                                     int cancel) {
+  gpr_mu_lock(&ac->mu);
+  if (ac->socket != NULL && cancel) {
+    grpc_winsocket_shutdown(ac->socket);
+  }
+  async_connect_cleanup(ac);
+}
+
+grpc_tcp_client_connect_attempt *grpc_tcp_client_connect_with_handle(
+    void(*cb)(void *arg, grpc_endpoint *tcp), void *arg,
+    const struct sockaddr *addr, int addr_len, gpr_timespec deadline) {
   SOCKET sock = INVALID_SOCKET;
   BOOL success;
   int status;
@@ -191,11 +216,11 @@ void grpc_tcp_client_connect(void(*cb)(void *arg, grpc_endpoint *tcp),
   ac->cb_arg = arg;
   ac->socket = socket;
   gpr_mu_init(&ac->mu);
-  ac->refs = 2;
+  ac->refs = 3;
 
-  grpc_alarm_init(&ac->alarm, deadline, on_alarm, ac, gpr_now());
+  grpc_alarm_init(&ac->alarm, deadline, on_alarm, ac, grpc_iomgr_now());
   grpc_socket_notify_on_write(socket, on_connect, ac);
-  return;
+  return ac;
 
 failure:
   utf8_message = gpr_format_message(WSAGetLastError());
@@ -207,6 +232,7 @@ failure:
     closesocket(sock);
   }
   cb(arg, NULL);
+  return NULL;
 }
 
 #endif  /* GPR_WINSOCK_SOCKET */
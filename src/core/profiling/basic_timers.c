@@ -38,115 +38,390 @@
 #include "src/core/profiling/timers.h"
 #include "src/core/profiling/timers_preciseclock.h"
 
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef GPR_POSIX_SYNC
+#include <pthread.h>
+#endif
+
+#include "src/core/support/env.h"
 #include <grpc/support/alloc.h>
+#include <grpc/support/atm.h>
 #include <grpc/support/log.h>
-#include <grpc/support/time.h>
 #include <grpc/support/sync.h>
 #include <grpc/support/thd.h>
-#include <stdio.h>
+#include <grpc/support/time.h>
+#include <grpc/support/tls.h>
+
+/* Every thread records timer events into its own ring buffer, without
+   locking. A background thread drains the buffers into a binary trace file
+   (GRPC_LATENCY_TRACE, or latency_trace.bin in the current directory) every
+   FLUSH_INTERVAL_MS, or as soon as a buffer gets half full. When a buffer is
+   full anyway, new events of its thread are dropped and counted rather than
+   blocking the thread. Buffers hold GRPC_LATENCY_TRACE_RING_SIZE events
+   (rounded up to a power of two, DEFAULT_RING_SIZE by default); the buffer
+   of a thread is freed once the thread exits and its events are flushed
+   (only on platforms with pthreads: elsewhere buffers live as long as the
+   process).
+
+   Trace file format, in host byte order:
+     header: the magic bytes "GRPCLAT1", then the clock ticks per second as
+             a double.
+     records: a record type byte, followed by
+       'F' (file name): gpr_uint32 file index, gpr_uint16 name length, name.
+                        Precedes the first event referring to the file.
+       '{' (begin), '}' (end), '.' (mark):
+                        gpr_int64 clock ticks, gpr_uint64 thread id,
+                        gpr_uint64 id, gpr_int32 tag, gpr_uint32 file index,
+                        gpr_int32 line.
+       'D' (dropped):   gpr_uint64 thread id, gpr_uint32 number of events
+                        dropped.
+
+   tools/profile_analyzer/profile_analyzer.py turns traces into per tag
+   latency histograms. */
+
+#define TRACE_MAGIC "GRPCLAT1"
+#define DEFAULT_TRACE_FILE "latency_trace.bin"
+
+#define DEFAULT_RING_SIZE 8192
+#define MIN_RING_SIZE 16
+#define FLUSH_INTERVAL_MS 10
 
 typedef struct grpc_timer_entry {
   grpc_precise_clock tm;
-  gpr_thd_id thd;
   int tag;
+  char type;
   void* id;
   const char* file;
   int line;
 } grpc_timer_entry;
 
-struct grpc_timers_log {
-  gpr_mu mu;
-  grpc_timer_entry* log;
-  int num_entries;
-  int capacity;
-  int capacity_limit;
-  FILE* fp;
-};
+typedef struct thread_log {
+  gpr_thd_id thd;
+  /* entries [tail, head) wait for the flusher: head is only written by the
+     owning thread and tail only by the flusher */
+  gpr_atm head;
+  gpr_atm tail;
+  gpr_atm dropped;
+  /* set once the owning thread exited: no more events will be added */
+  gpr_atm exited;
+  /* set by the flusher once the events of an exited thread are written */
+  int finished;
+  /* written under g_mu, see g_thread_logs */
+  struct thread_log* next;
+  /* power of two */
+  gpr_atm ring_size;
+  grpc_timer_entry* entries;
+} thread_log;
 
-grpc_timers_log* grpc_timers_log_global = NULL;
+/* file names seen by the flusher, and the index they were given */
+typedef struct {
+  const char** names;
+  size_t count;
+  size_t capacity;
+} file_table;
 
-static grpc_timers_log* grpc_timers_log_create(int capacity_limit, FILE* dump) {
-  grpc_timers_log* log = gpr_malloc(sizeof(*log));
+GPR_TLS_DECL(g_thread_log);
 
-  /* TODO (vpai): Allow allocation below limit */
-  log->log = gpr_malloc(capacity_limit * sizeof(*log->log));
+static gpr_once g_once = GPR_ONCE_INIT;
+static gpr_mu g_mu;
+static gpr_cv g_cv;
+/* Guarded by g_mu. Logs outlive init and destroy cycles: only the logs of
+   exited threads are freed. New logs are pushed at the front, and only the
+   flusher (or grpc_timers_global_init while there is no flusher) unlinks
+   logs, so the flusher walks the list without holding g_mu. */
+static thread_log* g_thread_logs;
+static int g_shutdown;
+/* set when a buffer gets half full, to flush before FLUSH_INTERVAL_MS */
+static int g_flush_requested;
+#ifdef GPR_POSIX_SYNC
+/* only used for its destructor, which runs when a thread exits */
+static pthread_key_t g_thread_exit_key;
+#endif
 
-  /* TODO (vpai): Improve concurrency, do per-thread logging? */
-  gpr_mu_init(&log->mu);
+static gpr_atm g_initialized;
+/* size of the buffers of threads that start recording, set before
+   g_initialized */
+static gpr_atm g_ring_size = DEFAULT_RING_SIZE;
+static FILE* g_fp;
+static gpr_event g_flusher_done;
+/* only used by the flusher */
+static file_table g_files;
 
-  log->num_entries = 0;
-  log->capacity = log->capacity_limit = capacity_limit;
+static thread_log* thread_log_create(void) {
+  thread_log* log = gpr_malloc(sizeof(thread_log));
+  log->thd = gpr_thd_currentid();
+  gpr_atm_rel_store(&log->head, 0);
+  gpr_atm_rel_store(&log->tail, 0);
+  gpr_atm_rel_store(&log->dropped, 0);
+  gpr_atm_rel_store(&log->exited, 0);
+  log->finished = 0;
+  log->ring_size = g_ring_size;
+  log->entries = gpr_malloc(log->ring_size * sizeof(grpc_timer_entry));
+  gpr_mu_lock(&g_mu);
+  log->next = g_thread_logs;
+  g_thread_logs = log;
+  gpr_mu_unlock(&g_mu);
+  gpr_tls_set(&g_thread_log, (gpr_intptr)log);
+#ifdef GPR_POSIX_SYNC
+  pthread_setspecific(g_thread_exit_key, log);
+#endif
+  return log;
+}
 
-  log->fp = dump;
+static void thread_log_destroy(thread_log* log) {
+  gpr_free(log->entries);
+  gpr_free(log);
+}
 
-  return log;
+#ifdef GPR_POSIX_SYNC
+/* Runs on an exiting thread: hands its log over to the flusher. */
+static void thread_exited(void* arg) {
+  thread_log* log = arg;
+  gpr_tls_set(&g_thread_log, 0);
+  gpr_atm_rel_store(&log->exited, 1);
 }
+#endif
 
-static void log_report_locked(grpc_timers_log* log) {
-  FILE* fp = log->fp;
-  int i;
-  for (i = 0; i < log->num_entries; i++) {
-    grpc_timer_entry* entry = &(log->log[i]);
-    fprintf(fp, "GRPC_LAT_PROF ");
-    grpc_precise_clock_print(&entry->tm, fp);
-    fprintf(fp, " %p %d %p %s %d\n", (void*)(gpr_intptr)entry->thd, entry->tag,
-            entry->id, entry->file, entry->line);
+/* Unlinks and frees the logs selected by should_free. Requires g_mu. */
+static void free_thread_logs_locked(int (*should_free)(thread_log* log)) {
+  thread_log** prev = &g_thread_logs;
+  while (*prev != NULL) {
+    thread_log* log = *prev;
+    if (should_free(log)) {
+      *prev = log->next;
+      thread_log_destroy(log);
+    } else {
+      prev = &log->next;
+    }
   }
-
-  /* Now clear out the log */
-  log->num_entries = 0;
 }
 
-static void grpc_timers_log_destroy(grpc_timers_log* log) {
-  gpr_mu_lock(&log->mu);
-  log_report_locked(log);
-  gpr_mu_unlock(&log->mu);
+static int is_finished(thread_log* log) { return log->finished; }
 
-  gpr_free(log->log);
-  gpr_mu_destroy(&log->mu);
+static int has_exited(thread_log* log) {
+  return gpr_atm_acq_load(&log->exited) != 0;
+}
 
-  gpr_free(log);
+static void request_flush(void) {
+  gpr_mu_lock(&g_mu);
+  g_flush_requested = 1;
+  gpr_cv_signal(&g_cv);
+  gpr_mu_unlock(&g_mu);
 }
 
-static void grpc_timers_log_add(grpc_timers_log* log, int tag, void* id,
+static void grpc_timers_log_add(char type, int tag, void* id,
                                 const char* file, int line) {
+  thread_log* log;
+  gpr_atm head;
+  gpr_atm tail;
   grpc_timer_entry* entry;
 
-  /* TODO (vpai) : Improve concurrency */
-  gpr_mu_lock(&log->mu);
-  if (log->num_entries == log->capacity_limit) {
-    log_report_locked(log);
-  }
-
-  entry = &log->log[log->num_entries++];
+  if (!gpr_atm_acq_load(&g_initialized)) return;
+  log = (thread_log*)gpr_tls_get(&g_thread_log);
+  if (log == NULL) log = thread_log_create();
 
+  head = gpr_atm_no_barrier_load(&log->head);
+  tail = gpr_atm_acq_load(&log->tail);
+  if (head - tail == log->ring_size) {
+    gpr_atm_no_barrier_fetch_add(&log->dropped, 1);
+    return;
+  }
+  entry = &log->entries[head & (log->ring_size - 1)];
   grpc_precise_clock_now(&entry->tm);
+  entry->type = type;
   entry->tag = tag;
   entry->id = id;
   entry->file = file;
   entry->line = line;
-  entry->thd = gpr_thd_currentid();
+  gpr_atm_rel_store(&log->head, head + 1);
+  /* the fill level only grows one event at a time, so it is seen crossing
+     half of the buffer every time it does */
+  if (head + 1 - tail == log->ring_size / 2) request_flush();
+}
+
+static gpr_uint32 file_index(const char* file) {
+  size_t i;
+  gpr_uint32 index;
+  gpr_uint16 length;
+  /* few distinct files record events, most recent ones are likeliest */
+  for (i = g_files.count; i > 0; i--) {
+    if (g_files.names[i - 1] == file) return (gpr_uint32)(i - 1);
+  }
+  if (g_files.count == g_files.capacity) {
+    g_files.capacity = g_files.capacity ? 2 * g_files.capacity : 64;
+    g_files.names = gpr_realloc(g_files.names,
+                                g_files.capacity * sizeof(*g_files.names));
+  }
+  index = (gpr_uint32)g_files.count;
+  g_files.names[g_files.count++] = file;
+  length = (gpr_uint16)strlen(file);
+  fputc('F', g_fp);
+  fwrite(&index, sizeof(index), 1, g_fp);
+  fwrite(&length, sizeof(length), 1, g_fp);
+  fwrite(file, 1, length, g_fp);
+  return index;
+}
 
-  gpr_mu_unlock(&log->mu);
+static void write_entry(gpr_uint64 thd, const grpc_timer_entry* entry) {
+  /* type, ticks, thread, id, tag, file, line */
+  char record[1 + 8 + 8 + 8 + 4 + 4 + 4];
+  char* p = record;
+  gpr_int64 ticks = grpc_precise_clock_ticks(&entry->tm);
+  gpr_uint64 id = (gpr_uint64)(gpr_intptr)entry->id;
+  gpr_int32 tag = entry->tag;
+  gpr_uint32 file = file_index(entry->file);
+  gpr_int32 line = entry->line;
+  *p++ = entry->type;
+  memcpy(p, &ticks, 8);
+  p += 8;
+  memcpy(p, &thd, 8);
+  p += 8;
+  memcpy(p, &id, 8);
+  p += 8;
+  memcpy(p, &tag, 4);
+  p += 4;
+  memcpy(p, &file, 4);
+  p += 4;
+  memcpy(p, &line, 4);
+  fwrite(record, sizeof(record), 1, g_fp);
+}
+
+static void flush_thread_log(thread_log* log) {
+  /* loaded before head: once the thread exited, head is final */
+  int exited = has_exited(log);
+  gpr_atm tail = gpr_atm_no_barrier_load(&log->tail);
+  gpr_atm head = gpr_atm_acq_load(&log->head);
+  gpr_atm dropped = gpr_atm_no_barrier_load(&log->dropped);
+  gpr_uint64 thd = (gpr_uint64)log->thd;
+  for (; tail != head; tail++) {
+    write_entry(thd, &log->entries[tail & (log->ring_size - 1)]);
+  }
+  gpr_atm_rel_store(&log->tail, tail);
+  if (dropped != 0) {
+    gpr_uint32 count = (gpr_uint32)dropped;
+    gpr_atm_no_barrier_fetch_add(&log->dropped, -dropped);
+    fputc('D', g_fp);
+    fwrite(&thd, sizeof(thd), 1, g_fp);
+    fwrite(&count, sizeof(count), 1, g_fp);
+  }
+  log->finished = exited;
+}
+
+static void flush_all(void) {
+  thread_log* log;
+  gpr_mu_lock(&g_mu);
+  log = g_thread_logs;
+  gpr_mu_unlock(&g_mu);
+  for (; log != NULL; log = log->next) {
+    flush_thread_log(log);
+  }
+  fflush(g_fp);
+  gpr_mu_lock(&g_mu);
+  free_thread_logs_locked(is_finished);
+  gpr_mu_unlock(&g_mu);
+}
+
+static void flusher(void* ignored) {
+  int shutdown = 0;
+  while (!shutdown) {
+    gpr_mu_lock(&g_mu);
+    if (!g_shutdown && !g_flush_requested) {
+      gpr_cv_wait(&g_cv, &g_mu,
+                  gpr_time_add(gpr_now(),
+                               gpr_time_from_millis(FLUSH_INTERVAL_MS)));
+    }
+    g_flush_requested = 0;
+    shutdown = g_shutdown;
+    gpr_mu_unlock(&g_mu);
+    flush_all();
+  }
+  gpr_event_set(&g_flusher_done, (void*)1);
 }
 
 /* Latency profiler API implementation. */
 void grpc_timer_add_mark(int tag, void* id, const char* file, int line) {
-  grpc_timers_log_add(grpc_timers_log_global, tag, id, file, line);
+  grpc_timers_log_add('.', tag, id, file, line);
+}
+
+void grpc_timer_begin(int tag, void* id, const char* file, int line) {
+  grpc_timers_log_add('{', tag, id, file, line);
+}
+
+void grpc_timer_end(int tag, void* id, const char* file, int line) {
+  grpc_timers_log_add('}', tag, id, file, line);
 }
 
-void grpc_timer_begin(int tag, void* id, const char *file, int line) {}
-void grpc_timer_end(int tag, void* id, const char *file, int line) {}
+static void init_once(void) {
+  gpr_tls_init(&g_thread_log);
+  gpr_mu_init(&g_mu);
+  gpr_cv_init(&g_cv);
+#ifdef GPR_POSIX_SYNC
+  GPR_ASSERT(pthread_key_create(&g_thread_exit_key, thread_exited) == 0);
+#endif
+}
+
+/* Returns GRPC_LATENCY_TRACE_RING_SIZE rounded up to a power of two, or
+   DEFAULT_RING_SIZE if it is not set. */
+static gpr_atm configured_ring_size(void) {
+  char* env = gpr_getenv("GRPC_LATENCY_TRACE_RING_SIZE");
+  long requested = env != NULL ? atol(env) : DEFAULT_RING_SIZE;
+  gpr_atm ring_size = MIN_RING_SIZE;
+  gpr_free(env);
+  while (ring_size < requested && ring_size < (1 << 24)) ring_size <<= 1;
+  return ring_size;
+}
 
 /* Basic profiler specific API functions. */
 void grpc_timers_global_init(void) {
-  grpc_timers_log_global = grpc_timers_log_create(100000, stdout);
+  char* path = gpr_getenv("GRPC_LATENCY_TRACE");
+  double ticks_per_second = grpc_precise_clock_ticks_per_second();
+  thread_log* log;
+  gpr_thd_id id;
+
+  gpr_once_init(&g_once, init_once);
+  g_ring_size = configured_ring_size();
+  g_fp = fopen(path != NULL ? path : DEFAULT_TRACE_FILE, "wb");
+  if (g_fp == NULL) {
+    gpr_log(GPR_ERROR, "Could not open latency trace file %s",
+            path != NULL ? path : DEFAULT_TRACE_FILE);
+    gpr_free(path);
+    return;
+  }
+  gpr_free(path);
+  fwrite(TRACE_MAGIC, 1, strlen(TRACE_MAGIC), g_fp);
+  fwrite(&ticks_per_second, sizeof(ticks_per_second), 1, g_fp);
+
+  gpr_event_init(&g_flusher_done);
+  gpr_mu_lock(&g_mu);
+  /* drop whatever a previous session left behind */
+  free_thread_logs_locked(has_exited);
+  for (log = g_thread_logs; log != NULL; log = log->next) {
+    gpr_atm_rel_store(&log->tail, gpr_atm_no_barrier_load(&log->head));
+    gpr_atm_rel_store(&log->dropped, 0);
+  }
+  g_shutdown = 0;
+  g_flush_requested = 0;
+  gpr_mu_unlock(&g_mu);
+  gpr_atm_rel_store(&g_initialized, 1);
+  GPR_ASSERT(gpr_thd_new(&id, flusher, NULL, NULL));
 }
 
 void grpc_timers_global_destroy(void) {
-  grpc_timers_log_destroy(grpc_timers_log_global);
-}
+  if (!gpr_atm_acq_load(&g_initialized)) return;
+  gpr_atm_rel_store(&g_initialized, 0);
+
+  gpr_mu_lock(&g_mu);
+  g_shutdown = 1;
+  gpr_cv_signal(&g_cv);
+  gpr_mu_unlock(&g_mu);
+  gpr_event_wait(&g_flusher_done, gpr_inf_future);
 
+  gpr_free(g_files.names);
+  memset(&g_files, 0, sizeof(g_files));
+  fclose(g_fp);
+}
 
 #else  /* !GRPC_BASIC_PROFILER */
 void grpc_timers_global_init(void) {}
@@ -34,13 +34,43 @@
 #ifndef GRPC_CORE_PROFILING_TIMERS_PRECISECLOCK_H
 #define GRPC_CORE_PROFILING_TIMERS_PRECISECLOCK_H
 
+#include <grpc/support/port_platform.h>
 #include <grpc/support/time.h>
-#include <stdio.h>
 
 typedef struct grpc_precise_clock grpc_precise_clock;
 
+/* Define GRPC_TIMERS_RDTSC to timestamp with the x86 time stamp counter
+   instead of gpr_now. Reading it is much cheaper, but it only makes sense on
+   CPUs with an invariant TSC. */
 #ifdef GRPC_TIMERS_RDTSC
-#error RDTSC timers not currently supported
+#if !defined(__i386__) && !defined(__x86_64__)
+#error RDTSC timers are only supported on x86
+#endif
+struct grpc_precise_clock {
+  gpr_int64 clock;
+};
+static void grpc_precise_clock_now(grpc_precise_clock* clk) {
+  gpr_uint32 lo, hi;
+  __asm__ __volatile__("rdtsc" : "=a"(lo), "=d"(hi));
+  clk->clock = (gpr_int64)(((gpr_uint64)hi << 32) | lo);
+}
+static gpr_int64 grpc_precise_clock_ticks(const grpc_precise_clock* clk) {
+  return clk->clock;
+}
+/* Measures the counter frequency against gpr_now for 10ms. */
+static double grpc_precise_clock_ticks_per_second(void) {
+  grpc_precise_clock start_clock, end_clock;
+  gpr_timespec start = gpr_now();
+  gpr_timespec end;
+  grpc_precise_clock_now(&start_clock);
+  do {
+    end = gpr_now();
+  } while (gpr_time_cmp(gpr_time_sub(end, start), gpr_time_from_millis(10)) <
+           0);
+  grpc_precise_clock_now(&end_clock);
+  return (double)(end_clock.clock - start_clock.clock) * 1e6 /
+         (double)gpr_timespec_to_micros(gpr_time_sub(end, start));
+}
 #else
 struct grpc_precise_clock {
   gpr_timespec clock;
@@ -48,8 +78,11 @@ struct grpc_precise_clock {
 static void grpc_precise_clock_now(grpc_precise_clock* clk) {
   clk->clock = gpr_now();
 }
-static void grpc_precise_clock_print(const grpc_precise_clock* clk, FILE* fp) {
-  fprintf(fp, "%ld.%09d", clk->clock.tv_sec, clk->clock.tv_nsec);
+static gpr_int64 grpc_precise_clock_ticks(const grpc_precise_clock* clk) {
+  return (gpr_int64)clk->clock.tv_sec * GPR_NS_PER_SEC + clk->clock.tv_nsec;
+}
+static double grpc_precise_clock_ticks_per_second(void) {
+  return GPR_NS_PER_SEC;
 }
 #endif /* GRPC_TIMERS_RDTSC */
 
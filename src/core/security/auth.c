@@ -46,11 +46,20 @@
 
 #define MAX_CREDENTIALS_METADATA_COUNT 4
 
+/* Service urls up to this size (including the terminating NUL) are built in
+   the call data rather than on the heap. */
+#define GRPC_AUTH_SERVICE_URL_INLINE_SIZE 128
+
 /* We can have a per-call credentials. */
 typedef struct {
   grpc_credentials *creds;
   grpc_mdstr *host;
   grpc_mdstr *method;
+  /* Built once per call from host and method, and kept until the call is
+     destroyed since credentials may use it after get_request_metadata
+     returns. Points to service_url_buf unless the url is too long for it. */
+  char *service_url;
+  char service_url_buf[GRPC_AUTH_SERVICE_URL_INLINE_SIZE];
   grpc_transport_op op;
   size_t op_md_idx;
   int sent_initial_metadata;
@@ -86,24 +95,42 @@ static void on_credentials_metadata(void *user_data, grpc_mdelem **md_elems,
   grpc_call_next_op(elem, op);
 }
 
-static char *build_service_url(const char *url_scheme, call_data *calld) {
-  char *service_url;
-  char *service = gpr_strdup(grpc_mdstr_as_c_string(calld->method));
-  char *last_slash = strrchr(service, '/');
+/* Builds the service url of the call into calld->service_url: the inline
+   buffer when it fits, so that most calls do not allocate. */
+static void build_service_url(const char *url_scheme, call_data *calld) {
+  const char *method = grpc_mdstr_as_c_string(calld->method);
+  const char *host = grpc_mdstr_as_c_string(calld->host);
+  const char *last_slash = strrchr(method, '/');
+  size_t scheme_len, host_len, service_len;
+  char *p;
   if (last_slash == NULL) {
     gpr_log(GPR_ERROR, "No '/' found in fully qualified method name");
-    service[0] = '\0';
-  } else if (last_slash == service) {
+    service_len = 0;
+  } else if (last_slash == method) {
     /* No service part in fully qualified method name: will just be "/". */
-    service[1] = '\0';
+    service_len = 1;
   } else {
-    *last_slash = '\0';
+    service_len = (size_t)(last_slash - method);
   }
   if (url_scheme == NULL) url_scheme = "";
-  gpr_asprintf(&service_url, "%s://%s%s", url_scheme,
-               grpc_mdstr_as_c_string(calld->host), service);
-  gpr_free(service);
-  return service_url;
+  scheme_len = strlen(url_scheme);
+  host_len = strlen(host);
+  if (scheme_len + 3 + host_len + service_len + 1 <=
+      sizeof(calld->service_url_buf)) {
+    calld->service_url = calld->service_url_buf;
+  } else {
+    calld->service_url =
+        gpr_malloc(scheme_len + 3 + host_len + service_len + 1);
+  }
+  p = calld->service_url;
+  memcpy(p, url_scheme, scheme_len);
+  p += scheme_len;
+  memcpy(p, "://", 3);
+  p += 3;
+  memcpy(p, host, host_len);
+  p += host_len;
+  memcpy(p, method, service_len);
+  p[service_len] = '\0';
 }
 
 static void send_security_metadata(grpc_call_element *elem,
@@ -124,12 +151,12 @@ static void send_security_metadata(grpc_call_element *elem,
   }
   if (channel_creds != NULL &&
       grpc_credentials_has_request_metadata(channel_creds)) {
-    char *service_url =
-        build_service_url(channeld->security_connector->base.url_scheme, calld);
+    if (calld->service_url == NULL) {
+      build_service_url(channeld->security_connector->base.url_scheme, calld);
+    }
     calld->op = *op; /* Copy op (originates from the caller's stack). */
-    grpc_credentials_get_request_metadata(channel_creds, service_url,
+    grpc_credentials_get_request_metadata(channel_creds, calld->service_url,
                                           on_credentials_metadata, elem);
-    gpr_free(service_url);
   } else {
     grpc_call_next_op(elem, op);
   }
@@ -234,6 +261,7 @@ static void init_call_elem(grpc_call_element *elem,
   calld->creds = NULL;
   calld->host = NULL;
   calld->method = NULL;
+  calld->service_url = NULL;
   calld->sent_initial_metadata = 0;
 
   GPR_ASSERT(!initial_op || !initial_op->send_ops);
@@ -251,6 +279,10 @@ static void destroy_call_elem(grpc_call_element *elem) {
   if (calld->method != NULL) {
     grpc_mdstr_unref(calld->method);
   }
+  if (calld->service_url != NULL &&
+      calld->service_url != calld->service_url_buf) {
+    gpr_free(calld->service_url);
+  }
 }
 
 /* Constructor for channel_data */
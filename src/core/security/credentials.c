@@ -174,6 +174,7 @@ static void ssl_destroy(grpc_credentials *creds) {
   if (c->config.pem_root_certs != NULL) gpr_free(c->config.pem_root_certs);
   if (c->config.pem_private_key != NULL) gpr_free(c->config.pem_private_key);
   if (c->config.pem_cert_chain != NULL) gpr_free(c->config.pem_cert_chain);
+  tsi_ssl_session_cache_unref(c->config.session_cache);
   gpr_free(creds);
 }
 
@@ -315,57 +316,122 @@ static void ssl_build_server_config(
 
 grpc_credentials *grpc_ssl_credentials_create(
     const char *pem_root_certs, grpc_ssl_pem_key_cert_pair *pem_key_cert_pair) {
+  return grpc_ssl_credentials_create_with_session_cache(
+      pem_root_certs, pem_key_cert_pair, GRPC_SSL_DEFAULT_SESSION_CACHE_SIZE);
+}
+
+grpc_credentials *grpc_ssl_credentials_create_with_session_cache(
+    const char *pem_root_certs, grpc_ssl_pem_key_cert_pair *pem_key_cert_pair,
+    size_t session_cache_size) {
   grpc_ssl_credentials *c = gpr_malloc(sizeof(grpc_ssl_credentials));
   memset(c, 0, sizeof(grpc_ssl_credentials));
   c->base.type = GRPC_CREDENTIALS_TYPE_SSL;
   c->base.vtable = &ssl_vtable;
   gpr_ref_init(&c->base.refcount, 1);
   ssl_build_config(pem_root_certs, pem_key_cert_pair, &c->config);
+  if (session_cache_size > 0) {
+    c->config.session_cache = tsi_ssl_session_cache_create(session_cache_size);
+  }
   return &c->base;
 }
 
 grpc_server_credentials *grpc_ssl_server_credentials_create(
     const char *pem_root_certs, grpc_ssl_pem_key_cert_pair *pem_key_cert_pairs,
     size_t num_key_cert_pairs) {
-  grpc_ssl_server_credentials *c =
-      gpr_malloc(sizeof(grpc_ssl_server_credentials));
+  return grpc_ssl_server_credentials_create_with_ticket_rotation(
+      pem_root_certs, pem_key_cert_pairs, num_key_cert_pairs,
+      GRPC_SSL_DEFAULT_SESSION_TICKET_KEY_ROTATION_SECS);
+}
+
+grpc_server_credentials *grpc_ssl_server_credentials_create_with_ticket_rotation(
+    const char *pem_root_certs, grpc_ssl_pem_key_cert_pair *pem_key_cert_pairs,
+    size_t num_key_cert_pairs, int session_ticket_key_rotation_secs) {
+  grpc_ssl_server_credentials *c;
+  if (session_ticket_key_rotation_secs < 0) {
+    gpr_log(GPR_ERROR, "Invalid session ticket key rotation: %d.",
+            session_ticket_key_rotation_secs);
+    return NULL;
+  }
+  c = gpr_malloc(sizeof(grpc_ssl_server_credentials));
   memset(c, 0, sizeof(grpc_ssl_server_credentials));
   c->base.type = GRPC_CREDENTIALS_TYPE_SSL;
   c->base.vtable = &ssl_server_vtable;
   ssl_build_server_config(pem_root_certs, pem_key_cert_pairs,
                           num_key_cert_pairs, &c->config);
+  c->config.session_ticket_key_rotation_secs =
+      session_ticket_key_rotation_secs;
   return &c->base;
 }
 
 /* -- Jwt credentials -- */
 
+typedef struct {
+  grpc_mdelem *jwt_md;
+  /* Interned in the credentials' metadata context. */
+  grpc_mdstr *service_url;
+  gpr_timespec jwt_expiration;
+} grpc_jwt_cache_entry;
+
 typedef struct {
   grpc_credentials base;
   grpc_mdctx *md_ctx;
 
-  /* Have a simple cache for now with just 1 entry. We could have a map based on
-     the service_url for a more sophisticated one. */
+  /* Small fully associative cache keyed by interned service_url, so that
+     entries are found by pointer comparison. The lock only covers lookups and
+     insertions: jwts are signed outside of it. */
   gpr_mu cache_mu;
-  struct {
-    grpc_mdelem *jwt_md;
-    char *service_url;
-    gpr_timespec jwt_expiration;
-  } cached;
+  grpc_jwt_cache_entry cached[GRPC_JWT_CACHE_SIZE];
 
   grpc_auth_json_key key;
   gpr_timespec jwt_lifetime;
 } grpc_jwt_credentials;
 
+static void jwt_reset_cache_entry(grpc_jwt_cache_entry *entry) {
+  if (entry->jwt_md != NULL) {
+    grpc_mdelem_unref(entry->jwt_md);
+    entry->jwt_md = NULL;
+  }
+  if (entry->service_url != NULL) {
+    grpc_mdstr_unref(entry->service_url);
+    entry->service_url = NULL;
+  }
+  entry->jwt_expiration = gpr_inf_past;
+}
+
 static void jwt_reset_cache(grpc_jwt_credentials *c) {
-  if (c->cached.jwt_md != NULL) {
-    grpc_mdelem_unref(c->cached.jwt_md);
-    c->cached.jwt_md = NULL;
+  size_t i;
+  for (i = 0; i < GRPC_JWT_CACHE_SIZE; i++) {
+    jwt_reset_cache_entry(&c->cached[i]);
+  }
+}
+
+/* Returns the entry caching service_url, or NULL. Requires cache_mu. */
+static grpc_jwt_cache_entry *jwt_find_cache_entry(grpc_jwt_credentials *c,
+                                                  grpc_mdstr *service_url) {
+  size_t i;
+  for (i = 0; i < GRPC_JWT_CACHE_SIZE; i++) {
+    if (c->cached[i].service_url == service_url) return &c->cached[i];
   }
-  if (c->cached.service_url != NULL) {
-    gpr_free(c->cached.service_url);
-    c->cached.service_url = NULL;
+  return NULL;
+}
+
+/* Returns the entry to store a new jwt for service_url in: the one already
+   used for this url if any, else a free slot, else the entry which expires
+   first. Requires cache_mu. */
+static grpc_jwt_cache_entry *jwt_pick_cache_entry(grpc_jwt_credentials *c,
+                                                  grpc_mdstr *service_url) {
+  grpc_jwt_cache_entry *victim = jwt_find_cache_entry(c, service_url);
+  size_t i;
+  if (victim != NULL) return victim;
+  victim = &c->cached[0];
+  for (i = 0; i < GRPC_JWT_CACHE_SIZE; i++) {
+    grpc_jwt_cache_entry *entry = &c->cached[i];
+    if (entry->service_url == NULL) return entry;
+    if (gpr_time_cmp(entry->jwt_expiration, victim->jwt_expiration) < 0) {
+      victim = entry;
+    }
   }
-  c->cached.jwt_expiration = gpr_inf_past;
+  return victim;
 }
 
 static void jwt_destroy(grpc_credentials *creds) {
@@ -391,40 +457,43 @@ static void jwt_get_request_metadata(grpc_credentials *creds,
   grpc_jwt_credentials *c = (grpc_jwt_credentials *)creds;
   gpr_timespec refresh_threshold = {GRPC_SECURE_TOKEN_REFRESH_THRESHOLD_SECS,
                                     0};
+  grpc_mdstr *service_url_key = grpc_mdstr_from_string(c->md_ctx, service_url);
+  grpc_jwt_cache_entry *entry;
+  grpc_mdelem *jwt_md = NULL;
 
   /* See if we can return a cached jwt. */
-  grpc_mdelem *jwt_md = NULL;
-  {
-    gpr_mu_lock(&c->cache_mu);
-    if (c->cached.service_url != NULL &&
-        strcmp(c->cached.service_url, service_url) == 0 &&
-        c->cached.jwt_md != NULL &&
-        (gpr_time_cmp(gpr_time_sub(c->cached.jwt_expiration, gpr_now()),
-                      refresh_threshold) > 0)) {
-      jwt_md = grpc_mdelem_ref(c->cached.jwt_md);
-    }
-    gpr_mu_unlock(&c->cache_mu);
+  gpr_mu_lock(&c->cache_mu);
+  entry = jwt_find_cache_entry(c, service_url_key);
+  if (entry != NULL && entry->jwt_md != NULL &&
+      (gpr_time_cmp(gpr_time_sub(entry->jwt_expiration, gpr_now()),
+                    refresh_threshold) > 0)) {
+    jwt_md = grpc_mdelem_ref(entry->jwt_md);
   }
+  gpr_mu_unlock(&c->cache_mu);
 
   if (jwt_md == NULL) {
-    char *jwt = NULL;
-    /* Generate a new jwt. */
-    gpr_mu_lock(&c->cache_mu);
-    jwt_reset_cache(c);
-    jwt = grpc_jwt_encode_and_sign(&c->key, service_url, c->jwt_lifetime, NULL);
+    /* Generate a new jwt without holding the lock: concurrent misses on the
+       same url may sign twice, but lookups for other urls are not blocked. */
+    char *jwt =
+        grpc_jwt_encode_and_sign(&c->key, service_url, c->jwt_lifetime, NULL);
     if (jwt != NULL) {
       char *md_value;
+      gpr_timespec jwt_expiration = gpr_time_add(gpr_now(), c->jwt_lifetime);
       gpr_asprintf(&md_value, "Bearer %s", jwt);
       gpr_free(jwt);
-      c->cached.jwt_expiration = gpr_time_add(gpr_now(), c->jwt_lifetime);
-      c->cached.service_url = gpr_strdup(service_url);
-      c->cached.jwt_md = grpc_mdelem_from_strings(
+      jwt_md = grpc_mdelem_from_strings(
           c->md_ctx, GRPC_AUTHORIZATION_METADATA_KEY, md_value);
       gpr_free(md_value);
-      jwt_md = grpc_mdelem_ref(c->cached.jwt_md);
+      gpr_mu_lock(&c->cache_mu);
+      entry = jwt_pick_cache_entry(c, service_url_key);
+      jwt_reset_cache_entry(entry);
+      entry->jwt_md = grpc_mdelem_ref(jwt_md);
+      entry->service_url = grpc_mdstr_ref(service_url_key);
+      entry->jwt_expiration = jwt_expiration;
+      gpr_mu_unlock(&c->cache_mu);
     }
-    gpr_mu_unlock(&c->cache_mu);
   }
+  grpc_mdstr_unref(service_url_key);
 
   if (jwt_md != NULL) {
     cb(user_data, &jwt_md, 1, GRPC_CREDENTIALS_OK);
@@ -473,6 +542,13 @@ typedef void (*grpc_fetch_oauth2_func)(grpc_credentials_metadata_request *req,
                                        grpc_httpcli_response_cb response_cb,
                                        gpr_timespec deadline);
 
+/* A request for metadata waiting on a token fetch. */
+typedef struct grpc_oauth2_pending_request {
+  grpc_credentials_metadata_cb cb;
+  void *user_data;
+  struct grpc_oauth2_pending_request *next;
+} grpc_oauth2_pending_request;
+
 typedef struct {
   grpc_credentials base;
   gpr_mu mu;
@@ -480,11 +556,17 @@ typedef struct {
   grpc_mdelem *access_token_md;
   gpr_timespec token_expiration;
   grpc_fetch_oauth2_func fetch_func;
+  /* At most one fetch is outstanding at a time: requests that arrive while
+     it is in flight wait for its result instead of starting their own. */
+  int fetch_in_flight;
+  grpc_oauth2_pending_request *pending_requests;
 } grpc_oauth2_token_fetcher_credentials;
 
 static void oauth2_token_fetcher_destroy(grpc_credentials *creds) {
   grpc_oauth2_token_fetcher_credentials *c =
       (grpc_oauth2_token_fetcher_credentials *)creds;
+  /* an in-flight fetch holds a ref, so there can be no one waiting */
+  GPR_ASSERT(c->pending_requests == NULL);
   if (c->access_token_md != NULL) {
     grpc_mdelem_unref(c->access_token_md);
   }
@@ -597,20 +679,39 @@ static void on_oauth2_token_fetcher_http_response(
       (grpc_credentials_metadata_request *)user_data;
   grpc_oauth2_token_fetcher_credentials *c =
       (grpc_oauth2_token_fetcher_credentials *)r->creds;
+  grpc_mdelem *new_access_token_md = NULL;
   gpr_timespec token_lifetime;
   grpc_credentials_status status;
+  grpc_oauth2_pending_request *pending;
+  grpc_oauth2_pending_request *next;
 
-  gpr_mu_lock(&c->mu);
   status = grpc_oauth2_token_fetcher_credentials_parse_server_response(
-      response, c->md_ctx, &c->access_token_md, &token_lifetime);
+      response, c->md_ctx, &new_access_token_md, &token_lifetime);
+
+  gpr_mu_lock(&c->mu);
   if (status == GRPC_CREDENTIALS_OK) {
+    if (c->access_token_md != NULL) grpc_mdelem_unref(c->access_token_md);
+    c->access_token_md = grpc_mdelem_ref(new_access_token_md);
     c->token_expiration = gpr_time_add(gpr_now(), token_lifetime);
-    r->cb(r->user_data, &c->access_token_md, 1, status);
-  } else {
-    c->token_expiration = gpr_inf_past;
-    r->cb(r->user_data, NULL, 0, status);
   }
+  /* on failure, keep any previous token: if this was a refresh ahead of
+     expiry, it is still good for a while */
+  c->fetch_in_flight = 0;
+  pending = c->pending_requests;
+  c->pending_requests = NULL;
   gpr_mu_unlock(&c->mu);
+
+  /* release everyone who was waiting on this fetch together */
+  for (; pending != NULL; pending = next) {
+    next = pending->next;
+    if (status == GRPC_CREDENTIALS_OK) {
+      pending->cb(pending->user_data, &new_access_token_md, 1, status);
+    } else {
+      pending->cb(pending->user_data, NULL, 0, status);
+    }
+    gpr_free(pending);
+  }
+  if (new_access_token_md != NULL) grpc_mdelem_unref(new_access_token_md);
   grpc_credentials_metadata_request_destroy(r);
 }
 
@@ -621,22 +722,45 @@ static void oauth2_token_fetcher_get_request_metadata(
       (grpc_oauth2_token_fetcher_credentials *)creds;
   gpr_timespec refresh_threshold = {GRPC_SECURE_TOKEN_REFRESH_THRESHOLD_SECS,
                                     0};
+  gpr_timespec proactive_refresh_threshold = {
+      GRPC_SECURE_TOKEN_PROACTIVE_REFRESH_SECS, 0};
   grpc_mdelem *cached_access_token_md = NULL;
+  int start_fetch = 0;
   {
+    gpr_timespec time_left;
     gpr_mu_lock(&c->mu);
+    time_left = gpr_time_sub(c->token_expiration, gpr_now());
     if (c->access_token_md != NULL &&
-        (gpr_time_cmp(gpr_time_sub(c->token_expiration, gpr_now()),
-                      refresh_threshold) > 0)) {
+        gpr_time_cmp(time_left, refresh_threshold) > 0) {
       cached_access_token_md = grpc_mdelem_ref(c->access_token_md);
+      /* close to expiring: get a new token in the background, so that no
+         request ever has to wait for one */
+      if (gpr_time_cmp(time_left, proactive_refresh_threshold) <= 0 &&
+          !c->fetch_in_flight) {
+        c->fetch_in_flight = 1;
+        start_fetch = 1;
+      }
+    } else {
+      grpc_oauth2_pending_request *pending =
+          gpr_malloc(sizeof(grpc_oauth2_pending_request));
+      pending->cb = cb;
+      pending->user_data = user_data;
+      pending->next = c->pending_requests;
+      c->pending_requests = pending;
+      if (!c->fetch_in_flight) {
+        c->fetch_in_flight = 1;
+        start_fetch = 1;
+      }
     }
     gpr_mu_unlock(&c->mu);
   }
   if (cached_access_token_md != NULL) {
     cb(user_data, &cached_access_token_md, 1, GRPC_CREDENTIALS_OK);
     grpc_mdelem_unref(cached_access_token_md);
-  } else {
+  }
+  if (start_fetch) {
     c->fetch_func(
-        grpc_credentials_metadata_request_create(creds, cb, user_data),
+        grpc_credentials_metadata_request_create(creds, NULL, NULL),
         on_oauth2_token_fetcher_http_response,
         gpr_time_add(gpr_now(), refresh_threshold));
   }
@@ -67,6 +67,15 @@ typedef enum {
   "application_default_credentials.json"
 
 #define GRPC_SECURE_TOKEN_REFRESH_THRESHOLD_SECS 60
+/* Once a cached oauth2 token is this close to expiring, requests are still
+   served from the cache but a new token is fetched in the background. */
+#define GRPC_SECURE_TOKEN_PROACTIVE_REFRESH_SECS 300
+
+/* Number of service urls for which jwt credentials keep a signed jwt around.
+   Clients that reach several services through the same credentials would
+   otherwise re-sign a jwt (an RSA signature) every time the service changes.
+   When full, the entry which expires first is evicted. */
+#define GRPC_JWT_CACHE_SIZE 8
 
 #define GRPC_COMPUTE_ENGINE_METADATA_HOST "metadata"
 #define GRPC_COMPUTE_ENGINE_METADATA_TOKEN_PATH \
@@ -0,0 +1,361 @@
+/*
+ *
+ * Copyright 2015, Google Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer
+ * in the documentation and/or other materials provided with the
+ * distribution.
+ *     * Neither the name of Google Inc. nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+
+#include "src/core/security/handshake_pool.h"
+
+#include <string.h>
+
+#include "src/core/iomgr/alarm.h"
+#include "src/core/iomgr/iomgr.h"
+#include "src/core/iomgr/iomgr_internal.h"
+#include <grpc/grpc_security.h>
+#include <grpc/support/alloc.h>
+#include <grpc/support/cpu.h>
+#include <grpc/support/log.h>
+#include <grpc/support/sync.h>
+#include <grpc/support/thd.h>
+
+/* A handshake step waiting for a thread */
+typedef struct step {
+  grpc_handshake_pool_cb run;
+  grpc_handshake_pool_cb done;
+  void *arg;
+  gpr_timespec queued_at;
+  struct step *next;
+} step;
+
+/* A handshake waiting for the number in progress to drop below the limit */
+typedef struct waiter {
+  grpc_handshake_pool_start_cb start;
+  void *arg;
+  gpr_timespec queued_at;
+  /* fails the handshake once it has waited for too long */
+  grpc_alarm alarm;
+  /* one for the alarm callback, one for calling start */
+  gpr_refcount refs;
+  /* whether the handshake may start: only read once it left the queue */
+  int admitted;
+  struct waiter *next;
+} waiter;
+
+/* the state below is reset by grpc_handshake_pool_init, g_mu lives on across
+   grpc_init/grpc_shutdown cycles */
+static gpr_once g_once = GPR_ONCE_INIT;
+static gpr_mu g_mu;
+static int g_shutdown;
+/* queued steps and waiting handshakes, oldest first */
+static step *g_steps_head;
+static step *g_steps_tail;
+static waiter *g_waiters_head;
+static waiter *g_waiters_tail;
+static size_t g_threads;
+static size_t g_max_threads;
+/* the limit only applies to server handshakes */
+static size_t g_server_in_progress;
+static size_t g_max_in_progress;
+static size_t g_max_waiting;
+static gpr_timespec g_max_wait_time;
+static grpc_handshake_offload_stats g_stats;
+
+static void init_mu(void) { gpr_mu_init(&g_mu); }
+
+void grpc_handshake_pool_init(void) {
+  gpr_once_init(&g_once, init_mu);
+  gpr_mu_lock(&g_mu);
+  g_shutdown = 0;
+  g_steps_head = g_steps_tail = NULL;
+  g_waiters_head = g_waiters_tail = NULL;
+  g_threads = 0;
+  g_server_in_progress = 0;
+  g_max_threads = GRPC_DEFAULT_HANDSHAKE_THREADS;
+  g_max_in_progress = GRPC_DEFAULT_MAX_CONCURRENT_HANDSHAKES;
+  g_max_waiting = GRPC_DEFAULT_MAX_WAITING_HANDSHAKES;
+  g_max_wait_time =
+      gpr_time_from_millis(GRPC_DEFAULT_MAX_HANDSHAKE_WAIT_TIME_MS);
+  memset(&g_stats, 0, sizeof(g_stats));
+  g_stats.total_wait_time = gpr_time_0;
+  g_stats.total_queue_time = gpr_time_0;
+  g_stats.total_handshake_time = gpr_time_0;
+  gpr_mu_unlock(&g_mu);
+}
+
+static int has_room_locked(void) {
+  return g_max_in_progress == 0 || g_server_in_progress < g_max_in_progress;
+}
+
+static void unref_waiter(waiter *w) {
+  if (gpr_unref(&w->refs)) gpr_free(w);
+}
+
+/* Takes w out of the queue: returns 0 if it already left it. Call with g_mu
+   held. */
+static int remove_waiter_locked(waiter *w) {
+  waiter **prev;
+  waiter *last = NULL;
+  for (prev = &g_waiters_head; *prev != NULL; prev = &(*prev)->next) {
+    if (*prev == w) {
+      *prev = w->next;
+      if (g_waiters_tail == w) g_waiters_tail = last;
+      w->next = NULL;
+      g_stats.handshakes_waiting--;
+      return 1;
+    }
+    last = *prev;
+  }
+  return 0;
+}
+
+/* run from the iomgr callback queue for waiters that left the queue, with no
+   lock held */
+static void finish_waiter(void *arg, int success) {
+  waiter *w = arg;
+  grpc_alarm_cancel(&w->alarm);
+  w->start(w->arg, w->admitted);
+  unref_waiter(w);
+}
+
+static void on_waiter_alarm(void *arg, int success) {
+  waiter *w = arg;
+  int expired = 0;
+  if (success) {
+    gpr_mu_lock(&g_mu);
+    expired = remove_waiter_locked(w);
+    if (expired) g_stats.handshakes_rejected++;
+    gpr_mu_unlock(&g_mu);
+  }
+  if (expired) {
+    gpr_log(GPR_ERROR, "Handshake waited too long to start.");
+    w->admitted = 0;
+    /* the alarm has fired: no need to go through finish_waiter */
+    w->start(w->arg, 0);
+    unref_waiter(w);
+  }
+  unref_waiter(w);
+}
+
+/* Start as many waiting handshakes as the limit allows. Call with g_mu
+   held. */
+static void admit_waiters_locked(gpr_timespec now) {
+  waiter *w;
+  while ((w = g_waiters_head) != NULL && has_room_locked()) {
+    remove_waiter_locked(w);
+    g_stats.handshakes_in_progress++;
+    g_server_in_progress++;
+    g_stats.total_wait_time = gpr_time_add(g_stats.total_wait_time,
+                                           gpr_time_sub(now, w->queued_at));
+    w->admitted = 1;
+    grpc_iomgr_add_callback(finish_waiter, w);
+  }
+}
+
+static void deliver_step_done(void *arg, int success) {
+  step *s = arg;
+  s->done(s->arg);
+  gpr_free(s);
+}
+
+/* Worker thread: runs queued steps until there are none left, then exits.
+   Holds an iomgr ref for its whole lifetime so that shutdown waits for it. */
+static void worker(void *ignored) {
+  step *s;
+  gpr_mu_lock(&g_mu);
+  while ((s = g_steps_head) != NULL) {
+    g_steps_head = s->next;
+    if (g_steps_head == NULL) g_steps_tail = NULL;
+    g_stats.steps_queued--;
+    g_stats.total_queue_time = gpr_time_add(
+        g_stats.total_queue_time, gpr_time_sub(gpr_now(), s->queued_at));
+    gpr_mu_unlock(&g_mu);
+
+    s->run(s->arg);
+    grpc_iomgr_add_callback(deliver_step_done, s);
+
+    gpr_mu_lock(&g_mu);
+  }
+  g_threads--;
+  gpr_mu_unlock(&g_mu);
+  grpc_iomgr_unref();
+}
+
+int grpc_handshake_pool_enabled(const grpc_channel_args *args) {
+  size_t i;
+  if (args == NULL) return 0;
+  for (i = 0; i < args->num_args; i++) {
+    if (0 == strcmp(args->args[i].key, GRPC_ARG_OFFLOAD_HANDSHAKES)) {
+      if (args->args[i].type != GRPC_ARG_INTEGER) {
+        gpr_log(GPR_ERROR, "%s ignored: it must be an integer",
+                GRPC_ARG_OFFLOAD_HANDSHAKES);
+        return 0;
+      }
+      return args->args[i].value.integer != 0;
+    }
+  }
+  return 0;
+}
+
+void grpc_handshake_pool_begin(int is_client,
+                               grpc_handshake_pool_start_cb start, void *arg) {
+  waiter *w;
+  gpr_timespec now;
+  gpr_mu_lock(&g_mu);
+  if (g_shutdown) {
+    g_stats.handshakes_rejected++;
+    gpr_mu_unlock(&g_mu);
+    start(arg, 0);
+    return;
+  }
+  if (is_client || has_room_locked()) {
+    g_stats.handshakes_in_progress++;
+    if (!is_client) g_server_in_progress++;
+    gpr_mu_unlock(&g_mu);
+    start(arg, 1);
+    return;
+  }
+  if (g_stats.handshakes_waiting >= g_max_waiting) {
+    g_stats.handshakes_rejected++;
+    gpr_mu_unlock(&g_mu);
+    gpr_log(GPR_ERROR, "Too many handshakes waiting to start.");
+    start(arg, 0);
+    return;
+  }
+  now = gpr_now();
+  w = gpr_malloc(sizeof(waiter));
+  w->start = start;
+  w->arg = arg;
+  w->queued_at = now;
+  gpr_ref_init(&w->refs, 2);
+  w->admitted = 0;
+  w->next = NULL;
+  if (g_waiters_tail) {
+    g_waiters_tail->next = w;
+  } else {
+    g_waiters_head = w;
+  }
+  g_waiters_tail = w;
+  g_stats.handshakes_waiting++;
+  grpc_alarm_init(&w->alarm, gpr_time_add(now, g_max_wait_time),
+                  on_waiter_alarm, w, now);
+  gpr_mu_unlock(&g_mu);
+}
+
+void grpc_handshake_pool_end(int is_client, gpr_timespec start_time,
+                             int success) {
+  gpr_timespec now = gpr_now();
+  gpr_mu_lock(&g_mu);
+  GPR_ASSERT(g_stats.handshakes_in_progress > 0);
+  g_stats.handshakes_in_progress--;
+  if (!is_client) {
+    GPR_ASSERT(g_server_in_progress > 0);
+    g_server_in_progress--;
+  }
+  if (success) {
+    g_stats.handshakes_succeeded++;
+  } else {
+    g_stats.handshakes_failed++;
+  }
+  g_stats.total_handshake_time = gpr_time_add(g_stats.total_handshake_time,
+                                              gpr_time_sub(now, start_time));
+  admit_waiters_locked(now);
+  gpr_mu_unlock(&g_mu);
+}
+
+void grpc_handshake_pool_run(grpc_handshake_pool_cb run,
+                             grpc_handshake_pool_cb done, void *arg) {
+  step *s = gpr_malloc(sizeof(step));
+  int spawn_worker = 0;
+  gpr_thd_id id;
+
+  s->run = run;
+  s->done = done;
+  s->arg = arg;
+  s->queued_at = gpr_now();
+  s->next = NULL;
+
+  gpr_mu_lock(&g_mu);
+  if (g_steps_tail) {
+    g_steps_tail->next = s;
+  } else {
+    g_steps_head = s;
+  }
+  g_steps_tail = s;
+  if (++g_stats.steps_queued > g_stats.max_steps_queued) {
+    g_stats.max_steps_queued = g_stats.steps_queued;
+  }
+  if (g_threads < (g_max_threads ? g_max_threads : gpr_cpu_num_cores())) {
+    g_threads++;
+    spawn_worker = 1;
+  }
+  gpr_mu_unlock(&g_mu);
+
+  if (spawn_worker) {
+    grpc_iomgr_ref();
+    gpr_thd_new(&id, worker, NULL, NULL);
+  }
+}
+
+void grpc_handshake_pool_shutdown(void) {
+  waiter *w;
+  gpr_mu_lock(&g_mu);
+  g_shutdown = 1;
+  while ((w = g_waiters_head) != NULL) {
+    remove_waiter_locked(w);
+    g_stats.handshakes_rejected++;
+    grpc_iomgr_add_callback(finish_waiter, w);
+  }
+  gpr_mu_unlock(&g_mu);
+}
+
+void grpc_set_handshake_offload_limits(size_t max_threads,
+                                       size_t max_concurrent_handshakes) {
+  gpr_mu_lock(&g_mu);
+  g_max_threads = max_threads;
+  g_max_in_progress = max_concurrent_handshakes;
+  admit_waiters_locked(gpr_now());
+  gpr_mu_unlock(&g_mu);
+}
+
+void grpc_set_handshake_offload_queue_limits(size_t max_waiting_handshakes,
+                                             gpr_timespec max_wait_time) {
+  gpr_mu_lock(&g_mu);
+  g_max_waiting = max_waiting_handshakes;
+  g_max_wait_time = max_wait_time;
+  gpr_mu_unlock(&g_mu);
+}
+
+void grpc_get_handshake_offload_stats(grpc_handshake_offload_stats *stats) {
+  gpr_once_init(&g_once, init_mu);
+  gpr_mu_lock(&g_mu);
+  *stats = g_stats;
+  gpr_mu_unlock(&g_mu);
+}
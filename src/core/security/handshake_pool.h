@@ -0,0 +1,82 @@
+/*
+ *
+ * Copyright 2015, Google Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer
+ * in the documentation and/or other materials provided with the
+ * distribution.
+ *     * Neither the name of Google Inc. nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+
+#ifndef GRPC_INTERNAL_CORE_SECURITY_HANDSHAKE_POOL_H
+#define GRPC_INTERNAL_CORE_SECURITY_HANDSHAKE_POOL_H
+
+#include <grpc/grpc.h>
+#include <grpc/support/time.h>
+
+/* --- Handshake pool. ---
+
+   Process-wide pool of threads running the CPU intensive steps of security
+   handshakes, see GRPC_ARG_OFFLOAD_HANDSHAKES. Threads are started on demand,
+   up to the configured limit, and exit once there is no step left to run.
+   The pool lives from grpc_init to grpc_shutdown. */
+
+typedef void (*grpc_handshake_pool_cb)(void *arg);
+/* success is zero if the handshake must fail without starting */
+typedef void (*grpc_handshake_pool_start_cb)(void *arg, int success);
+
+/* Resets the pool, from grpc_init. */
+void grpc_handshake_pool_init(void);
+
+/* Fails the waiting handshakes and any handshake beginning from now on, from
+   grpc_shutdown before iomgr shuts down (which waits for the threads). */
+void grpc_handshake_pool_shutdown(void);
+
+/* Returns non zero if args ask for handshakes to be offloaded. */
+int grpc_handshake_pool_enabled(const grpc_channel_args *args);
+
+/* Calls start(arg, 1) once fewer than the maximum number of server
+   handshakes are in progress: inline if there is room already or for client
+   handshakes, later from the iomgr callback queue otherwise. Calls
+   start(arg, 0) instead if too many handshakes are waiting already, if the
+   handshake waits for longer than the configured limit or if the pool shuts
+   down. Every started handshake (but not the failed ones) must be ended with
+   grpc_handshake_pool_end. */
+void grpc_handshake_pool_begin(int is_client,
+                               grpc_handshake_pool_start_cb start, void *arg);
+
+/* Ends a handshake started at start_time (the time its start callback was
+   called) and lets a waiting one start. */
+void grpc_handshake_pool_end(int is_client, gpr_timespec start_time,
+                             int success);
+
+/* Runs step(arg) on a handshake thread, then done(arg) from the iomgr
+   callback queue. */
+void grpc_handshake_pool_run(grpc_handshake_pool_cb step,
+                             grpc_handshake_pool_cb done, void *arg);
+
+#endif  /* GRPC_INTERNAL_CORE_SECURITY_HANDSHAKE_POOL_H */
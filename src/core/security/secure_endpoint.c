@@ -38,6 +38,7 @@
 #include <grpc/support/slice_buffer.h>
 #include <grpc/support/slice.h>
 #include <grpc/support/sync.h>
+#include <grpc/support/useful.h>
 #include "src/core/tsi/transport_security_interface.h"
 #include "src/core/debug/trace.h"
 
@@ -48,6 +49,9 @@ typedef struct {
   grpc_endpoint *wrapped_ep;
   struct tsi_frame_protector *protector;
   gpr_mu protector_mu;
+  /* whether the protector works on slices directly, in which case the
+     staging buffers are not used. */
+  int use_slices;
   /* saved upper level callbacks and user_data. */
   grpc_endpoint_read_cb read_cb;
   void *read_user_data;
@@ -62,6 +66,14 @@ typedef struct {
   gpr_slice write_staging_buffer;
   gpr_slice_buffer output_buffer;
 
+  /* slices handed to the protector when use_slices is set. */
+  gpr_slice_buffer protected_read_buffer;
+  gpr_slice_buffer plaintext_write_buffer;
+
+  /* protected by protector_mu: whether wrapped_ep has been shut down, either
+     by the upper level or after a protection error */
+  int shut_down;
+
   gpr_refcount ref;
 } secure_endpoint;
 
@@ -78,6 +90,8 @@ static void destroy(secure_endpoint *secure_ep) {
   gpr_slice_buffer_destroy(&ep->input_buffer);
   gpr_slice_unref(ep->write_staging_buffer);
   gpr_slice_buffer_destroy(&ep->output_buffer);
+  gpr_slice_buffer_destroy(&ep->protected_read_buffer);
+  gpr_slice_buffer_destroy(&ep->plaintext_write_buffer);
   gpr_mu_destroy(&ep->protector_mu);
   gpr_free(ep);
 }
@@ -88,6 +102,35 @@ static void secure_endpoint_unref(secure_endpoint *ep) {
   }
 }
 
+/* Shuts down the wrapped endpoint unless it already was. */
+static void shutdown_wrapped_endpoint(secure_endpoint *ep) {
+  int was_shut_down;
+  gpr_mu_lock(&ep->protector_mu);
+  was_shut_down = ep->shut_down;
+  ep->shut_down = 1;
+  gpr_mu_unlock(&ep->protector_mu);
+  if (!was_shut_down) grpc_endpoint_shutdown(ep->wrapped_ep);
+}
+
+/* Makes sure *staging_buffer has room for size bytes so that a whole batch of
+   slices is (un)protected into a single allocation. The unused tail of the
+   staging buffer is kept for the next batch. */
+static void reserve_staging_buffer(gpr_slice *staging_buffer, size_t size) {
+  if (GPR_SLICE_LENGTH(*staging_buffer) >= size) return;
+  gpr_slice_unref(*staging_buffer);
+  *staging_buffer = gpr_slice_malloc(GPR_MAX(size, STAGING_BUFFER_SIZE));
+}
+
+/* Returns the total length of slices. */
+static size_t slices_length(gpr_slice *slices, size_t nslices) {
+  size_t i;
+  size_t length = 0;
+  for (i = 0; i < nslices; i++) {
+    length += GPR_SLICE_LENGTH(slices[i]);
+  }
+  return length;
+}
+
 static void flush_read_staging_buffer(secure_endpoint *ep, gpr_uint8 **cur,
                                       gpr_uint8 **end) {
   gpr_slice_buffer_add(&ep->input_buffer, ep->read_staging_buffer);
@@ -112,6 +155,21 @@ static void call_read_cb(secure_endpoint *ep, gpr_slice *slices, size_t nslices,
   secure_endpoint_unref(ep);
 }
 
+/* Unprotects slices straight into input_buffer. Takes ownership of slices. */
+static tsi_result unprotect_slices(secure_endpoint *ep, gpr_slice *slices,
+                                   size_t nslices) {
+  tsi_result result;
+  gpr_slice_buffer_addn(&ep->protected_read_buffer, slices, nslices);
+  gpr_mu_lock(&ep->protector_mu);
+  result = tsi_frame_protector_unprotect_slices(
+      ep->protector, &ep->protected_read_buffer, &ep->input_buffer);
+  gpr_mu_unlock(&ep->protector_mu);
+  if (result != TSI_OK) {
+    gpr_log(GPR_ERROR, "Decryption error: %s", tsi_result_to_string(result));
+  }
+  return result;
+}
+
 static void on_read(void *user_data, gpr_slice *slices, size_t nslices,
                     grpc_endpoint_cb_status error) {
   unsigned i;
@@ -119,10 +177,23 @@ static void on_read(void *user_data, gpr_slice *slices, size_t nslices,
   int input_buffer_count = 0;
   tsi_result result = TSI_OK;
   secure_endpoint *ep = (secure_endpoint *)user_data;
-  gpr_uint8 *cur = GPR_SLICE_START_PTR(ep->read_staging_buffer);
-  gpr_uint8 *end = GPR_SLICE_END_PTR(ep->read_staging_buffer);
+  gpr_uint8 *cur;
+  gpr_uint8 *end;
+
+  if (ep->use_slices) {
+    result = unprotect_slices(ep, slices, nslices);
+    /* The protector now owns the slices. */
+    nslices = 0;
+  } else {
+    /* Unprotected data is never larger than the protected data it comes from,
+       bar what the protector buffered from previous reads. */
+    reserve_staging_buffer(&ep->read_staging_buffer,
+                           slices_length(slices, nslices));
+  }
+  cur = GPR_SLICE_START_PTR(ep->read_staging_buffer);
+  end = GPR_SLICE_END_PTR(ep->read_staging_buffer);
 
-  /* TODO(yangg) check error, maybe bail out early */
+  if (nslices > 0) gpr_mu_lock(&ep->protector_mu);
   for (i = 0; i < nslices; i++) {
     gpr_slice encrypted = slices[i];
     gpr_uint8 *message_bytes = GPR_SLICE_START_PTR(encrypted);
@@ -131,11 +202,9 @@ static void on_read(void *user_data, gpr_slice *slices, size_t nslices,
     while (message_size > 0 || keep_looping) {
       size_t unprotected_buffer_size_written = end - cur;
       size_t processed_message_size = message_size;
-      gpr_mu_lock(&ep->protector_mu);
       result = tsi_frame_protector_unprotect(ep->protector, message_bytes,
                                              &processed_message_size, cur,
                                              &unprotected_buffer_size_written);
-      gpr_mu_unlock(&ep->protector_mu);
       if (result != TSI_OK) {
         gpr_log(GPR_ERROR, "Decryption error: %s",
                 tsi_result_to_string(result));
@@ -160,6 +229,7 @@ static void on_read(void *user_data, gpr_slice *slices, size_t nslices,
     }
     if (result != TSI_OK) break;
   }
+  if (nslices > 0) gpr_mu_unlock(&ep->protector_mu);
 
   if (cur != GPR_SLICE_START_PTR(ep->read_staging_buffer)) {
     gpr_slice_buffer_add(
@@ -176,7 +246,10 @@ static void on_read(void *user_data, gpr_slice *slices, size_t nslices,
   }
 
   if (result != TSI_OK) {
+    /* The protector cannot be trusted with more data: fail the read and stop
+       the connection. */
     gpr_slice_buffer_reset_and_unref(&ep->input_buffer);
+    shutdown_wrapped_endpoint(ep);
     call_read_cb(ep, NULL, 0, GRPC_ENDPOINT_CB_ERROR);
     return;
   }
@@ -228,8 +301,8 @@ static grpc_endpoint_write_status endpoint_write(grpc_endpoint *secure_ep,
   int output_buffer_count = 0;
   tsi_result result = TSI_OK;
   secure_endpoint *ep = (secure_endpoint *)secure_ep;
-  gpr_uint8 *cur = GPR_SLICE_START_PTR(ep->write_staging_buffer);
-  gpr_uint8 *end = GPR_SLICE_END_PTR(ep->write_staging_buffer);
+  gpr_uint8 *cur;
+  gpr_uint8 *end;
   grpc_endpoint_write_status status;
   GPR_ASSERT(ep->output_buffer.count == 0);
 
@@ -243,6 +316,26 @@ static grpc_endpoint_write_status endpoint_write(grpc_endpoint *secure_ep,
     }
   }
 
+  if (ep->use_slices) {
+    gpr_slice_buffer_addn(&ep->plaintext_write_buffer, slices, nslices);
+    gpr_mu_lock(&ep->protector_mu);
+    result = tsi_frame_protector_protect_slices(
+        ep->protector, &ep->plaintext_write_buffer, &ep->output_buffer);
+    gpr_mu_unlock(&ep->protector_mu);
+    if (result != TSI_OK) {
+      gpr_log(GPR_ERROR, "Encryption error: %s", tsi_result_to_string(result));
+    }
+    /* The protector consumed the slices. */
+    nslices = 0;
+  } else {
+    /* Frame overheads that do not fit go to an extra staging buffer. */
+    reserve_staging_buffer(&ep->write_staging_buffer,
+                           slices_length(slices, nslices));
+    gpr_mu_lock(&ep->protector_mu);
+  }
+  cur = GPR_SLICE_START_PTR(ep->write_staging_buffer);
+  end = GPR_SLICE_END_PTR(ep->write_staging_buffer);
+
   for (i = 0; i < nslices; i++) {
     gpr_slice plain = slices[i];
     gpr_uint8 *message_bytes = GPR_SLICE_START_PTR(plain);
@@ -250,11 +343,9 @@ static grpc_endpoint_write_status endpoint_write(grpc_endpoint *secure_ep,
     while (message_size > 0) {
       size_t protected_buffer_size_to_send = end - cur;
       size_t processed_message_size = message_size;
-      gpr_mu_lock(&ep->protector_mu);
       result = tsi_frame_protector_protect(ep->protector, message_bytes,
                                            &processed_message_size, cur,
                                            &protected_buffer_size_to_send);
-      gpr_mu_unlock(&ep->protector_mu);
       if (result != TSI_OK) {
         gpr_log(GPR_ERROR, "Encryption error: %s",
                 tsi_result_to_string(result));
@@ -270,15 +361,13 @@ static grpc_endpoint_write_status endpoint_write(grpc_endpoint *secure_ep,
     }
     if (result != TSI_OK) break;
   }
-  if (result == TSI_OK) {
+  if (result == TSI_OK && !ep->use_slices) {
     size_t still_pending_size;
     do {
       size_t protected_buffer_size_to_send = end - cur;
-      gpr_mu_lock(&ep->protector_mu);
       result = tsi_frame_protector_protect_flush(ep->protector, cur,
                                                  &protected_buffer_size_to_send,
                                                  &still_pending_size);
-      gpr_mu_unlock(&ep->protector_mu);
       if (result != TSI_OK) break;
       cur += protected_buffer_size_to_send;
       if (cur == end) {
@@ -293,14 +382,17 @@ static grpc_endpoint_write_status endpoint_write(grpc_endpoint *secure_ep,
               cur - GPR_SLICE_START_PTR(ep->write_staging_buffer)));
     }
   }
+  if (!ep->use_slices) gpr_mu_unlock(&ep->protector_mu);
 
   for (i = 0; i < nslices; i++) {
     gpr_slice_unref(slices[i]);
   }
 
   if (result != TSI_OK) {
-    /* TODO(yangg) do different things according to the error type? */
+    /* The protector cannot be trusted with more data: fail the write and stop
+       the connection. */
     gpr_slice_buffer_reset_and_unref(&ep->output_buffer);
+    shutdown_wrapped_endpoint(ep);
     return GRPC_ENDPOINT_WRITE_ERROR;
   }
 
@@ -321,7 +413,7 @@ static grpc_endpoint_write_status endpoint_write(grpc_endpoint *secure_ep,
 
 static void endpoint_shutdown(grpc_endpoint *secure_ep) {
   secure_endpoint *ep = (secure_endpoint *)secure_ep;
-  grpc_endpoint_shutdown(ep->wrapped_ep);
+  shutdown_wrapped_endpoint(ep);
 }
 
 static void endpoint_unref(grpc_endpoint *secure_ep) {
@@ -347,6 +439,7 @@ grpc_endpoint *grpc_secure_endpoint_create(
   ep->base.vtable = &vtable;
   ep->wrapped_ep = transport;
   ep->protector = protector;
+  ep->use_slices = tsi_frame_protector_supports_slices(protector);
   gpr_slice_buffer_init(&ep->leftover_bytes);
   for (i = 0; i < leftover_nslices; i++) {
     gpr_slice_buffer_add(&ep->leftover_bytes,
@@ -356,7 +449,10 @@ grpc_endpoint *grpc_secure_endpoint_create(
   ep->read_staging_buffer = gpr_slice_malloc(STAGING_BUFFER_SIZE);
   gpr_slice_buffer_init(&ep->input_buffer);
   gpr_slice_buffer_init(&ep->output_buffer);
+  gpr_slice_buffer_init(&ep->protected_read_buffer);
+  gpr_slice_buffer_init(&ep->plaintext_write_buffer);
   gpr_mu_init(&ep->protector_mu);
+  ep->shut_down = 0;
   gpr_ref_init(&ep->ref, 1);
   return &ep->base;
 }
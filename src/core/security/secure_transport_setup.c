@@ -35,6 +35,7 @@
 
 #include <string.h>
 
+#include "src/core/security/handshake_pool.h"
 #include "src/core/security/secure_endpoint.h"
 #include <grpc/support/alloc.h>
 #include <grpc/support/log.h>
@@ -51,6 +52,18 @@ typedef struct {
   gpr_slice_buffer left_overs;
   grpc_secure_transport_setup_done_cb cb;
   void *user_data;
+  /* Set when the handshake steps run on the handshake pool. */
+  int offload;
+  gpr_timespec start_time;
+  grpc_security_status create_handshaker_status;
+  /* Handshake data received from the peer and the outcome of processing it:
+     the handshaker stopped in slices[processed_slices], after
+     consumed_slice_size bytes. */
+  gpr_slice *slices;
+  size_t nslices;
+  tsi_result process_result;
+  size_t processed_slices;
+  size_t consumed_slice_size;
 } grpc_secure_transport_setup;
 
 static void on_handshake_data_received_from_peer(void *setup, gpr_slice *slices,
@@ -71,6 +84,10 @@ static void secure_transport_setup_done(grpc_secure_transport_setup *s,
     }
     s->cb(s->user_data, GRPC_SECURITY_ERROR, NULL);
   }
+  if (s->offload) {
+    grpc_handshake_pool_end(s->connector->is_client_side, s->start_time,
+                            is_success);
+  }
   if (s->handshaker != NULL) tsi_handshaker_destroy(s->handshaker);
   if (s->handshake_buffer != NULL) gpr_free(s->handshake_buffer);
   gpr_slice_buffer_destroy(&s->left_overs);
@@ -169,22 +186,13 @@ static void cleanup_slices(gpr_slice *slices, size_t num_slices) {
   }
 }
 
-static void on_handshake_data_received_from_peer(
-    void *setup, gpr_slice *slices, size_t nslices,
-    grpc_endpoint_cb_status error) {
-  grpc_secure_transport_setup *s = setup;
+/* Feeds the received handshake data to the handshaker. This is where most of
+   the handshake crypto happens. */
+static void process_handshake_data(grpc_secure_transport_setup *s,
+                                   gpr_slice *slices, size_t nslices) {
   size_t consumed_slice_size = 0;
   tsi_result result = TSI_OK;
   size_t i;
-  size_t num_left_overs;
-  int has_left_overs_in_current_slice = 0;
-
-  if (error != GRPC_ENDPOINT_CB_OK) {
-    gpr_log(GPR_ERROR, "Read failed.");
-    cleanup_slices(slices, nslices);
-    secure_transport_setup_done(s, 0);
-    return;
-  }
 
   for (i = 0; i < nslices; i++) {
     consumed_slice_size = GPR_SLICE_LENGTH(slices[i]);
@@ -192,6 +200,18 @@ static void on_handshake_data_received_from_peer(
         s->handshaker, GPR_SLICE_START_PTR(slices[i]), &consumed_slice_size);
     if (!tsi_handshaker_is_in_progress(s->handshaker)) break;
   }
+  s->process_result = result;
+  s->processed_slices = i;
+  s->consumed_slice_size = consumed_slice_size;
+}
+
+static void on_handshake_data_processed(grpc_secure_transport_setup *s,
+                                        gpr_slice *slices, size_t nslices) {
+  size_t consumed_slice_size = s->consumed_slice_size;
+  tsi_result result = s->process_result;
+  size_t i = s->processed_slices;
+  size_t num_left_overs;
+  int has_left_overs_in_current_slice = 0;
 
   if (tsi_handshaker_is_in_progress(s->handshaker)) {
     /* We may need more data. */
@@ -199,7 +219,7 @@ static void on_handshake_data_received_from_peer(
       /* TODO(klempner,jboeuf): This should probably use the client setup
          deadline */
       grpc_endpoint_notify_on_read(s->endpoint,
-                                   on_handshake_data_received_from_peer, setup);
+                                   on_handshake_data_received_from_peer, s);
       cleanup_slices(slices, nslices);
       return;
     } else {
@@ -239,6 +259,44 @@ static void on_handshake_data_received_from_peer(
   check_peer(s);
 }
 
+static void process_handshake_data_on_pool(void *setup) {
+  grpc_secure_transport_setup *s = setup;
+  process_handshake_data(s, s->slices, s->nslices);
+}
+
+static void on_handshake_data_processed_on_pool(void *setup) {
+  grpc_secure_transport_setup *s = setup;
+  gpr_slice *slices = s->slices;
+  s->slices = NULL;
+  on_handshake_data_processed(s, slices, s->nslices);
+  gpr_free(slices);
+}
+
+static void on_handshake_data_received_from_peer(
+    void *setup, gpr_slice *slices, size_t nslices,
+    grpc_endpoint_cb_status error) {
+  grpc_secure_transport_setup *s = setup;
+
+  if (error != GRPC_ENDPOINT_CB_OK) {
+    gpr_log(GPR_ERROR, "Read failed.");
+    cleanup_slices(slices, nslices);
+    secure_transport_setup_done(s, 0);
+    return;
+  }
+
+  if (s->offload) {
+    /* The slices array only lives for the duration of this callback. */
+    s->slices = gpr_malloc(nslices * sizeof(gpr_slice));
+    memcpy(s->slices, slices, nslices * sizeof(gpr_slice));
+    s->nslices = nslices;
+    grpc_handshake_pool_run(process_handshake_data_on_pool,
+                            on_handshake_data_processed_on_pool, s);
+    return;
+  }
+  process_handshake_data(s, slices, nslices);
+  on_handshake_data_processed(s, slices, nslices);
+}
+
 /* If setup is NULL, the setup is done. */
 static void on_handshake_data_sent_to_peer(void *setup,
                                            grpc_endpoint_cb_status error) {
@@ -262,19 +320,42 @@ static void on_handshake_data_sent_to_peer(void *setup,
   }
 }
 
+static void on_handshaker_created(void *setup) {
+  grpc_secure_transport_setup *s = setup;
+  if (s->create_handshaker_status != GRPC_SECURITY_OK) {
+    secure_transport_setup_done(s, 0);
+    return;
+  }
+  send_handshake_bytes_to_peer(s);
+}
+
+static void create_handshaker(void *setup) {
+  grpc_secure_transport_setup *s = setup;
+  s->create_handshaker_status =
+      grpc_security_connector_create_handshaker(s->connector, &s->handshaker);
+}
+
+static void start_offloaded_handshake(void *setup, int success) {
+  grpc_secure_transport_setup *s = setup;
+  if (!success) {
+    /* the handshake never started: there is nothing to end in the pool */
+    s->offload = 0;
+    secure_transport_setup_done(s, 0);
+    return;
+  }
+  s->start_time = gpr_now();
+  /* Client handshakers generate their first message on creation. */
+  grpc_handshake_pool_run(create_handshaker, on_handshaker_created, s);
+}
+
 void grpc_setup_secure_transport(grpc_security_connector *connector,
                                  grpc_endpoint *nonsecure_endpoint,
+                                 const grpc_channel_args *args,
                                  grpc_secure_transport_setup_done_cb cb,
                                  void *user_data) {
-  grpc_security_status result = GRPC_SECURITY_OK;
   grpc_secure_transport_setup *s =
       gpr_malloc(sizeof(grpc_secure_transport_setup));
   memset(s, 0, sizeof(grpc_secure_transport_setup));
-  result = grpc_security_connector_create_handshaker(connector, &s->handshaker);
-  if (result != GRPC_SECURITY_OK) {
-    secure_transport_setup_done(s, 0);
-    return;
-  }
   s->connector = grpc_security_connector_ref(connector);
   s->handshake_buffer_size = GRPC_INITIAL_HANDSHAKE_BUFFER_SIZE;
   s->handshake_buffer = gpr_malloc(s->handshake_buffer_size);
@@ -282,5 +363,12 @@ void grpc_setup_secure_transport(grpc_security_connector *connector,
   s->user_data = user_data;
   s->cb = cb;
   gpr_slice_buffer_init(&s->left_overs);
-  send_handshake_bytes_to_peer(s);
+  if (grpc_handshake_pool_enabled(args)) {
+    s->offload = 1;
+    grpc_handshake_pool_begin(connector->is_client_side,
+                              start_offloaded_handshake, s);
+    return;
+  }
+  create_handshaker(s);
+  on_handshaker_created(s);
 }
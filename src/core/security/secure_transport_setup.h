@@ -44,9 +44,12 @@ typedef void (*grpc_secure_transport_setup_done_cb)(
     void *user_data, grpc_security_status status,
     grpc_endpoint *secure_endpoint);
 
-/* Calls the callback upon completion. */
+/* Calls the callback upon completion. args may be NULL. When they enable
+   GRPC_ARG_OFFLOAD_HANDSHAKES, the handshake steps run on the handshake
+   pool. */
 void grpc_setup_secure_transport(grpc_security_connector *connector,
                                  grpc_endpoint *nonsecure_endpoint,
+                                 const grpc_channel_args *args,
                                  grpc_secure_transport_setup_done_cb cb,
                                  void *user_data);
 
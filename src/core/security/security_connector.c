@@ -277,6 +277,9 @@ typedef struct {
   tsi_ssl_handshaker_factory *handshaker_factory;
   char *target_name;
   char *overridden_target_name;
+  /* key of the TLS session to resume: the target host:port, followed by the
+     overridden target name if any */
+  char *session_key;
   tsi_peer peer;
 } grpc_ssl_channel_security_connector;
 
@@ -294,6 +297,7 @@ static void ssl_channel_destroy(grpc_security_connector *sc) {
   }
   if (c->target_name != NULL) gpr_free(c->target_name);
   if (c->overridden_target_name != NULL) gpr_free(c->overridden_target_name);
+  if (c->session_key != NULL) gpr_free(c->session_key);
   tsi_peer_destruct(&c->peer);
   gpr_free(sc);
 }
@@ -309,11 +313,13 @@ static void ssl_server_destroy(grpc_security_connector *sc) {
 
 static grpc_security_status ssl_create_handshaker(
     tsi_ssl_handshaker_factory *handshaker_factory, int is_client,
-    const char *peer_name, tsi_handshaker **handshaker) {
+    const char *peer_name, const char *session_key,
+    tsi_handshaker **handshaker) {
   tsi_result result = TSI_OK;
   if (handshaker_factory == NULL) return GRPC_SECURITY_ERROR;
-  result = tsi_ssl_handshaker_factory_create_handshaker(
-      handshaker_factory, is_client ? peer_name : NULL, handshaker);
+  result = tsi_ssl_handshaker_factory_create_client_handshaker(
+      handshaker_factory, is_client ? peer_name : NULL,
+      is_client ? session_key : NULL, handshaker);
   if (result != TSI_OK) {
     gpr_log(GPR_ERROR, "Handshaker creation failed with error %s.",
             tsi_result_to_string(result));
@@ -330,14 +336,15 @@ static grpc_security_status ssl_channel_create_handshaker(
                                c->overridden_target_name != NULL
                                    ? c->overridden_target_name
                                    : c->target_name,
-                               handshaker);
+                               c->session_key, handshaker);
 }
 
 static grpc_security_status ssl_server_create_handshaker(
     grpc_security_connector *sc, tsi_handshaker **handshaker) {
   grpc_ssl_server_security_connector *c =
       (grpc_ssl_server_security_connector *)sc;
-  return ssl_create_handshaker(c->handshaker_factory, 0, NULL, handshaker);
+  return ssl_create_handshaker(c->handshaker_factory, 0, NULL, NULL,
+                               handshaker);
 }
 
 static int ssl_host_matches_name(const tsi_peer *peer, const char *peer_name) {
@@ -506,6 +513,10 @@ grpc_security_status grpc_ssl_channel_security_connector_create(
   gpr_free(port);
   if (overridden_target_name != NULL) {
     c->overridden_target_name = gpr_strdup(overridden_target_name);
+    gpr_asprintf(&c->session_key, "%s/%s", target_name,
+                 overridden_target_name);
+  } else {
+    c->session_key = gpr_strdup(target_name);
   }
   if (config->pem_root_certs == NULL) {
     pem_root_certs_size = grpc_get_default_ssl_roots(&pem_root_certs);
@@ -521,7 +532,8 @@ grpc_security_status grpc_ssl_channel_security_connector_create(
       config->pem_private_key, config->pem_private_key_size,
       config->pem_cert_chain, config->pem_cert_chain_size, pem_root_certs,
       pem_root_certs_size, ssl_cipher_suites(), alpn_protocol_strings,
-      alpn_protocol_string_lengths, num_alpn_protocols, &c->handshaker_factory);
+      alpn_protocol_string_lengths, num_alpn_protocols, config->session_cache,
+      &c->handshaker_factory);
   if (result != TSI_OK) {
     gpr_log(GPR_ERROR, "Handshaker factory creation failed with %s.",
             tsi_result_to_string(result));
@@ -575,7 +587,7 @@ grpc_security_status grpc_ssl_server_security_connector_create(
       config->pem_cert_chains_sizes, config->num_key_cert_pairs,
       config->pem_root_certs, config->pem_root_certs_size, ssl_cipher_suites(),
       alpn_protocol_strings, alpn_protocol_string_lengths, num_alpn_protocols,
-      &c->handshaker_factory);
+      config->session_ticket_key_rotation_secs, &c->handshaker_factory);
   if (result != TSI_OK) {
     gpr_log(GPR_ERROR, "Handshaker factory creation failed with %s.",
             tsi_result_to_string(result));
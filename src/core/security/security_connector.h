@@ -36,6 +36,7 @@
 
 #include <grpc/grpc_security.h>
 #include "src/core/iomgr/endpoint.h"
+#include "src/core/tsi/ssl_transport_security.h"
 #include "src/core/tsi/transport_security_interface.h"
 
 /* --- status enum. --- */
@@ -155,6 +156,9 @@ typedef struct {
   size_t pem_cert_chain_size;
   unsigned char *pem_root_certs;
   size_t pem_root_certs_size;
+  /* Cache of the sessions to resume, shared by all the channels created with
+     the same credentials. May be NULL. */
+  tsi_ssl_session_cache *session_cache;
 } grpc_ssl_config;
 
 /* Creates an SSL channel_security_connector.
@@ -187,6 +191,8 @@ typedef struct {
   size_t num_key_cert_pairs;
   unsigned char *pem_root_certs;
   size_t pem_root_certs_size;
+  /* Lifetime of the session ticket keys, 0 disables session tickets. */
+  int session_ticket_key_rotation_secs;
 } grpc_ssl_server_config;
 
 /* Creates an SSL server_security_connector.
@@ -35,6 +35,7 @@
 
 #include <string.h>
 
+#include "src/core/channel/compress_filter.h"
 #include "src/core/channel/http_server_filter.h"
 #include "src/core/iomgr/endpoint.h"
 #include "src/core/iomgr/resolve_address.h"
@@ -73,7 +74,7 @@ static grpc_transport_setup_result setup_transport(void *server,
                                                    grpc_transport *transport,
                                                    grpc_mdctx *mdctx) {
   static grpc_channel_filter const *extra_filters[] = {
-      &grpc_http_server_filter};
+      &grpc_http_server_filter, &grpc_compress_filter};
   return grpc_server_setup_transport(server, transport, extra_filters,
                                      GPR_ARRAY_SIZE(extra_filters), mdctx);
 }
@@ -104,8 +105,9 @@ static void on_secure_transport_setup_done(void *statep,
 static void on_accept(void *statep, grpc_endpoint *tcp) {
   grpc_server_secure_state *state = statep;
   state_ref(state);
-  grpc_setup_secure_transport(state->sc, tcp, on_secure_transport_setup_done,
-                              state);
+  grpc_setup_secure_transport(state->sc, tcp,
+                              grpc_server_get_channel_args(state->server),
+                              on_secure_transport_setup_done, state);
 }
 
 /* Server callback: start listening on our ports */
@@ -64,7 +64,7 @@
 
    Locking in block struct:
 
-   Exclusive g_log.lock must be held before calling any functions operatong on
+   Exclusive log->lock must be held before calling any functions operatong on
    block structs except census_log_start_write() and
    census_log_end_write().
 
@@ -195,8 +195,8 @@ struct census_log {
   gpr_atm out_of_space_count;
 };
 
-/* Single internal log */
-static struct census_log g_log;
+/* The log behind the census_log_* functions that take no log */
+static census_log g_log;
 
 /* Functions that operate on an atomic memory location used as a lock */
 
@@ -364,25 +364,25 @@ static void cl_block_end_read(cl_block* block) {
   cl_unlock(&block->reader_lock);
 }
 
-/* Internal functions operating on g_log */
+/* Internal functions operating on a log */
 
 /* Allocates a new free block (or recycles an available dirty block if log is
    configured to discard old records). Returns NULL if out-of-space. */
-static cl_block* cl_allocate_block(void) {
-  cl_block* block = cl_block_list_head(&g_log.free_block_list);
+static cl_block* cl_allocate_block(census_log* log) {
+  cl_block* block = cl_block_list_head(&log->free_block_list);
   if (block != NULL) {
-    cl_block_list_remove(&g_log.free_block_list, block);
+    cl_block_list_remove(&log->free_block_list, block);
     return block;
   }
-  if (!g_log.discard_old_records) {
+  if (!log->discard_old_records) {
     /* No free block and log is configured to keep old records. */
     return NULL;
   }
   /* Recycle dirty block. Start from the oldest. */
-  for (block = cl_block_list_head(&g_log.dirty_block_list); block != NULL;
+  for (block = cl_block_list_head(&log->dirty_block_list); block != NULL;
        block = block->link.next->block) {
     if (cl_block_try_disable_access(block, 1 /* discard data */)) {
-      cl_block_list_remove(&g_log.dirty_block_list, block);
+      cl_block_list_remove(&log->dirty_block_list, block);
       return block;
     }
   }
@@ -395,21 +395,21 @@ static cl_block* cl_allocate_block(void) {
    - allocated a new block OR
    - 'core_id' => 'old_block' mapping changed (another thread allocated a
      block before lock was acquired). */
-static int cl_allocate_core_local_block(gpr_int32 core_id,
+static int cl_allocate_core_local_block(census_log* log, gpr_int32 core_id,
                                         cl_block* old_block) {
   /* Now that we have the lock, check if core-local mapping has changed. */
-  cl_core_local_block* core_local_block = &g_log.core_local_blocks[core_id];
+  cl_core_local_block* core_local_block = &log->core_local_blocks[core_id];
   cl_block* block = cl_core_local_block_get_block(core_local_block);
   if ((block != NULL) && (block != old_block)) {
     return 1;
   }
   if (block != NULL) {
     cl_core_local_block_set_block(core_local_block, NULL);
-    cl_block_list_insert_at_tail(&g_log.dirty_block_list, block);
+    cl_block_list_insert_at_tail(&log->dirty_block_list, block);
   }
-  block = cl_allocate_block();
+  block = cl_allocate_block(log);
   if (block == NULL) {
-    gpr_atm_rel_store(&g_log.is_full, 1);
+    gpr_atm_rel_store(&log->is_full, 1);
     return 0;
   }
   cl_core_local_block_set_block(core_local_block, block);
@@ -417,17 +417,17 @@ static int cl_allocate_core_local_block(gpr_int32 core_id,
   return 1;
 }
 
-static cl_block* cl_get_block(void* record) {
-  gpr_uintptr p = (gpr_uintptr)((char*)record - g_log.buffer);
+static cl_block* cl_get_block(census_log* log, void* record) {
+  gpr_uintptr p = (gpr_uintptr)((char*)record - log->buffer);
   gpr_uintptr index = p >> CENSUS_LOG_2_MAX_RECORD_SIZE;
-  return &g_log.blocks[index];
+  return &log->blocks[index];
 }
 
 /* Gets the next block to read and tries to free 'prev' block (if not NULL).
    Returns NULL if reached the end. */
-static cl_block* cl_next_block_to_read(cl_block* prev) {
+static cl_block* cl_next_block_to_read(census_log* log, cl_block* prev) {
   cl_block* block = NULL;
-  if (g_log.read_iterator_state == g_log.num_cores) {
+  if (log->read_iterator_state == log->num_cores) {
     /* We are traversing dirty list; find the next dirty block. */
     if (prev != NULL) {
       /* Try to free the previous block if there is no unread data. This block
@@ -435,22 +435,22 @@ static cl_block* cl_next_block_to_read(cl_block* prev) {
          read_next() calls. */
       block = prev->link.next->block;
       if (cl_block_try_disable_access(prev, 0 /* do not discard data */)) {
-        cl_block_list_remove(&g_log.dirty_block_list, prev);
-        cl_block_list_insert_at_head(&g_log.free_block_list, prev);
-        gpr_atm_rel_store(&g_log.is_full, 0);
+        cl_block_list_remove(&log->dirty_block_list, prev);
+        cl_block_list_insert_at_head(&log->free_block_list, prev);
+        gpr_atm_rel_store(&log->is_full, 0);
       }
     } else {
-      block = cl_block_list_head(&g_log.dirty_block_list);
+      block = cl_block_list_head(&log->dirty_block_list);
     }
     if (block != NULL) {
       return block;
     }
     /* We are done with the dirty list; moving on to core-local blocks. */
   }
-  while (g_log.read_iterator_state > 0) {
-    g_log.read_iterator_state--;
+  while (log->read_iterator_state > 0) {
+    log->read_iterator_state--;
     block = cl_core_local_block_get_block(
-        &g_log.core_local_blocks[g_log.read_iterator_state]);
+        &log->core_local_blocks[log->read_iterator_state]);
     if (block != NULL) {
       return block;
     }
@@ -458,62 +458,62 @@ static cl_block* cl_next_block_to_read(cl_block* prev) {
   return NULL;
 }
 
-/* External functions: primary stats_log interface */
-void census_log_initialize(size_t size_in_mb, int discard_old_records) {
+static void cl_log_initialize(census_log* log, size_t size_in_mb,
+                              int discard_old_records) {
   gpr_int32 ix;
   /* Check cacheline alignment. */
   GPR_ASSERT(sizeof(cl_block) % GPR_CACHELINE_SIZE == 0);
   GPR_ASSERT(sizeof(cl_core_local_block) % GPR_CACHELINE_SIZE == 0);
-  GPR_ASSERT(!g_log.initialized);
-  g_log.discard_old_records = discard_old_records;
-  g_log.num_cores = gpr_cpu_num_cores();
+  GPR_ASSERT(!log->initialized);
+  log->discard_old_records = discard_old_records;
+  log->num_cores = gpr_cpu_num_cores();
   /* Ensure at least as many blocks as there are cores. */
-  g_log.num_blocks = GPR_MAX(
-      g_log.num_cores, (size_in_mb << 20) >> CENSUS_LOG_2_MAX_RECORD_SIZE);
-  gpr_mu_init(&g_log.lock);
-  g_log.read_iterator_state = 0;
-  g_log.block_being_read = NULL;
-  gpr_atm_rel_store(&g_log.is_full, 0);
-  g_log.core_local_blocks = (cl_core_local_block*)gpr_malloc_aligned(
-      g_log.num_cores * sizeof(cl_core_local_block), GPR_CACHELINE_SIZE_LOG);
-  memset(g_log.core_local_blocks, 0,
-         g_log.num_cores * sizeof(cl_core_local_block));
-  g_log.blocks = (cl_block*)gpr_malloc_aligned(
-      g_log.num_blocks * sizeof(cl_block), GPR_CACHELINE_SIZE_LOG);
-  memset(g_log.blocks, 0, g_log.num_blocks * sizeof(cl_block));
-  g_log.buffer = gpr_malloc(g_log.num_blocks * CENSUS_LOG_MAX_RECORD_SIZE);
-  memset(g_log.buffer, 0, g_log.num_blocks * CENSUS_LOG_MAX_RECORD_SIZE);
-  cl_block_list_initialize(&g_log.free_block_list);
-  cl_block_list_initialize(&g_log.dirty_block_list);
-  for (ix = 0; ix < g_log.num_blocks; ++ix) {
-    cl_block* block = g_log.blocks + ix;
+  log->num_blocks = GPR_MAX(
+      log->num_cores, (size_in_mb << 20) >> CENSUS_LOG_2_MAX_RECORD_SIZE);
+  gpr_mu_init(&log->lock);
+  log->read_iterator_state = 0;
+  log->block_being_read = NULL;
+  gpr_atm_rel_store(&log->is_full, 0);
+  log->core_local_blocks = (cl_core_local_block*)gpr_malloc_aligned(
+      log->num_cores * sizeof(cl_core_local_block), GPR_CACHELINE_SIZE_LOG);
+  memset(log->core_local_blocks, 0,
+         log->num_cores * sizeof(cl_core_local_block));
+  log->blocks = (cl_block*)gpr_malloc_aligned(
+      log->num_blocks * sizeof(cl_block), GPR_CACHELINE_SIZE_LOG);
+  memset(log->blocks, 0, log->num_blocks * sizeof(cl_block));
+  log->buffer = gpr_malloc(log->num_blocks * CENSUS_LOG_MAX_RECORD_SIZE);
+  memset(log->buffer, 0, log->num_blocks * CENSUS_LOG_MAX_RECORD_SIZE);
+  cl_block_list_initialize(&log->free_block_list);
+  cl_block_list_initialize(&log->dirty_block_list);
+  for (ix = 0; ix < log->num_blocks; ++ix) {
+    cl_block* block = log->blocks + ix;
     cl_block_initialize(block,
-                        g_log.buffer + (CENSUS_LOG_MAX_RECORD_SIZE * ix));
+                        log->buffer + (CENSUS_LOG_MAX_RECORD_SIZE * ix));
     cl_block_try_disable_access(block, 1 /* discard data */);
-    cl_block_list_insert_at_tail(&g_log.free_block_list, block);
+    cl_block_list_insert_at_tail(&log->free_block_list, block);
   }
-  gpr_atm_rel_store(&g_log.out_of_space_count, 0);
-  g_log.initialized = 1;
+  gpr_atm_rel_store(&log->out_of_space_count, 0);
+  log->initialized = 1;
 }
 
-void census_log_shutdown(void) {
-  GPR_ASSERT(g_log.initialized);
-  gpr_mu_destroy(&g_log.lock);
-  gpr_free_aligned(g_log.core_local_blocks);
-  g_log.core_local_blocks = NULL;
-  gpr_free_aligned(g_log.blocks);
-  g_log.blocks = NULL;
-  gpr_free(g_log.buffer);
-  g_log.buffer = NULL;
-  g_log.initialized = 0;
+static void cl_log_shutdown(census_log* log) {
+  GPR_ASSERT(log->initialized);
+  gpr_mu_destroy(&log->lock);
+  gpr_free_aligned(log->core_local_blocks);
+  log->core_local_blocks = NULL;
+  gpr_free_aligned(log->blocks);
+  log->blocks = NULL;
+  gpr_free(log->buffer);
+  log->buffer = NULL;
+  log->initialized = 0;
 }
 
-void* census_log_start_write(size_t size) {
+void* census_log_start_write_in(census_log* log, size_t size) {
   /* Used to bound number of times block allocation is attempted. */
-  gpr_int32 attempts_remaining = g_log.num_blocks;
+  gpr_int32 attempts_remaining = log->num_blocks;
   /* TODO(aveitch): move this inside the do loop when current_cpu is fixed */
   gpr_int32 core_id = gpr_cpu_current_cpu();
-  GPR_ASSERT(g_log.initialized);
+  GPR_ASSERT(log->initialized);
   if (size > CENSUS_LOG_MAX_RECORD_SIZE) {
     return NULL;
   }
@@ -521,7 +521,7 @@ void* census_log_start_write(size_t size) {
     int allocated;
     void* record = NULL;
     cl_block* block =
-        cl_core_local_block_get_block(&g_log.core_local_blocks[core_id]);
+        cl_core_local_block_get_block(&log->core_local_blocks[core_id]);
     if (block && (record = cl_block_start_write(block, size))) {
       return record;
     }
@@ -529,76 +529,119 @@ void* census_log_start_write(size_t size) {
        - No block associated with the core OR
        - Write in-progress on the block OR
        - block is out of space */
-    if (gpr_atm_acq_load(&g_log.is_full)) {
-      gpr_atm_no_barrier_fetch_add(&g_log.out_of_space_count, 1);
+    if (gpr_atm_acq_load(&log->is_full)) {
+      gpr_atm_no_barrier_fetch_add(&log->out_of_space_count, 1);
       return NULL;
     }
-    gpr_mu_lock(&g_log.lock);
-    allocated = cl_allocate_core_local_block(core_id, block);
-    gpr_mu_unlock(&g_log.lock);
+    gpr_mu_lock(&log->lock);
+    allocated = cl_allocate_core_local_block(log, core_id, block);
+    gpr_mu_unlock(&log->lock);
     if (!allocated) {
-      gpr_atm_no_barrier_fetch_add(&g_log.out_of_space_count, 1);
+      gpr_atm_no_barrier_fetch_add(&log->out_of_space_count, 1);
       return NULL;
     }
   } while (attempts_remaining--);
   /* Give up. */
-  gpr_atm_no_barrier_fetch_add(&g_log.out_of_space_count, 1);
+  gpr_atm_no_barrier_fetch_add(&log->out_of_space_count, 1);
   return NULL;
 }
 
-void census_log_end_write(void* record, size_t bytes_written) {
-  GPR_ASSERT(g_log.initialized);
-  cl_block_end_write(cl_get_block(record), bytes_written);
+void census_log_end_write_in(census_log* log, void* record,
+                             size_t bytes_written) {
+  GPR_ASSERT(log->initialized);
+  cl_block_end_write(cl_get_block(log, record), bytes_written);
 }
 
-void census_log_init_reader(void) {
-  GPR_ASSERT(g_log.initialized);
-  gpr_mu_lock(&g_log.lock);
+void census_log_init_reader_in(census_log* log) {
+  GPR_ASSERT(log->initialized);
+  gpr_mu_lock(&log->lock);
   /* If a block is locked for reading unlock it. */
-  if (g_log.block_being_read != NULL) {
-    cl_block_end_read(g_log.block_being_read);
-    g_log.block_being_read = NULL;
+  if (log->block_being_read != NULL) {
+    cl_block_end_read(log->block_being_read);
+    log->block_being_read = NULL;
   }
-  g_log.read_iterator_state = g_log.num_cores;
-  gpr_mu_unlock(&g_log.lock);
+  log->read_iterator_state = log->num_cores;
+  gpr_mu_unlock(&log->lock);
 }
 
-const void* census_log_read_next(size_t* bytes_available) {
-  GPR_ASSERT(g_log.initialized);
-  gpr_mu_lock(&g_log.lock);
-  if (g_log.block_being_read != NULL) {
-    cl_block_end_read(g_log.block_being_read);
+const void* census_log_read_next_in(census_log* log,
+                                    size_t* bytes_available) {
+  GPR_ASSERT(log->initialized);
+  gpr_mu_lock(&log->lock);
+  if (log->block_being_read != NULL) {
+    cl_block_end_read(log->block_being_read);
   }
   do {
-    g_log.block_being_read = cl_next_block_to_read(g_log.block_being_read);
-    if (g_log.block_being_read != NULL) {
+    log->block_being_read = cl_next_block_to_read(log, log->block_being_read);
+    if (log->block_being_read != NULL) {
       void* record =
-          cl_block_start_read(g_log.block_being_read, bytes_available);
+          cl_block_start_read(log->block_being_read, bytes_available);
       if (record != NULL) {
-        gpr_mu_unlock(&g_log.lock);
+        gpr_mu_unlock(&log->lock);
         return record;
       }
     }
-  } while (g_log.block_being_read != NULL);
-  gpr_mu_unlock(&g_log.lock);
+  } while (log->block_being_read != NULL);
+  gpr_mu_unlock(&log->lock);
   return NULL;
 }
 
-size_t census_log_remaining_space(void) {
+size_t census_log_remaining_space_in(census_log* log) {
   size_t space;
-  GPR_ASSERT(g_log.initialized);
-  gpr_mu_lock(&g_log.lock);
-  if (g_log.discard_old_records) {
+  GPR_ASSERT(log->initialized);
+  gpr_mu_lock(&log->lock);
+  if (log->discard_old_records) {
     /* Remaining space is not meaningful; just return the entire log space. */
-    space = g_log.num_blocks << CENSUS_LOG_2_MAX_RECORD_SIZE;
+    space = log->num_blocks << CENSUS_LOG_2_MAX_RECORD_SIZE;
   } else {
-    space = g_log.free_block_list.count * CENSUS_LOG_MAX_RECORD_SIZE;
+    space = log->free_block_list.count * CENSUS_LOG_MAX_RECORD_SIZE;
   }
-  gpr_mu_unlock(&g_log.lock);
+  gpr_mu_unlock(&log->lock);
   return space;
 }
 
+int census_log_out_of_space_count_in(census_log* log) {
+  GPR_ASSERT(log->initialized);
+  return gpr_atm_acq_load(&log->out_of_space_count);
+}
+
+census_log* census_log_create(size_t size_in_mb, int discard_old_records) {
+  census_log* log = gpr_malloc(sizeof(census_log));
+  memset(log, 0, sizeof(*log));
+  cl_log_initialize(log, size_in_mb, discard_old_records);
+  return log;
+}
+
+void census_log_destroy(census_log* log) {
+  cl_log_shutdown(log);
+  gpr_free(log);
+}
+
+/* The process wide log */
+void census_log_initialize(size_t size_in_mb, int discard_old_records) {
+  cl_log_initialize(&g_log, size_in_mb, discard_old_records);
+}
+
+void census_log_shutdown(void) { cl_log_shutdown(&g_log); }
+
+void* census_log_start_write(size_t size) {
+  return census_log_start_write_in(&g_log, size);
+}
+
+void census_log_end_write(void* record, size_t bytes_written) {
+  census_log_end_write_in(&g_log, record, bytes_written);
+}
+
+void census_log_init_reader(void) { census_log_init_reader_in(&g_log); }
+
+const void* census_log_read_next(size_t* bytes_available) {
+  return census_log_read_next_in(&g_log, bytes_available);
+}
+
+size_t census_log_remaining_space(void) {
+  return census_log_remaining_space_in(&g_log);
+}
+
 int census_log_out_of_space_count(void) {
-  GPR_ASSERT(g_log.initialized);
-  return gpr_atm_acq_load(&g_log.out_of_space_count);
+  return census_log_out_of_space_count_in(&g_log);
 }
@@ -88,4 +88,24 @@ size_t census_log_remaining_space(void);
    out-of-space. */
 int census_log_out_of_space_count(void);
 
+/* The functions above operate on a single process wide log. Subsystems that
+   need a log of their own (e.g. so that they only read back their own
+   records) create one instead, and use the census_log_*_in() functions
+   below, which behave as their counterparts above. */
+typedef struct census_log census_log;
+
+/* Creates a log, see census_log_initialize(). */
+census_log* census_log_create(size_t size_in_mb, int discard_old_records);
+
+/* Destroys a log, see census_log_shutdown(). */
+void census_log_destroy(census_log* log);
+
+void* census_log_start_write_in(census_log* log, size_t size);
+void census_log_end_write_in(census_log* log, void* record,
+                             size_t bytes_written);
+void census_log_init_reader_in(census_log* log);
+const void* census_log_read_next_in(census_log* log, size_t* bytes_available);
+size_t census_log_remaining_space_in(census_log* log);
+int census_log_out_of_space_count_in(census_log* log);
+
 #endif  /* GRPC_INTERNAL_CORE_STATISTICS_CENSUS_LOG_H */
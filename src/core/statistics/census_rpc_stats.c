@@ -35,60 +35,79 @@
 
 #include "src/core/statistics/census_interface.h"
 #include "src/core/statistics/census_rpc_stats.h"
-#include "src/core/statistics/hash_table.h"
 #include "src/core/statistics/census_tracing.h"
 #include "src/core/statistics/window_stats.h"
 #include "src/core/support/murmur_hash.h"
 #include "src/core/support/string.h"
 #include <grpc/support/alloc.h>
+#include <grpc/support/atm.h>
+#include <grpc/support/cpu.h>
 #include <grpc/support/log.h>
 #include <grpc/support/sync.h>
+#include <grpc/support/useful.h>
 
 #define NUM_INTERVALS 3
 #define MINUTE_INTERVAL 0
 #define HOUR_INTERVAL 1
 #define TOTAL_INTERVAL 2
 
+/* Capacity of the method registry. The lookup table is kept at most half
+   full, so that probing always ends on an empty slot. */
+#define MAX_METHODS 1024
+#define METHOD_TABLE_SIZE (2 * MAX_METHODS)
+
+/* Stats of a method are spread over one shard per core (up to MAX_SHARDS), so
+   that threads recording on different cores don't contend. */
+#define MAX_SHARDS 16
+
 /* for easier typing */
 typedef census_per_method_rpc_stats per_method_stats;
 
+/* One core's share of the stats of a method. Cacheline sized, so that
+   neighbouring shards don't share cachelines. */
+typedef union stats_shard {
+  struct {
+    gpr_mu mu;
+    /* NULL until stats are first recorded on this shard */
+    struct census_window_stats* window_stats;
+  } s;
+  char padding[GPR_CACHELINE_SIZE];
+} stats_shard;
+
+typedef struct registered_method {
+  char* name;
+  stats_shard* client_shards;
+  stats_shard* server_shards;
+} registered_method;
+
 /* Ensure mu is only initialized once. */
 static gpr_once g_stats_store_mu_init = GPR_ONCE_INIT;
-/* Guards two stats stores. */
+/* Guards method registration, store shutdown and stats queries. Recording
+   stats only takes the lock of a shard. */
 static gpr_mu g_mu;
-static census_ht* g_client_stats_store = NULL;
-static census_ht* g_server_stats_store = NULL;
+/* Stats are only recorded while the store is initialized. */
+static gpr_atm g_initialized = 0;
+static unsigned g_num_shards;
+/* Registered methods live as long as the process: their ids never go stale,
+   even across store shutdown and init, and may be cached by callers (the
+   census filter keeps them on :path metadata). Store shutdown only drops
+   the recorded stats. Indexed by method id. Entries are filled in before
+   their id is published in g_method_table. */
+static registered_method g_methods[MAX_METHODS];
+static int g_num_methods;
+/* Open addressing table from method name hashes to method id + 1, 0 marking
+   empty slots. Written under g_mu, read without locking. */
+static gpr_atm g_method_table[METHOD_TABLE_SIZE];
 
-static void init_mutex(void) { gpr_mu_init(&g_mu); }
+static void init_mutex(void) {
+  gpr_mu_init(&g_mu);
+  g_num_shards = GPR_CLAMP(gpr_cpu_num_cores(), 1, MAX_SHARDS);
+}
 
 static void init_mutex_once(void) {
   gpr_once_init(&g_stats_store_mu_init, init_mutex);
 }
 
-static int cmp_str_keys(const void* k1, const void* k2) {
-  return strcmp((const char*)k1, (const char*)k2);
-}
-
-/* TODO(hongyu): replace it with cityhash64 */
-static gpr_uint64 simple_hash(const void* k) {
-  size_t len = strlen(k);
-  gpr_uint64 higher = gpr_murmur_hash3((const char*)k, len / 2, 0);
-  return higher << 32 |
-         gpr_murmur_hash3((const char*)k + len / 2, len - len / 2, 0);
-}
-
-static void delete_stats(void* stats) {
-  census_window_stats_destroy((struct census_window_stats*)stats);
-}
-
-static void delete_key(void* key) { gpr_free(key); }
-
-static const census_ht_option ht_opt = {
-    CENSUS_HT_POINTER /* key type */, 1999 /* n_of_buckets */,
-    simple_hash /* hash function */, cmp_str_keys /* key comparator */,
-    delete_stats /* data deleter */, delete_key /* key deleter */
-};
-
 static void init_rpc_stats(void* stats) {
   memset(stats, 0, sizeof(census_rpc_stats));
 }
@@ -137,96 +156,200 @@ void census_aggregated_rpc_stats_set_empty(census_aggregated_rpc_stats* data) {
   data->stats = NULL;
 }
 
-static void record_stats(census_ht* store, census_op_id op_id,
-                         const census_rpc_stats* stats) {
+static stats_shard* create_shards(void) {
+  unsigned i;
+  stats_shard* shards = gpr_malloc_aligned(g_num_shards * sizeof(stats_shard),
+                                           GPR_CACHELINE_SIZE_LOG);
+  for (i = 0; i < g_num_shards; i++) {
+    gpr_mu_init(&shards[i].s.mu);
+    shards[i].s.window_stats = NULL;
+  }
+  return shards;
+}
+
+static void clear_shards(stats_shard* shards) {
+  unsigned i;
+  for (i = 0; i < g_num_shards; i++) {
+    gpr_mu_lock(&shards[i].s.mu);
+    if (shards[i].s.window_stats != NULL) {
+      census_window_stats_destroy(shards[i].s.window_stats);
+      shards[i].s.window_stats = NULL;
+    }
+    gpr_mu_unlock(&shards[i].s.mu);
+  }
+}
+
+static gpr_uint32 method_hash(const char* method) {
+  return gpr_murmur_hash3(method, strlen(method), 0);
+}
+
+/* Returns the id of method, or CENSUS_INVALID_METHOD_ID if it is not
+   registered, and sets *slot to the table slot where it is or would go. */
+static census_method_id find_method(const char* method, size_t* slot) {
+  size_t i = method_hash(method) & (METHOD_TABLE_SIZE - 1);
+  for (;; i = (i + 1) & (METHOD_TABLE_SIZE - 1)) {
+    gpr_atm entry = gpr_atm_acq_load(&g_method_table[i]);
+    if (entry == 0) break;
+    if (0 == strcmp(g_methods[entry - 1].name, method)) {
+      *slot = i;
+      return (census_method_id)(entry - 1);
+    }
+  }
+  *slot = i;
+  return CENSUS_INVALID_METHOD_ID;
+}
+
+census_method_id census_stats_register_method(const char* method) {
+  census_method_id id;
+  size_t slot;
+
+  /* registered methods are found without locking */
+  if (method == NULL) return CENSUS_INVALID_METHOD_ID;
+  id = find_method(method, &slot);
+  if (id != CENSUS_INVALID_METHOD_ID) return id;
+
+  init_mutex_once();
   gpr_mu_lock(&g_mu);
-  if (store != NULL) {
-    census_trace_obj* trace = NULL;
-    census_internal_lock_trace_store();
-    trace = census_get_trace_obj_locked(op_id);
-    if (trace != NULL) {
-      const char* method_name = census_get_trace_method_name(trace);
-      struct census_window_stats* window_stats = NULL;
-      census_ht_key key;
-      key.ptr = (void*)method_name;
-      window_stats = census_ht_find(store, key);
-      census_internal_unlock_trace_store();
-      if (window_stats == NULL) {
-        window_stats = census_window_stats_create(3, min_hour_total_intervals,
-                                                  30, &window_stats_settings);
-        key.ptr = gpr_strdup(key.ptr);
-        census_ht_insert(store, key, (void*)window_stats);
-      }
-      census_window_stats_add(window_stats, gpr_now(), stats);
+  /* another thread may have registered it in the meantime */
+  id = find_method(method, &slot);
+  if (id == CENSUS_INVALID_METHOD_ID) {
+    if (g_num_methods == MAX_METHODS) {
+      gpr_log(GPR_ERROR, "Census stats store full, not recording '%s'.",
+              method);
     } else {
-      census_internal_unlock_trace_store();
+      id = g_num_methods++;
+      g_methods[id].name = gpr_strdup(method);
+      g_methods[id].client_shards = create_shards();
+      g_methods[id].server_shards = create_shards();
+      gpr_atm_rel_store(&g_method_table[slot], (gpr_atm)id + 1);
     }
   }
   gpr_mu_unlock(&g_mu);
+  return id;
+}
+
+static void record_stats(int is_client, census_method_id id,
+                         const census_rpc_stats* stats) {
+  stats_shard* shards;
+  stats_shard* shard;
+  if (id < 0 || id >= MAX_METHODS || !gpr_atm_acq_load(&g_initialized)) {
+    return;
+  }
+  shards = is_client ? g_methods[id].client_shards
+                     : g_methods[id].server_shards;
+  if (shards == NULL) return;
+  shard = &shards[gpr_cpu_current_cpu() % g_num_shards];
+  gpr_mu_lock(&shard->s.mu);
+  /* checked again under the shard lock: stats recorded after shutdown
+     cleared this shard would outlive the store */
+  if (!gpr_atm_no_barrier_load(&g_initialized)) {
+    gpr_mu_unlock(&shard->s.mu);
+    return;
+  }
+  if (shard->s.window_stats == NULL) {
+    shard->s.window_stats = census_window_stats_create(
+        NUM_INTERVALS, min_hour_total_intervals, 30, &window_stats_settings);
+  }
+  census_window_stats_add(shard->s.window_stats, gpr_now(), stats);
+  gpr_mu_unlock(&shard->s.mu);
 }
 
 void census_record_rpc_client_stats(census_op_id op_id,
                                     const census_rpc_stats* stats) {
-  record_stats(g_client_stats_store, op_id, stats);
+  record_stats(1, census_tracing_get_method_id(op_id), stats);
 }
 
 void census_record_rpc_server_stats(census_op_id op_id,
                                     const census_rpc_stats* stats) {
-  record_stats(g_server_stats_store, op_id, stats);
+  record_stats(0, census_tracing_get_method_id(op_id), stats);
+}
+
+void census_record_rpc_client_stats_by_method(census_method_id method_id,
+                                              const census_rpc_stats* stats) {
+  record_stats(1, method_id, stats);
+}
+
+void census_record_rpc_server_stats_by_method(census_method_id method_id,
+                                              const census_rpc_stats* stats) {
+  record_stats(0, method_id, stats);
 }
 
-/* Get stats from input stats store */
-static void get_stats(census_ht* store, census_aggregated_rpc_stats* data) {
+/* Merges the stats of all shards into *out. Returns 0 if no stats were
+   recorded. Requires g_mu. */
+static int merge_shards(stats_shard* shards, gpr_timespec now,
+                        per_method_stats* out) {
+  census_rpc_stats totals[NUM_INTERVALS];
+  census_rpc_stats shard_totals[NUM_INTERVALS];
+  census_window_stats_sums sums[NUM_INTERVALS];
+  int recorded = 0;
+  unsigned i;
+  int j;
+
+  memset(totals, 0, sizeof(totals));
+  for (j = 0; j < NUM_INTERVALS; j++) {
+    sums[j].statistic = &shard_totals[j];
+  }
+  for (i = 0; i < g_num_shards; i++) {
+    gpr_mu_lock(&shards[i].s.mu);
+    if (shards[i].s.window_stats != NULL) {
+      recorded = 1;
+      census_window_stats_get_sums(shards[i].s.window_stats, now, sums);
+      for (j = 0; j < NUM_INTERVALS; j++) {
+        stat_add(&totals[j], &shard_totals[j]);
+      }
+    }
+    gpr_mu_unlock(&shards[i].s.mu);
+  }
+  out->minute_stats = totals[MINUTE_INTERVAL];
+  out->hour_stats = totals[HOUR_INTERVAL];
+  out->total_stats = totals[TOTAL_INTERVAL];
+  return recorded;
+}
+
+/* Get stats from the client or the server shards */
+static void get_stats(int is_client, census_aggregated_rpc_stats* data) {
   GPR_ASSERT(data != NULL);
   if (data->num_entries != 0) {
     census_aggregated_rpc_stats_set_empty(data);
   }
+  init_mutex_once();
   gpr_mu_lock(&g_mu);
-  if (store != NULL) {
-    size_t n;
-    unsigned i, j;
+  if (gpr_atm_no_barrier_load(&g_initialized) && g_num_methods > 0) {
+    int i;
+    int n = 0;
     gpr_timespec now = gpr_now();
-    census_ht_kv* kv = census_ht_get_all_elements(store, &n);
-    if (kv != NULL) {
-      data->num_entries = n;
-      data->stats = (per_method_stats*)gpr_malloc(sizeof(per_method_stats) * n);
-      for (i = 0; i < n; i++) {
-        census_window_stats_sums sums[NUM_INTERVALS];
-        for (j = 0; j < NUM_INTERVALS; j++) {
-          sums[j].statistic = (void*)census_rpc_stats_create_empty();
-        }
-        data->stats[i].method = gpr_strdup(kv[i].k.ptr);
-        census_window_stats_get_sums(kv[i].v, now, sums);
-        data->stats[i].minute_stats =
-            *(census_rpc_stats*)sums[MINUTE_INTERVAL].statistic;
-        data->stats[i].hour_stats =
-            *(census_rpc_stats*)sums[HOUR_INTERVAL].statistic;
-        data->stats[i].total_stats =
-            *(census_rpc_stats*)sums[TOTAL_INTERVAL].statistic;
-        for (j = 0; j < NUM_INTERVALS; j++) {
-          gpr_free(sums[j].statistic);
-        }
+    data->stats =
+        (per_method_stats*)gpr_malloc(sizeof(per_method_stats) * g_num_methods);
+    for (i = 0; i < g_num_methods; i++) {
+      registered_method* m = &g_methods[i];
+      if (merge_shards(is_client ? m->client_shards : m->server_shards, now,
+                       &data->stats[n])) {
+        data->stats[n].method = gpr_strdup(m->name);
+        n++;
       }
-      gpr_free(kv);
     }
+    if (n == 0) {
+      gpr_free(data->stats);
+      data->stats = NULL;
+    }
+    data->num_entries = n;
   }
   gpr_mu_unlock(&g_mu);
 }
 
 void census_get_client_stats(census_aggregated_rpc_stats* data) {
-  get_stats(g_client_stats_store, data);
+  get_stats(1, data);
 }
 
 void census_get_server_stats(census_aggregated_rpc_stats* data) {
-  get_stats(g_server_stats_store, data);
+  get_stats(0, data);
 }
 
 void census_stats_store_init(void) {
   init_mutex_once();
   gpr_mu_lock(&g_mu);
-  if (g_client_stats_store == NULL && g_server_stats_store == NULL) {
-    g_client_stats_store = census_ht_create(&ht_opt);
-    g_server_stats_store = census_ht_create(&ht_opt);
+  if (!gpr_atm_no_barrier_load(&g_initialized)) {
+    gpr_atm_rel_store(&g_initialized, 1);
   } else {
     gpr_log(GPR_ERROR, "Census stats store already initialized.");
   }
@@ -234,19 +357,17 @@ void census_stats_store_init(void) {
 }
 
 void census_stats_store_shutdown(void) {
+  int i;
   init_mutex_once();
   gpr_mu_lock(&g_mu);
-  if (g_client_stats_store != NULL) {
-    census_ht_destroy(g_client_stats_store);
-    g_client_stats_store = NULL;
-  } else {
-    gpr_log(GPR_ERROR, "Census server stats store not initialized.");
-  }
-  if (g_server_stats_store != NULL) {
-    census_ht_destroy(g_server_stats_store);
-    g_server_stats_store = NULL;
+  if (gpr_atm_no_barrier_load(&g_initialized)) {
+    gpr_atm_rel_store(&g_initialized, 0);
+    for (i = 0; i < g_num_methods; i++) {
+      clear_shards(g_methods[i].client_shards);
+      clear_shards(g_methods[i].server_shards);
+    }
   } else {
-    gpr_log(GPR_ERROR, "Census client stats store not initialized.");
+    gpr_log(GPR_ERROR, "Census stats store not initialized.");
   }
   gpr_mu_unlock(&g_mu);
 }
@@ -70,6 +70,18 @@ typedef struct census_aggregated_rpc_stats {
 /* Initializes an aggregated rpc stats object to an empty state. */
 void census_aggregated_rpc_stats_set_empty(census_aggregated_rpc_stats* data);
 
+/* Integer id of a method in the stats store. Method names are resolved to
+   ids once, so that recording stats does not look them up. */
+typedef int census_method_id;
+
+#define CENSUS_INVALID_METHOD_ID (-1)
+
+/* Returns the id of method, registering it if needed. Looking up an already
+   registered method takes no lock. Returns CENSUS_INVALID_METHOD_ID if the
+   registry is full. Methods can be registered whether or not the stats store
+   is initialized, and ids stay valid for the lifetime of the process. */
+census_method_id census_stats_register_method(const char* method);
+
 /* Records client side stats of a rpc. */
 void census_record_rpc_client_stats(census_op_id op_id,
                                     const census_rpc_stats* stats);
@@ -78,6 +90,15 @@ void census_record_rpc_client_stats(census_op_id op_id,
 void census_record_rpc_server_stats(census_op_id op_id,
                                     const census_rpc_stats* stats);
 
+/* Same as above, for callers that already know the method id. Stats are
+   recorded in per core shards and only merged by census_get_*_stats. Recording
+   against CENSUS_INVALID_METHOD_ID, or while the store is not initialized, is a
+   no-op. */
+void census_record_rpc_client_stats_by_method(census_method_id method_id,
+                                              const census_rpc_stats* stats);
+void census_record_rpc_server_stats_by_method(census_method_id method_id,
+                                              const census_rpc_stats* stats);
+
 /* The following two functions are intended for inprocess query of
    per-service per-method stats from grpc implementations. */
 
@@ -37,161 +37,403 @@
 #include <stdio.h>
 #include <string.h>
 
-#include "src/core/statistics/hash_table.h"
+#include "src/core/statistics/census_log.h"
 #include "src/core/support/string.h"
 #include <grpc/support/alloc.h>
+#include <grpc/support/atm.h>
+#include <grpc/support/cpu.h>
 #include <grpc/support/log.h>
 #include <grpc/support/port_platform.h>
 #include <grpc/support/sync.h>
+#include <grpc/support/useful.h>
 
-void census_trace_obj_destroy(census_trace_obj* obj) {
-  census_trace_annotation* p = obj->annotations;
-  while (p != NULL) {
-    census_trace_annotation* next = p->next;
-    gpr_free(p);
-    p = next;
-  }
-  gpr_free(obj->method);
-  gpr_free(obj);
-}
+/* Active traces are spread over one shard per core (up to MAX_SHARDS). Each
+   shard owns a pool of preallocated trace slots, so that starting, annotating
+   and ending an op only takes the lock of the shard it was started on. */
+#define MAX_SHARDS 16
 
-static void delete_trace_obj(void* obj) {
-  census_trace_obj_destroy((census_trace_obj*)obj);
+/* Slots are allocated in chunks of 2^SLOT_CHUNK_LOG. */
+#define SLOT_CHUNK_LOG 5
+#define SLOT_CHUNK_SIZE (1 << SLOT_CHUNK_LOG)
+
+/* An op id is (shard index << SLOT_INDEX_BITS | slot index, generation).
+   Generations come from a global counter and are never 0, which marks free
+   slots. */
+#define SLOT_INDEX_BITS 24
+#define MAX_SLOTS_PER_SHARD (1 << SLOT_INDEX_BITS)
+
+/* Method names up to this length are stored in the slot itself. */
+#define INLINE_METHOD_LENGTH 63
+
+typedef struct trace_slot {
+  /* obj.annotations chains entries of arena, newest first */
+  census_trace_obj obj;
+  census_trace_annotation arena[CENSUS_MAX_TRACE_ANNOTATIONS];
+  gpr_uint32 num_annotations;
+  gpr_uint32 num_dropped_annotations;
+  char method_buf[INLINE_METHOD_LENGTH + 1];
+  struct trace_slot* next_free;
+} trace_slot;
+
+/* Cacheline sized, so that neighbouring shards don't share cachelines. */
+typedef union trace_shard {
+  struct {
+    gpr_mu mu;
+    trace_slot** chunks;
+    size_t num_chunks;
+    trace_slot* free_list;
+  } s;
+  char padding[GPR_CACHELINE_SIZE];
+} trace_shard;
+
+/* Layout of a completed trace in the census log. The record is followed by
+   method_length bytes of method name, then num_annotations entries of
+   log_annotation, each followed by its text. Records are not aligned within
+   the log and are copied out before being read. */
+typedef struct log_record {
+  gpr_uint32 record_size;
+  census_op_id id;
+  gpr_timespec ts;
+  census_rpc_stats rpc_stats;
+  census_method_id method_id;
+  gpr_uint32 method_length;
+  gpr_uint32 num_annotations;
+} log_record;
+
+typedef struct log_annotation {
+  gpr_timespec ts;
+  gpr_uint32 length;
+} log_annotation;
+
+/* Ensure mu is only initialized once. */
+static gpr_once g_init_mu_once = GPR_ONCE_INIT;
+/* Guards initialization and shutdown of the trace store. */
+static gpr_mu g_init_mu;
+static trace_shard* g_shards = NULL;
+static unsigned g_num_shards;
+static gpr_atm g_generation;
+/* Completed traces, in a log of their own so that nothing else writing to
+   the process wide census log gets mistaken for a trace. Created and
+   destroyed along with g_shards. */
+static census_log* g_trace_log = NULL;
+
+static void init_mutex(void) { gpr_mu_init(&g_init_mu); }
+
+static void init_mutex_once(void) {
+  gpr_once_init(&g_init_mu_once, init_mutex);
 }
 
-static const census_ht_option ht_opt = {
-    CENSUS_HT_UINT64 /* key type*/, 571 /* n_of_buckets */, NULL /* hash */,
-    NULL /* compare_keys */, delete_trace_obj /* delete data */,
-    NULL /* delete key */
-};
+static void free_method(trace_slot* slot) {
+  if (slot->obj.method != slot->method_buf) {
+    gpr_free(slot->obj.method);
+  }
+  slot->obj.method = NULL;
+}
 
-static gpr_once g_init_mutex_once = GPR_ONCE_INIT;
-static gpr_mu g_mu; /* Guards following two static variables. */
-static census_ht* g_trace_store = NULL;
-static gpr_uint64 g_id = 0;
+/* Returns the shard op_id was started on, or NULL. */
+static trace_shard* shard_of(census_op_id op_id) {
+  gpr_uint32 shard_index = op_id.upper >> SLOT_INDEX_BITS;
+  if (g_shards == NULL || shard_index >= g_num_shards) return NULL;
+  return &g_shards[shard_index];
+}
 
-static census_ht_key op_id_as_key(census_op_id* id) {
-  return *(census_ht_key*)id;
+/* Returns the slot of op_id if it is active, or NULL. Requires the lock of
+   shard. */
+static trace_slot* find_slot(trace_shard* shard, census_op_id op_id) {
+  gpr_uint32 slot_index = op_id.upper & (MAX_SLOTS_PER_SHARD - 1);
+  trace_slot* slot;
+  if ((slot_index >> SLOT_CHUNK_LOG) >= shard->s.num_chunks) return NULL;
+  slot = &shard->s.chunks[slot_index >> SLOT_CHUNK_LOG]
+                         [slot_index & (SLOT_CHUNK_SIZE - 1)];
+  if (op_id.lower == 0 || slot->obj.id.lower != op_id.lower) return NULL;
+  return slot;
 }
 
-static gpr_uint64 op_id_2_uint64(census_op_id* id) {
-  gpr_uint64 ret;
-  memcpy(&ret, id, sizeof(census_op_id));
-  return ret;
+/* Locks the shard of op_id and returns its slot. Returns NULL, with no lock
+   held, if the op is not active. */
+static trace_slot* lock_slot(census_op_id op_id, trace_shard** shard) {
+  trace_slot* slot;
+  *shard = shard_of(op_id);
+  if (*shard == NULL) return NULL;
+  gpr_mu_lock(&(*shard)->s.mu);
+  slot = find_slot(*shard, op_id);
+  if (slot == NULL) gpr_mu_unlock(&(*shard)->s.mu);
+  return slot;
 }
 
-static void init_mutex(void) { gpr_mu_init(&g_mu); }
+/* Adds a chunk of free slots to shard. Requires the shard lock. Returns 0 if
+   the shard is full. */
+static int grow_shard(trace_shard* shard, gpr_uint32 shard_index) {
+  size_t chunk_index = shard->s.num_chunks;
+  trace_slot* chunk;
+  size_t i;
+  if ((chunk_index + 1) * SLOT_CHUNK_SIZE > MAX_SLOTS_PER_SHARD) return 0;
+  chunk = gpr_malloc(SLOT_CHUNK_SIZE * sizeof(trace_slot));
+  memset(chunk, 0, SLOT_CHUNK_SIZE * sizeof(trace_slot));
+  shard->s.chunks = gpr_realloc(shard->s.chunks,
+                                (chunk_index + 1) * sizeof(trace_slot*));
+  shard->s.chunks[chunk_index] = chunk;
+  shard->s.num_chunks++;
+  for (i = SLOT_CHUNK_SIZE; i > 0; i--) {
+    trace_slot* slot = &chunk[i - 1];
+    slot->obj.id.upper = (shard_index << SLOT_INDEX_BITS) |
+                         (gpr_uint32)(chunk_index * SLOT_CHUNK_SIZE + i - 1);
+    slot->next_free = shard->s.free_list;
+    shard->s.free_list = slot;
+  }
+  return 1;
+}
 
-static void init_mutex_once(void) {
-  gpr_once_init(&g_init_mutex_once, init_mutex);
+static gpr_uint32 next_generation(void) {
+  gpr_uint32 generation;
+  do {
+    generation = (gpr_uint32)gpr_atm_no_barrier_fetch_add(&g_generation, 1);
+  } while (generation == 0);
+  return generation;
 }
 
 census_op_id census_tracing_start_op(void) {
-  gpr_mu_lock(&g_mu);
-  {
-    census_trace_obj* ret = gpr_malloc(sizeof(census_trace_obj));
-    memset(ret, 0, sizeof(census_trace_obj));
-    g_id++;
-    memcpy(&ret->id, &g_id, sizeof(census_op_id));
-    ret->rpc_stats.cnt = 1;
-    ret->ts = gpr_now();
-    census_ht_insert(g_trace_store, op_id_as_key(&ret->id), (void*)ret);
-    gpr_log(GPR_DEBUG, "Start tracing for id %lu", g_id);
-    gpr_mu_unlock(&g_mu);
-    return ret->id;
+  census_op_id ret;
+  gpr_uint32 shard_index;
+  trace_shard* shard;
+  trace_slot* slot;
+  ret.lower = next_generation();
+  ret.upper = 0xffffffff; /* matches no slot */
+  if (g_shards == NULL) return ret;
+  shard_index = (gpr_uint32)gpr_cpu_current_cpu() % g_num_shards;
+  shard = &g_shards[shard_index];
+  gpr_mu_lock(&shard->s.mu);
+  if (shard->s.free_list == NULL && !grow_shard(shard, shard_index)) {
+    gpr_mu_unlock(&shard->s.mu);
+    gpr_log(GPR_ERROR, "Too many active census traces.");
+    return ret;
   }
+  slot = shard->s.free_list;
+  shard->s.free_list = slot->next_free;
+  slot->next_free = NULL;
+  slot->obj.id.lower = ret.lower;
+  slot->obj.ts = gpr_now();
+  memset(&slot->obj.rpc_stats, 0, sizeof(slot->obj.rpc_stats));
+  slot->obj.rpc_stats.cnt = 1;
+  slot->obj.method = NULL;
+  slot->obj.method_id = CENSUS_INVALID_METHOD_ID;
+  slot->obj.annotations = NULL;
+  slot->num_annotations = 0;
+  slot->num_dropped_annotations = 0;
+  ret.upper = slot->obj.id.upper;
+  gpr_mu_unlock(&shard->s.mu);
+  return ret;
 }
 
 int census_add_method_tag(census_op_id op_id, const char* method) {
-  int ret = 0;
-  census_trace_obj* trace = NULL;
-  gpr_mu_lock(&g_mu);
-  trace = census_ht_find(g_trace_store, op_id_as_key(&op_id));
-  if (trace == NULL) {
-    ret = 1;
+  return census_add_method_tag_with_id(op_id, method,
+                                       census_stats_register_method(method));
+}
+
+int census_add_method_tag_with_id(census_op_id op_id, const char* method,
+                                  census_method_id method_id) {
+  size_t len = strlen(method);
+  trace_shard* shard;
+  trace_slot* slot = lock_slot(op_id, &shard);
+  if (slot == NULL) return 1;
+  free_method(slot);
+  if (len <= INLINE_METHOD_LENGTH) {
+    memcpy(slot->method_buf, method, len + 1);
+    slot->obj.method = slot->method_buf;
   } else {
-    trace->method = gpr_strdup(method);
+    slot->obj.method = gpr_strdup(method);
   }
-  gpr_mu_unlock(&g_mu);
-  return ret;
+  slot->obj.method_id = method_id;
+  gpr_mu_unlock(&shard->s.mu);
+  return 0;
 }
 
 void census_tracing_print(census_op_id op_id, const char* anno_txt) {
-  census_trace_obj* trace = NULL;
-  gpr_mu_lock(&g_mu);
-  trace = census_ht_find(g_trace_store, op_id_as_key(&op_id));
-  if (trace != NULL) {
-    census_trace_annotation* anno = gpr_malloc(sizeof(census_trace_annotation));
-    anno->ts = gpr_now();
-    {
-      char* d = anno->txt;
-      const char* s = anno_txt;
-      int n = 0;
-      for (; n < CENSUS_MAX_ANNOTATION_LENGTH && *s != '\0'; ++n) {
-        *d++ = *s++;
-      }
-      *d = '\0';
-    }
-    anno->next = trace->annotations;
-    trace->annotations = anno;
+  trace_shard* shard;
+  trace_slot* slot = lock_slot(op_id, &shard);
+  census_trace_annotation* anno;
+  size_t len;
+  if (slot == NULL) return;
+  if (slot->num_annotations == CENSUS_MAX_TRACE_ANNOTATIONS) {
+    slot->num_dropped_annotations++;
+    gpr_mu_unlock(&shard->s.mu);
+    return;
   }
-  gpr_mu_unlock(&g_mu);
+  anno = &slot->arena[slot->num_annotations++];
+  anno->ts = gpr_now();
+  for (len = 0; len < CENSUS_MAX_ANNOTATION_LENGTH && anno_txt[len] != '\0';
+       ++len) {
+  }
+  memcpy(anno->txt, anno_txt, len);
+  anno->txt[len] = '\0';
+  anno->next = slot->obj.annotations;
+  slot->obj.annotations = anno;
+  gpr_mu_unlock(&shard->s.mu);
 }
 
-void census_tracing_end_op(census_op_id op_id) {
-  census_trace_obj* trace = NULL;
-  gpr_mu_lock(&g_mu);
-  trace = census_ht_find(g_trace_store, op_id_as_key(&op_id));
-  if (trace != NULL) {
-    trace->rpc_stats.elapsed_time_ms =
-        gpr_timespec_to_micros(gpr_time_sub(gpr_now(), trace->ts));
-    gpr_log(GPR_DEBUG, "End tracing for id %lu, method %s, latency %f us",
-            op_id_2_uint64(&op_id), trace->method,
-            trace->rpc_stats.elapsed_time_ms);
-    census_ht_erase(g_trace_store, op_id_as_key(&op_id));
+/* Appends the trace in slot to the census log. Drops it if the log is out of
+   space. */
+static void flush_to_log(trace_slot* slot) {
+  log_record record;
+  log_annotation la;
+  census_trace_annotation* anno;
+  size_t size = sizeof(record);
+  size_t method_length = slot->obj.method ? strlen(slot->obj.method) : 0;
+  char* p;
+  char* start;
+  for (anno = slot->obj.annotations; anno != NULL; anno = anno->next) {
+    size += sizeof(la) + strlen(anno->txt);
   }
-  gpr_mu_unlock(&g_mu);
+  /* annotations are bounded well below the maximum record size, truncate
+     the method name if needed */
+  method_length =
+      GPR_MIN(method_length, CENSUS_LOG_MAX_RECORD_SIZE - size);
+  size += method_length;
+  start = p = census_log_start_write_in(g_trace_log, size);
+  if (p == NULL) return;
+  record.record_size = (gpr_uint32)size;
+  record.id = slot->obj.id;
+  record.ts = slot->obj.ts;
+  record.rpc_stats = slot->obj.rpc_stats;
+  record.method_id = slot->obj.method_id;
+  record.method_length = (gpr_uint32)method_length;
+  record.num_annotations = slot->num_annotations;
+  memcpy(p, &record, sizeof(record));
+  p += sizeof(record);
+  memcpy(p, slot->obj.method, method_length);
+  p += method_length;
+  for (anno = slot->obj.annotations; anno != NULL; anno = anno->next) {
+    la.ts = anno->ts;
+    la.length = (gpr_uint32)strlen(anno->txt);
+    memcpy(p, &la, sizeof(la));
+    p += sizeof(la);
+    memcpy(p, anno->txt, la.length);
+    p += la.length;
+  }
+  census_log_end_write_in(g_trace_log, start, size);
+}
+
+void census_tracing_end_op(census_op_id op_id) {
+  trace_shard* shard;
+  trace_slot* slot = lock_slot(op_id, &shard);
+  if (slot == NULL) return;
+  slot->obj.rpc_stats.elapsed_time_ms =
+      gpr_timespec_to_micros(gpr_time_sub(gpr_now(), slot->obj.ts));
+  flush_to_log(slot);
+  free_method(slot);
+  slot->obj.id.lower = 0;
+  slot->next_free = shard->s.free_list;
+  shard->s.free_list = slot;
+  gpr_mu_unlock(&shard->s.mu);
 }
 
 void census_tracing_init(void) {
+  unsigned i;
   init_mutex_once();
-  gpr_mu_lock(&g_mu);
-  if (g_trace_store == NULL) {
-    g_id = 1;
-    g_trace_store = census_ht_create(&ht_opt);
+  gpr_mu_lock(&g_init_mu);
+  if (g_shards == NULL) {
+    g_num_shards = GPR_CLAMP(gpr_cpu_num_cores(), 1, MAX_SHARDS);
+    g_shards = gpr_malloc_aligned(g_num_shards * sizeof(trace_shard),
+                                  GPR_CACHELINE_SIZE_LOG);
+    for (i = 0; i < g_num_shards; i++) {
+      gpr_mu_init(&g_shards[i].s.mu);
+      g_shards[i].s.chunks = NULL;
+      g_shards[i].s.num_chunks = 0;
+      g_shards[i].s.free_list = NULL;
+    }
+    gpr_atm_rel_store(&g_generation, 1);
+    g_trace_log = census_log_create(CENSUS_TRACE_LOG_SIZE_IN_MB,
+                                    1 /* discard old records */);
   } else {
     gpr_log(GPR_ERROR, "Census trace store already initialized.");
   }
-  gpr_mu_unlock(&g_mu);
+  gpr_mu_unlock(&g_init_mu);
 }
 
 void census_tracing_shutdown(void) {
-  gpr_mu_lock(&g_mu);
-  if (g_trace_store != NULL) {
-    census_ht_destroy(g_trace_store);
-    g_trace_store = NULL;
+  unsigned i;
+  size_t j, k;
+  init_mutex_once();
+  gpr_mu_lock(&g_init_mu);
+  if (g_shards != NULL) {
+    for (i = 0; i < g_num_shards; i++) {
+      trace_shard* shard = &g_shards[i];
+      for (j = 0; j < shard->s.num_chunks; j++) {
+        for (k = 0; k < SLOT_CHUNK_SIZE; k++) {
+          free_method(&shard->s.chunks[j][k]);
+        }
+        gpr_free(shard->s.chunks[j]);
+      }
+      gpr_free(shard->s.chunks);
+      gpr_mu_destroy(&shard->s.mu);
+    }
+    gpr_free_aligned(g_shards);
+    g_shards = NULL;
+    census_log_destroy(g_trace_log);
+    g_trace_log = NULL;
   } else {
     gpr_log(GPR_ERROR, "Census trace store is not initialized.");
   }
-  gpr_mu_unlock(&g_mu);
+  gpr_mu_unlock(&g_init_mu);
 }
 
-void census_internal_lock_trace_store(void) { gpr_mu_lock(&g_mu); }
+void census_internal_lock_trace_store(void) {
+  unsigned i;
+  if (g_shards == NULL) return;
+  for (i = 0; i < g_num_shards; i++) {
+    gpr_mu_lock(&g_shards[i].s.mu);
+  }
+}
 
-void census_internal_unlock_trace_store(void) { gpr_mu_unlock(&g_mu); }
+void census_internal_unlock_trace_store(void) {
+  unsigned i;
+  if (g_shards == NULL) return;
+  for (i = g_num_shards; i > 0; i--) {
+    gpr_mu_unlock(&g_shards[i - 1].s.mu);
+  }
+}
 
 census_trace_obj* census_get_trace_obj_locked(census_op_id op_id) {
-  if (g_trace_store == NULL) {
+  trace_shard* shard;
+  trace_slot* slot;
+  if (g_shards == NULL) {
     gpr_log(GPR_ERROR, "Census trace store is not initialized.");
     return NULL;
   }
-  return (census_trace_obj*)census_ht_find(g_trace_store, op_id_as_key(&op_id));
+  shard = shard_of(op_id);
+  slot = shard == NULL ? NULL : find_slot(shard, op_id);
+  return slot == NULL ? NULL : &slot->obj;
+}
+
+census_method_id census_tracing_get_method_id(census_op_id op_id) {
+  census_method_id ret;
+  trace_shard* shard;
+  trace_slot* slot = lock_slot(op_id, &shard);
+  if (slot == NULL) return CENSUS_INVALID_METHOD_ID;
+  ret = slot->obj.method_id;
+  gpr_mu_unlock(&shard->s.mu);
+  return ret;
 }
 
 const char* census_get_trace_method_name(const census_trace_obj* trace) {
   return trace->method;
 }
 
+census_method_id census_get_trace_method_id(const census_trace_obj* trace) {
+  return trace->method_id;
+}
+
+void census_trace_obj_destroy(census_trace_obj* obj) {
+  census_trace_annotation* p = obj->annotations;
+  while (p != NULL) {
+    census_trace_annotation* next = p->next;
+    gpr_free(p);
+    p = next;
+  }
+  gpr_free(obj->method);
+  gpr_free(obj);
+}
+
 static census_trace_annotation* dup_annotation_chain(
     census_trace_annotation* from) {
   census_trace_annotation *ret = NULL;
@@ -212,26 +454,110 @@ static census_trace_obj* trace_obj_dup(census_trace_obj* from) {
   to->ts = from->ts;
   to->rpc_stats = from->rpc_stats;
   to->method = gpr_strdup(from->method);
+  to->method_id = from->method_id;
   to->annotations = dup_annotation_chain(from->annotations);
   return to;
 }
 
+/* Appends trace_obj_dup of the active slots of shard to *ops. Requires the
+   shard lock. */
+static void dup_active_slots(trace_shard* shard, census_trace_obj*** ops,
+                             size_t* n, size_t* capacity) {
+  size_t i, j;
+  for (i = 0; i < shard->s.num_chunks; i++) {
+    for (j = 0; j < SLOT_CHUNK_SIZE; j++) {
+      trace_slot* slot = &shard->s.chunks[i][j];
+      if (slot->obj.id.lower == 0) continue;
+      if (*n == *capacity) {
+        *capacity = GPR_MAX(8, 2 * *capacity);
+        *ops = gpr_realloc(*ops, *capacity * sizeof(census_trace_obj*));
+      }
+      (*ops)[(*n)++] = trace_obj_dup(&slot->obj);
+    }
+  }
+}
+
 census_trace_obj** census_get_active_ops(int* num_active_ops) {
   census_trace_obj** ret = NULL;
-  gpr_mu_lock(&g_mu);
-  if (g_trace_store != NULL) {
-    size_t n = 0;
-    census_ht_kv* all_kvs = census_ht_get_all_elements(g_trace_store, &n);
-    *num_active_ops = (int)n;
-    if (n != 0 ) {
-      size_t i = 0;
-      ret = gpr_malloc(sizeof(census_trace_obj *) * n);
-      for (i = 0; i < n; i++) {
-        ret[i] = trace_obj_dup((census_trace_obj*)all_kvs[i].v);
+  size_t n = 0;
+  size_t capacity = 0;
+  unsigned i;
+  gpr_mu_lock(&g_init_mu);
+  if (g_shards != NULL) {
+    for (i = 0; i < g_num_shards; i++) {
+      gpr_mu_lock(&g_shards[i].s.mu);
+      dup_active_slots(&g_shards[i], &ret, &n, &capacity);
+      gpr_mu_unlock(&g_shards[i].s.mu);
+    }
+  }
+  gpr_mu_unlock(&g_init_mu);
+  *num_active_ops = (int)n;
+  return ret;
+}
+
+/* Decodes the log record at data into a new trace object. */
+static census_trace_obj* trace_obj_from_record(const char* data) {
+  log_record record;
+  log_annotation la;
+  census_trace_annotation** next_anno;
+  census_trace_obj* obj = gpr_malloc(sizeof(census_trace_obj));
+  gpr_uint32 i;
+  memcpy(&record, data, sizeof(record));
+  data += sizeof(record);
+  obj->id = record.id;
+  obj->ts = record.ts;
+  obj->rpc_stats = record.rpc_stats;
+  obj->method_id = record.method_id;
+  obj->method = NULL;
+  if (record.method_length > 0) {
+    obj->method = gpr_malloc(record.method_length + 1);
+    memcpy(obj->method, data, record.method_length);
+    obj->method[record.method_length] = '\0';
+  }
+  data += record.method_length;
+  obj->annotations = NULL;
+  next_anno = &obj->annotations;
+  for (i = 0; i < record.num_annotations; i++) {
+    census_trace_annotation* anno = gpr_malloc(sizeof(*anno));
+    memcpy(&la, data, sizeof(la));
+    data += sizeof(la);
+    anno->ts = la.ts;
+    memcpy(anno->txt, data, la.length);
+    anno->txt[la.length] = '\0';
+    data += la.length;
+    anno->next = NULL;
+    *next_anno = anno;
+    next_anno = &anno->next;
+  }
+  return obj;
+}
+
+census_trace_obj** census_get_completed_ops(int* num_completed_ops) {
+  census_trace_obj** ret = NULL;
+  size_t n = 0;
+  size_t capacity = 0;
+  gpr_mu_lock(&g_init_mu);
+  if (g_shards != NULL) {
+    const char* block;
+    size_t bytes_available;
+    census_log_init_reader_in(g_trace_log);
+    while ((block = census_log_read_next_in(g_trace_log, &bytes_available)) !=
+           NULL) {
+      while (bytes_available >= sizeof(log_record)) {
+        gpr_uint32 record_size;
+        memcpy(&record_size, block, sizeof(record_size));
+        GPR_ASSERT(record_size <= bytes_available);
+        if (n == capacity) {
+          capacity = GPR_MAX(8, 2 * capacity);
+          ret = gpr_realloc(ret, capacity * sizeof(census_trace_obj*));
+        }
+        ret[n++] = trace_obj_from_record(block);
+        block += record_size;
+        bytes_available -= record_size;
       }
     }
-    gpr_free(all_kvs);
   }
-  gpr_mu_unlock(&g_mu);
+  gpr_mu_unlock(&g_init_mu);
+  *num_completed_ops = (int)n;
   return ret;
 }
@@ -46,6 +46,14 @@
 extern "C" {
 #endif
 
+/* Maximum number of annotations kept per trace. Later annotations are
+   dropped. */
+#define CENSUS_MAX_TRACE_ANNOTATIONS 16
+
+/* Size of the census log that completed traces are flushed to, enough for
+   tens of thousands of traces. Oldest traces are discarded first. */
+#define CENSUS_TRACE_LOG_SIZE_IN_MB 4
+
 /* Struct for a trace annotation. */
 typedef struct census_trace_annotation {
   gpr_timespec ts;                            /* timestamp of the annotation */
@@ -58,13 +66,16 @@ typedef struct census_trace_obj {
   gpr_timespec ts;
   census_rpc_stats rpc_stats;
   char* method;
+  census_method_id method_id;
   census_trace_annotation* annotations;
 } census_trace_obj;
 
-/* Deletes trace object. */
+/* Deletes trace object returned by census_get_active_ops() or
+   census_get_completed_ops(). */
 void census_trace_obj_destroy(census_trace_obj* obj);
 
-/* Initializes trace store. This function is thread safe. */
+/* Initializes trace store and the census log that completed traces are
+   written to. This function is thread safe. */
 void census_tracing_init(void);
 
 /* Shutsdown trace store. This function is thread safe. */
@@ -72,23 +83,44 @@ void census_tracing_shutdown(void);
 
 /* Gets trace obj corresponding to the input op_id. Returns NULL if trace store
    is not initialized or trace obj is not found. Requires trace store being
-   locked before calling this function. */
+   locked before calling this function. The trace obj is owned by the store
+   and is only valid while the store is locked. */
 census_trace_obj* census_get_trace_obj_locked(census_op_id op_id);
 
-/* The following two functions acquire and release the trace store global lock.
-   They are for census internal use only. */
+/* The following two functions acquire and release the locks of all trace
+   store shards. They are for census internal use only. */
 void census_internal_lock_trace_store(void);
 void census_internal_unlock_trace_store(void);
 
+/* Same as census_add_method_tag, for callers which already resolved method to
+   method_id with census_stats_register_method. */
+int census_add_method_tag_with_id(census_op_id op_id, const char* method,
+                                  census_method_id method_id);
+
+/* Returns the stats store id of the method tagged on op_id, or
+   CENSUS_INVALID_METHOD_ID. Only locks the shard of op_id. */
+census_method_id census_tracing_get_method_id(census_op_id op_id);
+
 /* Gets method name associated with the input trace object. */
 const char* census_get_trace_method_name(const census_trace_obj* trace);
 
+/* Gets the stats store id of the method associated with the input trace
+   object, CENSUS_INVALID_METHOD_ID if it has none. */
+census_method_id census_get_trace_method_id(const census_trace_obj* trace);
+
 /* Returns an array of pointers to trace objects of currently active operations
    and fills in number of active operations. Returns NULL if there are no active
    operations.
    Caller owns the returned objects. */
 census_trace_obj** census_get_active_ops(int* num_active_ops);
 
+/* Returns an array of pointers to trace objects of operations completed since
+   the last call, read back from the census log, and fills in their number.
+   Returns NULL if there are none. Traces are lost if the log wraps around
+   between calls.
+   Caller owns the returned objects. */
+census_trace_obj** census_get_completed_ops(int* num_completed_ops);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,419 @@
+/*
+ *
+ * Copyright 2015, Google Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer
+ * in the documentation and/or other materials provided with the
+ * distribution.
+ *     * Neither the name of Google Inc. nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+
+#include "src/core/support/hdr_histogram.h"
+
+#include <float.h>
+#include <string.h>
+
+#include <grpc/support/alloc.h>
+#include <grpc/support/atm.h>
+#include <grpc/support/log.h>
+#include <grpc/support/sync.h>
+#include <grpc/support/useful.h>
+
+/* Values are bucketed as integers. With s = sub_bucket_bits and
+   half = 2^(s-1), a value v with k = max(0, msb(v) - s + 1) falls in bucket
+   (k * half) + (v >> k). Bucket i starts at
+   (i - k * half) << k, where k = max(0, i / half - 1), and is 2^k wide. */
+
+/* Largest value that can be bucketed. */
+#define MAX_TRACKABLE_VALUE ((gpr_uint64)1 << 62)
+
+/* The exact sum, sum of squares, minimum and maximum of the added values.
+   Where a double fits in a gpr_atm they are stored as bit patterns and
+   updated with compare and swap, so adding stays lock free; elsewhere they
+   are protected by a mutex. */
+enum { STAT_SUM, STAT_SUM_OF_SQUARES, STAT_MIN, STAT_MAX, STAT_COUNT };
+
+#if defined(GPR_ARCH_64)
+#define GPR_HDR_HISTOGRAM_ATOMIC_STATS
+#endif
+
+struct gpr_hdr_histogram {
+  int sub_bucket_bits;
+  gpr_uint64 max_value;
+  size_t num_buckets;
+  gpr_atm *buckets;
+#ifdef GPR_HDR_HISTOGRAM_ATOMIC_STATS
+  gpr_atm stats[STAT_COUNT];
+#else
+  gpr_mu stats_mu;
+  double stats[STAT_COUNT];
+#endif
+};
+
+static double combine_stat(int stat, double a, double b) {
+  switch (stat) {
+    case STAT_MIN:
+      return GPR_MIN(a, b);
+    case STAT_MAX:
+      return GPR_MAX(a, b);
+    default:
+      return a + b;
+  }
+}
+
+#ifdef GPR_HDR_HISTOGRAM_ATOMIC_STATS
+static gpr_atm double_to_atm(double d) {
+  gpr_atm a;
+  memcpy(&a, &d, sizeof(a));
+  return a;
+}
+
+static double atm_to_double(gpr_atm a) {
+  double d;
+  memcpy(&d, &a, sizeof(d));
+  return d;
+}
+
+static void init_stat(gpr_hdr_histogram *h, int stat, double value) {
+  h->stats[stat] = double_to_atm(value);
+}
+
+static double load_stat(const gpr_hdr_histogram *h, int stat) {
+  return atm_to_double(gpr_atm_no_barrier_load(&h->stats[stat]));
+}
+
+static void update_stat(gpr_hdr_histogram *h, int stat, double x) {
+  gpr_atm old;
+  gpr_atm updated;
+  do {
+    old = gpr_atm_no_barrier_load(&h->stats[stat]);
+    updated = double_to_atm(combine_stat(stat, atm_to_double(old), x));
+    if (updated == old) return;
+  } while (!gpr_atm_no_barrier_cas(&h->stats[stat], old, updated));
+}
+#else
+static void init_stat(gpr_hdr_histogram *h, int stat, double value) {
+  h->stats[stat] = value;
+}
+
+static double load_stat(const gpr_hdr_histogram *h, int stat) {
+  double value;
+  gpr_mu_lock((gpr_mu *)&h->stats_mu);
+  value = h->stats[stat];
+  gpr_mu_unlock((gpr_mu *)&h->stats_mu);
+  return value;
+}
+
+static void update_stat(gpr_hdr_histogram *h, int stat, double x) {
+  gpr_mu_lock(&h->stats_mu);
+  h->stats[stat] = combine_stat(stat, h->stats[stat], x);
+  gpr_mu_unlock(&h->stats_mu);
+}
+#endif
+
+static void update_stats(gpr_hdr_histogram *h, double sum,
+                         double sum_of_squares, double min_seen,
+                         double max_seen) {
+  update_stat(h, STAT_SUM, sum);
+  update_stat(h, STAT_SUM_OF_SQUARES, sum_of_squares);
+  update_stat(h, STAT_MIN, min_seen);
+  update_stat(h, STAT_MAX, max_seen);
+}
+
+/* index of the most significant set bit of v, which must not be 0 */
+static int msb_index(gpr_uint64 v) {
+#if defined(__GNUC__)
+  return 63 - __builtin_clzll(v);
+#else
+  int n = 0;
+  if (v >> 32) {
+    v >>= 32;
+    n += 32;
+  }
+  if (v >> 16) {
+    v >>= 16;
+    n += 16;
+  }
+  if (v >> 8) {
+    v >>= 8;
+    n += 8;
+  }
+  if (v >> 4) {
+    v >>= 4;
+    n += 4;
+  }
+  if (v >> 2) {
+    v >>= 2;
+    n += 2;
+  }
+  return n + (int)(v >> 1);
+#endif
+}
+
+static size_t bucket_for(const gpr_hdr_histogram *h, gpr_uint64 v) {
+  int k = 0;
+  if (v >> h->sub_bucket_bits) {
+    k = msb_index(v) - h->sub_bucket_bits + 1;
+  }
+  return ((size_t)k << (h->sub_bucket_bits - 1)) + (size_t)(v >> k);
+}
+
+static int bucket_shift(const gpr_hdr_histogram *h, size_t bucket) {
+  int k = (int)(bucket >> (h->sub_bucket_bits - 1)) - 1;
+  return GPR_MAX(k, 0);
+}
+
+static gpr_uint64 bucket_start(const gpr_hdr_histogram *h, size_t bucket) {
+  int k = bucket_shift(h, bucket);
+  return (gpr_uint64)(bucket - ((size_t)k << (h->sub_bucket_bits - 1))) << k;
+}
+
+static gpr_uint64 bucket_width(const gpr_hdr_histogram *h, size_t bucket) {
+  return (gpr_uint64)1 << bucket_shift(h, bucket);
+}
+
+static gpr_atm load_bucket(const gpr_hdr_histogram *h, size_t bucket) {
+  return gpr_atm_no_barrier_load(&h->buckets[bucket]);
+}
+
+/* Returns the number of values recorded, and sets *first and *last to the
+   first and last non empty buckets, in a single pass over the buckets. */
+static double summarize(const gpr_hdr_histogram *h, size_t *first,
+                        size_t *last) {
+  gpr_int64 count = 0;
+  size_t i;
+  *first = *last = h->num_buckets;
+  for (i = 0; i < h->num_buckets; i++) {
+    gpr_atm c = load_bucket(h, i);
+    if (c == 0) continue;
+    if (*first == h->num_buckets) *first = i;
+    *last = i;
+    count += c;
+  }
+  return (double)count;
+}
+
+static double bucket_end(const gpr_hdr_histogram *h, size_t bucket) {
+  return (double)GPR_MIN(bucket_start(h, bucket) + bucket_width(h, bucket) - 1,
+                         h->max_value);
+}
+
+gpr_hdr_histogram *gpr_hdr_histogram_create(double resolution,
+                                            double max_value) {
+  gpr_hdr_histogram *h = gpr_malloc(sizeof(gpr_hdr_histogram));
+  GPR_ASSERT(resolution > 0.0);
+  GPR_ASSERT(max_value >= 1.0);
+  /* buckets past the first 2^s are at most 2^(1-s) times their start wide */
+  h->sub_bucket_bits = 1;
+  while (h->sub_bucket_bits < 30 &&
+         1.0 / (double)(1 << (h->sub_bucket_bits - 1)) > resolution) {
+    h->sub_bucket_bits++;
+  }
+  h->max_value = max_value >= (double)MAX_TRACKABLE_VALUE
+                     ? MAX_TRACKABLE_VALUE
+                     : (gpr_uint64)max_value;
+  h->num_buckets = bucket_for(h, h->max_value) + 1;
+  h->buckets = gpr_malloc(sizeof(gpr_atm) * h->num_buckets);
+  memset(h->buckets, 0, sizeof(gpr_atm) * h->num_buckets);
+#ifndef GPR_HDR_HISTOGRAM_ATOMIC_STATS
+  gpr_mu_init(&h->stats_mu);
+#endif
+  init_stat(h, STAT_SUM, 0.0);
+  init_stat(h, STAT_SUM_OF_SQUARES, 0.0);
+  init_stat(h, STAT_MIN, DBL_MAX);
+  init_stat(h, STAT_MAX, -DBL_MAX);
+  return h;
+}
+
+void gpr_hdr_histogram_destroy(gpr_hdr_histogram *h) {
+#ifndef GPR_HDR_HISTOGRAM_ATOMIC_STATS
+  gpr_mu_destroy(&h->stats_mu);
+#endif
+  gpr_free(h->buckets);
+  gpr_free(h);
+}
+
+void gpr_hdr_histogram_add(gpr_hdr_histogram *h, double x) {
+  gpr_uint64 v;
+  if (x <= 0.0) {
+    v = 0;
+  } else if (x >= (double)h->max_value) {
+    v = h->max_value;
+  } else {
+    v = (gpr_uint64)x;
+  }
+  gpr_atm_no_barrier_fetch_add(&h->buckets[bucket_for(h, v)], 1);
+  update_stats(h, x, x * x, x, x);
+}
+
+int gpr_hdr_histogram_merge(gpr_hdr_histogram *dst,
+                            const gpr_hdr_histogram *src) {
+  size_t i;
+  if (dst->sub_bucket_bits != src->sub_bucket_bits ||
+      dst->num_buckets != src->num_buckets) {
+    return 0;
+  }
+  for (i = gpr_hdr_histogram_next_nonempty_bucket(src, 0);
+       i < src->num_buckets;
+       i = gpr_hdr_histogram_next_nonempty_bucket(src, i + 1)) {
+    gpr_atm_no_barrier_fetch_add(&dst->buckets[i], load_bucket(src, i));
+  }
+  update_stats(dst, load_stat(src, STAT_SUM),
+               load_stat(src, STAT_SUM_OF_SQUARES), load_stat(src, STAT_MIN),
+               load_stat(src, STAT_MAX));
+  return 1;
+}
+
+void gpr_hdr_histogram_merge_stats(gpr_hdr_histogram *h, double sum,
+                                   double sum_of_squares, double min_seen,
+                                   double max_seen) {
+  update_stats(h, sum, sum_of_squares, min_seen, max_seen);
+}
+
+double gpr_hdr_histogram_count(const gpr_hdr_histogram *h) {
+  size_t first, last;
+  return summarize(h, &first, &last);
+}
+
+double gpr_hdr_histogram_sum(const gpr_hdr_histogram *h) {
+  return load_stat(h, STAT_SUM);
+}
+
+double gpr_hdr_histogram_sum_of_squares(const gpr_hdr_histogram *h) {
+  return load_stat(h, STAT_SUM_OF_SQUARES);
+}
+
+double gpr_hdr_histogram_mean(const gpr_hdr_histogram *h) {
+  double count = gpr_hdr_histogram_count(h);
+  GPR_ASSERT(count > 0);
+  return gpr_hdr_histogram_sum(h) / count;
+}
+
+double gpr_hdr_histogram_minimum(const gpr_hdr_histogram *h) {
+  double min_seen = load_stat(h, STAT_MIN);
+  return min_seen == DBL_MAX ? 0.0 : min_seen;
+}
+
+double gpr_hdr_histogram_maximum(const gpr_hdr_histogram *h) {
+  double max_seen = load_stat(h, STAT_MAX);
+  return max_seen == -DBL_MAX ? 0.0 : max_seen;
+}
+
+double gpr_hdr_histogram_percentile(const gpr_hdr_histogram *h,
+                                    double percentile) {
+  size_t first, last;
+  double count = summarize(h, &first, &last);
+  double count_below = count * percentile / 100.0;
+  double count_so_far = 0.0;
+  double min_seen;
+  double max_seen;
+  double lower_bound;
+  double upper_bound;
+  size_t lower_idx;
+  size_t upper_idx;
+  gpr_atm lower_count = 0;
+
+  GPR_ASSERT(count >= 1);
+  /* the buckets bound the values; the exact extremes tighten the bounds
+     unless the stats were never merged in (see
+     gpr_hdr_histogram_merge_stats) */
+  min_seen = (double)bucket_start(h, first);
+  max_seen = bucket_end(h, last);
+  if (load_stat(h, STAT_MIN) != DBL_MAX) {
+    min_seen = GPR_CLAMP(load_stat(h, STAT_MIN), min_seen, max_seen);
+  }
+  if (load_stat(h, STAT_MAX) != -DBL_MAX) {
+    max_seen = GPR_CLAMP(load_stat(h, STAT_MAX), min_seen, max_seen);
+  }
+  if (count_below <= 0) {
+    return min_seen;
+  }
+  if (count_below >= count) {
+    return max_seen;
+  }
+
+  /* find the lowest bucket that gets us above count_below */
+  for (lower_idx = first; lower_idx < h->num_buckets; lower_idx++) {
+    lower_count = load_bucket(h, lower_idx);
+    count_so_far += lower_count;
+    if (count_so_far >= count_below) {
+      break;
+    }
+  }
+  if (lower_idx == h->num_buckets) {
+    /* raced with concurrent adds */
+    return max_seen;
+  }
+  /* buckets hold integers, so a bucket's values span [start, start+width-1] */
+  lower_bound = (double)bucket_start(h, lower_idx);
+  upper_bound = lower_bound + (double)(bucket_width(h, lower_idx) - 1);
+  if (count_so_far == count_below) {
+    /* this bucket hits the threshold exactly... we should be midway through
+       any run of empty buckets following it */
+    upper_idx = gpr_hdr_histogram_next_nonempty_bucket(h, lower_idx + 1);
+    if (upper_idx < h->num_buckets) {
+      return GPR_CLAMP((upper_bound + (double)bucket_start(h, upper_idx)) / 2.0,
+                       min_seen, max_seen);
+    }
+    return GPR_CLAMP(upper_bound, min_seen, max_seen);
+  }
+  /* treat values as uniform throughout the bucket, and find where this value
+     should lie */
+  return GPR_CLAMP(upper_bound - (upper_bound - lower_bound) *
+                                     (count_so_far - count_below) /
+                                     (double)lower_count,
+                   min_seen, max_seen);
+}
+
+size_t gpr_hdr_histogram_memory_size(const gpr_hdr_histogram *h) {
+  return sizeof(gpr_hdr_histogram) + sizeof(gpr_atm) * h->num_buckets;
+}
+
+size_t gpr_hdr_histogram_num_buckets(const gpr_hdr_histogram *h) {
+  return h->num_buckets;
+}
+
+size_t gpr_hdr_histogram_next_nonempty_bucket(const gpr_hdr_histogram *h,
+                                              size_t start) {
+  for (; start < h->num_buckets; start++) {
+    if (load_bucket(h, start) != 0) break;
+  }
+  return start;
+}
+
+gpr_uint64 gpr_hdr_histogram_bucket_count(const gpr_hdr_histogram *h,
+                                          size_t bucket) {
+  GPR_ASSERT(bucket < h->num_buckets);
+  return (gpr_uint64)load_bucket(h, bucket);
+}
+
+int gpr_hdr_histogram_add_to_bucket(gpr_hdr_histogram *h, size_t bucket,
+                                    gpr_uint64 count) {
+  if (bucket >= h->num_buckets) return 0;
+  gpr_atm_no_barrier_fetch_add(&h->buckets[bucket], (gpr_atm)count);
+  return 1;
+}
@@ -0,0 +1,108 @@
+/*
+ *
+ * Copyright 2015, Google Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer
+ * in the documentation and/or other materials provided with the
+ * distribution.
+ *     * Neither the name of Google Inc. nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+
+#ifndef GRPC_INTERNAL_CORE_SUPPORT_HDR_HISTOGRAM_H
+#define GRPC_INTERNAL_CORE_SUPPORT_HDR_HISTOGRAM_H
+
+#include <grpc/support/port_platform.h>
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* A histogram of non-negative values with log-linear buckets, in the style
+   of HdrHistogram. Values below 2^s fall in buckets of width 1; above that,
+   each power of two range is split into 2^(s-1) equal buckets. s is chosen so
+   that the width of a bucket is at most resolution times its start. Bucket
+   indices are computed with integer arithmetic only.
+
+   gpr_hdr_histogram_add may be called concurrently from any number of
+   threads without taking a lock on 64 bit platforms. The sum, sum of squares,
+   minimum and maximum are exact; the count and percentiles come from the
+   buckets. Queries that race with adds see a subset of the concurrent adds. */
+typedef struct gpr_hdr_histogram gpr_hdr_histogram;
+
+/* Creates a histogram with buckets no wider than resolution times their
+   start, covering values up to max_value. Larger values are recorded as
+   max_value. */
+gpr_hdr_histogram *gpr_hdr_histogram_create(double resolution,
+                                            double max_value);
+void gpr_hdr_histogram_destroy(gpr_hdr_histogram *h);
+
+/* Records x. Thread safe and lock free. */
+void gpr_hdr_histogram_add(gpr_hdr_histogram *h, double x);
+
+/* Adds the buckets of src to dst. Returns 0 if the histograms don't have the
+   same bucket layout, 1 on success. */
+int gpr_hdr_histogram_merge(gpr_hdr_histogram *dst,
+                            const gpr_hdr_histogram *src);
+/* Merges the exact statistics of values whose buckets were added with
+   gpr_hdr_histogram_add_to_bucket. */
+void gpr_hdr_histogram_merge_stats(gpr_hdr_histogram *h, double sum,
+                                   double sum_of_squares, double min_seen,
+                                   double max_seen);
+
+double gpr_hdr_histogram_percentile(const gpr_hdr_histogram *h,
+                                    double percentile);
+double gpr_hdr_histogram_mean(const gpr_hdr_histogram *h);
+double gpr_hdr_histogram_count(const gpr_hdr_histogram *h);
+double gpr_hdr_histogram_sum(const gpr_hdr_histogram *h);
+double gpr_hdr_histogram_sum_of_squares(const gpr_hdr_histogram *h);
+double gpr_hdr_histogram_minimum(const gpr_hdr_histogram *h);
+double gpr_hdr_histogram_maximum(const gpr_hdr_histogram *h);
+
+/* Returns the size of the memory used by h, in bytes. */
+size_t gpr_hdr_histogram_memory_size(const gpr_hdr_histogram *h);
+
+/* Sparse access to the buckets, for serialization. Histograms with the same
+   resolution and max_value have the same number of buckets, at the same
+   indices. */
+size_t gpr_hdr_histogram_num_buckets(const gpr_hdr_histogram *h);
+/* Returns the index of the first non empty bucket at or after start, or
+   gpr_hdr_histogram_num_buckets(h) if there is none. */
+size_t gpr_hdr_histogram_next_nonempty_bucket(const gpr_hdr_histogram *h,
+                                              size_t start);
+gpr_uint64 gpr_hdr_histogram_bucket_count(const gpr_hdr_histogram *h,
+                                          size_t bucket);
+/* Adds count values to bucket. Returns 0 if bucket is out of range. */
+int gpr_hdr_histogram_add_to_bucket(gpr_hdr_histogram *h, size_t bucket,
+                                    gpr_uint64 count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  /* GRPC_INTERNAL_CORE_SUPPORT_HDR_HISTOGRAM_H */
@@ -252,3 +252,13 @@ gpr_int32 gpr_time_to_millis(gpr_timespec t) {
 double gpr_timespec_to_micros(gpr_timespec t) {
   return t.tv_sec * GPR_US_PER_SEC + t.tv_nsec * 1e-3;
 }
+
+gpr_timespec gpr_clock_convert(gpr_timespec t, gpr_clock_type from,
+                               gpr_clock_type to) {
+  if (from == to || t.tv_sec == TYPE_MAX(time_t) ||
+      t.tv_sec == TYPE_MIN(time_t)) {
+    return t;
+  }
+  return gpr_time_add(gpr_clock_now(to),
+                      gpr_time_sub(t, gpr_clock_now(from)));
+}
@@ -60,6 +60,13 @@ gpr_timespec gpr_now(void) {
   clock_gettime(CLOCK_REALTIME, &now);
   return gpr_from_timespec(now);
 }
+
+gpr_timespec gpr_clock_now(gpr_clock_type clock) {
+  struct timespec now;
+  clock_gettime(clock == GPR_CLOCK_MONOTONIC ? CLOCK_MONOTONIC : CLOCK_REALTIME,
+                &now);
+  return gpr_from_timespec(now);
+}
 #else
 /* For some reason Apple's OSes haven't implemented clock_gettime. */
 
@@ -73,6 +80,9 @@ gpr_timespec gpr_now(void) {
   now.tv_nsec = now_tv.tv_usec * 1000;
   return now;
 }
+
+/* No monotonic clock without clock_gettime: use the wall clock. */
+gpr_timespec gpr_clock_now(gpr_clock_type clock) { return gpr_now(); }
 #endif
 
 void gpr_sleep_until(gpr_timespec until) {
@@ -50,6 +50,21 @@ gpr_timespec gpr_now(void) {
   return now_tv;
 }
 
+gpr_timespec gpr_clock_now(gpr_clock_type clock) {
+  gpr_timespec now_tv;
+  LARGE_INTEGER counter;
+  LARGE_INTEGER frequency;
+  if (clock != GPR_CLOCK_MONOTONIC) {
+    return gpr_now();
+  }
+  QueryPerformanceCounter(&counter);
+  QueryPerformanceFrequency(&frequency);
+  now_tv.tv_sec = (time_t)(counter.QuadPart / frequency.QuadPart);
+  now_tv.tv_nsec = (int)((counter.QuadPart % frequency.QuadPart) *
+                         GPR_NS_PER_SEC / frequency.QuadPart);
+  return now_tv;
+}
+
 void gpr_sleep_until(gpr_timespec until) {
   gpr_timespec now;
   gpr_timespec delta;
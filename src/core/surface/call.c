@@ -631,6 +631,12 @@ static int begin_message(grpc_call *call, grpc_begin_message msg) {
     gpr_free(message);
     return 0;
   }
+  if (msg.flags & GRPC_WRITE_INTERNAL_COMPRESS) {
+    /* only happens on stacks without the compression filter */
+    grpc_call_cancel_with_status(call, GRPC_STATUS_UNIMPLEMENTED,
+                                 "Received a compressed message");
+    return 0;
+  }
   /* stash away parameters, and prepare for incoming slices */
   if (msg.length > grpc_channel_get_max_message_length(call->channel)) {
     char *message = NULL;
@@ -1044,7 +1050,7 @@ static void set_deadline_alarm(grpc_call *call, gpr_timespec deadline) {
   }
   GRPC_CALL_INTERNAL_REF(call, "alarm");
   call->have_alarm = 1;
-  grpc_alarm_init(&call->alarm, deadline, call_alarm, call, gpr_now());
+  grpc_alarm_init(&call->alarm, deadline, call_alarm, call, grpc_iomgr_now());
 }
 
 /* we offset status by a small amount when storing it into transport metadata
@@ -36,9 +36,12 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "src/core/channel/client_channel.h"
+#include "src/core/iomgr/alarm.h"
 #include "src/core/iomgr/iomgr.h"
 #include "src/core/surface/call.h"
 #include "src/core/surface/client.h"
+#include "src/core/surface/completion_queue.h"
 #include "src/core/surface/init.h"
 #include <grpc/support/alloc.h>
 #include <grpc/support/log.h>
@@ -216,6 +219,76 @@ void grpc_channel_destroy(grpc_channel *channel) {
   grpc_channel_internal_unref(channel);
 }
 
+/* the stack of channel if it ends in a client channel, otherwise NULL */
+static grpc_channel_stack *client_channel_stack(grpc_channel *channel) {
+  grpc_channel_stack *stack = CHANNEL_STACK_FROM_CHANNEL(channel);
+  if (grpc_channel_stack_last_element(stack)->filter !=
+      &grpc_client_channel_filter) {
+    return NULL;
+  }
+  return stack;
+}
+
+/* the state of a channel without a client channel, which never changes */
+static grpc_connectivity_state fixed_connectivity_state(grpc_channel *channel) {
+  grpc_channel_stack *stack = CHANNEL_STACK_FROM_CHANNEL(channel);
+  return grpc_channel_stack_last_element(stack)->filter ==
+                 &grpc_lame_client_filter
+             ? GRPC_CHANNEL_FATAL_FAILURE
+             : GRPC_CHANNEL_READY;
+}
+
+grpc_connectivity_state grpc_channel_check_connectivity_state(
+    grpc_channel *channel, int try_to_connect) {
+  grpc_channel_stack *stack = client_channel_stack(channel);
+  if (stack == NULL) return fixed_connectivity_state(channel);
+  return grpc_client_channel_check_connectivity_state(stack, try_to_connect);
+}
+
+typedef struct {
+  grpc_channel *channel;
+  grpc_completion_queue *cq;
+  void *tag;
+  /* deadline of a watch on a channel whose state never changes */
+  grpc_alarm alarm;
+} state_watch;
+
+static void finish_state_watch(void *arg, int changed) {
+  state_watch *w = arg;
+  grpc_cq_end_op(w->cq, w->tag, NULL, NULL, NULL,
+                 changed ? GRPC_OP_OK : GRPC_OP_ERROR);
+  grpc_channel_internal_unref(w->channel);
+  gpr_free(w);
+}
+
+static void on_fixed_state_watch_alarm(void *arg, int success) {
+  finish_state_watch(arg, 0);
+}
+
+void grpc_channel_watch_connectivity_state(
+    grpc_channel *channel, grpc_connectivity_state last_observed_state,
+    gpr_timespec deadline, grpc_completion_queue *cq, void *tag) {
+  grpc_channel_stack *stack = client_channel_stack(channel);
+  state_watch *w = gpr_malloc(sizeof(state_watch));
+
+  grpc_cq_begin_op(cq, NULL, GRPC_OP_COMPLETE);
+  /* the channel (and so its stack) stays alive until the watch completes */
+  grpc_channel_internal_ref(channel);
+  w->channel = channel;
+  w->cq = cq;
+  w->tag = tag;
+
+  if (stack != NULL) {
+    grpc_client_channel_watch_connectivity_state(
+        stack, last_observed_state, deadline, finish_state_watch, w);
+  } else if (fixed_connectivity_state(channel) != last_observed_state) {
+    finish_state_watch(w, 1);
+  } else {
+    grpc_alarm_init(&w->alarm, deadline, on_fixed_state_watch_alarm, w,
+                    grpc_iomgr_now());
+  }
+}
+
 void grpc_client_channel_closed(grpc_channel_element *elem) {
   grpc_channel_internal_unref(CHANNEL_FROM_TOP_ELEM(elem));
 }
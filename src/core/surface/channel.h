@@ -51,4 +51,7 @@ void grpc_client_channel_closed(grpc_channel_element *elem);
 void grpc_channel_internal_ref(grpc_channel *channel);
 void grpc_channel_internal_unref(grpc_channel *channel);
 
+/* the only filter of a lame client channel */
+extern const grpc_channel_filter grpc_lame_client_filter;
+
 #endif /* GRPC_INTERNAL_CORE_SURFACE_CHANNEL_H */
@@ -42,6 +42,7 @@
 #include "src/core/channel/channel_args.h"
 #include "src/core/channel/client_channel.h"
 #include "src/core/channel/client_setup.h"
+#include "src/core/channel/compress_filter.h"
 #include "src/core/channel/connected_channel.h"
 #include "src/core/channel/http_client_filter.h"
 #include "src/core/iomgr/endpoint.h"
@@ -52,6 +53,7 @@
 #include "src/core/support/string.h"
 #include "src/core/transport/chttp2_transport.h"
 #include <grpc/support/alloc.h>
+#include <grpc/support/atm.h>
 #include <grpc/support/log.h>
 #include <grpc/support/sync.h>
 #include <grpc/support/useful.h>
@@ -62,10 +64,6 @@ typedef struct setup setup;
 typedef struct {
   grpc_client_setup_request *cs_request;
   setup *setup;
-  /* Resolved addresses, or null if resolution not yet completed */
-  grpc_resolved_addresses *resolved;
-  /* which address in resolved should we pick for the next connection attempt */
-  size_t resolved_index;
 } request;
 
 /* Global setup logic (may be running many simultaneous setup requests, but
@@ -74,15 +72,13 @@ struct setup {
   const char *target;
   grpc_transport_setup_callback setup_callback;
   void *setup_user_data;
+  /* bumped by each request so that successive connections (which may all be
+     open at once) start from different resolved addresses */
+  gpr_atm next_first_address;
 };
 
-static int maybe_try_next_resolved(request *r);
-
 static void done(request *r, int was_successful) {
   grpc_client_setup_request_finish(r->cs_request, was_successful);
-  if (r->resolved) {
-    grpc_resolved_addresses_destroy(r->resolved);
-  }
   gpr_free(r);
 }
 
@@ -100,12 +96,8 @@ static void on_connect(void *rp, grpc_endpoint *tcp) {
   }
 
   if (!tcp) {
-    if (!maybe_try_next_resolved(r)) {
-      done(r, 0);
-      return;
-    } else {
-      return;
-    }
+    done(r, 0);
+    return;
   } else if (grpc_client_setup_cb_begin(r->cs_request)) {
     grpc_create_chttp2_transport(
         r->setup->setup_callback, r->setup->setup_user_data,
@@ -119,18 +111,6 @@ static void on_connect(void *rp, grpc_endpoint *tcp) {
   }
 }
 
-/* attempt to connect to the next available resolved address */
-static int maybe_try_next_resolved(request *r) {
-  grpc_resolved_address *addr;
-  if (!r->resolved) return 0;
-  if (r->resolved_index == r->resolved->naddrs) return 0;
-  addr = &r->resolved->addrs[r->resolved_index++];
-  grpc_tcp_client_connect(on_connect, r, (struct sockaddr *)&addr->addr,
-                          addr->len,
-                          grpc_client_setup_request_deadline(r->cs_request));
-  return 1;
-}
-
 /* callback for when our target address has been resolved */
 static void on_resolved(void *rp, grpc_resolved_addresses *resolved) {
   request *r = rp;
@@ -148,11 +128,12 @@ static void on_resolved(void *rp, grpc_resolved_addresses *resolved) {
     done(r, 0);
     return;
   } else {
-    r->resolved = resolved;
-    r->resolved_index = 0;
-    if (!maybe_try_next_resolved(r)) {
-      done(r, 0);
-    }
+    grpc_tcp_client_connect_to_any(
+        on_connect, r, resolved,
+        (size_t)gpr_atm_full_fetch_add(&r->setup->next_first_address, 1),
+        grpc_client_setup_get_connect_stagger(r->cs_request),
+        grpc_client_setup_get_connect_attempt_timeout(r->cs_request),
+        grpc_client_setup_request_deadline(r->cs_request));
   }
 }
 
@@ -160,8 +141,6 @@ static void initiate_setup(void *sp, grpc_client_setup_request *cs_request) {
   request *r = gpr_malloc(sizeof(request));
   r->setup = sp;
   r->cs_request = cs_request;
-  r->resolved = NULL;
-  r->resolved_index = 0;
   /* TODO(klempner): Make grpc_resolve_address respect deadline */
   grpc_resolve_address(r->setup->target, "http", on_resolved, r);
 }
@@ -176,7 +155,7 @@ static grpc_transport_setup_result complete_setup(void *channel_stack,
                                                   grpc_transport *transport,
                                                   grpc_mdctx *mdctx) {
   static grpc_channel_filter const *extra_filters[] = {
-      &grpc_http_client_filter};
+      &grpc_http_client_filter, &grpc_compress_filter};
   return grpc_client_channel_transport_setup_complete(
       channel_stack, transport, extra_filters, GPR_ARRAY_SIZE(extra_filters),
       mdctx);
@@ -205,6 +184,7 @@ grpc_channel *grpc_channel_create(const char *target,
   s->target = gpr_strdup(target);
   s->setup_callback = complete_setup;
   s->setup_user_data = grpc_channel_get_channel_stack(channel);
+  gpr_atm_rel_store(&s->next_first_address, 0);
 
   grpc_client_setup_create_and_attach(grpc_channel_get_channel_stack(channel),
                                       args, mdctx, initiate_setup, done_setup,
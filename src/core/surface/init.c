@@ -33,6 +33,7 @@
 
 #include <grpc/grpc.h>
 #include "src/core/channel/channel_stack.h"
+#include "src/core/compression/message_compress.h"
 #include "src/core/debug/trace.h"
 #include "src/core/iomgr/iomgr.h"
 #include "src/core/statistics/census_interface.h"
@@ -72,9 +73,11 @@ void grpc_init(void) {
 void grpc_shutdown(void) {
   gpr_mu_lock(&g_init_mu);
   if (--g_initializations == 0) {
+    grpc_security_shutdown();
     grpc_iomgr_shutdown();
     census_shutdown();
     grpc_timers_global_destroy();
+    grpc_msg_codec_pool_shutdown();
   }
   gpr_mu_unlock(&g_init_mu);
 }
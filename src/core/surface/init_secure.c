@@ -33,10 +33,16 @@
 
 #include "src/core/surface/init.h"
 #include "src/core/debug/trace.h"
+#include "src/core/security/handshake_pool.h"
 #include "src/core/security/secure_endpoint.h"
 #include "src/core/tsi/transport_security_interface.h"
 
 void grpc_security_pre_init(void) {
   grpc_register_tracer("secure_endpoint", &grpc_trace_secure_endpoint);
   grpc_register_tracer("transport_security", &tsi_tracing_enabled);
+  grpc_handshake_pool_init();
+}
+
+void grpc_security_shutdown(void) {
+  grpc_handshake_pool_shutdown();
 }
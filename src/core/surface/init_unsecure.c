@@ -35,3 +35,6 @@
 
 void grpc_security_pre_init(void) {
 }
+
+void grpc_security_shutdown(void) {
+}
@@ -113,14 +113,14 @@ static void init_channel_elem(grpc_channel_element *elem,
 
 static void destroy_channel_elem(grpc_channel_element *elem) {}
 
-static const grpc_channel_filter lame_filter = {
+const grpc_channel_filter grpc_lame_client_filter = {
     lame_start_transport_op, channel_op, sizeof(call_data), init_call_elem,
     destroy_call_elem, sizeof(channel_data), init_channel_elem,
     destroy_channel_elem, "lame-client",
 };
 
 grpc_channel *grpc_lame_client_channel_create(void) {
-  static const grpc_channel_filter *filters[] = {&lame_filter};
+  static const grpc_channel_filter *filters[] = {&grpc_lame_client_filter};
   return grpc_channel_create_from_filters(filters, 1, NULL, grpc_mdctx_create(),
                                           1);
 }
@@ -95,10 +95,8 @@ grpc_chttp2_parse_error grpc_chttp2_data_parser_parse(
       }
       switch (p->frame_type) {
         case 0:
-          break;
         case 1:
-          gpr_log(GPR_ERROR, "Compressed GRPC frames not yet supported");
-          return GRPC_CHTTP2_STREAM_ERROR;
+          break;
         default:
           gpr_log(GPR_ERROR, "Bad GRPC frame type 0x%02x", p->frame_type);
           return GRPC_CHTTP2_STREAM_ERROR;
@@ -130,7 +128,9 @@ grpc_chttp2_parse_error grpc_chttp2_data_parser_parse(
       p->state = GRPC_CHTTP2_DATA_FRAME;
       ++cur;
       state->need_flush_reads = 1;
-      grpc_sopb_add_begin_message(&p->incoming_sopb, p->frame_size, 0);
+      grpc_sopb_add_begin_message(
+          &p->incoming_sopb, p->frame_size,
+          p->frame_type == 1 ? GRPC_WRITE_INTERNAL_COMPRESS : 0);
     /* fallthrough */
     case GRPC_CHTTP2_DATA_FRAME:
       if (cur == end) {
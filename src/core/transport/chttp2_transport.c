@@ -37,6 +37,7 @@
 #include <stdio.h>
 #include <string.h>
 
+#include "src/core/iomgr/iomgr.h"
 #include "src/core/support/string.h"
 #include "src/core/transport/chttp2/frame_data.h"
 #include "src/core/transport/chttp2/frame_goaway.h"
@@ -1355,7 +1356,7 @@ static void on_header(void *tp, grpc_mdelem *md) {
       }
       grpc_mdelem_set_user_data(md, free_timeout, cached_timeout);
     }
-    s->incoming_deadline = gpr_time_add(gpr_now(), *cached_timeout);
+    s->incoming_deadline = gpr_time_add(grpc_iomgr_now(), *cached_timeout);
     grpc_mdelem_unref(md);
   } else {
     add_incoming_metadata(t, s, md);
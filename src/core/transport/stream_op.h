@@ -58,6 +58,12 @@ typedef enum grpc_stream_op_code {
   GRPC_OP_SLICE
 } grpc_stream_op_code;
 
+/* Internal write flag (grpc_begin_message.flags): the message payload is
+   compressed with the algorithm announced in the stream's grpc-encoding
+   metadata. Set by the compression filter, and by transports for received
+   messages that carry the compressed bit. */
+#define GRPC_WRITE_INTERNAL_COMPRESS (0x80000000u)
+
 /* Arguments for GRPC_OP_BEGIN */
 typedef struct grpc_begin_message {
   /* How many bytes of data will this message contain */
@@ -370,7 +370,7 @@ static void fake_protector_destroy(tsi_frame_protector* self) {
 
 static const tsi_frame_protector_vtable frame_protector_vtable = {
     fake_protector_protect, fake_protector_protect_flush,
-    fake_protector_unprotect, fake_protector_destroy, };
+    fake_protector_unprotect, NULL, NULL, fake_protector_destroy, };
 
 /* --- tsi_handshaker methods implementation. ---*/
 
@@ -35,15 +35,21 @@
 
 #include <limits.h>
 #include <string.h>
+#include <time.h>
 
 #include <grpc/support/log.h>
+#include <grpc/support/slice_buffer.h>
 #include <grpc/support/sync.h>
 #include <grpc/support/thd.h>
+#include <grpc/support/time.h>
 #include <grpc/support/useful.h>
 #include "src/core/tsi/transport_security.h"
 
 #include <openssl/bio.h>
 #include <openssl/err.h>
+#include <openssl/evp.h>
+#include <openssl/hmac.h>
+#include <openssl/rand.h>
 #include <openssl/ssl.h>
 #include <openssl/x509.h>
 #include <openssl/x509v3.h>
@@ -57,18 +63,64 @@
  * SSL structure. This is what we would ultimately want though... */
 #define TSI_SSL_MAX_PROTECTION_OVERHEAD 100
 
+/* Size of the records written and of the slices read by protectors used with
+   slices: the largest record plaintext allowed by TLS. */
+#define TSI_SSL_SLICES_RECORD_SIZE SSL3_RT_MAX_PLAIN_LENGTH
+
+/* Size of the slices the records written by SSL are copied into: a few full
+   records, so that writes only allocate every few records. */
+#define TSI_SSL_SLICE_BIO_STAGING_SIZE \
+  (4 * (TSI_SSL_SLICES_RECORD_SIZE + TSI_SSL_MAX_PROTECTION_OVERHEAD))
+
+/* Session id context set on all server contexts. Sessions are only resumed
+   within the same context and OpenSSL refuses to resume sessions when client
+   certificates are verified and no context is set. */
+#define TSI_SSL_SERVER_SESSION_ID_CONTEXT "grpc"
+
+/* Sizes of the session ticket key material: the name sent in the clear in the
+   ticket, the AES-128-CBC encryption key and the HMAC-SHA256 key. */
+#define TSI_SSL_TICKET_KEY_NAME_SIZE 16
+#define TSI_SSL_TICKET_AES_KEY_SIZE 16
+#define TSI_SSL_TICKET_HMAC_KEY_SIZE 32
+
 /* --- Structure definitions. ---*/
 
 struct tsi_ssl_handshaker_factory {
   tsi_result (*create_handshaker)(tsi_ssl_handshaker_factory* self,
                                   const char* server_name_indication,
+                                  const char* session_key,
                                   tsi_handshaker** handshaker);
   void (*destroy)(tsi_ssl_handshaker_factory* self);
 };
 
+typedef struct tsi_ssl_session_cache_entry {
+  char* key;
+  SSL_SESSION* session;
+  struct tsi_ssl_session_cache_entry* prev;
+  struct tsi_ssl_session_cache_entry* next;
+} tsi_ssl_session_cache_entry;
+
+struct tsi_ssl_session_cache {
+  gpr_refcount refcount;
+  gpr_mu mu;
+  size_t capacity;
+  size_t size;
+  /* Entries ordered from the most to the least recently used. */
+  tsi_ssl_session_cache_entry* head;
+  tsi_ssl_session_cache_entry* tail;
+};
+
+typedef struct {
+  unsigned char name[TSI_SSL_TICKET_KEY_NAME_SIZE];
+  unsigned char aes_key[TSI_SSL_TICKET_AES_KEY_SIZE];
+  unsigned char hmac_key[TSI_SSL_TICKET_HMAC_KEY_SIZE];
+  gpr_timespec creation_time;
+} tsi_ssl_ticket_key;
+
 typedef struct {
   tsi_ssl_handshaker_factory base;
   SSL_CTX* ssl_context;
+  tsi_ssl_session_cache* session_cache;
 } tsi_ssl_client_handshaker_factory;
 
 typedef struct {
@@ -82,6 +134,14 @@ typedef struct {
   size_t ssl_context_count;
   unsigned char* alpn_protocol_list;
   size_t alpn_protocol_list_length;
+
+  /* Session ticket keys shared by all the contexts: ticket_keys[0] encrypts
+     new tickets, ticket_keys[1] is the key it replaced which is still
+     accepted until the next rotation. Protected by ticket_keys_mu. */
+  gpr_mu ticket_keys_mu;
+  gpr_timespec ticket_key_rotation_period;
+  tsi_ssl_ticket_key ticket_keys[2];
+  int has_previous_ticket_key;
 } tsi_ssl_server_handshaker_factory;
 
 typedef struct {
@@ -90,6 +150,8 @@ typedef struct {
   BIO* into_ssl;
   BIO* from_ssl;
   tsi_result result;
+  /* Cache of the session of a client handshaker, or NULL. */
+  tsi_ssl_session_cache* session_cache;
 } tsi_ssl_handshaker;
 
 typedef struct {
@@ -100,12 +162,193 @@ typedef struct {
   unsigned char* buffer;
   size_t buffer_size;
   size_t buffer_offset;
+  /* Set once the protector has been switched to slices: into_ssl and from_ssl
+     are then replaced by slice buffer BIOs over the two buffers below. */
+  int uses_slices;
+  /* Protected bytes received from the peer not yet consumed by SSL. */
+  gpr_slice_buffer protected_input;
+  /* Protected bytes written by SSL not yet handed to the caller. */
+  gpr_slice_buffer protected_output;
+  /* Partially filled slice receiving unprotected bytes. */
+  gpr_slice unprotected_staging;
+  size_t unprotected_staging_offset;
 } tsi_ssl_frame_protector;
 
+/* --- Slice buffer BIO. ---*/
+
+/* BIO reading from or writing to one of the slice buffers of a
+   tsi_ssl_frame_protector. Unlike memory BIOs, it takes over the slices
+   received from the peer and hands the slices written by SSL to the caller
+   without copying them again. */
+
+typedef struct {
+  gpr_slice_buffer* buffer;
+  /* Unused tail of the slice the last written records were copied into. */
+  gpr_slice staging;
+} slice_bio_data;
+
+#if OPENSSL_VERSION_NUMBER >= 0x10100000L
+#define SLICE_BIO_GET_DATA(bio) ((slice_bio_data*)BIO_get_data(bio))
+#else
+#define SLICE_BIO_GET_DATA(bio) ((slice_bio_data*)(bio)->ptr)
+#endif
+#define SLICE_BIO_GET_BUFFER(bio) (SLICE_BIO_GET_DATA(bio)->buffer)
+
+/* Copies up to size bytes from the front of sb to dst and removes them from
+   sb. Returns the number of bytes copied. */
+static size_t slice_buffer_take_front(gpr_slice_buffer* sb, char* dst,
+                                      size_t size) {
+  size_t copied = 0;
+  size_t consumed = 0;
+  while (copied < size && consumed < sb->count) {
+    gpr_slice* slice = &sb->slices[consumed];
+    size_t n = GPR_MIN(size - copied, GPR_SLICE_LENGTH(*slice));
+    memcpy(dst + copied, GPR_SLICE_START_PTR(*slice), n);
+    copied += n;
+    if (n == GPR_SLICE_LENGTH(*slice)) {
+      gpr_slice_unref(*slice);
+      consumed++;
+    } else {
+      gpr_slice_unref(gpr_slice_split_head(slice, n));
+    }
+  }
+  memmove(sb->slices, sb->slices + consumed,
+          (sb->count - consumed) * sizeof(gpr_slice));
+  sb->count -= consumed;
+  sb->length -= copied;
+  return copied;
+}
+
+/* Appends all the slices of src to dst, leaving src empty. */
+static void slice_buffer_move_all(gpr_slice_buffer* src,
+                                  gpr_slice_buffer* dst) {
+  gpr_slice_buffer_addn(dst, src->slices, src->count);
+  src->count = 0;
+  src->length = 0;
+}
+
+static int slice_bio_read(BIO* bio, char* out, int out_size) {
+  gpr_slice_buffer* input = SLICE_BIO_GET_BUFFER(bio);
+  BIO_clear_retry_flags(bio);
+  if (out_size <= 0) return 0;
+  if (input->length == 0) {
+    BIO_set_retry_read(bio);
+    return -1;
+  }
+  return (int)slice_buffer_take_front(input, out, (size_t)out_size);
+}
+
+static int slice_bio_write(BIO* bio, const char* in, int in_size) {
+  slice_bio_data* data = SLICE_BIO_GET_DATA(bio);
+  BIO_clear_retry_flags(bio);
+  if (in_size <= 0) return 0;
+  if (GPR_SLICE_LENGTH(data->staging) < (size_t)in_size) {
+    gpr_slice_unref(data->staging);
+    data->staging = gpr_slice_malloc(
+        GPR_MAX((size_t)in_size, TSI_SSL_SLICE_BIO_STAGING_SIZE));
+  }
+  memcpy(GPR_SLICE_START_PTR(data->staging), in, (size_t)in_size);
+  gpr_slice_buffer_add(data->buffer,
+                       gpr_slice_split_head(&data->staging, (size_t)in_size));
+  return in_size;
+}
+
+static int slice_bio_puts(BIO* bio, const char* str) {
+  return slice_bio_write(bio, str, (int)strlen(str));
+}
+
+static long slice_bio_ctrl(BIO* bio, int cmd, long num, void* ptr) {
+  switch (cmd) {
+    case BIO_CTRL_PENDING:
+      return (long)SLICE_BIO_GET_BUFFER(bio)->length;
+    case BIO_CTRL_FLUSH:
+      return 1;
+    default:
+      return 0;
+  }
+}
+
+static int slice_bio_create(BIO* bio) {
+#if OPENSSL_VERSION_NUMBER >= 0x10100000L
+  BIO_set_init(bio, 1);
+#else
+  bio->init = 1;
+  bio->ptr = NULL;
+#endif
+  return 1;
+}
+
+static int slice_bio_destroy(BIO* bio) {
+  slice_bio_data* data;
+  if (bio == NULL) return 0;
+  /* The slice buffers are owned by the frame protector. */
+  data = SLICE_BIO_GET_DATA(bio);
+  if (data != NULL) {
+    gpr_slice_unref(data->staging);
+    free(data);
+  }
+  return 1;
+}
+
+#if OPENSSL_VERSION_NUMBER >= 0x10100000L
+static BIO_METHOD* slice_bio_method = NULL;
+
+static void init_slice_bio_method(void) {
+  slice_bio_method =
+      BIO_meth_new(BIO_get_new_index() | BIO_TYPE_SOURCE_SINK, "gpr_slice");
+  GPR_ASSERT(slice_bio_method != NULL);
+  BIO_meth_set_write(slice_bio_method, slice_bio_write);
+  BIO_meth_set_read(slice_bio_method, slice_bio_read);
+  BIO_meth_set_puts(slice_bio_method, slice_bio_puts);
+  BIO_meth_set_ctrl(slice_bio_method, slice_bio_ctrl);
+  BIO_meth_set_create(slice_bio_method, slice_bio_create);
+  BIO_meth_set_destroy(slice_bio_method, slice_bio_destroy);
+}
+#else
+static BIO_METHOD slice_bio_method_storage = {
+    BIO_TYPE_SOURCE_SINK, "gpr_slice", slice_bio_write, slice_bio_read,
+    slice_bio_puts,       NULL,        slice_bio_ctrl,  slice_bio_create,
+    slice_bio_destroy,    NULL, };
+static BIO_METHOD* slice_bio_method = &slice_bio_method_storage;
+
+static void init_slice_bio_method(void) {}
+#endif
+
+/* Creates a BIO reading from or writing to sb, which must outlive it. */
+static BIO* slice_bio_create_for(gpr_slice_buffer* sb) {
+  slice_bio_data* data = malloc(sizeof(slice_bio_data));
+  BIO* bio;
+  if (data == NULL) return NULL;
+  bio = BIO_new(slice_bio_method);
+  if (bio == NULL) {
+    free(data);
+    return NULL;
+  }
+  data->buffer = sb;
+  data->staging = gpr_empty_slice();
+#if OPENSSL_VERSION_NUMBER >= 0x10100000L
+  BIO_set_data(bio, data);
+#else
+  bio->ptr = data;
+#endif
+  return bio;
+}
+
 /* --- Library Initialization. ---*/
 
 static gpr_once init_openssl_once = GPR_ONCE_INIT;
 static gpr_mu *openssl_mutexes = NULL;
+/* Index of the ex_data slot in which each SSL_CTX stores a pointer to the
+   handshaker factory that owns it. */
+static int ssl_ctx_ex_factory_index = -1;
+/* Index of the ex_data slot in which each client SSL stores the key under
+   which its session is cached (owned by the SSL). */
+static int ssl_ex_session_key_index = -1;
+
+static void free_session_key(void* parent, void* ptr, CRYPTO_EX_DATA* ad,
+                             int index, long argl, void* argp) {
+  free(ptr);
+}
 
 static void openssl_locking_cb(int mode, int type, const char* file, int line) {
   if (mode & CRYPTO_LOCK) {
@@ -131,6 +374,13 @@ static void init_openssl(void) {
   }
   CRYPTO_set_locking_callback(openssl_locking_cb);
   CRYPTO_set_id_callback(openssl_thread_id_cb);
+  ssl_ctx_ex_factory_index =
+      SSL_CTX_get_ex_new_index(0, NULL, NULL, NULL, NULL);
+  GPR_ASSERT(ssl_ctx_ex_factory_index != -1);
+  ssl_ex_session_key_index =
+      SSL_get_ex_new_index(0, NULL, NULL, NULL, free_session_key);
+  GPR_ASSERT(ssl_ex_session_key_index != -1);
+  init_slice_bio_method();
 }
 
 /* --- Ssl utils. ---*/
@@ -630,8 +880,266 @@ static tsi_result build_alpn_protocol_name_list(
   return TSI_OK;
 }
 
+/* --- tsi_ssl_session_cache methods implementation. ---*/
+
+tsi_ssl_session_cache* tsi_ssl_session_cache_create(size_t capacity) {
+  tsi_ssl_session_cache* cache;
+  if (capacity == 0) return NULL;
+  cache = calloc(1, sizeof(tsi_ssl_session_cache));
+  if (cache == NULL) return NULL;
+  gpr_ref_init(&cache->refcount, 1);
+  gpr_mu_init(&cache->mu);
+  cache->capacity = capacity;
+  return cache;
+}
+
+tsi_ssl_session_cache* tsi_ssl_session_cache_ref(tsi_ssl_session_cache* cache) {
+  if (cache == NULL) return NULL;
+  gpr_ref(&cache->refcount);
+  return cache;
+}
+
+static void session_cache_entry_destroy(tsi_ssl_session_cache_entry* entry) {
+  SSL_SESSION_free(entry->session);
+  free(entry->key);
+  free(entry);
+}
+
+void tsi_ssl_session_cache_unref(tsi_ssl_session_cache* cache) {
+  tsi_ssl_session_cache_entry* entry;
+  if (cache == NULL || !gpr_unref(&cache->refcount)) return;
+  entry = cache->head;
+  while (entry != NULL) {
+    tsi_ssl_session_cache_entry* next = entry->next;
+    session_cache_entry_destroy(entry);
+    entry = next;
+  }
+  gpr_mu_destroy(&cache->mu);
+  free(cache);
+}
+
+size_t tsi_ssl_session_cache_size(tsi_ssl_session_cache* cache) {
+  size_t size;
+  gpr_mu_lock(&cache->mu);
+  size = cache->size;
+  gpr_mu_unlock(&cache->mu);
+  return size;
+}
+
+static void session_cache_unlink_locked(tsi_ssl_session_cache* cache,
+                                        tsi_ssl_session_cache_entry* entry) {
+  if (entry->prev != NULL) {
+    entry->prev->next = entry->next;
+  } else {
+    cache->head = entry->next;
+  }
+  if (entry->next != NULL) {
+    entry->next->prev = entry->prev;
+  } else {
+    cache->tail = entry->prev;
+  }
+  entry->prev = entry->next = NULL;
+  cache->size--;
+}
+
+static void session_cache_push_front_locked(
+    tsi_ssl_session_cache* cache, tsi_ssl_session_cache_entry* entry) {
+  entry->prev = NULL;
+  entry->next = cache->head;
+  if (cache->head != NULL) {
+    cache->head->prev = entry;
+  } else {
+    cache->tail = entry;
+  }
+  cache->head = entry;
+  cache->size++;
+}
+
+/* Caches hold one session per target and a client rarely talks to more than a
+   handful of targets so a linear scan is good enough. */
+static tsi_ssl_session_cache_entry* session_cache_find_locked(
+    tsi_ssl_session_cache* cache, const char* key) {
+  tsi_ssl_session_cache_entry* entry;
+  for (entry = cache->head; entry != NULL; entry = entry->next) {
+    if (strcmp(entry->key, key) == 0) return entry;
+  }
+  return NULL;
+}
+
+static int session_is_expired(SSL_SESSION* session) {
+  return (long)time(NULL) >=
+         SSL_SESSION_get_time(session) + SSL_SESSION_get_timeout(session);
+}
+
+/* Sets the session cached under key, if any, on ssl so that it is offered to
+   the server during the handshake. */
+static void session_cache_resume(tsi_ssl_session_cache* cache, const char* key,
+                                 SSL* ssl) {
+  tsi_ssl_session_cache_entry* entry;
+  gpr_mu_lock(&cache->mu);
+  entry = session_cache_find_locked(cache, key);
+  if (entry != NULL) {
+    session_cache_unlink_locked(cache, entry);
+    if (session_is_expired(entry->session)) {
+      session_cache_entry_destroy(entry);
+    } else {
+      /* SSL_set_session takes its own reference on the session. */
+      if (!SSL_set_session(ssl, entry->session)) {
+        gpr_log(GPR_ERROR, "Could not set cached session for %s.", key);
+      }
+      session_cache_push_front_locked(cache, entry);
+    }
+  }
+  gpr_mu_unlock(&cache->mu);
+}
+
+/* Stores session as the session to resume under key. Takes ownership of the
+   session reference in all cases. */
+static void session_cache_put(tsi_ssl_session_cache* cache, const char* key,
+                              SSL_SESSION* session) {
+  tsi_ssl_session_cache_entry* entry;
+  gpr_mu_lock(&cache->mu);
+  entry = session_cache_find_locked(cache, key);
+  if (entry != NULL) {
+    session_cache_unlink_locked(cache, entry);
+    SSL_SESSION_free(entry->session);
+    entry->session = session;
+  } else {
+    entry = calloc(1, sizeof(tsi_ssl_session_cache_entry));
+    if (entry != NULL) entry->key = malloc(strlen(key) + 1);
+    if (entry == NULL || entry->key == NULL) {
+      free(entry);
+      gpr_mu_unlock(&cache->mu);
+      SSL_SESSION_free(session);
+      return;
+    }
+    strcpy(entry->key, key);
+    entry->session = session;
+    if (cache->size == cache->capacity) {
+      tsi_ssl_session_cache_entry* lru = cache->tail;
+      session_cache_unlink_locked(cache, lru);
+      session_cache_entry_destroy(lru);
+    }
+  }
+  session_cache_push_front_locked(cache, entry);
+  gpr_mu_unlock(&cache->mu);
+}
+
+/* Drops the session cached under key, if any. */
+static void session_cache_remove(tsi_ssl_session_cache* cache,
+                                 const char* key) {
+  tsi_ssl_session_cache_entry* entry;
+  gpr_mu_lock(&cache->mu);
+  entry = session_cache_find_locked(cache, key);
+  if (entry != NULL) {
+    session_cache_unlink_locked(cache, entry);
+    session_cache_entry_destroy(entry);
+  }
+  gpr_mu_unlock(&cache->mu);
+}
+
+/* Called by OpenSSL each time a client handshake establishes a new session,
+   either through a full handshake or when the server renews its ticket. */
+static int ssl_client_new_session_callback(SSL* ssl, SSL_SESSION* session) {
+  tsi_ssl_client_handshaker_factory* factory = SSL_CTX_get_ex_data(
+      SSL_get_SSL_CTX(ssl), ssl_ctx_ex_factory_index);
+  const char* key = SSL_get_ex_data(ssl, ssl_ex_session_key_index);
+  if (factory == NULL || factory->session_cache == NULL || key == NULL) {
+    return 0;
+  }
+  session_cache_put(factory->session_cache, key, session);
+  return 1; /* We took the reference on the session. */
+}
+
+/* --- Session ticket keys. ---*/
+
+static tsi_result generate_ticket_key(tsi_ssl_ticket_key* key) {
+  if (!RAND_bytes(key->name, sizeof(key->name)) ||
+      !RAND_bytes(key->aes_key, sizeof(key->aes_key)) ||
+      !RAND_bytes(key->hmac_key, sizeof(key->hmac_key))) {
+    gpr_log(GPR_ERROR, "Could not generate session ticket key.");
+    return TSI_INTERNAL_ERROR;
+  }
+  key->creation_time = gpr_now();
+  return TSI_OK;
+}
+
+static void maybe_rotate_ticket_keys_locked(
+    tsi_ssl_server_handshaker_factory* impl) {
+  tsi_ssl_ticket_key new_key;
+  if (gpr_time_cmp(gpr_time_sub(gpr_now(), impl->ticket_keys[0].creation_time),
+                   impl->ticket_key_rotation_period) < 0) {
+    return;
+  }
+  /* Keep serving with the current key if we could not get a new one. */
+  if (generate_ticket_key(&new_key) != TSI_OK) return;
+  impl->ticket_keys[1] = impl->ticket_keys[0];
+  impl->ticket_keys[0] = new_key;
+  impl->has_previous_ticket_key = 1;
+  OPENSSL_cleanse(&new_key, sizeof(new_key));
+}
+
+/* Returns 1 when using the current key, 2 when the ticket was encrypted with
+   the previous key (which tells OpenSSL to issue a new ticket), 0 when the key
+   is unknown (which falls back to a full handshake) and -1 on error. */
+static int ssl_server_ticket_key_callback(SSL* ssl, unsigned char* key_name,
+                                          unsigned char* iv,
+                                          EVP_CIPHER_CTX* cipher_ctx,
+                                          HMAC_CTX* hmac_ctx, int encrypt) {
+  tsi_ssl_server_handshaker_factory* impl = SSL_CTX_get_ex_data(
+      SSL_get_SSL_CTX(ssl), ssl_ctx_ex_factory_index);
+  tsi_ssl_ticket_key key;
+  int result = 0;
+  if (impl == NULL) return -1;
+  gpr_mu_lock(&impl->ticket_keys_mu);
+  maybe_rotate_ticket_keys_locked(impl);
+  if (encrypt ||
+      memcmp(key_name, impl->ticket_keys[0].name, sizeof(key.name)) == 0) {
+    key = impl->ticket_keys[0];
+    result = 1;
+  } else if (impl->has_previous_ticket_key &&
+             memcmp(key_name, impl->ticket_keys[1].name, sizeof(key.name)) ==
+                 0) {
+    key = impl->ticket_keys[1];
+    result = 2;
+  }
+  gpr_mu_unlock(&impl->ticket_keys_mu);
+  if (result == 0) return 0;
+
+  if (encrypt) {
+    memcpy(key_name, key.name, sizeof(key.name));
+    if (!RAND_bytes(iv, EVP_CIPHER_iv_length(EVP_aes_128_cbc())) ||
+        !EVP_EncryptInit_ex(cipher_ctx, EVP_aes_128_cbc(), NULL, key.aes_key,
+                            iv)) {
+      result = -1;
+    }
+  } else if (!EVP_DecryptInit_ex(cipher_ctx, EVP_aes_128_cbc(), NULL,
+                                 key.aes_key, iv)) {
+    result = -1;
+  }
+  if (result != -1 && !HMAC_Init_ex(hmac_ctx, key.hmac_key,
+                                    sizeof(key.hmac_key), EVP_sha256(), NULL)) {
+    result = -1;
+  }
+  OPENSSL_cleanse(&key, sizeof(key));
+  return result;
+}
+
 /* --- tsi_frame_protector methods implementation. ---*/
 
+/* Connections are closed at the transport level without exchanging TLS
+   close_notify alerts, which OpenSSL takes as a sign that the session is
+   compromised: it would invalidate the session on SSL_free and the session
+   could not be resumed. If keep_session is set and the handshake completed,
+   mark the connection as cleanly shut down instead. */
+static void ssl_free(SSL* ssl, int keep_session) {
+  if (ssl == NULL) return;
+  if (keep_session && SSL_is_init_finished(ssl)) {
+    SSL_set_shutdown(ssl, SSL_SENT_SHUTDOWN | SSL_RECEIVED_SHUTDOWN);
+  }
+  SSL_free(ssl);
+}
+
 static tsi_result ssl_protector_protect(tsi_frame_protector* self,
                                         const unsigned char* unprotected_bytes,
                                         size_t* unprotected_bytes_size,
@@ -641,9 +1149,12 @@ static tsi_result ssl_protector_protect(tsi_frame_protector* self,
   int read_from_ssl;
   size_t available;
   tsi_result result = TSI_OK;
+  size_t pending_in_ssl;
+
+  if (impl->uses_slices) return TSI_FAILED_PRECONDITION;
 
   /* First see if we have some pending data in the SSL BIO. */
-  size_t pending_in_ssl = BIO_ctrl_pending(impl->from_ssl);
+  pending_in_ssl = BIO_ctrl_pending(impl->from_ssl);
   if (pending_in_ssl > 0) {
     *unprotected_bytes_size = 0;
     read_from_ssl = BIO_read(impl->from_ssl, protected_output_frames,
@@ -692,6 +1203,8 @@ static tsi_result ssl_protector_protect_flush(
   tsi_ssl_frame_protector* impl = (tsi_ssl_frame_protector*)self;
   int read_from_ssl = 0;
 
+  if (impl->uses_slices) return TSI_FAILED_PRECONDITION;
+
   if (impl->buffer_offset != 0) {
     result = do_ssl_write(impl->ssl, impl->buffer, impl->buffer_offset);
     if (result != TSI_OK) return result;
@@ -722,6 +1235,8 @@ static tsi_result ssl_protector_unprotect(
   size_t output_bytes_offset = 0;
   tsi_ssl_frame_protector* impl = (tsi_ssl_frame_protector*)self;
 
+  if (impl->uses_slices) return TSI_FAILED_PRECONDITION;
+
   /* First, try to read remaining data from ssl. */
   result = do_ssl_read(impl->ssl, unprotected_bytes, unprotected_bytes_size);
   if (result != TSI_OK) return result;
@@ -753,16 +1268,165 @@ static tsi_result ssl_protector_unprotect(
   return result;
 }
 
+/* Switches the protector from the memory BIOs used during the handshake to
+   slice buffer BIOs. Bytes still pending in the memory BIOs are carried
+   over. */
+static tsi_result ssl_protector_use_slices(tsi_ssl_frame_protector* impl) {
+  unsigned char* record_buffer;
+  BIO* input_bio;
+  BIO* output_bio;
+  char drain_buffer[4096];
+  int drained;
+  tsi_result result;
+
+  if (impl->uses_slices) return TSI_OK;
+  record_buffer = malloc(TSI_SSL_SLICES_RECORD_SIZE);
+  if (record_buffer == NULL) return TSI_OUT_OF_RESOURCES;
+  input_bio = slice_bio_create_for(&impl->protected_input);
+  output_bio = slice_bio_create_for(&impl->protected_output);
+  if (input_bio == NULL || output_bio == NULL) {
+    gpr_log(GPR_ERROR, "Could not create slice buffer BIOs.");
+    if (input_bio != NULL) BIO_free(input_bio);
+    if (output_bio != NULL) BIO_free(output_bio);
+    free(record_buffer);
+    return TSI_OUT_OF_RESOURCES;
+  }
+
+  if (impl->buffer_offset != 0) {
+    result = do_ssl_write(impl->ssl, impl->buffer, impl->buffer_offset);
+    if (result != TSI_OK) {
+      BIO_free(input_bio);
+      BIO_free(output_bio);
+      free(record_buffer);
+      return result;
+    }
+    impl->buffer_offset = 0;
+  }
+  while ((drained = BIO_read(impl->from_ssl, drain_buffer,
+                             sizeof(drain_buffer))) > 0) {
+    slice_bio_write(output_bio, drain_buffer, drained);
+  }
+  while ((drained = BIO_read(impl->into_ssl, drain_buffer,
+                             sizeof(drain_buffer))) > 0) {
+    gpr_slice_buffer_add(&impl->protected_input,
+                         gpr_slice_from_copied_buffer(drain_buffer, drained));
+  }
+
+  /* Frees the memory BIOs. */
+  SSL_set_bio(impl->ssl, input_bio, output_bio);
+  impl->into_ssl = NULL;
+  impl->from_ssl = NULL;
+  /* Lets SSL pull all the received records at once instead of reading each
+     record header and body separately. */
+  SSL_set_read_ahead(impl->ssl, 1);
+  free(impl->buffer);
+  impl->buffer = record_buffer;
+  impl->buffer_size = TSI_SSL_SLICES_RECORD_SIZE;
+  impl->uses_slices = 1;
+  return TSI_OK;
+}
+
+static tsi_result ssl_protector_protect_slices(
+    tsi_frame_protector* self, gpr_slice_buffer* unprotected_slices,
+    gpr_slice_buffer* protected_slices) {
+  tsi_ssl_frame_protector* impl = (tsi_ssl_frame_protector*)self;
+  tsi_result result = ssl_protector_use_slices(impl);
+  size_t i;
+
+  for (i = 0; result == TSI_OK && i < unprotected_slices->count; i++) {
+    unsigned char* bytes = GPR_SLICE_START_PTR(unprotected_slices->slices[i]);
+    size_t remaining = GPR_SLICE_LENGTH(unprotected_slices->slices[i]);
+    while (result == TSI_OK && remaining > 0) {
+      size_t chunk;
+      if (impl->buffer_offset == 0 && remaining >= impl->buffer_size) {
+        /* Encrypt straight from the slice: SSL cuts full size records. */
+        chunk = GPR_MIN(remaining, (size_t)INT_MAX);
+        result = do_ssl_write(impl->ssl, bytes, chunk);
+      } else {
+        /* Coalesce small slices so that they do not each cost a record. */
+        chunk = GPR_MIN(remaining, impl->buffer_size - impl->buffer_offset);
+        memcpy(impl->buffer + impl->buffer_offset, bytes, chunk);
+        impl->buffer_offset += chunk;
+        if (impl->buffer_offset == impl->buffer_size) {
+          result = do_ssl_write(impl->ssl, impl->buffer, impl->buffer_size);
+          impl->buffer_offset = 0;
+        }
+      }
+      bytes += chunk;
+      remaining -= chunk;
+    }
+  }
+  if (result == TSI_OK && impl->buffer_offset != 0) {
+    result = do_ssl_write(impl->ssl, impl->buffer, impl->buffer_offset);
+    impl->buffer_offset = 0;
+  }
+  gpr_slice_buffer_reset_and_unref(unprotected_slices);
+  slice_buffer_move_all(&impl->protected_output, protected_slices);
+  return result;
+}
+
+static tsi_result ssl_protector_unprotect_slices(
+    tsi_frame_protector* self, gpr_slice_buffer* protected_slices,
+    gpr_slice_buffer* unprotected_slices) {
+  tsi_ssl_frame_protector* impl = (tsi_ssl_frame_protector*)self;
+  tsi_result result = ssl_protector_use_slices(impl);
+  if (result != TSI_OK) {
+    gpr_slice_buffer_reset_and_unref(protected_slices);
+    return result;
+  }
+  slice_buffer_move_all(protected_slices, &impl->protected_input);
+
+  for (;;) {
+    size_t read_size;
+    if (impl->unprotected_staging_offset ==
+        GPR_SLICE_LENGTH(impl->unprotected_staging)) {
+      gpr_slice_unref(impl->unprotected_staging);
+      impl->unprotected_staging = gpr_slice_malloc(TSI_SSL_SLICES_RECORD_SIZE);
+      impl->unprotected_staging_offset = 0;
+    }
+    read_size = GPR_SLICE_LENGTH(impl->unprotected_staging) -
+                impl->unprotected_staging_offset;
+    result = do_ssl_read(impl->ssl,
+                         GPR_SLICE_START_PTR(impl->unprotected_staging) +
+                             impl->unprotected_staging_offset,
+                         &read_size);
+    if (result != TSI_OK || read_size == 0) break;
+    impl->unprotected_staging_offset += read_size;
+    if (impl->unprotected_staging_offset ==
+        GPR_SLICE_LENGTH(impl->unprotected_staging)) {
+      gpr_slice_buffer_add(unprotected_slices,
+                           gpr_slice_ref(impl->unprotected_staging));
+    }
+  }
+  /* Hand over the bytes read into the partially filled slice and keep its
+     tail for the next call. */
+  if (impl->unprotected_staging_offset > 0 &&
+      impl->unprotected_staging_offset <
+          GPR_SLICE_LENGTH(impl->unprotected_staging)) {
+    gpr_slice_buffer_add(
+        unprotected_slices,
+        gpr_slice_split_head(&impl->unprotected_staging,
+                             impl->unprotected_staging_offset));
+    impl->unprotected_staging_offset = 0;
+  }
+  return result;
+}
+
 static void ssl_protector_destroy(tsi_frame_protector* self) {
   tsi_ssl_frame_protector* impl = (tsi_ssl_frame_protector*)self;
   if (impl->buffer != NULL) free(impl->buffer);
-  if (impl->ssl != NULL) SSL_free(impl->ssl);
+  /* Protectors are only created once the handshake succeeded. */
+  ssl_free(impl->ssl, 1);
+  gpr_slice_buffer_destroy(&impl->protected_input);
+  gpr_slice_buffer_destroy(&impl->protected_output);
+  gpr_slice_unref(impl->unprotected_staging);
   free(self);
 }
 
 static const tsi_frame_protector_vtable frame_protector_vtable = {
-    ssl_protector_protect, ssl_protector_protect_flush, ssl_protector_unprotect,
-    ssl_protector_destroy, };
+    ssl_protector_protect,        ssl_protector_protect_flush,
+    ssl_protector_unprotect,      ssl_protector_protect_slices,
+    ssl_protector_unprotect_slices, ssl_protector_destroy, };
 
 /* --- tsi_handshaker methods implementation. ---*/
 
@@ -842,11 +1506,36 @@ static tsi_result ssl_handshaker_process_bytes_from_peer(
   }
 }
 
+/* Appends a string property to the properties of peer. */
+static tsi_result add_string_peer_property(tsi_peer* peer, const char* name,
+                                           const char* value,
+                                           size_t value_length) {
+  tsi_result result;
+  size_t i;
+  tsi_peer_property* new_properties =
+      calloc(1, sizeof(tsi_peer_property) * (peer->property_count + 1));
+  if (new_properties == NULL) return TSI_OUT_OF_RESOURCES;
+  for (i = 0; i < peer->property_count; i++) {
+    new_properties[i] = peer->properties[i];
+  }
+  result = tsi_construct_string_peer_property(
+      name, value, value_length, &new_properties[peer->property_count]);
+  if (result != TSI_OK) {
+    free(new_properties);
+    return result;
+  }
+  if (peer->properties != NULL) free(peer->properties);
+  peer->property_count++;
+  peer->properties = new_properties;
+  return TSI_OK;
+}
+
 static tsi_result ssl_handshaker_extract_peer(tsi_handshaker* self,
                                               tsi_peer* peer) {
   tsi_result result = TSI_OK;
   const unsigned char* alpn_selected;
   unsigned int alpn_selected_len;
+  const char* session_reused;
   tsi_ssl_handshaker* impl = (tsi_ssl_handshaker*)self;
   X509* peer_cert = SSL_get_peer_certificate(impl->ssl);
   if (peer_cert != NULL) {
@@ -856,25 +1545,14 @@ static tsi_result ssl_handshaker_extract_peer(tsi_handshaker* self,
   }
   SSL_get0_alpn_selected(impl->ssl, &alpn_selected, &alpn_selected_len);
   if (alpn_selected != NULL) {
-    size_t i;
-    tsi_peer_property* new_properties =
-        calloc(1, sizeof(tsi_peer_property) * (peer->property_count + 1));
-    if (new_properties == NULL) return TSI_OUT_OF_RESOURCES;
-    for (i = 0; i < peer->property_count; i++) {
-      new_properties[i] = peer->properties[i];
-    }
-    result = tsi_construct_string_peer_property(
-        TSI_SSL_ALPN_SELECTED_PROTOCOL, (const char*)alpn_selected,
-        alpn_selected_len, &new_properties[peer->property_count]);
-    if (result != TSI_OK) {
-      free(new_properties);
-      return result;
-    }
-    if (peer->properties != NULL) free(peer->properties);
-    peer->property_count++;
-    peer->properties = new_properties;
+    result = add_string_peer_property(peer, TSI_SSL_ALPN_SELECTED_PROTOCOL,
+                                      (const char*)alpn_selected,
+                                      alpn_selected_len);
+    if (result != TSI_OK) return result;
   }
-  return result;
+  session_reused = SSL_session_reused(impl->ssl) ? "true" : "false";
+  return add_string_peer_property(peer, TSI_SSL_SESSION_REUSED_PEER_PROPERTY,
+                                  session_reused, strlen(session_reused));
 }
 
 static tsi_result ssl_handshaker_create_frame_protector(
@@ -917,6 +1595,9 @@ static tsi_result ssl_handshaker_create_frame_protector(
   impl->ssl = NULL;
   protector_impl->into_ssl = impl->into_ssl;
   protector_impl->from_ssl = impl->from_ssl;
+  gpr_slice_buffer_init(&protector_impl->protected_input);
+  gpr_slice_buffer_init(&protector_impl->protected_output);
+  protector_impl->unprotected_staging = gpr_empty_slice();
 
   protector_impl->base.vtable = &frame_protector_vtable;
   *protector = &protector_impl->base;
@@ -925,7 +1606,18 @@ static tsi_result ssl_handshaker_create_frame_protector(
 
 static void ssl_handshaker_destroy(tsi_handshaker* self) {
   tsi_ssl_handshaker* impl = (tsi_ssl_handshaker*)self;
-  SSL_free(impl->ssl); /* The BIO objects are owned by ssl */
+  const char* key;
+  if (impl->ssl != NULL && impl->result != TSI_OK) {
+    /* Do not resume the session of a failed handshake, whether it was just
+       established or offered from the cache. */
+    key = SSL_get_ex_data(impl->ssl, ssl_ex_session_key_index);
+    if (impl->session_cache != NULL && key != NULL) {
+      session_cache_remove(impl->session_cache, key);
+    }
+  }
+  /* The BIO objects are owned by ssl. */
+  ssl_free(impl->ssl, impl->result == TSI_OK);
+  tsi_ssl_session_cache_unref(impl->session_cache);
   free(impl);
 }
 
@@ -942,8 +1634,16 @@ static const tsi_handshaker_vtable handshaker_vtable = {
 tsi_result tsi_ssl_handshaker_factory_create_handshaker(
     tsi_ssl_handshaker_factory* self, const char* server_name_indication,
     tsi_handshaker** handshaker) {
+  return tsi_ssl_handshaker_factory_create_client_handshaker(
+      self, server_name_indication, server_name_indication, handshaker);
+}
+
+tsi_result tsi_ssl_handshaker_factory_create_client_handshaker(
+    tsi_ssl_handshaker_factory* self, const char* server_name_indication,
+    const char* session_key, tsi_handshaker** handshaker) {
   if (self == NULL || handshaker == NULL) return TSI_INVALID_ARGUMENT;
-  return self->create_handshaker(self, server_name_indication, handshaker);
+  return self->create_handshaker(self, server_name_indication, session_key,
+                                 handshaker);
 }
 
 void tsi_ssl_handshaker_factory_destroy(tsi_ssl_handshaker_factory* self) {
@@ -953,6 +1653,8 @@ void tsi_ssl_handshaker_factory_destroy(tsi_ssl_handshaker_factory* self) {
 
 static tsi_result create_tsi_ssl_handshaker(SSL_CTX* ctx, int is_client,
                                             const char* server_name_indication,
+                                            const char* session_key,
+                                            tsi_ssl_session_cache* session_cache,
                                             tsi_handshaker** handshaker) {
   SSL* ssl = SSL_new(ctx);
   BIO* into_ssl = NULL;
@@ -989,6 +1691,16 @@ static tsi_result create_tsi_ssl_handshaker(SSL_CTX* ctx, int is_client,
         return TSI_INTERNAL_ERROR;
       }
     }
+    if (session_cache != NULL && session_key != NULL) {
+      char* key = malloc(strlen(session_key) + 1);
+      if (key == NULL) {
+        SSL_free(ssl);
+        return TSI_OUT_OF_RESOURCES;
+      }
+      strcpy(key, session_key);
+      SSL_set_ex_data(ssl, ssl_ex_session_key_index, key);
+      session_cache_resume(session_cache, session_key, ssl);
+    }
     ssl_result = SSL_do_handshake(ssl);
     ssl_result = SSL_get_error(ssl, ssl_result);
     if (ssl_result != SSL_ERROR_WANT_READ) {
@@ -1011,6 +1723,7 @@ static tsi_result create_tsi_ssl_handshaker(SSL_CTX* ctx, int is_client,
   impl->into_ssl = into_ssl;
   impl->from_ssl = from_ssl;
   impl->result = TSI_HANDSHAKE_IN_PROGRESS;
+  impl->session_cache = tsi_ssl_session_cache_ref(session_cache);
   impl->base.vtable = &handshaker_vtable;
   *handshaker = &impl->base;
   return TSI_OK;
@@ -1020,10 +1733,11 @@ static tsi_result create_tsi_ssl_handshaker(SSL_CTX* ctx, int is_client,
 
 static tsi_result ssl_client_handshaker_factory_create_handshaker(
     tsi_ssl_handshaker_factory* self, const char* server_name_indication,
-    tsi_handshaker** handshaker) {
+    const char* session_key, tsi_handshaker** handshaker) {
   tsi_ssl_client_handshaker_factory* impl =
       (tsi_ssl_client_handshaker_factory*)self;
   return create_tsi_ssl_handshaker(impl->ssl_context, 1, server_name_indication,
+                                   session_key, impl->session_cache,
                                    handshaker);
 }
 
@@ -1032,6 +1746,7 @@ static void ssl_client_handshaker_factory_destroy(
   tsi_ssl_client_handshaker_factory* impl =
       (tsi_ssl_client_handshaker_factory*)self;
   SSL_CTX_free(impl->ssl_context);
+  tsi_ssl_session_cache_unref(impl->session_cache);
   free(impl);
 }
 
@@ -1039,15 +1754,17 @@ static void ssl_client_handshaker_factory_destroy(
 
 static tsi_result ssl_server_handshaker_factory_create_handshaker(
     tsi_ssl_handshaker_factory* self, const char* server_name_indication,
-    tsi_handshaker** handshaker) {
+    const char* session_key, tsi_handshaker** handshaker) {
   tsi_ssl_server_handshaker_factory* impl =
       (tsi_ssl_server_handshaker_factory*)self;
-  if (impl->ssl_context_count == 0 || server_name_indication != NULL) {
+  if (impl->ssl_context_count == 0 || server_name_indication != NULL ||
+      session_key != NULL) {
     return TSI_INVALID_ARGUMENT;
   }
   /* Create the handshaker with the first context. We will switch if needed
      because of SNI in ssl_server_handshaker_factory_servername_callback.  */
-  return create_tsi_ssl_handshaker(impl->ssl_contexts[0], 0, NULL, handshaker);
+  return create_tsi_ssl_handshaker(impl->ssl_contexts[0], 0, NULL, NULL, NULL,
+                                   handshaker);
 }
 
 static void ssl_server_handshaker_factory_destroy(
@@ -1066,6 +1783,8 @@ static void ssl_server_handshaker_factory_destroy(
     free(impl->ssl_context_x509_subject_names);
   }
   if (impl->alpn_protocol_list != NULL) free(impl->alpn_protocol_list);
+  OPENSSL_cleanse(impl->ticket_keys, sizeof(impl->ticket_keys));
+  gpr_mu_destroy(&impl->ticket_keys_mu);
   free(impl);
 }
 
@@ -1172,6 +1891,7 @@ tsi_result tsi_create_ssl_client_handshaker_factory(
     const unsigned char* pem_root_certs, size_t pem_root_certs_size,
     const char* cipher_list, const unsigned char** alpn_protocols,
     const unsigned char* alpn_protocols_lengths, uint16_t num_alpn_protocols,
+    tsi_ssl_session_cache* session_cache,
     tsi_ssl_handshaker_factory** factory) {
   SSL_CTX* ssl_context = NULL;
   tsi_ssl_client_handshaker_factory* impl = NULL;
@@ -1236,6 +1956,15 @@ tsi_result tsi_create_ssl_client_handshaker_factory(
     return TSI_OUT_OF_RESOURCES;
   }
   impl->ssl_context = ssl_context;
+  if (session_cache != NULL) {
+    /* Sessions are only kept in our cache, keyed by target, rather than in
+       the OpenSSL one which is keyed by session id. */
+    impl->session_cache = tsi_ssl_session_cache_ref(session_cache);
+    SSL_CTX_set_ex_data(ssl_context, ssl_ctx_ex_factory_index, impl);
+    SSL_CTX_set_session_cache_mode(
+        ssl_context, SSL_SESS_CACHE_CLIENT | SSL_SESS_CACHE_NO_INTERNAL_STORE);
+    SSL_CTX_sess_set_new_cb(ssl_context, ssl_client_new_session_callback);
+  }
   impl->base.create_handshaker =
       ssl_client_handshaker_factory_create_handshaker;
   impl->base.destroy = ssl_client_handshaker_factory_destroy;
@@ -1251,6 +1980,7 @@ tsi_result tsi_create_ssl_server_handshaker_factory(
     size_t pem_client_root_certs_size, const char* cipher_list,
     const unsigned char** alpn_protocols,
     const unsigned char* alpn_protocols_lengths, uint16_t num_alpn_protocols,
+    int session_ticket_key_rotation_secs,
     tsi_ssl_handshaker_factory** factory) {
   tsi_ssl_server_handshaker_factory* impl = NULL;
   tsi_result result = TSI_OK;
@@ -1261,7 +1991,7 @@ tsi_result tsi_create_ssl_server_handshaker_factory(
   if (factory == NULL) return TSI_INVALID_ARGUMENT;
   *factory = NULL;
   if (key_cert_pair_count == 0 || pem_private_keys == NULL ||
-      pem_cert_chains == NULL) {
+      pem_cert_chains == NULL || session_ticket_key_rotation_secs < 0) {
     return TSI_INVALID_ARGUMENT;
   }
 
@@ -1270,6 +2000,16 @@ tsi_result tsi_create_ssl_server_handshaker_factory(
   impl->base.create_handshaker =
       ssl_server_handshaker_factory_create_handshaker;
   impl->base.destroy = ssl_server_handshaker_factory_destroy;
+  gpr_mu_init(&impl->ticket_keys_mu);
+  if (session_ticket_key_rotation_secs > 0) {
+    impl->ticket_key_rotation_period =
+        gpr_time_from_seconds(session_ticket_key_rotation_secs);
+    result = generate_ticket_key(&impl->ticket_keys[0]);
+    if (result != TSI_OK) {
+      tsi_ssl_handshaker_factory_destroy(&impl->base);
+      return result;
+    }
+  }
   impl->ssl_contexts = calloc(key_cert_pair_count, sizeof(SSL_CTX*));
   impl->ssl_context_x509_subject_names =
       calloc(key_cert_pair_count, sizeof(tsi_peer));
@@ -1328,6 +2068,19 @@ tsi_result tsi_create_ssl_server_handshaker_factory(
       SSL_CTX_set_tlsext_servername_arg(impl->ssl_contexts[i], impl);
       SSL_CTX_set_alpn_select_cb(impl->ssl_contexts[i],
                                  server_handshaker_factory_alpn_callback, impl);
+
+      SSL_CTX_set_session_id_context(
+          impl->ssl_contexts[i],
+          (const unsigned char*)TSI_SSL_SERVER_SESSION_ID_CONTEXT,
+          strlen(TSI_SSL_SERVER_SESSION_ID_CONTEXT));
+      if (session_ticket_key_rotation_secs > 0) {
+        SSL_CTX_set_ex_data(impl->ssl_contexts[i], ssl_ctx_ex_factory_index,
+                            impl);
+        SSL_CTX_set_tlsext_ticket_key_cb(impl->ssl_contexts[i],
+                                         ssl_server_ticket_key_callback);
+      } else {
+        SSL_CTX_set_options(impl->ssl_contexts[i], SSL_OP_NO_TICKET);
+      }
     } while (0);
 
     if (result != TSI_OK) {
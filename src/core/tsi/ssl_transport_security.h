@@ -54,6 +54,35 @@ extern "C" {
 /* This property is of type TSI_PEER_PROPERTY_STRING. */
 #define TSI_SSL_ALPN_SELECTED_PROTOCOL "ssl_alpn_selected_protocol"
 
+/* This property is of type TSI_PEER_PROPERTY_STRING. Its value is "true" if
+   the handshake resumed a previous session and "false" otherwise.  */
+#define TSI_SSL_SESSION_REUSED_PEER_PROPERTY "ssl_session_reused"
+
+/* --- tsi_ssl_session_cache object ---
+
+   Cache of client TLS sessions keyed by target (see
+   tsi_ssl_handshaker_factory_create_client_handshaker). When a client
+   handshaker is created for a target that has a cached session, the
+   handshaker offers that session to the server which may then skip the
+   certificate exchange and the key agreement (abbreviated handshake). The
+   cache holds at most capacity sessions and evicts the least recently used
+   one when full. It is ref-counted and thread-safe so that it can be shared
+   by several client handshaker factories.  */
+
+typedef struct tsi_ssl_session_cache tsi_ssl_session_cache;
+
+/* Creates a session cache holding at most capacity sessions. capacity must be
+   at least 1.  */
+tsi_ssl_session_cache* tsi_ssl_session_cache_create(size_t capacity);
+
+/* Ref-counting of the session cache. The cache is destroyed, and all its
+   sessions released, when the last reference goes away.  */
+tsi_ssl_session_cache* tsi_ssl_session_cache_ref(tsi_ssl_session_cache* cache);
+void tsi_ssl_session_cache_unref(tsi_ssl_session_cache* cache);
+
+/* Returns the number of sessions currently held by the cache.  */
+size_t tsi_ssl_session_cache_size(tsi_ssl_session_cache* cache);
+
 /* --- tsi_ssl_handshaker_factory object ---
 
    This object creates tsi_handshaker objects implemented in terms of the
@@ -84,6 +113,10 @@ typedef struct tsi_ssl_handshaker_factory tsi_ssl_handshaker_factory;
      protocols specified in alpn_protocols. This parameter can be NULL.
    - num_alpn_protocols is the number of alpn protocols and associated lengths
      specified. If this parameter is 0, the other alpn parameters must be NULL.
+   - session_cache is the cache in which the sessions established by the
+     handshakers created with this factory are stored, and from which they are
+     resumed. The factory takes its own reference on the cache. This parameter
+     can be NULL in which case sessions are never resumed.
    - factory is the address of the factory pointer to be created.
 
    - This method returns TSI_OK on success or TSI_INVALID_PARAMETER in the case
@@ -94,6 +127,7 @@ tsi_result tsi_create_ssl_client_handshaker_factory(
     const unsigned char* pem_root_certs, size_t pem_root_certs_size,
     const char* cipher_suites, const unsigned char** alpn_protocols,
     const unsigned char* alpn_protocols_lengths, uint16_t num_alpn_protocols,
+    tsi_ssl_session_cache* session_cache,
     tsi_ssl_handshaker_factory** factory);
 
 /* Creates a server handshaker factory.
@@ -126,6 +160,12 @@ tsi_result tsi_create_ssl_client_handshaker_factory(
      protocols specified in alpn_protocols. This parameter can be NULL.
    - num_alpn_protocols is the number of alpn protocols and associated lengths
      specified. If this parameter is 0, the other alpn parameters must be NULL.
+   - session_ticket_key_rotation_secs is the lifetime, in seconds, of the keys
+     used to encrypt session tickets. Keys are generated randomly by the
+     factory; once the current key is older than this lifetime, a new one is
+     generated and the old one is only used to decrypt (and renew) tickets for
+     one more period. If this parameter is 0, session tickets are disabled and
+     sessions can only be resumed through the server-side session cache.
    - factory is the address of the factory pointer to be created.
 
    - This method returns TSI_OK on success or TSI_INVALID_PARAMETER in the case
@@ -138,6 +178,7 @@ tsi_result tsi_create_ssl_server_handshaker_factory(
     size_t pem_client_root_certs_size, const char* cipher_suites,
     const unsigned char** alpn_protocols,
     const unsigned char* alpn_protocols_lengths, uint16_t num_alpn_protocols,
+    int session_ticket_key_rotation_secs,
     tsi_ssl_handshaker_factory** factory);
 
 /* Creates a handshaker.
@@ -154,6 +195,17 @@ tsi_result tsi_ssl_handshaker_factory_create_handshaker(
     tsi_ssl_handshaker_factory* self, const char* server_name_indication,
     tsi_handshaker** handshaker);
 
+/* Creates a client handshaker whose session is cached under session_key,
+   rather than under server_name_indication as with
+   tsi_ssl_handshaker_factory_create_handshaker. Sessions are only resumed
+   with the handshakers created with the same key, which should identify the
+   server (e.g. its host:port) and not only its name. session_key may be NULL
+   in which case the session is neither resumed nor cached. Only sessions of
+   successful handshakes are kept for resumption.  */
+tsi_result tsi_ssl_handshaker_factory_create_client_handshaker(
+    tsi_ssl_handshaker_factory* self, const char* server_name_indication,
+    const char* session_key, tsi_handshaker** handshaker);
+
 /* Destroys the handshaker factory. WARNING: it is unsafe to destroy a factory
    while handshakers created with this factory are still in use.  */
 void tsi_ssl_handshaker_factory_destroy(tsi_ssl_handshaker_factory* self);
@@ -133,6 +133,33 @@ tsi_result tsi_frame_protector_unprotect(
                                  unprotected_bytes_size);
 }
 
+int tsi_frame_protector_supports_slices(tsi_frame_protector* self) {
+  return self != NULL && self->vtable->protect_slices != NULL &&
+         self->vtable->unprotect_slices != NULL;
+}
+
+tsi_result tsi_frame_protector_protect_slices(
+    tsi_frame_protector* self, gpr_slice_buffer* unprotected_slices,
+    gpr_slice_buffer* protected_slices) {
+  if (self == NULL || unprotected_slices == NULL || protected_slices == NULL) {
+    return TSI_INVALID_ARGUMENT;
+  }
+  if (self->vtable->protect_slices == NULL) return TSI_UNIMPLEMENTED;
+  return self->vtable->protect_slices(self, unprotected_slices,
+                                      protected_slices);
+}
+
+tsi_result tsi_frame_protector_unprotect_slices(
+    tsi_frame_protector* self, gpr_slice_buffer* protected_slices,
+    gpr_slice_buffer* unprotected_slices) {
+  if (self == NULL || protected_slices == NULL || unprotected_slices == NULL) {
+    return TSI_INVALID_ARGUMENT;
+  }
+  if (self->vtable->unprotect_slices == NULL) return TSI_UNIMPLEMENTED;
+  return self->vtable->unprotect_slices(self, protected_slices,
+                                        unprotected_slices);
+}
+
 void tsi_frame_protector_destroy(tsi_frame_protector* self) {
   if (self == NULL) return;
   self->vtable->destroy(self);
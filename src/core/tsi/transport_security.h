@@ -59,6 +59,13 @@ typedef struct {
                           size_t* protected_frames_bytes_size,
                           unsigned char* unprotected_bytes,
                           size_t* unprotected_bytes_size);
+  /* protect_slices and unprotect_slices are optional and may be NULL. */
+  tsi_result (*protect_slices)(tsi_frame_protector* self,
+                               gpr_slice_buffer* unprotected_slices,
+                               gpr_slice_buffer* protected_slices);
+  tsi_result (*unprotect_slices)(tsi_frame_protector* self,
+                                 gpr_slice_buffer* protected_slices,
+                                 gpr_slice_buffer* unprotected_slices);
   void (*destroy)(tsi_frame_protector* self);
 } tsi_frame_protector_vtable;
 
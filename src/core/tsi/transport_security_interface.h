@@ -37,6 +37,8 @@
 #include <stdint.h>
 #include <stdlib.h>
 
+#include <grpc/support/slice_buffer.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -169,6 +171,47 @@ tsi_result tsi_frame_protector_unprotect(
     size_t* protected_frames_bytes_size, unsigned char* unprotected_bytes,
     size_t* unprotected_bytes_size);
 
+/* --- Slice based protection ---
+
+   Some protectors can also protect and unprotect directly from and into
+   slices. This saves the copies to and from the caller's buffers of the
+   functions above and lets the protector use frames as large as its protocol
+   allows. Once one of the slice based functions has been called on a
+   protector, the byte based functions must not be used on it anymore.  */
+
+/* Returns 1 if the protector implements the slice based functions, 0
+   otherwise.  */
+int tsi_frame_protector_supports_slices(tsi_frame_protector* self);
+
+/* Protects all the bytes in unprotected_slices.
+   - unprotected_slices is an input/output parameter. All its slices are
+     consumed and it is empty when the call returns.
+   - protected_slices is an output parameter to which the protected frames are
+     appended. Nothing is kept buffered in the protector: there is no need to
+     flush.
+
+   - This method returns TSI_OK in case of success or a specific error code in
+     case of failure, including TSI_UNIMPLEMENTED when the protector does not
+     support slices.  */
+tsi_result tsi_frame_protector_protect_slices(
+    tsi_frame_protector* self, gpr_slice_buffer* unprotected_slices,
+    gpr_slice_buffer* protected_slices);
+
+/* Unprotects the frames in protected_slices.
+   - protected_slices is an input/output parameter. All its slices are taken
+     over by the protector and it is empty when the call returns. Bytes of
+     incomplete frames are kept by the protector until the rest of the frame
+     is received.
+   - unprotected_slices is an output parameter to which the unprotected bytes
+     of all the complete frames are appended.
+
+   - This method returns TSI_OK in case of success or a specific error code in
+     case of failure, including TSI_UNIMPLEMENTED when the protector does not
+     support slices.  */
+tsi_result tsi_frame_protector_unprotect_slices(
+    tsi_frame_protector* self, gpr_slice_buffer* protected_slices,
+    gpr_slice_buffer* unprotected_slices);
+
 /* Destroys the tsi_frame_protector object.  */
 void tsi_frame_protector_destroy(tsi_frame_protector* self);
 
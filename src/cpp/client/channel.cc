@@ -34,11 +34,14 @@
 #include "src/cpp/client/channel.h"
 
 #include <memory>
+#include <vector>
 
 #include <grpc/grpc.h>
 #include <grpc/grpc_security.h>
+#include <grpc/support/cpu.h>
 #include <grpc/support/log.h>
 #include <grpc/support/slice.h>
+#include <grpc/support/thd.h>
 
 #include "src/core/profiling/timers.h"
 #include "src/cpp/proto/proto_utils.h"
@@ -53,10 +56,84 @@
 
 namespace grpc {
 
+// The completion queue of a channel's callback calls, and the threads that
+// poll it and thereby run the callbacks.
+class CallbackQueue GRPC_FINAL {
+ public:
+  CallbackQueue() {
+    int threads = gpr_cpu_num_cores();
+    if (!threads) threads = 4;
+    gpr_thd_options options = gpr_thd_options_default();
+    gpr_thd_options_set_joinable(&options);
+    for (int i = 0; i < threads; i++) {
+      gpr_thd_id id;
+      GPR_ASSERT(gpr_thd_new(&id, &CallbackQueue::Poll, &cq_, &options));
+      pollers_.push_back(id);
+    }
+  }
+
+  CompletionQueue* cq() { return &cq_; }
+
+  // Shuts the queue down and frees it once calls still in flight have run
+  // their callbacks. A callback may drop the last reference to the channel,
+  // in which case the poller running it cannot wait for itself: the pollers
+  // are then joined from a thread of their own.
+  static void Destroy(CallbackQueue* queue) {
+    queue->cq_.Shutdown();
+    gpr_thd_id self = gpr_thd_currentid();
+    for (auto it = queue->pollers_.begin(); it != queue->pollers_.end();
+         ++it) {
+      if (*it == self) {
+        gpr_thd_id id;
+        GPR_ASSERT(gpr_thd_new(&id, &CallbackQueue::JoinAndDelete, queue,
+                               nullptr));
+        return;
+      }
+    }
+    JoinAndDelete(queue);
+  }
+
+ private:
+  static void Poll(void* arg) {
+    CompletionQueue* cq = static_cast<CompletionQueue*>(arg);
+    void* tag;
+    bool ok;
+    // Every event is consumed by its tag.
+    while (cq->Next(&tag, &ok)) {
+    }
+  }
+
+  static void JoinAndDelete(void* arg) {
+    CallbackQueue* queue = static_cast<CallbackQueue*>(arg);
+    for (auto it = queue->pollers_.begin(); it != queue->pollers_.end();
+         ++it) {
+      gpr_thd_join(*it);
+    }
+    delete queue;
+  }
+
+  CompletionQueue cq_;
+  std::vector<gpr_thd_id> pollers_;
+};
+
 Channel::Channel(const grpc::string& target, grpc_channel* channel)
-    : target_(target), c_channel_(channel) {}
+    : target_(target), c_channel_(channel), callback_queue_(nullptr) {}
 
-Channel::~Channel() { grpc_channel_destroy(c_channel_); }
+Channel::Channel(const grpc::string& target, grpc_channel* channel,
+                 const ChannelArguments& args)
+    : target_(target), c_channel_(channel), callback_queue_(nullptr) {
+  for (auto it = args.constant_metadata_.begin();
+       it != args.constant_metadata_.end(); ++it) {
+    constant_metadata_.Add(it->first, it->second);
+  }
+}
+
+Channel::~Channel() {
+  if (callback_queue_) {
+    CallbackQueue::Destroy(callback_queue_);
+  }
+  grpc_channel_destroy(c_channel_);
+}
 
 Call Channel::CreateCall(const RpcMethod& method, ClientContext* context,
                          CompletionQueue* cq) {
@@ -72,9 +149,20 @@ Call Channel::CreateCall(const RpcMethod& method, ClientContext* context,
                                      context->raw_deadline());
   GRPC_TIMER_MARK(GRPC_PTAG_CPP_CALL_CREATED, c_call);
   context->set_call(c_call, shared_from_this());
+  if (!constant_metadata_.empty()) {
+    context->send_initial_metadata_.set_constant(&constant_metadata_);
+  }
   return Call(c_call, this, cq);
 }
 
+CompletionQueue* Channel::CallbackCompletionQueue() {
+  grpc::lock_guard<grpc::mutex> lock(callback_queue_mu_);
+  if (!callback_queue_) {
+    callback_queue_ = new CallbackQueue;
+  }
+  return callback_queue_->cq();
+}
+
 void Channel::PerformOpsOnCall(CallOpBuffer* buf, Call* call) {
   static const size_t MAX_OPS = 8;
   size_t nops = MAX_OPS;
@@ -90,4 +178,34 @@ void* Channel::RegisterMethod(const char* method) {
   return grpc_channel_register_call(c_channel_, method, target_.c_str());
 }
 
+grpc_connectivity_state Channel::GetState(bool try_to_connect) {
+  return grpc_channel_check_connectivity_state(c_channel_, try_to_connect);
+}
+
+bool Channel::WaitForReadyInternal(gpr_timespec deadline) {
+  grpc_connectivity_state state = GetState(true);
+  if (state == GRPC_CHANNEL_READY) return true;
+  // Watch the state on a private queue so that no caller thread polls it.
+  grpc_completion_queue* cq = grpc_completion_queue_create();
+  bool changed = true;
+  while (state != GRPC_CHANNEL_READY &&
+         state != GRPC_CHANNEL_FATAL_FAILURE && changed) {
+    grpc_channel_watch_connectivity_state(c_channel_, state, deadline, cq,
+                                          this);
+    grpc_event* ev = grpc_completion_queue_pluck(cq, this, gpr_inf_future);
+    changed = ev->data.op_complete == GRPC_OP_OK;
+    grpc_event_finish(ev);
+    state = GetState(true);
+  }
+  grpc_completion_queue_shutdown(cq);
+  grpc_event* ev;
+  while ((ev = grpc_completion_queue_next(cq, gpr_inf_future))->type !=
+         GRPC_QUEUE_SHUTDOWN) {
+    grpc_event_finish(ev);
+  }
+  grpc_event_finish(ev);
+  grpc_completion_queue_destroy(cq);
+  return state == GRPC_CHANNEL_READY;
+}
+
 }  // namespace grpc
@@ -39,11 +39,14 @@
 #include <grpc++/channel_interface.h>
 #include <grpc++/config.h>
 #include <grpc++/impl/grpc_library.h>
+#include <grpc++/impl/sync.h>
+#include <grpc++/metadata.h>
 
 struct grpc_channel;
 
 namespace grpc {
 class Call;
+class CallbackQueue;
 class CallOpBuffer;
 class ChannelArguments;
 class CompletionQueue;
@@ -54,16 +57,28 @@ class Channel GRPC_FINAL : public GrpcLibrary,
                            public ChannelInterface {
  public:
   Channel(const grpc::string& target, grpc_channel* c_channel);
+  Channel(const grpc::string& target, grpc_channel* c_channel,
+          const ChannelArguments& args);
   ~Channel() GRPC_OVERRIDE;
 
   virtual void *RegisterMethod(const char *method) GRPC_OVERRIDE;
   virtual Call CreateCall(const RpcMethod& method, ClientContext* context,
                           CompletionQueue* cq) GRPC_OVERRIDE;
+  virtual CompletionQueue* CallbackCompletionQueue() GRPC_OVERRIDE;
   virtual void PerformOpsOnCall(CallOpBuffer* ops, Call* call) GRPC_OVERRIDE;
+  virtual grpc_connectivity_state GetState(bool try_to_connect) GRPC_OVERRIDE;
 
  private:
+  virtual bool WaitForReadyInternal(gpr_timespec deadline) GRPC_OVERRIDE;
+
   const grpc::string target_;
   grpc_channel* const c_channel_;  // owned
+  // Sent ahead of the metadata of every call; calls refer to it through
+  // their ClientContext, which keeps the channel alive.
+  OutgoingMetadata constant_metadata_;
+  grpc::mutex callback_queue_mu_;
+  // Started by the first callback call.
+  CallbackQueue* callback_queue_;
 };
 
 }  // namespace grpc
@@ -50,6 +50,11 @@ grpc::string ChannelArguments::GetSslTargetNameOverride() const {
   return "";
 }
 
+void ChannelArguments::AddConstantMetadata(const grpc::string& key,
+                                           const grpc::string& value) {
+  constant_metadata_.push_back(std::make_pair(key, value));
+}
+
 void ChannelArguments::SetInt(const grpc::string& key, int value) {
   grpc_arg arg;
   arg.type = GRPC_ARG_INTEGER;
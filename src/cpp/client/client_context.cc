@@ -64,7 +64,7 @@ ClientContext::~ClientContext() {
 
 void ClientContext::AddMetadata(const grpc::string& meta_key,
                                 const grpc::string& meta_value) {
-  send_initial_metadata_.insert(std::make_pair(meta_key, meta_value));
+  send_initial_metadata_.Add(meta_key, meta_value);
 }
 
 void ClientContext::TryCancel() {
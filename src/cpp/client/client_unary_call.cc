@@ -61,4 +61,44 @@ Status BlockingUnaryCall(ChannelInterface* channel, const RpcMethod& method,
   return status;
 }
 
+namespace {
+
+class CallbackUnaryOps GRPC_FINAL : public CallOpBuffer {
+ public:
+  explicit CallbackUnaryOps(std::function<void(Status)> on_done)
+      : on_done_(on_done) {}
+
+  bool FinalizeResult(void** tag, bool* status) GRPC_OVERRIDE {
+    CallOpBuffer::FinalizeResult(tag, status);
+    on_done_(status_);
+    delete this;
+    return false;
+  }
+
+  Status* status() { return &status_; }
+
+ private:
+  std::function<void(Status)> on_done_;
+  Status status_;
+};
+
+}  // namespace
+
+void CallbackUnaryCall(ChannelInterface* channel, const RpcMethod& method,
+                       ClientContext* context,
+                       const grpc::protobuf::Message& request,
+                       grpc::protobuf::Message* result,
+                       std::function<void(Status)> on_done) {
+  CompletionQueue* cq = channel->CallbackCompletionQueue();
+  Call call(channel->CreateCall(method, context, cq));
+  CallbackUnaryOps* ops = new CallbackUnaryOps(on_done);
+  ops->AddSendInitialMetadata(context);
+  ops->AddSendMessage(request);
+  ops->AddRecvInitialMetadata(context);
+  ops->AddRecvMessage(result);
+  ops->AddClientSendClose();
+  ops->AddClientRecvStatus(context, ops->status());
+  call.PerformOps(ops);
+}
+
 }  // namespace grpc
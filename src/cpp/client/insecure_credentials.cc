@@ -49,7 +49,7 @@ class InsecureCredentialsImpl GRPC_FINAL : public Credentials {
     grpc_channel_args channel_args;
     args.SetChannelArgs(&channel_args);
     return std::shared_ptr<ChannelInterface>(new Channel(
-        target, grpc_channel_create(target.c_str(), &channel_args)));
+        target, grpc_channel_create(target.c_str(), &channel_args), args));
   }
 
   SecureCredentials* AsSecureCredentials() GRPC_OVERRIDE { return nullptr; }
@@ -46,7 +46,8 @@ std::shared_ptr<grpc::ChannelInterface> SecureCredentials::CreateChannel(
   return std::shared_ptr<ChannelInterface>(new Channel(
       args.GetSslTargetNameOverride().empty() ? target
                                               : args.GetSslTargetNameOverride(),
-      grpc_secure_channel_create(c_creds_, target.c_str(), &channel_args)));
+      grpc_secure_channel_create(c_creds_, target.c_str(), &channel_args),
+      args));
 }
 
 namespace {
@@ -64,12 +65,19 @@ std::unique_ptr<Credentials> GoogleDefaultCredentials() {
 // Builds SSL Credentials given SSL specific options
 std::unique_ptr<Credentials> SslCredentials(
     const SslCredentialsOptions& options) {
+  return SslCredentials(options, SslSessionCacheOptions());
+}
+
+std::unique_ptr<Credentials> SslCredentials(
+    const SslCredentialsOptions& options,
+    const SslSessionCacheOptions& session_cache_options) {
   grpc_ssl_pem_key_cert_pair pem_key_cert_pair = {
       options.pem_private_key.c_str(), options.pem_cert_chain.c_str()};
 
-  grpc_credentials* c_creds = grpc_ssl_credentials_create(
+  grpc_credentials* c_creds = grpc_ssl_credentials_create_with_session_cache(
       options.pem_root_certs.empty() ? nullptr : options.pem_root_certs.c_str(),
-      options.pem_private_key.empty() ? nullptr : &pem_key_cert_pair);
+      options.pem_private_key.empty() ? nullptr : &pem_key_cert_pair,
+      session_cache_options.max_sessions);
   return WrapCredentials(c_creds);
 }
 
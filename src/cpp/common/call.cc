@@ -78,12 +78,12 @@ void CallOpBuffer::Reset(void* next_return_tag) {
 
   send_initial_metadata_ = false;
   initial_metadata_count_ = 0;
-  gpr_free(initial_metadata_);
+  initial_metadata_ = nullptr;
 
   recv_initial_metadata_ = nullptr;
   recv_initial_metadata_arr_.count = 0;
 
-  if (send_buf_ && send_message_) {
+  if (send_buf_) {
     grpc_byte_buffer_destroy(send_buf_);
   }
   send_message_ = nullptr;
@@ -122,48 +122,24 @@ CallOpBuffer::~CallOpBuffer() {
   if (recv_buf_ && recv_message_) {
     grpc_byte_buffer_destroy(recv_buf_);
   }
-  if (send_buf_ && send_message_) {
+  if (send_buf_) {
     grpc_byte_buffer_destroy(send_buf_);
   }
 }
 
 namespace {
-// TODO(yangg) if the map is changed before we send, the pointers will be a
-// mess. Make sure it does not happen.
-grpc_metadata* FillMetadataArray(
-    std::multimap<grpc::string, grpc::string>* metadata) {
-  if (metadata->empty()) {
-    return nullptr;
-  }
-  grpc_metadata* metadata_array =
-      (grpc_metadata*)gpr_malloc(metadata->size() * sizeof(grpc_metadata));
-  size_t i = 0;
-  for (auto iter = metadata->cbegin(); iter != metadata->cend(); ++iter, ++i) {
-    metadata_array[i].key = iter->first.c_str();
-    metadata_array[i].value = iter->second.c_str();
-    metadata_array[i].value_length = iter->second.size();
-  }
-  return metadata_array;
-}
-
-void FillMetadataMap(grpc_metadata_array* arr,
-                     std::multimap<grpc::string, grpc::string>* metadata) {
-  for (size_t i = 0; i < arr->count; i++) {
-    // TODO(yangg) handle duplicates?
-    metadata->insert(std::pair<grpc::string, grpc::string>(
-        arr->metadata[i].key,
-        grpc::string(arr->metadata[i].value, arr->metadata[i].value_length)));
-  }
-  grpc_metadata_array_destroy(arr);
-  grpc_metadata_array_init(arr);
+// The received keys and values are owned by the call, so the map only keeps
+// references to them; the array itself is kept for the next batch.
+void FillMetadataMap(grpc_metadata_array* arr, MetadataMap* metadata) {
+  metadata->Fill(arr->metadata, arr->count);
+  arr->count = 0;
 }
 }  // namespace
 
-void CallOpBuffer::AddSendInitialMetadata(
-    std::multimap<grpc::string, grpc::string>* metadata) {
+void CallOpBuffer::AddSendInitialMetadata(OutgoingMetadata* metadata) {
   send_initial_metadata_ = true;
   initial_metadata_count_ = metadata->size();
-  initial_metadata_ = FillMetadataArray(metadata);
+  initial_metadata_ = metadata->Fill();
 }
 
 void CallOpBuffer::AddRecvInitialMetadata(ClientContext* ctx) {
@@ -204,11 +180,11 @@ void CallOpBuffer::AddClientRecvStatus(ClientContext* context, Status* status) {
   recv_status_ = status;
 }
 
-void CallOpBuffer::AddServerSendStatus(
-    std::multimap<grpc::string, grpc::string>* metadata, const Status& status) {
+void CallOpBuffer::AddServerSendStatus(OutgoingMetadata* metadata,
+                                       const Status& status) {
   if (metadata != NULL) {
     trailing_metadata_count_ = metadata->size();
-    trailing_metadata_ = FillMetadataArray(metadata);
+    trailing_metadata_ = metadata->Fill();
   } else {
     trailing_metadata_count_ = 0;
   }
@@ -240,7 +216,9 @@ void CallOpBuffer::FillOps(grpc_op* ops, size_t* nops) {
       }
       GRPC_TIMER_END(GRPC_PTAG_PROTO_SERIALIZE, 0);
     } else {
-      send_buf_ = send_message_buffer_->buffer();
+      // Shares the slices of the pre-serialized message, so the ByteBuffer
+      // may go away before the op completes.
+      send_buf_ = grpc_byte_buffer_copy(send_message_buffer_->buffer());
     }
     ops[*nops].op = GRPC_OP_SEND_MESSAGE;
     ops[*nops].data.send_message = send_buf_;
@@ -285,20 +263,12 @@ void CallOpBuffer::FillOps(grpc_op* ops, size_t* nops) {
 
 bool CallOpBuffer::FinalizeResult(void** tag, bool* status) {
   // Release send buffers.
-  if (send_buf_ && send_message_) {
-    if (send_message_) {
-      grpc_byte_buffer_destroy(send_buf_);
-    }
+  if (send_buf_) {
+    grpc_byte_buffer_destroy(send_buf_);
     send_buf_ = nullptr;
   }
-  if (initial_metadata_) {
-    gpr_free(initial_metadata_);
-    initial_metadata_ = nullptr;
-  }
-  if (trailing_metadata_count_) {
-    gpr_free(trailing_metadata_);
-    trailing_metadata_ = nullptr;
-  }
+  initial_metadata_ = nullptr;
+  trailing_metadata_ = nullptr;
   // Set user-facing tag.
   *tag = return_tag_;
   // Process received initial metadata
@@ -0,0 +1,120 @@
+/*
+ *
+ * Copyright 2015, Google Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer
+ * in the documentation and/or other materials provided with the
+ * distribution.
+ *     * Neither the name of Google Inc. nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+
+#include <grpc++/metadata.h>
+
+namespace grpc {
+
+namespace {
+// Sized so that a typical set of metadata fits without regrowing.
+const size_t kInitialEntries = 8;
+const size_t kInitialBytes = 256;
+}  // namespace
+
+MetadataMap::const_iterator MetadataMap::find(string_ref key) const {
+  for (auto it = entries_.begin(); it != entries_.end(); ++it) {
+    if (it->first == key) return it;
+  }
+  return entries_.end();
+}
+
+size_t MetadataMap::count(string_ref key) const {
+  size_t n = 0;
+  for (auto it = entries_.begin(); it != entries_.end(); ++it) {
+    if (it->first == key) n++;
+  }
+  return n;
+}
+
+void MetadataMap::Fill(const grpc_metadata* metadata, size_t count) {
+  entries_.clear();
+  entries_.reserve(count);
+  for (size_t i = 0; i < count; i++) {
+    entries_.push_back(
+        value_type(string_ref(metadata[i].key),
+                   string_ref(metadata[i].value, metadata[i].value_length)));
+  }
+}
+
+OutgoingMetadata::OutgoingMetadata(const OutgoingMetadata& other)
+    : storage_(other.storage_),
+      entries_(other.entries_),
+      constant_(other.constant_) {}
+
+OutgoingMetadata& OutgoingMetadata::operator=(const OutgoingMetadata& other) {
+  if (this != &other) {
+    storage_ = other.storage_;
+    entries_ = other.entries_;
+    array_.clear();
+    constant_ = other.constant_;
+  }
+  return *this;
+}
+
+void OutgoingMetadata::Add(string_ref key, string_ref value) {
+  if (entries_.empty()) {
+    entries_.reserve(kInitialEntries);
+    storage_.reserve(kInitialBytes);
+  }
+  Entry entry;
+  entry.key = storage_.size();
+  storage_.append(key.data(), key.size());
+  storage_.push_back('\0');
+  entry.value = storage_.size();
+  entry.value_length = value.size();
+  storage_.append(value.data(), value.size());
+  entries_.push_back(entry);
+}
+
+void OutgoingMetadata::AppendTo(std::vector<grpc_metadata>* array) const {
+  const char* base = storage_.data();
+  for (auto it = entries_.begin(); it != entries_.end(); ++it) {
+    grpc_metadata md;
+    md.key = base + it->key;
+    md.value = base + it->value;
+    md.value_length = it->value_length;
+    array->push_back(md);
+  }
+}
+
+grpc_metadata* OutgoingMetadata::Fill() {
+  array_.clear();
+  if (size() == 0) return nullptr;
+  array_.reserve(size());
+  if (constant_) constant_->AppendTo(&array_);
+  AppendTo(&array_);
+  return &array_[0];
+}
+
+}  // namespace grpc
@@ -72,6 +72,8 @@ class GrpcBufferWriter GRPC_FINAL
   }
 
   void BackUp(int count) GRPC_OVERRIDE {
+    // Serializing an empty message may back up nothing before any Next().
+    if (count == 0) return;
     gpr_slice_buffer_pop(slice_buffer_);
     if (count == block_size_) {
       backup_slice_ = slice_;
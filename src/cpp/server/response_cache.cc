@@ -0,0 +1,108 @@
+/*
+ *
+ * Copyright 2015, Google Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer
+ * in the documentation and/or other materials provided with the
+ * distribution.
+ *     * Neither the name of Google Inc. nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include <grpc++/response_cache.h>
+
+namespace grpc {
+
+ResponseCache::ResponseCache(gpr_timespec ttl, size_t max_entries)
+    : ttl_(ttl), max_entries_(max_entries) {}
+
+bool ResponseCache::Lookup(const grpc::protobuf::Message& request,
+                           ByteBuffer* response) {
+  return Lookup(request.SerializeAsString(), response);
+}
+
+bool ResponseCache::Lookup(const grpc::string& key, ByteBuffer* response) {
+  gpr_timespec now = gpr_clock_now(GPR_CLOCK_MONOTONIC);
+  grpc::lock_guard<grpc::mutex> lock(mu_);
+  auto it = entries_.find(key);
+  if (it == entries_.end()) {
+    return false;
+  }
+  if (gpr_time_cmp(it->second.expiry, now) <= 0) {
+    entries_.erase(it);
+    return false;
+  }
+  *response = it->second.response;
+  return true;
+}
+
+bool ResponseCache::Insert(const grpc::protobuf::Message& request,
+                           const grpc::protobuf::Message& response,
+                           ByteBuffer* serialized) {
+  ByteBuffer buffer;
+  if (!SerializeToByteBuffer(response, &buffer)) {
+    return false;
+  }
+  Insert(request.SerializeAsString(), buffer);
+  if (serialized) {
+    *serialized = buffer;
+  }
+  return true;
+}
+
+void ResponseCache::Insert(const grpc::string& key,
+                           const ByteBuffer& response) {
+  if (max_entries_ == 0) {
+    return;
+  }
+  gpr_timespec now = gpr_clock_now(GPR_CLOCK_MONOTONIC);
+  grpc::lock_guard<grpc::mutex> lock(mu_);
+  if (entries_.size() >= max_entries_ && entries_.find(key) == entries_.end()) {
+    EvictLocked(now);
+  }
+  Entry& entry = entries_[key];
+  entry.response = response;
+  entry.expiry = gpr_time_add(now, ttl_);
+}
+
+size_t ResponseCache::size() {
+  grpc::lock_guard<grpc::mutex> lock(mu_);
+  return entries_.size();
+}
+
+void ResponseCache::EvictLocked(gpr_timespec now) {
+  for (auto it = entries_.begin(); it != entries_.end();) {
+    if (gpr_time_cmp(it->second.expiry, now) <= 0) {
+      it = entries_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  if (entries_.size() >= max_entries_) {
+    entries_.erase(entries_.begin());
+  }
+}
+
+}  // namespace grpc
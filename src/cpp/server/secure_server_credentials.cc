@@ -42,6 +42,12 @@ int SecureServerCredentials::AddPortToServer(
 
 std::shared_ptr<ServerCredentials> SslServerCredentials(
     const SslServerCredentialsOptions& options) {
+  return SslServerCredentials(options, SslSessionTicketOptions());
+}
+
+std::shared_ptr<ServerCredentials> SslServerCredentials(
+    const SslServerCredentialsOptions& options,
+    const SslSessionTicketOptions& session_ticket_options) {
   std::vector<grpc_ssl_pem_key_cert_pair> pem_key_cert_pairs;
   for (auto key_cert_pair = options.pem_key_cert_pairs.begin();
        key_cert_pair != options.pem_key_cert_pairs.end(); key_cert_pair++) {
@@ -49,9 +55,12 @@ std::shared_ptr<ServerCredentials> SslServerCredentials(
                                     key_cert_pair->cert_chain.c_str()};
     pem_key_cert_pairs.push_back(p);
   }
-  grpc_server_credentials* c_creds = grpc_ssl_server_credentials_create(
-      options.pem_root_certs.empty() ? nullptr : options.pem_root_certs.c_str(),
-      &pem_key_cert_pairs[0], pem_key_cert_pairs.size());
+  grpc_server_credentials* c_creds =
+      grpc_ssl_server_credentials_create_with_ticket_rotation(
+          options.pem_root_certs.empty() ? nullptr
+                                         : options.pem_root_certs.c_str(),
+          &pem_key_cert_pairs[0], pem_key_cert_pairs.size(),
+          session_ticket_options.key_rotation_secs);
   return std::shared_ptr<ServerCredentials>(
       new SecureServerCredentials(c_creds));
 }
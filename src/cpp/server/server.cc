@@ -52,6 +52,33 @@
 
 namespace grpc {
 
+namespace {
+
+// A message taken from a method's pool for the duration of one call.
+class PooledMessage {
+ public:
+  PooledMessage() : pool_(nullptr), message_(nullptr) {}
+  ~PooledMessage() {
+    if (message_) {
+      pool_->Put(message_);
+    }
+  }
+
+  void Acquire(MessagePool* pool) {
+    GPR_ASSERT(!message_);
+    pool_ = pool;
+    message_ = pool->Get();
+  }
+
+  grpc::protobuf::Message* get() const { return message_; }
+
+ private:
+  MessagePool* pool_;
+  grpc::protobuf::Message* message_;
+};
+
+}  // namespace
+
 class Server::SyncRequest GRPC_FINAL : public CompletionQueueTag {
  public:
   SyncRequest(RpcServiceMethod* method, void* tag)
@@ -121,18 +148,18 @@ class Server::SyncRequest GRPC_FINAL : public CompletionQueueTag {
     }
 
     void Run() {
-      std::unique_ptr<grpc::protobuf::Message> req;
-      std::unique_ptr<grpc::protobuf::Message> res;
+      PooledMessage req;
+      PooledMessage res;
       if (has_request_payload_) {
         GRPC_TIMER_BEGIN(GRPC_PTAG_PROTO_DESERIALIZE, call_.call());
-        req.reset(method_->AllocateRequestProto());
+        req.Acquire(method_->request_pool());
         if (!DeserializeProto(request_payload_, req.get())) {
           abort();  // for now
         }
         GRPC_TIMER_END(GRPC_PTAG_PROTO_DESERIALIZE, call_.call());
       }
       if (has_response_payload_) {
-        res.reset(method_->AllocateResponseProto());
+        res.Acquire(method_->response_pool());
       }
       ctx_.BeginCompletionOp(&call_);
       auto status = method_->handler()->RunHandler(
@@ -142,7 +169,7 @@ class Server::SyncRequest GRPC_FINAL : public CompletionQueueTag {
         buf.AddSendInitialMetadata(&ctx_.initial_metadata_);
       }
       if (has_response_payload_) {
-        buf.AddSendMessage(*res);
+        buf.AddSendMessage(*res.get());
       }
       buf.AddServerSendStatus(&ctx_.trailing_metadata_, status);
       call_.PerformOps(&buf);
@@ -176,11 +203,166 @@ class Server::SyncRequest GRPC_FINAL : public CompletionQueueTag {
   grpc_completion_queue* cq_;
 };
 
-Server::Server(ThreadPoolInterface* thread_pool, bool thread_pool_owned)
+// A pending request for a call to one method of a callback service. When the
+// call arrives the handler is run right on the polling thread, and the slot
+// asks for the next call.
+class Server::CallbackRequest GRPC_FINAL : public CompletionQueueTag {
+ public:
+  CallbackRequest(Server* server, RpcServiceMethod* method, void* tag)
+      : server_(server),
+        method_(method),
+        tag_(tag),
+        has_request_payload_(method->method_type() == RpcMethod::NORMAL_RPC ||
+                             method->method_type() ==
+                                 RpcMethod::SERVER_STREAMING),
+        call_(nullptr),
+        request_payload_(nullptr) {
+    grpc_metadata_array_init(&request_metadata_);
+  }
+
+  CallbackRequest(const CallbackRequest& other)
+      : server_(other.server_),
+        method_(other.method_),
+        tag_(other.tag_),
+        has_request_payload_(other.has_request_payload_),
+        call_(nullptr),
+        request_payload_(nullptr) {
+    grpc_metadata_array_init(&request_metadata_);
+  }
+
+  ~CallbackRequest() { grpc_metadata_array_destroy(&request_metadata_); }
+
+  // Called with server_->mu_ held.
+  void Request() {
+    server_->callback_outstanding_++;
+    request_metadata_.count = 0;
+    request_payload_ = nullptr;
+    GPR_ASSERT(GRPC_CALL_OK ==
+               grpc_server_request_registered_call(
+                   server_->server_, tag_, &call_, &deadline_,
+                   &request_metadata_,
+                   has_request_payload_ ? &request_payload_ : nullptr,
+                   server_->callback_cq_.cq(), this));
+  }
+
+  bool FinalizeResult(void** tag, bool* status) GRPC_OVERRIDE {
+    if (*status) {
+      CallData* cd = new CallData(server_, this);
+      {
+        grpc::lock_guard<grpc::mutex> lock(server_->mu_);
+        server_->callback_outstanding_++;
+        Request();
+      }
+      cd->Run();
+    }
+    server_->CallbackDone();
+    return false;
+  }
+
+  class CallData GRPC_FINAL : public CallOpBuffer, public ServerUnaryReactor {
+   public:
+    CallData(Server* server, CallbackRequest* mrd)
+        : server_(server),
+          call_(mrd->call_, server, &server->callback_cq_),
+          ctx_(mrd->deadline_, mrd->request_metadata_.metadata,
+               mrd->request_metadata_.count),
+          request_payload_(mrd->request_payload_),
+          method_(mrd->method_),
+          refs_(2) {
+      ctx_.call_ = mrd->call_;
+      ctx_.cq_ = &server->callback_cq_;
+    }
+
+    ~CallData() {
+      if (request_payload_) {
+        grpc_byte_buffer_destroy(request_payload_);
+      }
+    }
+
+    void Run() {
+      // Destroying the call before the client has closed it would cancel it,
+      // so the call lives until both the status is sent and the close seen.
+      ctx_.BeginCompletionOp(&call_, std::bind(&CallData::Unref, this));
+      if (method_->callback_handler() == nullptr) {
+        Finish(Status(StatusCode::UNIMPLEMENTED, ""));
+        return;
+      }
+      req_.Acquire(method_->request_pool());
+      res_.Acquire(method_->response_pool());
+      GRPC_TIMER_BEGIN(GRPC_PTAG_PROTO_DESERIALIZE, call_.call());
+      bool parsed = request_payload_ != nullptr &&
+                    DeserializeProto(request_payload_, req_.get());
+      GRPC_TIMER_END(GRPC_PTAG_PROTO_DESERIALIZE, call_.call());
+      if (!parsed) {
+        Finish(Status(StatusCode::INTERNAL, "Failed to parse request"));
+        return;
+      }
+      method_->callback_handler()->RunHandler(&ctx_, req_.get(), res_.get(),
+                                              this);
+    }
+
+    void Finish(const Status& status) GRPC_OVERRIDE {
+      if (!ctx_.sent_initial_metadata_) {
+        AddSendInitialMetadata(&ctx_.initial_metadata_);
+        ctx_.sent_initial_metadata_ = true;
+      }
+      if (status.IsOk()) {
+        AddSendMessage(*res_.get());
+      }
+      AddServerSendStatus(&ctx_.trailing_metadata_, status);
+      call_.PerformOps(this);
+    }
+
+    bool FinalizeResult(void** tag, bool* status) GRPC_OVERRIDE {
+      CallOpBuffer::FinalizeResult(tag, status);
+      Unref();
+      return false;
+    }
+
+   private:
+    void Unref() {
+      {
+        grpc::lock_guard<grpc::mutex> lock(mu_);
+        if (--refs_ != 0) return;
+      }
+      Server* server = server_;
+      delete this;
+      server->CallbackDone();
+    }
+
+    Server* const server_;
+    Call call_;
+    ServerContext ctx_;
+    grpc_byte_buffer* request_payload_;
+    RpcServiceMethod* const method_;
+    PooledMessage req_;
+    PooledMessage res_;
+    grpc::mutex mu_;
+    // One for the status batch, one for the completion op of ctx_.
+    int refs_;
+  };
+
+ private:
+  Server* const server_;
+  RpcServiceMethod* const method_;
+  void* const tag_;
+  const bool has_request_payload_;
+  grpc_call* call_;
+  gpr_timespec deadline_;
+  grpc_metadata_array request_metadata_;
+  grpc_byte_buffer* request_payload_;
+};
+
+Server::Server(ThreadPoolInterface* thread_pool, bool thread_pool_owned,
+               int callback_threads, int sync_request_depth)
     : started_(false),
       shutdown_(false),
       num_running_cb_(0),
-      sync_methods_(new std::list<SyncRequest>),
+      sync_methods_(new std::vector<SyncRequest>),
+      sync_request_depth_(sync_request_depth),
+      callback_methods_(new std::list<CallbackRequest>),
+      num_callback_threads_(callback_threads),
+      callback_outstanding_(0),
       server_(grpc_server_create(cq_.cq(), nullptr)),
       thread_pool_(thread_pool),
       thread_pool_owned_(thread_pool_owned) {}
@@ -198,6 +380,7 @@ Server::~Server() {
     delete thread_pool_;
   }
   delete sync_methods_;
+  delete callback_methods_;
 }
 
 bool Server::RegisterService(RpcService* service) {
@@ -210,8 +393,32 @@ bool Server::RegisterService(RpcService* service) {
               method->name());
       return false;
     }
+    // Several outstanding requests let a burst of calls start right away
+    // instead of queueing in the core until each one is requested again.
     SyncRequest request(method, tag);
-    sync_methods_->emplace_back(request);
+    for (int j = 0; j < sync_request_depth_; j++) {
+      sync_methods_->emplace_back(request);
+    }
+  }
+  return true;
+}
+
+bool Server::RegisterCallbackService(RpcService* service) {
+  for (int i = 0; i < service->GetMethodCount(); ++i) {
+    RpcServiceMethod* method = service->GetMethod(i);
+    void* tag = grpc_server_register_method(server_, method->name(), nullptr,
+                                            callback_cq_.cq());
+    if (!tag) {
+      gpr_log(GPR_DEBUG, "Attempt to register %s multiple times",
+              method->name());
+      return false;
+    }
+    // One pending request per polling thread, so that every poller can pick
+    // up a new call while the others are running handlers.
+    CallbackRequest request(this, method, tag);
+    for (int j = 0; j < num_callback_threads_; j++) {
+      callback_methods_->emplace_back(request);
+    }
   }
   return true;
 }
@@ -261,6 +468,20 @@ bool Server::Start() {
     ScheduleCallback();
   }
 
+  if (!callback_methods_->empty()) {
+    {
+      grpc::lock_guard<grpc::mutex> lock(mu_);
+      for (auto m = callback_methods_->begin(); m != callback_methods_->end();
+           m++) {
+        m->Request();
+      }
+    }
+    for (int i = 0; i < num_callback_threads_; i++) {
+      callback_threads_.push_back(
+          grpc::thread(&Server::RunCallbackPoller, this));
+    }
+  }
+
   return true;
 }
 
@@ -272,15 +493,22 @@ void Server::Shutdown() {
     cq_.Shutdown();
 
     // Wait for running callbacks to finish.
-    while (num_running_cb_ != 0) {
+    while (num_running_cb_ != 0 || callback_outstanding_ != 0) {
       callback_cv_.wait(lock);
     }
+
+    callback_cq_.Shutdown();
+    lock.unlock();
+    for (auto t = callback_threads_.begin(); t != callback_threads_.end();
+         t++) {
+      t->join();
+    }
   }
 }
 
 void Server::Wait() {
   grpc::unique_lock<grpc::mutex> lock(mu_);
-  while (num_running_cb_ != 0) {
+  while (num_running_cb_ != 0 || callback_outstanding_ != 0) {
     callback_cv_.wait(lock);
   }
 }
@@ -357,13 +585,7 @@ class Server::AsyncRequest GRPC_FINAL : public CompletionQueueTag {
     GPR_ASSERT(ctx);
     if (*status) {
       ctx->deadline_ = call_details_.deadline;
-      for (size_t i = 0; i < array_.count; i++) {
-        ctx->client_metadata_.insert(std::make_pair(
-            grpc::string(array_.metadata[i].key),
-            grpc::string(
-                array_.metadata[i].value,
-                array_.metadata[i].value + array_.metadata[i].value_length)));
-      }
+      ctx->client_metadata_.Fill(array_.metadata, array_.count);
       if (generic_ctx_) {
         // TODO(yangg) remove the copy here.
         generic_ctx_->method_ = call_details_.method;
@@ -442,4 +664,20 @@ void Server::RunRpc() {
   }
 }
 
+void Server::RunCallbackPoller() {
+  void* tag;
+  bool ok;
+  // Every event is consumed by its tag, so Next only returns at shutdown.
+  while (callback_cq_.Next(&tag, &ok)) {
+  }
+}
+
+void Server::CallbackDone() {
+  grpc::lock_guard<grpc::mutex> lock(mu_);
+  callback_outstanding_--;
+  if (shutdown_) {
+    callback_cv_.notify_all();
+  }
+}
+
 }  // namespace grpc
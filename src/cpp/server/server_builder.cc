@@ -42,7 +42,10 @@
 namespace grpc {
 
 ServerBuilder::ServerBuilder()
-    : generic_service_(nullptr), thread_pool_(nullptr) {}
+    : generic_service_(nullptr),
+      thread_pool_(nullptr),
+      callback_threads_(0),
+      sync_request_depth_(1) {}
 
 void ServerBuilder::RegisterService(SynchronousService* service) {
   services_.push_back(service->service());
@@ -52,6 +55,10 @@ void ServerBuilder::RegisterAsyncService(AsynchronousService* service) {
   async_services_.push_back(service);
 }
 
+void ServerBuilder::RegisterCallbackService(CallbackService* service) {
+  callback_services_.push_back(service->service());
+}
+
 void ServerBuilder::RegisterAsyncGenericService(AsyncGenericService* service) {
   if (generic_service_) {
     gpr_log(GPR_ERROR,
@@ -74,6 +81,14 @@ void ServerBuilder::SetThreadPool(ThreadPoolInterface* thread_pool) {
   thread_pool_ = thread_pool;
 }
 
+void ServerBuilder::SetSyncRequestDepth(int depth) {
+  sync_request_depth_ = depth > 0 ? depth : 1;
+}
+
+void ServerBuilder::SetCallbackThreads(int threads) {
+  callback_threads_ = threads;
+}
+
 std::unique_ptr<Server> ServerBuilder::BuildAndStart() {
   bool thread_pool_owned = false;
   if (!async_services_.empty() && !services_.empty()) {
@@ -86,13 +101,26 @@ std::unique_ptr<Server> ServerBuilder::BuildAndStart() {
     thread_pool_ = new ThreadPool(cores);
     thread_pool_owned = true;
   }
-  std::unique_ptr<Server> server(new Server(thread_pool_, thread_pool_owned));
+  int callback_threads = callback_threads_;
+  if (callback_threads <= 0 && !callback_services_.empty()) {
+    callback_threads = gpr_cpu_num_cores();
+    if (!callback_threads) callback_threads = 4;
+  }
+  std::unique_ptr<Server> server(
+      new Server(thread_pool_, thread_pool_owned, callback_threads,
+                 sync_request_depth_));
   for (auto service = services_.begin(); service != services_.end();
        service++) {
     if (!server->RegisterService(*service)) {
       return nullptr;
     }
   }
+  for (auto service = callback_services_.begin();
+       service != callback_services_.end(); service++) {
+    if (!server->RegisterCallbackService(*service)) {
+      return nullptr;
+    }
+  }
   for (auto service = async_services_.begin();
        service != async_services_.end(); service++) {
     if (!server->RegisterAsyncService(*service)) {
@@ -46,7 +46,8 @@ namespace grpc {
 class ServerContext::CompletionOp GRPC_FINAL : public CallOpBuffer {
  public:
   // initial refs: one in the server context, one in the cq
-  CompletionOp() : refs_(2), finalized_(false), cancelled_(false) {
+  explicit CompletionOp(std::function<void()> on_done)
+      : refs_(2), finalized_(false), cancelled_(false), on_done_(on_done) {
     AddServerRecvClose(&cancelled_);
   }
   bool FinalizeResult(void** tag, bool* status) GRPC_OVERRIDE;
@@ -60,6 +61,7 @@ class ServerContext::CompletionOp GRPC_FINAL : public CallOpBuffer {
   int refs_;
   bool finalized_;
   bool cancelled_;
+  std::function<void()> on_done_;
 };
 
 void ServerContext::CompletionOp::Unref() {
@@ -78,13 +80,15 @@ bool ServerContext::CompletionOp::CheckCancelled(CompletionQueue* cq) {
 
 bool ServerContext::CompletionOp::FinalizeResult(void** tag, bool* status) {
   GPR_ASSERT(CallOpBuffer::FinalizeResult(tag, status));
-  grpc::unique_lock<grpc::mutex> lock(mu_);
-  finalized_ = true;
-  if (!*status) cancelled_ = true;
-  if (--refs_ == 0) {
-    lock.unlock();
-    delete this;
+  {
+    grpc::lock_guard<grpc::mutex> g(mu_);
+    finalized_ = true;
+    if (!*status) cancelled_ = true;
   }
+  // Run without the lock: on_done_ may destroy the server context, which
+  // drops the other ref.
+  if (on_done_) on_done_();
+  Unref();
   return false;
 }
 
@@ -103,12 +107,7 @@ ServerContext::ServerContext(gpr_timespec deadline, grpc_metadata* metadata,
       call_(nullptr),
       cq_(nullptr),
       sent_initial_metadata_(false) {
-  for (size_t i = 0; i < metadata_count; i++) {
-    client_metadata_.insert(std::make_pair(
-        grpc::string(metadata[i].key),
-        grpc::string(metadata[i].value,
-                     metadata[i].value + metadata[i].value_length)));
-  }
+  client_metadata_.Fill(metadata, metadata_count);
 }
 
 ServerContext::~ServerContext() {
@@ -121,19 +120,24 @@ ServerContext::~ServerContext() {
 }
 
 void ServerContext::BeginCompletionOp(Call* call) {
+  BeginCompletionOp(call, nullptr);
+}
+
+void ServerContext::BeginCompletionOp(Call* call,
+                                      std::function<void()> on_done) {
   GPR_ASSERT(!completion_op_);
-  completion_op_ = new CompletionOp();
+  completion_op_ = new CompletionOp(on_done);
   call->PerformOps(completion_op_);
 }
 
 void ServerContext::AddInitialMetadata(const grpc::string& key,
                                        const grpc::string& value) {
-  initial_metadata_.insert(std::make_pair(key, value));
+  initial_metadata_.Add(key, value);
 }
 
 void ServerContext::AddTrailingMetadata(const grpc::string& key,
                                         const grpc::string& value) {
-  trailing_metadata_.insert(std::make_pair(key, value));
+  trailing_metadata_.Add(key, value);
 }
 
 bool ServerContext::IsCancelled() {
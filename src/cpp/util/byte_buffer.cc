@@ -33,6 +33,8 @@
 
 #include <grpc++/byte_buffer.h>
 
+#include "src/cpp/proto/proto_utils.h"
+
 namespace grpc {
 
 ByteBuffer::ByteBuffer(Slice* slices, size_t nslices) {
@@ -44,6 +46,19 @@ ByteBuffer::ByteBuffer(Slice* slices, size_t nslices) {
   buffer_ = grpc_byte_buffer_create(c_slices.data(), nslices);
 }
 
+ByteBuffer::ByteBuffer(const ByteBuffer& other)
+    : buffer_(other.buffer_ ? grpc_byte_buffer_copy(other.buffer_) : nullptr) {}
+
+ByteBuffer& ByteBuffer::operator=(const ByteBuffer& other) {
+  if (this != &other) {
+    Clear();
+    if (other.buffer_) {
+      buffer_ = grpc_byte_buffer_copy(other.buffer_);
+    }
+  }
+  return *this;
+}
+
 void ByteBuffer::Clear() {
   if (buffer_) {
     grpc_byte_buffer_destroy(buffer_);
@@ -72,4 +87,15 @@ size_t ByteBuffer::Length() {
   }
 }
 
+bool SerializeToByteBuffer(const grpc::protobuf::Message& message,
+                           ByteBuffer* buffer) {
+  grpc_byte_buffer* buf;
+  if (!SerializeProto(message, &buf)) {
+    return false;
+  }
+  buffer->Clear();
+  buffer->set_buffer(buf);
+  return true;
+}
+
 }  // namespace grpc
@@ -0,0 +1,334 @@
+/*
+ *
+ * Copyright 2015, Google Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer
+ * in the documentation and/or other materials provided with the
+ * distribution.
+ *     * Neither the name of Google Inc. nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include "src/core/channel/compress_filter.h"
+
+#include <string.h>
+
+#include <grpc/grpc.h>
+#include <grpc/support/alloc.h>
+#include <grpc/support/log.h>
+#include <grpc/support/useful.h>
+#include "src/core/compression/message_compress.h"
+#include "test/core/util/test_config.h"
+
+#define LOG_TEST_NAME() gpr_log(GPR_INFO, "%s", __FUNCTION__)
+
+#define MESSAGE_SIZE 1024
+
+/* Pass-through filter: the compress filter may be neither first nor last. */
+static void first_start_transport_op(grpc_call_element *elem,
+                                     grpc_transport_op *op) {
+  grpc_call_next_op(elem, op);
+}
+
+static void first_channel_op(grpc_channel_element *elem,
+                             grpc_channel_element *from_elem,
+                             grpc_channel_op *op) {
+  grpc_channel_next_op(elem, op);
+}
+
+/* Last filter: stands for the transport, remembering what was sent and the
+   pending receive. */
+typedef struct {
+  int sent_encoding;
+  int sent_accept_encoding;
+  int messages_sent;
+  gpr_uint32 last_message_flags;
+  grpc_status_code cancel_status;
+  grpc_stream_op_buffer *recv_ops;
+  void (*on_done_recv)(void *user_data, int success);
+  void *recv_user_data;
+} last_call_data;
+
+static void last_start_transport_op(grpc_call_element *elem,
+                                    grpc_transport_op *op) {
+  last_call_data *calld = elem->call_data;
+  size_t i;
+  if (op->send_ops != NULL) {
+    for (i = 0; i < op->send_ops->nops; i++) {
+      grpc_stream_op *sop = &op->send_ops->ops[i];
+      grpc_linked_mdelem *l;
+      if (sop->type == GRPC_OP_BEGIN_MESSAGE) {
+        calld->messages_sent++;
+        calld->last_message_flags = sop->data.begin_message.flags;
+      } else if (sop->type == GRPC_OP_METADATA) {
+        for (l = sop->data.metadata.list.head; l != NULL; l = l->next) {
+          const char *key = grpc_mdstr_as_c_string(l->md->key);
+          if (0 == strcmp(key, "grpc-encoding")) calld->sent_encoding = 1;
+          if (0 == strcmp(key, "grpc-accept-encoding")) {
+            calld->sent_accept_encoding = 1;
+          }
+        }
+      }
+    }
+  }
+  if (op->recv_ops != NULL) {
+    calld->recv_ops = op->recv_ops;
+    calld->on_done_recv = op->on_done_recv;
+    calld->recv_user_data = op->recv_user_data;
+  }
+  if (op->cancel_with_status != GRPC_STATUS_OK) {
+    calld->cancel_status = op->cancel_with_status;
+    if (op->cancel_message != NULL) grpc_mdstr_unref(op->cancel_message);
+  }
+}
+
+static void last_channel_op(grpc_channel_element *elem,
+                            grpc_channel_element *from_elem,
+                            grpc_channel_op *op) {}
+
+static void init_call_elem(grpc_call_element *elem,
+                           const void *server_transport_data,
+                           grpc_transport_op *initial_op) {
+  memset(elem->call_data, 0, sizeof(last_call_data));
+}
+
+static void destroy_call_elem(grpc_call_element *elem) {}
+
+static void init_channel_elem(grpc_channel_element *elem,
+                              const grpc_channel_args *args,
+                              grpc_mdctx *metadata_context, int is_first,
+                              int is_last) {}
+
+static void destroy_channel_elem(grpc_channel_element *elem) {}
+
+static const grpc_channel_filter first_filter = {
+    first_start_transport_op, first_channel_op, 0, init_call_elem,
+    destroy_call_elem, 0, init_channel_elem, destroy_channel_elem,
+    "first"};
+
+static const grpc_channel_filter last_filter = {
+    last_start_transport_op, last_channel_op, sizeof(last_call_data),
+    init_call_elem, destroy_call_elem, 0, init_channel_elem,
+    destroy_channel_elem, "last"};
+
+/* A client call through the compress filter */
+typedef struct {
+  grpc_mdctx *mdctx;
+  grpc_channel_stack *channel_stack;
+  grpc_call_stack *call_stack;
+  last_call_data *last;
+  grpc_stream_op_buffer recv_ops;
+  grpc_stream_state recv_state;
+  int recv_done;
+  grpc_linked_mdelem recv_md_link;
+} test_call;
+
+static void on_recv(void *user_data, int success) {
+  test_call *call = user_data;
+  GPR_ASSERT(success);
+  call->recv_done = 1;
+}
+
+static void start_op(test_call *call, grpc_transport_op *op) {
+  grpc_call_element *first = grpc_call_stack_element(call->call_stack, 0);
+  first->filter->start_transport_op(first, op);
+}
+
+static void test_call_init(test_call *call, const char *algorithm,
+                           int max_message_length) {
+  const grpc_channel_filter *filters[] = {&first_filter, &grpc_compress_filter,
+                                          &last_filter};
+  grpc_arg args[2];
+  grpc_channel_args channel_args;
+  grpc_transport_op op;
+
+  args[0].type = GRPC_ARG_INTEGER;
+  args[0].key = GRPC_ARG_MAX_MESSAGE_LENGTH;
+  args[0].value.integer = max_message_length;
+  args[1].type = GRPC_ARG_STRING;
+  args[1].key = GRPC_ARG_COMPRESSION_ALGORITHM;
+  args[1].value.string = (char *)algorithm;
+  channel_args.num_args = algorithm != NULL ? 2 : 1;
+  channel_args.args = args;
+
+  memset(call, 0, sizeof(*call));
+  call->mdctx = grpc_mdctx_create();
+  call->channel_stack = gpr_malloc(grpc_channel_stack_size(filters, 3));
+  grpc_channel_stack_init(filters, 3, &channel_args, call->mdctx,
+                          call->channel_stack);
+  call->call_stack = gpr_malloc(call->channel_stack->call_stack_size);
+  grpc_call_stack_init(call->channel_stack, NULL, NULL, call->call_stack);
+  call->last = grpc_call_stack_element(call->call_stack, 2)->call_data;
+
+  /* start receiving */
+  grpc_sopb_init(&call->recv_ops);
+  memset(&op, 0, sizeof(op));
+  op.recv_ops = &call->recv_ops;
+  op.recv_state = &call->recv_state;
+  op.on_done_recv = on_recv;
+  op.recv_user_data = call;
+  start_op(call, &op);
+  GPR_ASSERT(call->last->on_done_recv != NULL);
+}
+
+static void test_call_destroy(test_call *call) {
+  grpc_sopb_destroy(&call->recv_ops);
+  grpc_call_stack_destroy(call->call_stack);
+  gpr_free(call->call_stack);
+  grpc_channel_stack_destroy(call->channel_stack);
+  gpr_free(call->channel_stack);
+  grpc_mdctx_unref(call->mdctx);
+}
+
+/* Sends initial metadata (on the first call) and a compressible message. */
+static void send_message(test_call *call, int with_metadata) {
+  grpc_stream_op_buffer sopb;
+  grpc_transport_op op;
+  grpc_metadata_batch md;
+  grpc_sopb_init(&sopb);
+  if (with_metadata) {
+    grpc_metadata_batch_init(&md);
+    grpc_sopb_add_metadata(&sopb, md);
+  }
+  grpc_sopb_add_begin_message(&sopb, MESSAGE_SIZE, 0);
+  grpc_sopb_add_slice(&sopb, gpr_slice_malloc(MESSAGE_SIZE));
+  memset(GPR_SLICE_START_PTR(sopb.ops[sopb.nops - 1].data.slice), 'a',
+         MESSAGE_SIZE);
+  memset(&op, 0, sizeof(op));
+  op.send_ops = &sopb;
+  start_op(call, &op);
+  grpc_sopb_destroy(&sopb);
+}
+
+/* Completes the pending receive with ops already in call->recv_ops. */
+static void finish_recv(test_call *call) {
+  GPR_ASSERT(call->last->on_done_recv != NULL);
+  call->last->on_done_recv(call->last->recv_user_data, 1);
+  GPR_ASSERT(call->recv_done);
+}
+
+static void add_server_metadata(test_call *call, const char *key,
+                                const char *value) {
+  grpc_metadata_batch md;
+  grpc_metadata_batch_init(&md);
+  grpc_metadata_batch_add_tail(
+      &md, &call->recv_md_link,
+      grpc_mdelem_from_strings(call->mdctx, key, value));
+  grpc_sopb_add_metadata(&call->recv_ops, md);
+  finish_recv(call);
+  /* the filter consumes its own metadata */
+  GPR_ASSERT(call->recv_ops.nops == 1);
+  GPR_ASSERT(call->recv_ops.ops[0].data.metadata.list.head == NULL);
+}
+
+/* Without an algorithm, nothing is advertised or compressed. */
+static void test_disabled(void) {
+  test_call call;
+  LOG_TEST_NAME();
+  test_call_init(&call, NULL, 1024 * 1024);
+  send_message(&call, 1);
+  GPR_ASSERT(!call.last->sent_encoding);
+  GPR_ASSERT(!call.last->sent_accept_encoding);
+  GPR_ASSERT(call.last->messages_sent == 1);
+  GPR_ASSERT(!(call.last->last_message_flags & GRPC_WRITE_INTERNAL_COMPRESS));
+  test_call_destroy(&call);
+}
+
+/* Clients compress only once the server has said it accepts the algorithm. */
+static void test_compress_once_accepted(void) {
+  test_call call;
+  LOG_TEST_NAME();
+  test_call_init(&call, "gzip", 1024 * 1024);
+  send_message(&call, 1);
+  GPR_ASSERT(call.last->sent_encoding);
+  GPR_ASSERT(call.last->sent_accept_encoding);
+  GPR_ASSERT(!(call.last->last_message_flags & GRPC_WRITE_INTERNAL_COMPRESS));
+
+  add_server_metadata(&call, "grpc-accept-encoding", "deflate,lz");
+  send_message(&call, 0);
+  GPR_ASSERT(!(call.last->last_message_flags & GRPC_WRITE_INTERNAL_COMPRESS));
+  test_call_destroy(&call);
+
+  test_call_init(&call, "gzip", 1024 * 1024);
+  send_message(&call, 1);
+  add_server_metadata(&call, "grpc-accept-encoding", "deflate, gzip");
+  send_message(&call, 0);
+  GPR_ASSERT(call.last->messages_sent == 2);
+  GPR_ASSERT(call.last->last_message_flags & GRPC_WRITE_INTERNAL_COMPRESS);
+  test_call_destroy(&call);
+}
+
+/* Receives a gzip message decompressing to length bytes. */
+static void recv_compressed_message(test_call *call, size_t length) {
+  gpr_slice_buffer input;
+  gpr_slice_buffer compressed;
+  gpr_slice value = gpr_slice_malloc(length);
+  size_t i;
+
+  memset(GPR_SLICE_START_PTR(value), 0, length);
+  gpr_slice_buffer_init(&input);
+  gpr_slice_buffer_init(&compressed);
+  gpr_slice_buffer_add(&input, value);
+  GPR_ASSERT(grpc_msg_compress(GRPC_COMPRESS_GZIP, &input, &compressed));
+  grpc_sopb_add_begin_message(&call->recv_ops, (gpr_uint32)compressed.length,
+                              GRPC_WRITE_INTERNAL_COMPRESS);
+  for (i = 0; i < compressed.count; i++) {
+    grpc_sopb_add_slice(&call->recv_ops, gpr_slice_ref(compressed.slices[i]));
+  }
+  call->recv_done = 0;
+  finish_recv(call);
+  gpr_slice_buffer_destroy(&input);
+  gpr_slice_buffer_destroy(&compressed);
+}
+
+/* A compressed message inflating past the maximum message length fails the
+   call with RESOURCE_EXHAUSTED instead of being decompressed. */
+static void test_oversized_compressed_message(void) {
+  test_call call;
+  LOG_TEST_NAME();
+  test_call_init(&call, NULL, 64 * 1024);
+  add_server_metadata(&call, "grpc-encoding", "gzip");
+  grpc_sopb_reset(&call.recv_ops);
+
+  recv_compressed_message(&call, 64 * 1024);
+  GPR_ASSERT(call.last->cancel_status == GRPC_STATUS_OK);
+  GPR_ASSERT(call.recv_ops.nops > 0);
+  GPR_ASSERT(call.recv_ops.ops[0].type == GRPC_OP_BEGIN_MESSAGE);
+  GPR_ASSERT(call.recv_ops.ops[0].data.begin_message.length == 64 * 1024);
+  grpc_sopb_reset(&call.recv_ops);
+
+  recv_compressed_message(&call, 16 * 1024 * 1024);
+  GPR_ASSERT(call.last->cancel_status == GRPC_STATUS_RESOURCE_EXHAUSTED);
+  GPR_ASSERT(call.recv_ops.nops == 0);
+  test_call_destroy(&call);
+}
+
+int main(int argc, char **argv) {
+  grpc_test_init(argc, argv);
+  test_disabled();
+  test_compress_once_accepted();
+  test_oversized_compressed_message();
+  return 0;
+}
@@ -0,0 +1,183 @@
+/*
+ *
+ * Copyright 2015, Google Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer
+ * in the documentation and/or other materials provided with the
+ * distribution.
+ *     * Neither the name of Google Inc. nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/* Restarts a server several times under a set of channels connected to it,
+   and checks that the channels' reconnection attempts are spread out rather
+   than arriving at the server together. */
+
+#include <grpc/grpc.h>
+
+#include <netinet/in.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "test/core/util/port.h"
+#include "test/core/util/test_config.h"
+#include <grpc/support/alloc.h>
+#include <grpc/support/host_port.h>
+#include <grpc/support/log.h>
+#include <grpc/support/time.h>
+
+#define NUM_CHANNELS 20
+#define NUM_RESTARTS 3
+#define INITIAL_BACKOFF_MS 2000
+/* jitter is +/-20% of the backoff, so reconnections should be spread over
+   about 800ms. Without a poller of their own, channels notice connections
+   completing in ~100ms steps, so leave plenty of room. */
+#define MIN_SPREAD_MS 200
+
+static gpr_timespec test_deadline(void) {
+  return GRPC_TIMEOUT_SECONDS_TO_DEADLINE(20);
+}
+
+static void sleep_ms(int ms) {
+  gpr_sleep_until(gpr_time_add(gpr_now(), gpr_time_from_millis(ms)));
+}
+
+/* A server that never accepts: the kernel completes connections into the
+   listen backlog, which is enough for a channel to become ready. Closing the
+   listener resets them all at once. */
+static int start_server(int port) {
+  struct sockaddr_in addr;
+  int one = 1;
+  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  GPR_ASSERT(fd >= 0);
+  GPR_ASSERT(0 == setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one)));
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(port);
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  GPR_ASSERT(0 == bind(fd, (struct sockaddr *)&addr, sizeof(addr)));
+  GPR_ASSERT(0 == listen(fd, 2 * NUM_CHANNELS));
+  return fd;
+}
+
+static void wait_for_all(grpc_channel **channels,
+                         grpc_connectivity_state state) {
+  gpr_timespec deadline = test_deadline();
+  int i;
+  for (i = 0; i < NUM_CHANNELS; i++) {
+    while (grpc_channel_check_connectivity_state(channels[i], 0) != state) {
+      GPR_ASSERT(gpr_time_cmp(gpr_now(), deadline) < 0);
+      sleep_ms(1);
+    }
+  }
+}
+
+/* Connect all channels while the server is down, bring it up, and return how
+   far apart the first and last channels' reconnections were (in ms) */
+static int measure_reconnect_spread(grpc_channel **channels, int port,
+                                    int *server_fd) {
+  gpr_timespec ready_at[NUM_CHANNELS];
+  gpr_timespec deadline = test_deadline();
+  gpr_timespec first;
+  gpr_timespec last;
+  int remaining = NUM_CHANNELS;
+  int i;
+
+  /* every channel's first attempt fails at (nearly) the same moment... */
+  for (i = 0; i < NUM_CHANNELS; i++) {
+    grpc_channel_check_connectivity_state(channels[i], 1);
+    ready_at[i] = gpr_inf_future;
+  }
+  wait_for_all(channels, GRPC_CHANNEL_TRANSIENT_FAILURE);
+
+  /* ...and the server comes back well before any of them retry */
+  sleep_ms(INITIAL_BACKOFF_MS / 5);
+  *server_fd = start_server(port);
+
+  while (remaining > 0) {
+    GPR_ASSERT(gpr_time_cmp(gpr_now(), deadline) < 0);
+    for (i = 0; i < NUM_CHANNELS; i++) {
+      if (gpr_time_cmp(ready_at[i], gpr_inf_future) == 0 &&
+          grpc_channel_check_connectivity_state(channels[i], 0) ==
+              GRPC_CHANNEL_READY) {
+        ready_at[i] = gpr_now();
+        remaining--;
+      }
+    }
+    sleep_ms(1);
+  }
+
+  first = last = ready_at[0];
+  for (i = 1; i < NUM_CHANNELS; i++) {
+    if (gpr_time_cmp(ready_at[i], first) < 0) first = ready_at[i];
+    if (gpr_time_cmp(ready_at[i], last) > 0) last = ready_at[i];
+  }
+  return gpr_time_to_millis(gpr_time_sub(last, first));
+}
+
+int main(int argc, char **argv) {
+  grpc_channel *channels[NUM_CHANNELS];
+  grpc_arg arg;
+  grpc_channel_args args;
+  int port;
+  int server_fd;
+  int spread_ms;
+  char *target;
+  int i;
+
+  grpc_test_init(argc, argv);
+  grpc_init();
+
+  port = grpc_pick_unused_port_or_die();
+  gpr_join_host_port(&target, "127.0.0.1", port);
+
+  arg.type = GRPC_ARG_INTEGER;
+  arg.key = GRPC_ARG_INITIAL_RECONNECT_BACKOFF_MS;
+  arg.value.integer = INITIAL_BACKOFF_MS;
+  args.num_args = 1;
+  args.args = &arg;
+  for (i = 0; i < NUM_CHANNELS; i++) {
+    channels[i] = grpc_channel_create(target, &args);
+  }
+
+  for (i = 0; i < NUM_RESTARTS; i++) {
+    spread_ms = measure_reconnect_spread(channels, port, &server_fd);
+    gpr_log(GPR_INFO, "restart %d: reconnections spread over %dms", i,
+            spread_ms);
+    GPR_ASSERT(spread_ms >= MIN_SPREAD_MS);
+
+    /* take the server down again: every channel loses its connection */
+    close(server_fd);
+    wait_for_all(channels, GRPC_CHANNEL_IDLE);
+  }
+
+  for (i = 0; i < NUM_CHANNELS; i++) {
+    grpc_channel_destroy(channels[i]);
+  }
+  gpr_free(target);
+  grpc_shutdown();
+  return 0;
+}
@@ -0,0 +1,187 @@
+/*
+ *
+ * Copyright 2015, Google Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer
+ * in the documentation and/or other materials provided with the
+ * distribution.
+ *     * Neither the name of Google Inc. nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/*
+   Message compression benchmark.
+
+   Compresses and decompresses COMPRESSABLE (zero filled, as the qps and
+   interop payloads are) and UNCOMPRESSABLE (random) payloads of several sizes
+   with every compression algorithm, and reports the compression ratio and the
+   throughput. Each run compresses with a codec reused across messages, the
+   way the compression filter does for the messages of a call, with the
+   one-shot grpc_msg_compress API (which reuses pooled codecs), and with a new
+   codec for every message, which shows what setting up zlib streams costs.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "src/core/compression/message_compress.h"
+#include <grpc/support/cmdline.h>
+#include <grpc/support/log.h>
+#include <grpc/support/slice_buffer.h>
+#include <grpc/support/time.h>
+#include <grpc/support/useful.h>
+
+typedef enum { COMPRESSABLE, UNCOMPRESSABLE } payload_type;
+
+static const char *payload_type_name(payload_type type) {
+  return type == COMPRESSABLE ? "COMPRESSABLE" : "UNCOMPRESSABLE";
+}
+
+static gpr_slice create_payload(payload_type type, size_t size) {
+  gpr_slice payload = gpr_slice_malloc(size);
+  size_t i;
+  if (type == COMPRESSABLE) {
+    memset(GPR_SLICE_START_PTR(payload), 0, size);
+  } else {
+    for (i = 0; i < size; i++) {
+      GPR_SLICE_START_PTR(payload)[i] = (gpr_uint8)rand();
+    }
+  }
+  return payload;
+}
+
+static double seconds_since(gpr_timespec start) {
+  return gpr_timespec_to_micros(gpr_time_sub(gpr_now(), start)) / 1e6;
+}
+
+static void run_benchmark(grpc_compression_algorithm algorithm, int level,
+                          payload_type type, size_t size, size_t megabytes) {
+  gpr_slice payload = create_payload(type, size);
+  size_t iterations = ((megabytes << 20) + size - 1) / size;
+  grpc_msg_codec *compressor =
+      grpc_msg_codec_create_with_level(algorithm, level);
+  grpc_msg_codec *codec;
+  grpc_msg_codec *decompressor = grpc_msg_codec_create(algorithm);
+  gpr_slice_buffer input;
+  gpr_slice_buffer compressed;
+  gpr_slice_buffer decompressed;
+  gpr_timespec start;
+  double compress_secs;
+  double oneshot_secs;
+  double fresh_secs;
+  double decompress_secs;
+  double ratio;
+  int was_compressed = 0;
+  size_t i;
+
+  gpr_slice_buffer_init(&input);
+  gpr_slice_buffer_init(&compressed);
+  gpr_slice_buffer_init(&decompressed);
+  gpr_slice_buffer_add(&input, payload);
+
+  start = gpr_now();
+  for (i = 0; i < iterations; i++) {
+    gpr_slice_buffer_reset_and_unref(&compressed);
+    was_compressed = grpc_msg_codec_compress(compressor, &input, &compressed);
+  }
+  compress_secs = seconds_since(start);
+  ratio = (double)size / (double)compressed.length;
+
+  /* messages that do not compress are sent as is and never decompressed */
+  start = gpr_now();
+  for (i = 0; was_compressed && i < iterations; i++) {
+    gpr_slice_buffer_reset_and_unref(&decompressed);
+    GPR_ASSERT(
+        grpc_msg_codec_decompress(decompressor, &compressed, &decompressed));
+  }
+  decompress_secs = seconds_since(start);
+
+  start = gpr_now();
+  for (i = 0; i < iterations; i++) {
+    gpr_slice_buffer_reset_and_unref(&compressed);
+    grpc_msg_compress(algorithm, &input, &compressed);
+  }
+  oneshot_secs = seconds_since(start);
+
+  start = gpr_now();
+  for (i = 0; i < iterations; i++) {
+    gpr_slice_buffer_reset_and_unref(&compressed);
+    codec = grpc_msg_codec_create_with_level(algorithm, level);
+    grpc_msg_codec_compress(codec, &input, &compressed);
+    grpc_msg_codec_destroy(codec);
+  }
+  fresh_secs = seconds_since(start);
+
+  gpr_log(GPR_INFO,
+          "%-8s %-14s %7d bytes: ratio %7.2f, compress %8.1f MB/s "
+          "(one-shot %8.1f MB/s, new codec %8.1f MB/s), "
+          "decompress %8.1f MB/s",
+          grpc_compression_algorithm_name(algorithm), payload_type_name(type),
+          (int)size, ratio, iterations * size / compress_secs / 1e6,
+          iterations * size / oneshot_secs / 1e6,
+          iterations * size / fresh_secs / 1e6,
+          was_compressed ? iterations * size / decompress_secs / 1e6 : 0.0);
+
+  gpr_slice_buffer_destroy(&input);
+  gpr_slice_buffer_destroy(&compressed);
+  gpr_slice_buffer_destroy(&decompressed);
+  grpc_msg_codec_destroy(compressor);
+  grpc_msg_codec_destroy(decompressor);
+}
+
+int main(int argc, char **argv) {
+  static const size_t sizes[] = {64, 1024, 16384, 262144};
+  int megabytes = 64;
+  int level = GRPC_MSG_COMPRESS_LEVEL_DEFAULT;
+  int type;
+  size_t i;
+  int algorithm;
+  gpr_cmdline *cmdline =
+      gpr_cmdline_create("message_compress_benchmark throughput tool");
+
+  gpr_cmdline_add_int(cmdline, "megabytes",
+                      "Megabytes to compress per algorithm, payload type and "
+                      "message size",
+                      &megabytes);
+  gpr_cmdline_add_int(cmdline, "level",
+                      "Compression level, from 1 (fastest) to 9 (smallest); "
+                      "-1 for the default",
+                      &level);
+  gpr_cmdline_parse(cmdline, argc, argv);
+  GPR_ASSERT(megabytes > 0);
+
+  for (type = COMPRESSABLE; type <= UNCOMPRESSABLE; type++) {
+    for (i = 0; i < GPR_ARRAY_SIZE(sizes); i++) {
+      for (algorithm = 0; algorithm < GRPC_COMPRESS_ALGORITHMS_COUNT;
+           algorithm++) {
+        run_benchmark((grpc_compression_algorithm)algorithm, level,
+                      (payload_type)type, sizes[i], (size_t)megabytes);
+      }
+    }
+  }
+
+  gpr_cmdline_destroy(cmdline);
+  return 0;
+}
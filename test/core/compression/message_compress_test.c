@@ -38,6 +38,7 @@
 
 #include "test/core/util/test_config.h"
 #include "src/core/support/murmur_hash.h"
+#include <grpc/grpc.h>
 #include <grpc/support/log.h>
 #include <grpc/support/useful.h>
 #include "test/core/util/slice_splitter.h"
@@ -165,6 +166,162 @@ static void test_bad_data(void) {
   gpr_slice_buffer_destroy(&output);
 }
 
+/* Pushes a series of messages through the same pair of codecs: state kept
+   from one message must not leak into the next. */
+static void test_codec_reuse(grpc_compression_algorithm algorithm) {
+  grpc_msg_codec *compressor = grpc_msg_codec_create(algorithm);
+  grpc_msg_codec *decompressor = grpc_msg_codec_create(algorithm);
+  size_t i;
+  size_t j;
+
+  GPR_ASSERT(grpc_msg_codec_algorithm(compressor) == algorithm);
+  for (i = 0; i < 20; i++) {
+    gpr_slice_buffer input;
+    gpr_slice_buffer compressed;
+    gpr_slice_buffer output;
+    gpr_slice value = gpr_slice_malloc(100 + 997 * i);
+    gpr_slice final;
+    int was_compressed;
+    for (j = 0; j < GPR_SLICE_LENGTH(value); j++) {
+      /* repetitive, but different for every message */
+      GPR_SLICE_START_PTR(value)[j] = (gpr_uint8)((j % (7 + i)) * (i + 1));
+    }
+
+    gpr_slice_buffer_init(&input);
+    gpr_slice_buffer_init(&compressed);
+    gpr_slice_buffer_init(&output);
+    gpr_slice_buffer_add(&input, gpr_slice_ref(value));
+
+    was_compressed = grpc_msg_codec_compress(compressor, &input, &compressed);
+    GPR_ASSERT(was_compressed == (algorithm != GRPC_COMPRESS_NONE));
+    GPR_ASSERT(grpc_msg_codec_decompress(decompressor, &compressed, &output));
+    final = grpc_slice_merge(output.slices, output.count);
+    GPR_ASSERT(0 == gpr_slice_cmp(value, final));
+
+    gpr_slice_unref(final);
+    gpr_slice_unref(value);
+    gpr_slice_buffer_destroy(&input);
+    gpr_slice_buffer_destroy(&compressed);
+    gpr_slice_buffer_destroy(&output);
+  }
+
+  grpc_msg_codec_destroy(compressor);
+  grpc_msg_codec_destroy(decompressor);
+}
+
+static void test_levels(grpc_compression_algorithm algorithm) {
+  gpr_slice value = create_test_value(ONE_KB_A);
+  int level;
+
+  for (level = GRPC_MSG_COMPRESS_LEVEL_FASTEST;
+       level <= GRPC_MSG_COMPRESS_LEVEL_BEST; level++) {
+    grpc_msg_codec *compressor =
+        grpc_msg_codec_create_with_level(algorithm, level);
+    gpr_slice_buffer input;
+    gpr_slice_buffer compressed;
+    gpr_slice_buffer output;
+    gpr_slice final;
+
+    GPR_ASSERT(grpc_msg_codec_level(compressor) == level);
+    gpr_slice_buffer_init(&input);
+    gpr_slice_buffer_init(&compressed);
+    gpr_slice_buffer_init(&output);
+    gpr_slice_buffer_add(&input, gpr_slice_ref(value));
+
+    GPR_ASSERT(grpc_msg_codec_compress(compressor, &input, &compressed) ==
+               (algorithm != GRPC_COMPRESS_NONE));
+    GPR_ASSERT(grpc_msg_decompress(algorithm, &compressed, &output));
+    final = grpc_slice_merge(output.slices, output.count);
+    GPR_ASSERT(0 == gpr_slice_cmp(value, final));
+
+    gpr_slice_unref(final);
+    gpr_slice_buffer_destroy(&input);
+    gpr_slice_buffer_destroy(&compressed);
+    gpr_slice_buffer_destroy(&output);
+    grpc_msg_codec_destroy(compressor);
+  }
+
+  gpr_slice_unref(value);
+}
+
+/* A small compressed message expanding into a large one fails to decompress
+   past the limit, and leaves the output alone. */
+static void test_decompress_limit(grpc_compression_algorithm algorithm) {
+  grpc_msg_codec *compressor = grpc_msg_codec_create(algorithm);
+  grpc_msg_codec *decompressor = grpc_msg_codec_create(algorithm);
+  gpr_slice value = create_test_value(ONE_MB_A);
+  size_t length = GPR_SLICE_LENGTH(value);
+  gpr_slice_buffer input;
+  gpr_slice_buffer compressed;
+  gpr_slice_buffer output;
+
+  gpr_slice_buffer_init(&input);
+  gpr_slice_buffer_init(&compressed);
+  gpr_slice_buffer_init(&output);
+  gpr_slice_buffer_add(&input, value);
+  GPR_ASSERT(grpc_msg_codec_compress(compressor, &input, &compressed) ==
+             (algorithm != GRPC_COMPRESS_NONE));
+  if (algorithm != GRPC_COMPRESS_NONE) {
+    GPR_ASSERT(compressed.length < length / 100);
+  }
+
+  GPR_ASSERT(grpc_msg_codec_decompress_with_limit(decompressor, &compressed,
+                                                  &output, length - 1) ==
+             GRPC_MSG_DECOMPRESS_TOO_LARGE);
+  GPR_ASSERT(output.count == 0 && output.length == 0);
+  GPR_ASSERT(grpc_msg_codec_decompress_with_limit(decompressor, &compressed,
+                                                  &output, 1024) ==
+             GRPC_MSG_DECOMPRESS_TOO_LARGE);
+  GPR_ASSERT(output.count == 0 && output.length == 0);
+
+  /* the decompressor is still usable, and a limit of exactly the message
+     length is enough */
+  GPR_ASSERT(grpc_msg_codec_decompress_with_limit(decompressor, &compressed,
+                                                  &output, length) ==
+             GRPC_MSG_DECOMPRESS_OK);
+  GPR_ASSERT(output.length == length);
+
+  gpr_slice_buffer_destroy(&input);
+  gpr_slice_buffer_destroy(&compressed);
+  gpr_slice_buffer_destroy(&output);
+  grpc_msg_codec_destroy(compressor);
+  grpc_msg_codec_destroy(decompressor);
+}
+
+/* grpc_shutdown frees the pooled codecs, and one-shot calls keep working
+   after it. */
+static void test_pool_shutdown(void) {
+  int round;
+  grpc_init();
+  for (round = 0; round < 2; round++) {
+    gpr_slice value = create_test_value(ONE_KB_A);
+    gpr_slice_buffer input;
+    gpr_slice_buffer compressed;
+    gpr_slice_buffer output;
+
+    gpr_slice_buffer_init(&input);
+    gpr_slice_buffer_init(&compressed);
+    gpr_slice_buffer_init(&output);
+    gpr_slice_buffer_add(&input, value);
+    GPR_ASSERT(grpc_msg_compress(GRPC_COMPRESS_GZIP, &input, &compressed));
+    GPR_ASSERT(grpc_msg_decompress(GRPC_COMPRESS_GZIP, &compressed, &output));
+    GPR_ASSERT(output.length == GPR_SLICE_LENGTH(value));
+    gpr_slice_buffer_destroy(&input);
+    gpr_slice_buffer_destroy(&compressed);
+    gpr_slice_buffer_destroy(&output);
+
+    grpc_shutdown();
+    if (round == 0) grpc_init();
+  }
+}
+
+static void test_invalid_level(void) {
+  grpc_msg_codec *codec =
+      grpc_msg_codec_create_with_level(GRPC_COMPRESS_DEFLATE, 42);
+  GPR_ASSERT(grpc_msg_codec_level(codec) == GRPC_MSG_COMPRESS_LEVEL_DEFAULT);
+  grpc_msg_codec_destroy(codec);
+}
+
 int main(int argc, char **argv) {
   unsigned i, j, k, m;
   grpc_slice_split_mode uncompressed_split_modes[] = {
@@ -188,6 +345,13 @@ int main(int argc, char **argv) {
   }
 
   test_bad_data();
+  for (i = 0; i < GRPC_COMPRESS_ALGORITHMS_COUNT; i++) {
+    test_codec_reuse(i);
+    test_levels(i);
+    test_decompress_limit(i);
+  }
+  test_invalid_level();
+  test_pool_shutdown();
 
   return 0;
 }
@@ -39,9 +39,11 @@ import simplejson
 END2END_FIXTURES = {
     'chttp2_fake_security': True,
     'chttp2_fullstack': False,
+    'chttp2_fullstack_compression': False,
     'chttp2_fullstack_uds': False,
     'chttp2_simple_ssl_fullstack': True,
     'chttp2_simple_ssl_with_oauth2_fullstack': True,
+    'chttp2_simple_ssl_with_offload_fullstack': True,
     'chttp2_socket_pair': False,
     'chttp2_socket_pair_one_byte_at_a_time': False,
 }
@@ -55,6 +57,7 @@ END2END_TESTS = {
     'cancel_before_invoke': True,
     'cancel_in_a_vacuum': True,
     'census_simple_request': True,
+    'channel_connectivity': True,
     'disappearing_server': True,
     'early_server_shutdown_finishes_inflight_calls': True,
     'early_server_shutdown_finishes_tags': True,
@@ -0,0 +1,342 @@
+/*
+ *
+ * Copyright 2015, Google Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer
+ * in the documentation and/or other materials provided with the
+ * distribution.
+ *     * Neither the name of Google Inc. nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include "test/core/end2end/end2end_tests.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include <grpc/byte_buffer.h>
+#include <grpc/grpc.h>
+#include <grpc/support/alloc.h>
+#include <grpc/support/log.h>
+#include <grpc/support/time.h>
+#include <grpc/support/useful.h>
+#include "test/core/end2end/cq_verifier.h"
+
+static void *tag(gpr_intptr t) { return (void *)t; }
+
+static gpr_timespec n_seconds_time(int n) {
+  return GRPC_TIMEOUT_SECONDS_TO_DEADLINE(n);
+}
+
+static gpr_timespec five_seconds_time(void) { return n_seconds_time(5); }
+
+static gpr_timespec n_millis_time(int n) {
+  return gpr_time_add(gpr_now(), gpr_time_from_millis(n));
+}
+
+static void drain_cq(grpc_completion_queue *cq) {
+  grpc_event *ev;
+  grpc_completion_type type;
+  do {
+    ev = grpc_completion_queue_next(cq, five_seconds_time());
+    GPR_ASSERT(ev);
+    type = ev->type;
+    grpc_event_finish(ev);
+  } while (type != GRPC_QUEUE_SHUTDOWN);
+}
+
+/* wait on the client cq for the connectivity state to change from last;
+   returns 0 if deadline passes first */
+static int watch_state(grpc_end2end_test_fixture *f,
+                       grpc_connectivity_state last, gpr_timespec deadline) {
+  grpc_event *ev;
+  int changed;
+  grpc_channel_watch_connectivity_state(f->client, last, deadline,
+                                        f->client_cq, tag(1000));
+  /* the watch itself must complete by its deadline */
+  deadline = gpr_time_add(deadline, gpr_time_from_seconds(5));
+  ev = grpc_completion_queue_pluck(f->client_cq, tag(1000), deadline);
+  GPR_ASSERT(ev);
+  GPR_ASSERT(ev->type == GRPC_OP_COMPLETE);
+  changed = ev->data.op_complete == GRPC_OP_OK;
+  grpc_event_finish(ev);
+  return changed;
+}
+
+/* start connecting and watch the state until the channel is ready */
+static int wait_for_ready(grpc_end2end_test_fixture *f, gpr_timespec deadline) {
+  grpc_connectivity_state state;
+  while ((state = grpc_channel_check_connectivity_state(f->client, 1)) !=
+         GRPC_CHANNEL_READY) {
+    if (!watch_state(f, state, deadline)) return 0;
+  }
+  return 1;
+}
+
+static void shutdown_server(grpc_end2end_test_fixture *f) {
+  if (!f->server) return;
+  grpc_server_shutdown(f->server);
+  grpc_server_destroy(f->server);
+  f->server = NULL;
+}
+
+static void shutdown_client(grpc_end2end_test_fixture *f) {
+  if (!f->client) return;
+  grpc_channel_destroy(f->client);
+  f->client = NULL;
+}
+
+static void end_test(grpc_end2end_test_fixture *f) {
+  shutdown_server(f);
+  shutdown_client(f);
+
+  grpc_completion_queue_shutdown(f->server_cq);
+  drain_cq(f->server_cq);
+  grpc_completion_queue_destroy(f->server_cq);
+  grpc_completion_queue_shutdown(f->client_cq);
+  drain_cq(f->client_cq);
+  grpc_completion_queue_destroy(f->client_cq);
+}
+
+static void simple_request_body(grpc_end2end_test_fixture *f) {
+  grpc_call *c;
+  grpc_call *s;
+  gpr_timespec deadline = five_seconds_time();
+  cq_verifier *v_client = cq_verifier_create(f->client_cq);
+  cq_verifier *v_server = cq_verifier_create(f->server_cq);
+  grpc_op ops[6];
+  grpc_op *op;
+  grpc_metadata_array initial_metadata_recv;
+  grpc_metadata_array trailing_metadata_recv;
+  grpc_metadata_array request_metadata_recv;
+  grpc_call_details call_details;
+  grpc_status_code status;
+  char *details = NULL;
+  size_t details_capacity = 0;
+  int was_cancelled = 2;
+
+  c = grpc_channel_create_call(f->client, f->client_cq, "/foo",
+                               "foo.test.google.fr", deadline);
+  GPR_ASSERT(c);
+
+  grpc_metadata_array_init(&initial_metadata_recv);
+  grpc_metadata_array_init(&trailing_metadata_recv);
+  grpc_metadata_array_init(&request_metadata_recv);
+  grpc_call_details_init(&call_details);
+
+  op = ops;
+  op->op = GRPC_OP_SEND_INITIAL_METADATA;
+  op->data.send_initial_metadata.count = 0;
+  op++;
+  op->op = GRPC_OP_SEND_CLOSE_FROM_CLIENT;
+  op++;
+  op->op = GRPC_OP_RECV_INITIAL_METADATA;
+  op->data.recv_initial_metadata = &initial_metadata_recv;
+  op++;
+  op->op = GRPC_OP_RECV_STATUS_ON_CLIENT;
+  op->data.recv_status_on_client.trailing_metadata = &trailing_metadata_recv;
+  op->data.recv_status_on_client.status = &status;
+  op->data.recv_status_on_client.status_details = &details;
+  op->data.recv_status_on_client.status_details_capacity = &details_capacity;
+  op++;
+  GPR_ASSERT(GRPC_CALL_OK == grpc_call_start_batch(c, ops, op - ops, tag(1)));
+
+  GPR_ASSERT(GRPC_CALL_OK == grpc_server_request_call(f->server, &s,
+                                                      &call_details,
+                                                      &request_metadata_recv,
+                                                      f->server_cq, tag(101)));
+  cq_expect_completion(v_server, tag(101), GRPC_OP_OK);
+  cq_verify(v_server);
+
+  op = ops;
+  op->op = GRPC_OP_SEND_INITIAL_METADATA;
+  op->data.send_initial_metadata.count = 0;
+  op++;
+  op->op = GRPC_OP_SEND_STATUS_FROM_SERVER;
+  op->data.send_status_from_server.trailing_metadata_count = 0;
+  op->data.send_status_from_server.status = GRPC_STATUS_UNIMPLEMENTED;
+  op->data.send_status_from_server.status_details = "xyz";
+  op++;
+  op->op = GRPC_OP_RECV_CLOSE_ON_SERVER;
+  op->data.recv_close_on_server.cancelled = &was_cancelled;
+  op++;
+  GPR_ASSERT(GRPC_CALL_OK == grpc_call_start_batch(s, ops, op - ops, tag(102)));
+
+  cq_expect_completion(v_server, tag(102), GRPC_OP_OK);
+  cq_verify(v_server);
+
+  cq_expect_completion(v_client, tag(1), GRPC_OP_OK);
+  cq_verify(v_client);
+
+  GPR_ASSERT(status == GRPC_STATUS_UNIMPLEMENTED);
+  GPR_ASSERT(0 == strcmp(details, "xyz"));
+  GPR_ASSERT(0 == strcmp(call_details.method, "/foo"));
+  GPR_ASSERT(0 == strcmp(call_details.host, "foo.test.google.fr"));
+  GPR_ASSERT(was_cancelled == 0);
+
+  gpr_free(details);
+  grpc_metadata_array_destroy(&initial_metadata_recv);
+  grpc_metadata_array_destroy(&trailing_metadata_recv);
+  grpc_metadata_array_destroy(&request_metadata_recv);
+  grpc_call_details_destroy(&call_details);
+
+  grpc_call_destroy(c);
+  grpc_call_destroy(s);
+
+  cq_verifier_destroy(v_client);
+  cq_verifier_destroy(v_server);
+}
+
+/* Every kind of channel can be waited on, and reports ready once it is */
+static void test_wait_for_ready(grpc_end2end_test_config config) {
+  grpc_end2end_test_fixture f;
+
+  gpr_log(GPR_INFO, "%s/%s", __FUNCTION__, config.name);
+  f = config.create_fixture(NULL, NULL);
+  config.init_client(&f, NULL);
+  config.init_server(&f, NULL);
+
+  GPR_ASSERT(wait_for_ready(&f, five_seconds_time()));
+  GPR_ASSERT(grpc_channel_check_connectivity_state(f.client, 0) ==
+             GRPC_CHANNEL_READY);
+  simple_request_body(&f);
+
+  end_test(&f);
+  config.tear_down_data(&f);
+}
+
+/* A watch on a state that does not change completes with an error at its
+   deadline */
+static void test_watch_deadline(grpc_end2end_test_config config) {
+  grpc_end2end_test_fixture f;
+
+  gpr_log(GPR_INFO, "%s/%s", __FUNCTION__, config.name);
+  f = config.create_fixture(NULL, NULL);
+  config.init_client(&f, NULL);
+  config.init_server(&f, NULL);
+
+  GPR_ASSERT(wait_for_ready(&f, five_seconds_time()));
+  GPR_ASSERT(!watch_state(&f, GRPC_CHANNEL_READY, n_millis_time(200)));
+
+  end_test(&f);
+  config.tear_down_data(&f);
+}
+
+/* Destroying a client channel completes its pending watches */
+static void test_destroy_completes_watch(grpc_end2end_test_config config) {
+  grpc_end2end_test_fixture f;
+  grpc_event *ev;
+
+  gpr_log(GPR_INFO, "%s/%s", __FUNCTION__, config.name);
+  f = config.create_fixture(NULL, NULL);
+  config.init_client(&f, NULL);
+  config.init_server(&f, NULL);
+
+  GPR_ASSERT(wait_for_ready(&f, five_seconds_time()));
+  grpc_channel_watch_connectivity_state(f.client, GRPC_CHANNEL_READY,
+                                        n_seconds_time(30), f.client_cq,
+                                        tag(1001));
+  shutdown_client(&f);
+  ev = grpc_completion_queue_pluck(f.client_cq, tag(1001), five_seconds_time());
+  GPR_ASSERT(ev);
+  GPR_ASSERT(ev->type == GRPC_OP_COMPLETE);
+  GPR_ASSERT(ev->data.op_complete == GRPC_OP_OK);
+  grpc_event_finish(ev);
+
+  end_test(&f);
+  config.tear_down_data(&f);
+}
+
+/* A client channel only connects when asked to, reports failed attempts
+   while there is no server, and becomes ready once there is one */
+static void test_connect_before_first_call(grpc_end2end_test_config config) {
+  grpc_end2end_test_fixture f;
+
+  gpr_log(GPR_INFO, "%s/%s", __FUNCTION__, config.name);
+  f = config.create_fixture(NULL, NULL);
+  config.init_client(&f, NULL);
+
+  GPR_ASSERT(grpc_channel_check_connectivity_state(f.client, 0) ==
+             GRPC_CHANNEL_IDLE);
+  GPR_ASSERT(grpc_channel_check_connectivity_state(f.client, 0) ==
+             GRPC_CHANNEL_IDLE);
+  GPR_ASSERT(grpc_channel_check_connectivity_state(f.client, 1) ==
+             GRPC_CHANNEL_CONNECTING);
+
+  GPR_ASSERT(!wait_for_ready(&f, n_millis_time(500)));
+  GPR_ASSERT(grpc_channel_check_connectivity_state(f.client, 0) ==
+             GRPC_CHANNEL_TRANSIENT_FAILURE);
+
+  config.init_server(&f, NULL);
+  GPR_ASSERT(wait_for_ready(&f, five_seconds_time()));
+  GPR_ASSERT(grpc_channel_check_connectivity_state(f.client, 0) ==
+             GRPC_CHANNEL_READY);
+  simple_request_body(&f);
+
+  end_test(&f);
+  config.tear_down_data(&f);
+}
+
+/* With an idle timeout, an unused connection is closed and the channel goes
+   back to idle; the next call reconnects */
+static void test_idle_timeout(grpc_end2end_test_config config) {
+  grpc_end2end_test_fixture f;
+  grpc_arg arg;
+  grpc_channel_args client_args;
+  gpr_timespec deadline = five_seconds_time();
+
+  arg.type = GRPC_ARG_INTEGER;
+  arg.key = GRPC_ARG_CLIENT_IDLE_TIMEOUT_MS;
+  arg.value.integer = 200;
+  client_args.num_args = 1;
+  client_args.args = &arg;
+
+  gpr_log(GPR_INFO, "%s/%s", __FUNCTION__, config.name);
+  f = config.create_fixture(&client_args, NULL);
+  config.init_client(&f, &client_args);
+  config.init_server(&f, NULL);
+
+  GPR_ASSERT(wait_for_ready(&f, deadline));
+  GPR_ASSERT(watch_state(&f, GRPC_CHANNEL_READY, deadline));
+  GPR_ASSERT(grpc_channel_check_connectivity_state(f.client, 0) ==
+             GRPC_CHANNEL_IDLE);
+
+  simple_request_body(&f);
+  GPR_ASSERT(grpc_channel_check_connectivity_state(f.client, 0) ==
+             GRPC_CHANNEL_READY);
+
+  end_test(&f);
+  config.tear_down_data(&f);
+}
+
+void grpc_end2end_tests(grpc_end2end_test_config config) {
+  test_wait_for_ready(config);
+  test_watch_deadline(config);
+  if (config.feature_mask & FEATURE_MASK_SUPPORTS_DELAYED_CONNECTION) {
+    test_connect_before_first_call(config);
+    test_destroy_completes_watch(config);
+    test_idle_timeout(config);
+  }
+}
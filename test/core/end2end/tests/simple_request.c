@@ -37,7 +37,9 @@
 #include <string.h>
 #include <unistd.h>
 
+#include "src/core/channel/client_channel.h"
 #include "src/core/support/string.h"
+#include "src/core/surface/channel.h"
 #include <grpc/byte_buffer.h>
 #include <grpc/grpc.h>
 #include <grpc/support/alloc.h>
@@ -213,7 +215,85 @@ static void test_invoke_10_simple_requests(grpc_end2end_test_config config) {
   config.tear_down_data(&f);
 }
 
+#define POOL_SIZE 3
+
+/* number of connections in the client channel's pool (filling calls with the
+   calls started on each), or -1 if the fixture's client has no pool */
+static int get_calls_per_connection(grpc_end2end_test_fixture f,
+                                    gpr_uint32 *calls) {
+  grpc_channel_stack *stack = grpc_channel_get_channel_stack(f.client);
+  if (grpc_channel_stack_last_element(stack)->filter !=
+      &grpc_client_channel_filter) {
+    return -1;
+  }
+  return (int)grpc_client_channel_get_calls_per_connection(stack, calls,
+                                                           POOL_SIZE);
+}
+
+static void test_invoke_10_simple_requests_on_subchannel_pool(
+    grpc_end2end_test_config config, const char *lb_policy) {
+  int i;
+  int connections;
+  int used;
+  gpr_uint32 calls[POOL_SIZE];
+  gpr_uint32 calls_before[POOL_SIZE];
+  gpr_timespec deadline;
+  grpc_end2end_test_fixture f;
+  grpc_arg client_arg_values[2];
+  grpc_channel_args client_args;
+
+  client_arg_values[0].type = GRPC_ARG_INTEGER;
+  client_arg_values[0].key = GRPC_ARG_MAX_SUBCHANNELS;
+  client_arg_values[0].value.integer = POOL_SIZE;
+  client_arg_values[1].type = GRPC_ARG_STRING;
+  client_arg_values[1].key = GRPC_ARG_LB_POLICY;
+  client_arg_values[1].value.string = (char *)lb_policy;
+  client_args.num_args = 2;
+  client_args.args = client_arg_values;
+
+  f = begin_test(config, lb_policy, &client_args, NULL);
+  /* the first call connects the channel, after which the rest of the pool
+     connects in the background */
+  simple_request_body(f);
+  deadline = n_seconds_time(10);
+  while ((connections = get_calls_per_connection(f, calls)) >= 0 &&
+         connections < POOL_SIZE) {
+    GPR_ASSERT(gpr_time_cmp(gpr_now(), deadline) < 0);
+    gpr_sleep_until(gpr_time_add(gpr_now(), gpr_time_from_millis(10)));
+  }
+  if (connections >= 0) {
+    GPR_ASSERT(connections == POOL_SIZE);
+    memcpy(calls_before, calls, sizeof(calls));
+  }
+
+  for (i = 0; i < 10; i++) {
+    simple_request_body(f);
+    gpr_log(GPR_INFO, "Passed simple request %d", i);
+  }
+
+  if (connections >= 0) {
+    GPR_ASSERT(get_calls_per_connection(f, calls) == POOL_SIZE);
+    used = 0;
+    for (i = 0; i < POOL_SIZE; i++) {
+      if (calls[i] != calls_before[i]) used++;
+      /* round robin hands every connection its turn in order */
+      if (0 == strcmp(lb_policy, GRPC_LB_POLICY_ROUND_ROBIN)) {
+        GPR_ASSERT(calls[i] - calls_before[i] >= 10 / POOL_SIZE);
+      }
+    }
+    /* least outstanding rotates between idle connections, though one still
+       tearing down a finished call may be skipped */
+    GPR_ASSERT(used > 1);
+  }
+  end_test(&f);
+  config.tear_down_data(&f);
+}
+
 void grpc_end2end_tests(grpc_end2end_test_config config) {
   test_invoke_simple_request(config);
   test_invoke_10_simple_requests(config);
+  test_invoke_10_simple_requests_on_subchannel_pool(config,
+                                                     GRPC_LB_POLICY_ROUND_ROBIN);
+  test_invoke_10_simple_requests_on_subchannel_pool(
+      config, GRPC_LB_POLICY_LEAST_OUTSTANDING);
 }
@@ -0,0 +1,180 @@
+/*
+ *
+ * Copyright 2015, Google Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer
+ * in the documentation and/or other materials provided with the
+ * distribution.
+ *     * Neither the name of Google Inc. nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+
+/*
+   Alarm list benchmark.
+
+   Every thread keeps a window of pending alarms, due tens of seconds out as
+   call deadlines are: it adds an alarm and cancels the oldest pending one,
+   over and over, while another thread checks for expired alarms every
+   millisecond as the pollers do. Reports the add+cancel throughput of each
+   alarm list backend for a growing number of threads.
+ */
+
+#include <stdio.h>
+
+#include "src/core/iomgr/alarm.h"
+#include "src/core/iomgr/alarm_internal.h"
+#include <grpc/support/alloc.h>
+#include <grpc/support/cmdline.h>
+#include <grpc/support/log.h>
+#include <grpc/support/sync.h>
+#include <grpc/support/thd.h>
+#include <grpc/support/time.h>
+
+typedef struct {
+  gpr_mu mu;
+  gpr_cv done;
+  gpr_event checker_done;
+  int threads_running;
+  int iterations;
+  int pending;
+  gpr_timespec start;
+} benchmark_state;
+
+void grpc_kick_poller(void) {}
+void grpc_iomgr_refresh_cached_now(void) {}
+
+static void count_cancelled(void *arg, int success) {
+  GPR_ASSERT(!success);
+  ++*(int *)arg;
+}
+
+static void add_cancel_thread(void *arg) {
+  benchmark_state *state = arg;
+  grpc_alarm *alarms = gpr_malloc(sizeof(grpc_alarm) * state->pending);
+  int cancelled = 0;
+  int i;
+
+  for (i = 0; i < state->iterations + state->pending; i++) {
+    grpc_alarm *alarm = &alarms[i % state->pending];
+    if (i >= state->pending) {
+      grpc_alarm_cancel(alarm);
+    }
+    if (i < state->iterations) {
+      grpc_alarm_init(alarm,
+                      gpr_time_add(state->start,
+                                   gpr_time_from_millis(10000 + i % 9000)),
+                      count_cancelled, &cancelled, state->start);
+    }
+  }
+  GPR_ASSERT(cancelled == state->iterations);
+  gpr_free(alarms);
+
+  gpr_mu_lock(&state->mu);
+  if (--state->threads_running == 0) {
+    gpr_cv_signal(&state->done);
+  }
+  gpr_mu_unlock(&state->mu);
+}
+
+static void check_thread(void *arg) {
+  benchmark_state *state = arg;
+  gpr_mu_lock(&state->mu);
+  while (state->threads_running > 0) {
+    gpr_mu_unlock(&state->mu);
+    GPR_ASSERT(0 == grpc_alarm_check(NULL, gpr_now(), NULL));
+    gpr_sleep_until(gpr_time_add(gpr_now(), gpr_time_from_millis(1)));
+    gpr_mu_lock(&state->mu);
+  }
+  gpr_mu_unlock(&state->mu);
+  gpr_event_set(&state->checker_done, (void *)1);
+}
+
+static void run_benchmark(grpc_alarm_list_backend backend, int num_threads,
+                          int iterations, int pending) {
+  benchmark_state state;
+  gpr_timespec start_time;
+  double elapsed_micro;
+  double nops = (double)num_threads * iterations;
+  gpr_thd_id id;
+  int i;
+
+  gpr_mu_init(&state.mu);
+  gpr_cv_init(&state.done);
+  gpr_event_init(&state.checker_done);
+  state.threads_running = num_threads;
+  state.iterations = iterations;
+  state.pending = pending;
+  state.start = gpr_now();
+  grpc_alarm_list_set_backend(backend);
+  grpc_alarm_list_init(state.start);
+
+  start_time = gpr_now();
+  for (i = 0; i < num_threads; i++) {
+    GPR_ASSERT(gpr_thd_new(&id, add_cancel_thread, &state, NULL));
+  }
+  GPR_ASSERT(gpr_thd_new(&id, check_thread, &state, NULL));
+  gpr_mu_lock(&state.mu);
+  while (state.threads_running > 0) {
+    gpr_cv_wait(&state.done, &state.mu, gpr_inf_future);
+  }
+  gpr_mu_unlock(&state.mu);
+  elapsed_micro = gpr_timespec_to_micros(gpr_time_sub(gpr_now(), start_time));
+  gpr_event_wait(&state.checker_done, gpr_inf_future);
+
+  grpc_alarm_list_shutdown();
+  gpr_cv_destroy(&state.done);
+  gpr_mu_destroy(&state.mu);
+
+  printf("%-5s  %2d threads  %8.3f Mops/s  %7.1f ns/op\n",
+         backend == GRPC_ALARM_LIST_WHEEL ? "wheel" : "heap", num_threads,
+         nops / elapsed_micro, 1000 * elapsed_micro / nops);
+}
+
+int main(int argc, char **argv) {
+  int max_threads = 8;
+  int iterations = 1000000;
+  int pending = 10000;
+  int num_threads;
+  gpr_cmdline *cmdline =
+      gpr_cmdline_create("alarm list add+cancel throughput tool");
+
+  gpr_cmdline_add_int(cmdline, "max_threads",
+                      "Largest number of threads to run with", &max_threads);
+  gpr_cmdline_add_int(cmdline, "iterations",
+                      "Alarms each thread adds and cancels", &iterations);
+  gpr_cmdline_add_int(cmdline, "pending",
+                      "Alarms each thread keeps pending", &pending);
+  gpr_cmdline_parse(cmdline, argc, argv);
+  GPR_ASSERT(max_threads > 0 && iterations > 0 && pending > 0);
+
+  for (num_threads = 1; num_threads <= max_threads; num_threads *= 2) {
+    run_benchmark(GRPC_ALARM_LIST_HEAP, num_threads, iterations, pending);
+    run_benchmark(GRPC_ALARM_LIST_WHEEL, num_threads, iterations, pending);
+  }
+
+  gpr_cmdline_destroy(cmdline);
+  return 0;
+}
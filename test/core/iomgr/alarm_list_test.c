@@ -37,6 +37,7 @@
 
 #include "src/core/iomgr/alarm_internal.h"
 #include <grpc/support/log.h>
+#include <grpc/support/useful.h>
 #include "test/core/util/test_config.h"
 
 #define MAX_CB 30
@@ -45,6 +46,7 @@ static int cb_called[MAX_CB][2];
 static int kicks;
 
 void grpc_kick_poller(void) { ++kicks; }
+void grpc_iomgr_refresh_cached_now(void) {}
 
 static void cb(void *arg, int success) {
   cb_called[(gpr_intptr)arg][success]++;
@@ -107,6 +109,53 @@ static void add_test(void) {
   grpc_alarm_list_shutdown();
 }
 
+/* Alarms far enough apart to be spread over several timing wheel levels. */
+static void far_deadlines_test(void) {
+  static const int deadline_ms[] = {70, 4100, 300000, 300001,
+                                     1500000000};
+  gpr_timespec start = gpr_now();
+  gpr_timespec next;
+  grpc_alarm alarms[GPR_ARRAY_SIZE(deadline_ms) + 1];
+  size_t i;
+
+  grpc_alarm_list_init(start);
+  memset(cb_called, 0, sizeof(cb_called));
+
+  for (i = 0; i < GPR_ARRAY_SIZE(deadline_ms); i++) {
+    grpc_alarm_init(&alarms[i],
+                    gpr_time_add(start, gpr_time_from_millis(deadline_ms[i])),
+                    cb, (void *)(gpr_intptr) i, start);
+  }
+  /* Only ever run by grpc_alarm_list_shutdown() */
+  grpc_alarm_init(&alarms[i],
+                  gpr_time_add(start, gpr_time_from_seconds(100000000)), cb,
+                  (void *)(gpr_intptr) i, start);
+
+  grpc_alarm_cancel(&alarms[3]);
+  GPR_ASSERT(1 == cb_called[3][0]);
+
+  for (i = 0; i < GPR_ARRAY_SIZE(deadline_ms); i++) {
+    gpr_timespec deadline =
+        gpr_time_add(start, gpr_time_from_millis(deadline_ms[i]));
+    if (i == 3) continue;
+    /* The reported next wakeup is never after the earliest deadline */
+    next = gpr_inf_future;
+    GPR_ASSERT(0 == grpc_alarm_check(
+                        NULL, gpr_time_sub(deadline, gpr_time_from_millis(1)),
+                        &next));
+    GPR_ASSERT(gpr_time_cmp(next, deadline) <= 0);
+    GPR_ASSERT(0 == cb_called[i][1]);
+    GPR_ASSERT(1 == grpc_alarm_check(
+                        NULL, gpr_time_add(deadline, gpr_time_from_millis(1)),
+                        NULL));
+    GPR_ASSERT(1 == cb_called[i][1]);
+  }
+
+  grpc_alarm_list_shutdown();
+  GPR_ASSERT(1 == cb_called[i][0]);
+  GPR_ASSERT(0 == cb_called[3][1]);
+}
+
 /* Cleaning up a list with pending alarms. */
 void destruction_test(void) {
   grpc_alarm alarms[5];
@@ -137,8 +186,16 @@ void destruction_test(void) {
 }
 
 int main(int argc, char **argv) {
+  static const grpc_alarm_list_backend backends[] = {GRPC_ALARM_LIST_HEAP,
+                                                     GRPC_ALARM_LIST_WHEEL};
+  size_t i;
   grpc_test_init(argc, argv);
-  add_test();
-  destruction_test();
+  for (i = 0; i < GPR_ARRAY_SIZE(backends); i++) {
+    gpr_log(GPR_INFO, "backend=%d", backends[i]);
+    grpc_alarm_list_set_backend(backends[i]);
+    add_test();
+    far_deadlines_test();
+    destruction_test();
+  }
   return 0;
 }
@@ -45,6 +45,9 @@
 #include <grpc/support/log.h>
 #include <grpc/support/sync.h>
 #include <grpc/support/time.h>
+#include "src/core/iomgr/alarm_internal.h"
+#include "src/core/iomgr/iomgr.h"
+#include "src/core/iomgr/iomgr_internal.h"
 #include "test/core/util/test_config.h"
 
 #define SUCCESS_NOT_SET (-1)
@@ -85,7 +88,7 @@ static void alarm_cb(void *arg /* alarm_arg */, int success) {
 }
 
 /* Test grpc_alarm add and cancel. */
-static void test_grpc_alarm(void) {
+static void test_grpc_alarm(grpc_alarm_list_backend backend) {
   grpc_alarm alarm;
   grpc_alarm alarm_to_cancel;
   /* Timeout on the alarm cond. var, so make big enough to absorb time
@@ -98,6 +101,8 @@ static void test_grpc_alarm(void) {
   alarm_arg arg2;
   void *fdone;
 
+  gpr_log(GPR_INFO, "test_grpc_alarm: backend=%d", backend);
+  grpc_alarm_list_set_backend(backend);
   grpc_iomgr_init();
 
   arg.counter = 0;
@@ -210,8 +215,92 @@ static void test_grpc_alarm(void) {
   grpc_iomgr_shutdown();
 }
 
+#define BLOCKING_CB_MILLIS 100
+
+typedef struct {
+  gpr_event started;
+  gpr_event release;
+} blocker_arg;
+
+/* Keeps the background callback executor busy, so that callbacks queued
+   meanwhile are left to the test thread. */
+static void blocker_cb(void *arg, int success) {
+  blocker_arg *b = arg;
+  gpr_event_set(&b->started, (void *)1);
+  GPR_ASSERT(gpr_event_wait(&b->release, GRPC_TIMEOUT_SECONDS_TO_DEADLINE(5)));
+}
+
+static void blocking_cb(void *arg, int success) {
+  gpr_sleep_until(GRPC_TIMEOUT_MILLIS_TO_DEADLINE(BLOCKING_CB_MILLIS));
+}
+
+static void read_now_cb(void *arg, int success) {
+  *(gpr_timespec *)arg = grpc_iomgr_now();
+}
+
+typedef struct {
+  int calls;
+  gpr_timespec seen_now;
+} block_then_read_now_arg;
+
+/* Expired alarms may run in any order: the first one to run blocks, the
+   second reads the time. */
+static void block_then_read_now_cb(void *arg, int success) {
+  block_then_read_now_arg *a = arg;
+  if (a->calls++ == 0) {
+    blocking_cb(NULL, success);
+  } else {
+    read_now_cb(&a->seen_now, success);
+  }
+}
+
+/* Checks that a callback run after one which blocked sees the time after
+   the blocking, not the time cached when the poller woke up. */
+static void test_cached_now_after_blocking_callback(void) {
+  blocker_arg blocker;
+  grpc_alarm alarm1;
+  grpc_alarm alarm2;
+  gpr_timespec cached_now;
+  gpr_timespec start;
+  gpr_timespec seen_now;
+  block_then_read_now_arg alarms_arg = {0, {0, 0}};
+  gpr_timespec *prev_cached_now;
+  gpr_timespec threshold = gpr_time_from_millis(BLOCKING_CB_MILLIS / 2);
+
+  grpc_iomgr_init();
+  gpr_event_init(&blocker.started);
+  gpr_event_init(&blocker.release);
+  grpc_iomgr_add_delayed_callback(blocker_cb, &blocker, 1);
+  GPR_ASSERT(
+      gpr_event_wait(&blocker.started, GRPC_TIMEOUT_SECONDS_TO_DEADLINE(5)));
+
+  /* delayed callbacks */
+  start = cached_now = gpr_now();
+  prev_cached_now = grpc_iomgr_set_cached_now(&cached_now);
+  grpc_iomgr_add_delayed_callback(blocking_cb, NULL, 1);
+  grpc_iomgr_add_delayed_callback(read_now_cb, &seen_now, 1);
+  GPR_ASSERT(2 == grpc_maybe_call_delayed_callbacks(NULL, 1));
+  GPR_ASSERT(gpr_time_cmp(gpr_time_sub(seen_now, start), threshold) > 0);
+
+  /* alarms */
+  start = cached_now = gpr_now();
+  grpc_alarm_init(&alarm1, gpr_time_sub(cached_now, gpr_time_from_millis(2)),
+                  block_then_read_now_cb, &alarms_arg, cached_now);
+  grpc_alarm_init(&alarm2, gpr_time_sub(cached_now, gpr_time_from_millis(1)),
+                  block_then_read_now_cb, &alarms_arg, cached_now);
+  GPR_ASSERT(2 == grpc_alarm_check(NULL, cached_now, NULL));
+  GPR_ASSERT(
+      gpr_time_cmp(gpr_time_sub(alarms_arg.seen_now, start), threshold) > 0);
+
+  grpc_iomgr_set_cached_now(prev_cached_now);
+  gpr_event_set(&blocker.release, (void *)1);
+  grpc_iomgr_shutdown();
+}
+
 int main(int argc, char **argv) {
   grpc_test_init(argc, argv);
-  test_grpc_alarm();
+  test_grpc_alarm(GRPC_ALARM_LIST_HEAP);
+  test_grpc_alarm(GRPC_ALARM_LIST_WHEEL);
+  test_cached_now_after_blocking_callback();
   return 0;
 }
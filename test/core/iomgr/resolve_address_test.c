@@ -33,6 +33,8 @@
 
 #include "src/core/iomgr/resolve_address.h"
 #include "src/core/iomgr/iomgr.h"
+#include <string.h>
+#include <grpc/support/alloc.h>
 #include <grpc/support/log.h>
 #include <grpc/support/sync.h>
 #include <grpc/support/time.h>
@@ -121,6 +123,126 @@ static void test_unparseable_hostports(void) {
   }
 }
 
+/* Stub resolver: names starting with "good" resolve to a single address,
+   everything else fails. Counts lookups, and holds each one until
+   g_stub_release is set. */
+static gpr_mu g_stub_mu;
+static int g_stub_lookups;
+static gpr_event g_stub_release;
+
+static grpc_resolved_addresses* stub_resolve(const char* name,
+                                             const char* default_port) {
+  grpc_resolved_addresses* addrs = NULL;
+  gpr_mu_lock(&g_stub_mu);
+  g_stub_lookups++;
+  gpr_mu_unlock(&g_stub_mu);
+  GPR_ASSERT(gpr_event_wait(&g_stub_release, test_deadline()));
+  if (0 == strncmp(name, "good", 4)) {
+    addrs = gpr_malloc(sizeof(grpc_resolved_addresses));
+    addrs->naddrs = 1;
+    addrs->addrs = gpr_malloc(sizeof(grpc_resolved_address));
+    memset(addrs->addrs, 0, sizeof(grpc_resolved_address));
+  }
+  return addrs;
+}
+
+static int stub_lookups(void) {
+  int n;
+  gpr_mu_lock(&g_stub_mu);
+  n = g_stub_lookups;
+  gpr_mu_unlock(&g_stub_mu);
+  return n;
+}
+
+static void begin_stub_test(gpr_timespec ttl, gpr_timespec negative_ttl) {
+  gpr_mu_init(&g_stub_mu);
+  g_stub_lookups = 0;
+  gpr_event_init(&g_stub_release);
+  grpc_resolve_address_flush_cache();
+  grpc_resolve_address_set_cache_ttl(ttl, negative_ttl);
+  grpc_resolve_address_set_blocking_resolver(stub_resolve);
+}
+
+static void end_stub_test(void) {
+  grpc_resolve_address_set_blocking_resolver(NULL);
+  grpc_resolve_address_set_cache_ttl(gpr_time_from_seconds(30),
+                                     gpr_time_from_seconds(2));
+  grpc_resolve_address_flush_cache();
+  gpr_mu_destroy(&g_stub_mu);
+}
+
+static void resolve_and_wait(const char* name, grpc_resolve_cb cb) {
+  gpr_event ev;
+  gpr_event_init(&ev);
+  grpc_resolve_address(name, "1", cb, &ev);
+  GPR_ASSERT(gpr_event_wait(&ev, test_deadline()));
+}
+
+static void test_cache_hit(void) {
+  begin_stub_test(gpr_time_from_seconds(100), gpr_time_from_seconds(100));
+  gpr_event_set(&g_stub_release, (void*)1);
+  resolve_and_wait("good.example.com", must_succeed);
+  resolve_and_wait("good.example.com", must_succeed);
+  GPR_ASSERT(stub_lookups() == 1);
+  /* a different default port is a different key */
+  {
+    gpr_event ev;
+    gpr_event_init(&ev);
+    grpc_resolve_address("good.example.com", "2", must_succeed, &ev);
+    GPR_ASSERT(gpr_event_wait(&ev, test_deadline()));
+  }
+  GPR_ASSERT(stub_lookups() == 2);
+  end_stub_test();
+}
+
+static void test_negative_cache(void) {
+  begin_stub_test(gpr_time_from_seconds(100), gpr_time_from_seconds(100));
+  gpr_event_set(&g_stub_release, (void*)1);
+  resolve_and_wait("bad.example.com", must_fail);
+  resolve_and_wait("bad.example.com", must_fail);
+  GPR_ASSERT(stub_lookups() == 1);
+  end_stub_test();
+}
+
+static void test_cache_disabled(void) {
+  begin_stub_test(gpr_time_0, gpr_time_0);
+  gpr_event_set(&g_stub_release, (void*)1);
+  resolve_and_wait("good.example.com", must_succeed);
+  resolve_and_wait("good.example.com", must_succeed);
+  resolve_and_wait("bad.example.com", must_fail);
+  resolve_and_wait("bad.example.com", must_fail);
+  GPR_ASSERT(stub_lookups() == 4);
+  end_stub_test();
+}
+
+static void test_cache_expiry(void) {
+  begin_stub_test(gpr_time_from_millis(100), gpr_time_from_millis(100));
+  gpr_event_set(&g_stub_release, (void*)1);
+  resolve_and_wait("good.example.com", must_succeed);
+  gpr_sleep_until(gpr_time_add(gpr_now(), gpr_time_from_millis(200)));
+  resolve_and_wait("good.example.com", must_succeed);
+  GPR_ASSERT(stub_lookups() == 2);
+  end_stub_test();
+}
+
+#define NUM_COALESCED_REQUESTS 10
+
+static void test_concurrent_requests_coalesce(void) {
+  gpr_event evs[NUM_COALESCED_REQUESTS];
+  int i;
+  begin_stub_test(gpr_time_0, gpr_time_0);
+  for (i = 0; i < NUM_COALESCED_REQUESTS; i++) {
+    gpr_event_init(&evs[i]);
+    grpc_resolve_address("good.example.com", "1", must_succeed, &evs[i]);
+  }
+  gpr_event_set(&g_stub_release, (void*)1);
+  for (i = 0; i < NUM_COALESCED_REQUESTS; i++) {
+    GPR_ASSERT(gpr_event_wait(&evs[i], test_deadline()));
+  }
+  GPR_ASSERT(stub_lookups() == 1);
+  end_stub_test();
+}
+
 int main(int argc, char** argv) {
   grpc_test_init(argc, argv);
   grpc_iomgr_init();
@@ -131,6 +253,11 @@ int main(int argc, char** argv) {
   test_ipv6_without_port();
   test_invalid_ip_addresses();
   test_unparseable_hostports();
+  test_cache_hit();
+  test_negative_cache();
+  test_cache_disabled();
+  test_cache_expiry();
+  test_concurrent_requests_coalesce();
   grpc_iomgr_shutdown();
   return 0;
 }
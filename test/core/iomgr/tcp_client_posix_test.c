@@ -41,6 +41,7 @@
 
 #include "src/core/iomgr/iomgr.h"
 #include "src/core/iomgr/socket_utils_posix.h"
+#include <grpc/support/alloc.h>
 #include <grpc/support/log.h>
 #include <grpc/support/time.h>
 #include "test/core/util/test_config.h"
@@ -168,6 +169,211 @@ void test_times_out(void) {
   }
 }
 
+/* create a listener that never accepts, with its listen queue full so that
+   connection attempts to it hang (as if to a blackholed address) */
+static int create_blackholed_server(struct sockaddr_in *addr,
+                                    socklen_t *addr_len, int *client_fd,
+                                    int num_client_fds) {
+  int svr_fd;
+  int i;
+  int r;
+
+  memset(addr, 0, sizeof(*addr));
+  addr->sin_family = AF_INET;
+  *addr_len = sizeof(*addr);
+  svr_fd = socket(AF_INET, SOCK_STREAM, 0);
+  GPR_ASSERT(svr_fd >= 0);
+  GPR_ASSERT(0 == bind(svr_fd, (struct sockaddr *)addr, *addr_len));
+  GPR_ASSERT(0 == listen(svr_fd, 1));
+  GPR_ASSERT(getsockname(svr_fd, (struct sockaddr *)addr, addr_len) == 0);
+
+  /* tie up the listen buffer */
+  for (i = 0; i < num_client_fds; ++i) {
+    client_fd[i] = socket(AF_INET, SOCK_STREAM, 0);
+    grpc_set_socket_nonblocking(client_fd[i], 1);
+    do {
+      r = connect(client_fd[i], (struct sockaddr *)addr, *addr_len);
+    } while (r == -1 && errno == EINTR);
+    GPR_ASSERT(r < 0);
+    GPR_ASSERT(errno == EWOULDBLOCK || errno == EINPROGRESS);
+  }
+  return svr_fd;
+}
+
+static grpc_resolved_addresses *make_addresses(struct sockaddr_in *addrs,
+                                               size_t naddrs) {
+  grpc_resolved_addresses *resolved =
+      gpr_malloc(sizeof(grpc_resolved_addresses));
+  size_t i;
+  resolved->naddrs = naddrs;
+  resolved->addrs = gpr_malloc(sizeof(grpc_resolved_address) * naddrs);
+  for (i = 0; i < naddrs; i++) {
+    memcpy(resolved->addrs[i].addr, &addrs[i], sizeof(addrs[i]));
+    resolved->addrs[i].len = sizeof(addrs[i]);
+  }
+  return resolved;
+}
+
+void test_connect_to_any_skips_blackholed_address(void) {
+  struct sockaddr_in addrs[2];
+  socklen_t addr_len;
+  int blackholed_fd;
+  int svr_fd;
+  int client_fd[NUM_CLIENT_CONNECTS];
+  int i;
+  int r;
+  gpr_event ev;
+
+  gpr_event_init(&ev);
+
+  blackholed_fd = create_blackholed_server(&addrs[0], &addr_len, client_fd,
+                                           NUM_CLIENT_CONNECTS);
+
+  /* and a good server */
+  memset(&addrs[1], 0, sizeof(addrs[1]));
+  addrs[1].sin_family = AF_INET;
+  addr_len = sizeof(addrs[1]);
+  svr_fd = socket(AF_INET, SOCK_STREAM, 0);
+  GPR_ASSERT(svr_fd >= 0);
+  GPR_ASSERT(0 == bind(svr_fd, (struct sockaddr *)&addrs[1], addr_len));
+  GPR_ASSERT(0 == listen(svr_fd, 1));
+  GPR_ASSERT(getsockname(svr_fd, (struct sockaddr *)&addrs[1], &addr_len) ==
+             0);
+
+  /* try the blackholed address first: the good one should be tried after the
+     stagger interval, long before the first attempt times out */
+  grpc_tcp_client_connect_to_any(
+      must_succeed, &ev, make_addresses(addrs, 2), 0, gpr_time_from_millis(100),
+      gpr_time_from_seconds(30), GRPC_TIMEOUT_SECONDS_TO_DEADLINE(30));
+
+  do {
+    addr_len = sizeof(addrs[1]);
+    r = accept(svr_fd, (struct sockaddr *)&addrs[1], &addr_len);
+  } while (r == -1 && errno == EINTR);
+  GPR_ASSERT(r >= 0);
+  close(r);
+
+  GPR_ASSERT(gpr_event_wait(&ev, test_deadline()));
+  close(svr_fd);
+  close(blackholed_fd);
+  for (i = 0; i < NUM_CLIENT_CONNECTS; ++i) {
+    close(client_fd[i]);
+  }
+}
+
+void test_connect_to_any_times_out(void) {
+  struct sockaddr_in addrs[2];
+  socklen_t addr_len;
+  int svr_fd[2];
+  int client_fd[2][NUM_CLIENT_CONNECTS];
+  int i;
+  int j;
+  gpr_event ev;
+
+  gpr_event_init(&ev);
+
+  for (i = 0; i < 2; i++) {
+    svr_fd[i] = create_blackholed_server(&addrs[i], &addr_len, client_fd[i],
+                                         NUM_CLIENT_CONNECTS);
+  }
+
+  grpc_tcp_client_connect_to_any(
+      must_fail, &ev, make_addresses(addrs, 2), 1, gpr_time_from_millis(100),
+      gpr_time_from_seconds(1), GRPC_TIMEOUT_SECONDS_TO_DEADLINE(30));
+  /* both attempts are in flight until their attempt timeouts expire */
+  GPR_ASSERT(!gpr_event_wait(&ev, GRPC_TIMEOUT_MILLIS_TO_DEADLINE(500)));
+  GPR_ASSERT(gpr_event_wait(&ev, test_deadline()));
+
+  for (i = 0; i < 2; i++) {
+    close(svr_fd[i]);
+    for (j = 0; j < NUM_CLIENT_CONNECTS; ++j) {
+      close(client_fd[i][j]);
+    }
+  }
+}
+
+void test_cancel_connect(void) {
+  struct sockaddr_in addr;
+  socklen_t addr_len;
+  int svr_fd;
+  int client_fd[NUM_CLIENT_CONNECTS];
+  int i;
+  grpc_tcp_client_connect_attempt *attempt;
+  gpr_event ev;
+
+  gpr_event_init(&ev);
+
+  svr_fd = create_blackholed_server(&addr, &addr_len, client_fd,
+                                    NUM_CLIENT_CONNECTS);
+
+  attempt = grpc_tcp_client_connect_with_handle(
+      must_fail, &ev, (struct sockaddr *)&addr, addr_len,
+      GRPC_TIMEOUT_SECONDS_TO_DEADLINE(30));
+  GPR_ASSERT(attempt != NULL);
+  GPR_ASSERT(!gpr_event_wait(&ev, GRPC_TIMEOUT_MILLIS_TO_DEADLINE(100)));
+  /* cancelling fails the attempt long before its deadline */
+  grpc_tcp_client_release_connect(attempt, 1);
+  GPR_ASSERT(gpr_event_wait(&ev, GRPC_TIMEOUT_SECONDS_TO_DEADLINE(1)));
+
+  close(svr_fd);
+  for (i = 0; i < NUM_CLIENT_CONNECTS; ++i) {
+    close(client_fd[i]);
+  }
+}
+
+void test_connect_to_any_cancels_losers(void) {
+  struct sockaddr_in addrs[2];
+  socklen_t addr_len;
+  int blackholed_fd;
+  int svr_fd;
+  int client_fd[NUM_CLIENT_CONNECTS];
+  int i;
+  int r;
+  gpr_event ev;
+  gpr_timespec start;
+
+  gpr_event_init(&ev);
+
+  blackholed_fd = create_blackholed_server(&addrs[0], &addr_len, client_fd,
+                                           NUM_CLIENT_CONNECTS);
+  memset(&addrs[1], 0, sizeof(addrs[1]));
+  addrs[1].sin_family = AF_INET;
+  addr_len = sizeof(addrs[1]);
+  svr_fd = socket(AF_INET, SOCK_STREAM, 0);
+  GPR_ASSERT(svr_fd >= 0);
+  GPR_ASSERT(0 == bind(svr_fd, (struct sockaddr *)&addrs[1], addr_len));
+  GPR_ASSERT(0 == listen(svr_fd, 1));
+  GPR_ASSERT(getsockname(svr_fd, (struct sockaddr *)&addrs[1], &addr_len) ==
+             0);
+
+  grpc_tcp_client_connect_to_any(
+      must_succeed, &ev, make_addresses(addrs, 2), 0, gpr_time_from_millis(100),
+      gpr_time_from_seconds(30), GRPC_TIMEOUT_SECONDS_TO_DEADLINE(30));
+
+  do {
+    addr_len = sizeof(addrs[1]);
+    r = accept(svr_fd, (struct sockaddr *)&addrs[1], &addr_len);
+  } while (r == -1 && errno == EINTR);
+  GPR_ASSERT(r >= 0);
+  close(r);
+  GPR_ASSERT(gpr_event_wait(&ev, test_deadline()));
+
+  /* the attempt on the blackholed address was cancelled when the good one
+     won, so iomgr shutdown has no socket left to wait for: without the
+     cancellation it would be held until the 30s attempt timeout */
+  start = gpr_now();
+  grpc_iomgr_shutdown();
+  GPR_ASSERT(gpr_time_cmp(gpr_time_sub(gpr_now(), start),
+                          gpr_time_from_seconds(2)) < 0);
+  grpc_iomgr_init();
+
+  close(svr_fd);
+  close(blackholed_fd);
+  for (i = 0; i < NUM_CLIENT_CONNECTS; ++i) {
+    close(client_fd[i]);
+  }
+}
+
 int main(int argc, char **argv) {
   grpc_test_init(argc, argv);
   grpc_iomgr_init();
@@ -175,6 +381,10 @@ int main(int argc, char **argv) {
   gpr_log(GPR_ERROR, "End of first test");
   test_fails();
   test_times_out();
+  test_connect_to_any_skips_blackholed_address();
+  test_connect_to_any_times_out();
+  test_cancel_connect();
+  test_connect_to_any_cancels_losers();
   grpc_iomgr_shutdown();
   return 0;
 }
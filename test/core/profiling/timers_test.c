@@ -32,12 +32,29 @@
  */
 
 #include "src/core/profiling/timers.h"
+#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include "src/core/support/env.h"
+#include "src/core/support/file.h"
+#include "src/core/support/string.h"
+#include <grpc/support/alloc.h>
+#include <grpc/support/log.h>
+#include <grpc/support/slice.h>
+#include <grpc/support/thd.h>
+#include <grpc/support/time.h>
 #include "test/core/util/test_config.h"
 
+#define STATE_0 GRPC_PTAG_OTHER_BASE
+#define STATE_1 (GRPC_PTAG_OTHER_BASE + 1)
+#define STATE_2 (GRPC_PTAG_OTHER_BASE + 2)
+#define LOG_EVENTS (GRPC_PTAG_OTHER_BASE + 3)
+#define TRACE_TEST (GRPC_PTAG_OTHER_BASE + 4)
+
 void test_log_events(int num_seqs) {
   int start = 0;
   int *state;
+  GRPC_TIMER_BEGIN(LOG_EVENTS, 0);
   state = calloc(num_seqs, sizeof(state[0]));
   while (start < num_seqs) {
     int i;
@@ -72,12 +89,167 @@ void test_log_events(int num_seqs) {
     }
   }
   free(state);
+  GRPC_TIMER_END(LOG_EVENTS, 0);
+}
+
+#ifdef GRPC_BASIC_PROFILER
+
+#define TRACE_RING_SIZE 64
+#define TRACE_PAIRS (8 * TRACE_RING_SIZE)
+#define TRACE_BURST (4 * TRACE_RING_SIZE)
+#define TRACE_THREADS 4
+#define TRACE_THREAD_MARKS (2 * TRACE_RING_SIZE)
+
+typedef struct {
+  size_t begins;
+  size_t ends;
+  size_t marks;
+  size_t dropped;
+} trace_counts;
+
+static void record_marks(void *ignored) {
+  int i;
+  for (i = 0; i < TRACE_THREAD_MARKS; i++) {
+    GRPC_TIMER_MARK(TRACE_TEST, i);
+  }
+}
+
+/* Checks the trace against the format documented in basic_timers.c, and
+   counts its records. */
+static void parse_trace(const char *path, trace_counts *counts) {
+  int success;
+  gpr_slice trace = gpr_load_file(path, 0, &success);
+  const char *p = (const char *)GPR_SLICE_START_PTR(trace);
+  const char *end = p + GPR_SLICE_LENGTH(trace);
+  gpr_uint32 num_files = 0;
+  double ticks_per_second;
+
+  GPR_ASSERT(success);
+  memset(counts, 0, sizeof(*counts));
+  GPR_ASSERT(end - p >= 16 && 0 == memcmp(p, "GRPCLAT1", 8));
+  memcpy(&ticks_per_second, p + 8, 8);
+  GPR_ASSERT(ticks_per_second > 0);
+  p += 16;
+  while (p != end) {
+    char type = *p++;
+    if (type == 'F') {
+      gpr_uint32 index;
+      gpr_uint16 length;
+      GPR_ASSERT(end - p >= 6);
+      memcpy(&index, p, 4);
+      memcpy(&length, p + 4, 2);
+      p += 6;
+      /* files are numbered in order of appearance */
+      GPR_ASSERT(index == num_files++);
+      GPR_ASSERT(end - p >= length);
+      GPR_ASSERT(length == strlen(__FILE__) &&
+                 0 == memcmp(p, __FILE__, length));
+      p += length;
+    } else if (type == 'D') {
+      gpr_uint32 count;
+      GPR_ASSERT(end - p >= 12);
+      memcpy(&count, p + 8, 4);
+      GPR_ASSERT(count > 0);
+      counts->dropped += count;
+      p += 12;
+    } else {
+      gpr_int32 tag;
+      gpr_uint32 file;
+      gpr_int32 line;
+      GPR_ASSERT(type == '{' || type == '}' || type == '.');
+      GPR_ASSERT(end - p >= 36);
+      memcpy(&tag, p + 24, 4);
+      memcpy(&file, p + 28, 4);
+      memcpy(&line, p + 32, 4);
+      GPR_ASSERT(tag == TRACE_TEST);
+      GPR_ASSERT(file < num_files);
+      GPR_ASSERT(line > 0);
+      p += 36;
+      if (type == '{') counts->begins++;
+      if (type == '}') counts->ends++;
+      if (type == '.') counts->marks++;
+    }
+  }
+  gpr_slice_unref(trace);
+}
+
+/* Records more events than fit in the buffers, from threads that come and
+   go, and checks that every event ends up in the trace or is reported as
+   dropped. */
+static void test_trace_file(void) {
+  char *path;
+  FILE *fp = gpr_tmpfile("timers_test", &path);
+  gpr_thd_options options = gpr_thd_options_default();
+  gpr_thd_id threads[TRACE_THREADS];
+  trace_counts counts;
+  size_t recorded;
+  char *analyzer_cmd;
+  int i;
+
+  GPR_ASSERT(fp != NULL);
+  fclose(fp);
+  gpr_setenv("GRPC_LATENCY_TRACE", path);
+  gpr_setenv("GRPC_LATENCY_TRACE_RING_SIZE", "60"); /* rounded up to 64 */
+  grpc_timers_global_init();
+
+  /* pause now and then, so that the buffer wraps around without overflowing */
+  for (i = 0; i < TRACE_PAIRS; i++) {
+    GRPC_TIMER_BEGIN(TRACE_TEST, i);
+    GRPC_TIMER_END(TRACE_TEST, i);
+    if (i % (TRACE_RING_SIZE / 8) == 0) {
+      gpr_sleep_until(gpr_time_add(gpr_now(), gpr_time_from_millis(1)));
+    }
+  }
+  /* more than a buffer without pausing: some events may be dropped */
+  for (i = 0; i < TRACE_BURST; i++) {
+    GRPC_TIMER_MARK(TRACE_TEST, i);
+  }
+  /* the buffers of exited threads are still flushed */
+  gpr_thd_options_set_joinable(&options);
+  for (i = 0; i < TRACE_THREADS; i++) {
+    GPR_ASSERT(gpr_thd_new(&threads[i], record_marks, NULL, &options));
+  }
+  for (i = 0; i < TRACE_THREADS; i++) {
+    gpr_thd_join(threads[i]);
+  }
+  grpc_timers_global_destroy();
+
+  parse_trace(path, &counts);
+  gpr_log(GPR_INFO, "%d begins, %d ends, %d marks, %d dropped",
+          (int)counts.begins, (int)counts.ends, (int)counts.marks,
+          (int)counts.dropped);
+  recorded = counts.begins + counts.ends + counts.marks;
+  GPR_ASSERT(recorded + counts.dropped ==
+             2 * TRACE_PAIRS + TRACE_BURST + TRACE_THREADS * TRACE_THREAD_MARKS);
+  GPR_ASSERT(counts.begins + counts.ends > TRACE_RING_SIZE);
+
+  /* the analyzer reads the trace (tests run from the repository root) */
+  fp = fopen("tools/profile_analyzer/profile_analyzer.py", "r");
+  if (fp == NULL) {
+    gpr_log(GPR_INFO, "profile_analyzer.py not found, not running it");
+  } else {
+    fclose(fp);
+    gpr_asprintf(&analyzer_cmd,
+                 "python tools/profile_analyzer/profile_analyzer.py "
+                 "--histograms %s",
+                 path);
+    GPR_ASSERT(system(analyzer_cmd) == 0);
+    gpr_free(analyzer_cmd);
+  }
+
+  remove(path);
+  gpr_free(path);
 }
 
+#endif /* GRPC_BASIC_PROFILER */
+
 int main(int argc, char **argv) {
   grpc_test_init(argc, argv);
   grpc_timers_global_init();
   test_log_events(1000000);
   grpc_timers_global_destroy();
+#ifdef GRPC_BASIC_PROFILER
+  test_trace_file();
+#endif
   return 0;
 }
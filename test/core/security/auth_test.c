@@ -0,0 +1,277 @@
+/*
+ *
+ * Copyright 2015, Google Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer
+ * in the documentation and/or other materials provided with the
+ * distribution.
+ *     * Neither the name of Google Inc. nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include "src/core/security/auth.h"
+
+#include <string.h>
+
+#include <grpc/support/alloc.h>
+#include <grpc/support/log.h>
+#include "src/core/security/credentials.h"
+#include "src/core/security/security_connector.h"
+#include "src/core/support/string.h"
+#include "test/core/util/test_config.h"
+
+#define LOG_TEST_NAME() gpr_log(GPR_INFO, "%s", __FUNCTION__)
+
+/* Credentials recording the service url they are asked metadata for, and
+   optionally holding on to the request until complete_request is called. */
+typedef struct {
+  grpc_credentials base;
+  grpc_mdctx *md_ctx;
+  int is_async;
+  const char *service_url;
+  char *service_url_copy;
+  grpc_credentials_metadata_cb cb;
+  void *user_data;
+} test_credentials;
+
+static void test_creds_destroy(grpc_credentials *creds) {
+  test_credentials *c = (test_credentials *)creds;
+  gpr_free(c->service_url_copy);
+  gpr_free(c);
+}
+
+static int test_creds_has_request_metadata(const grpc_credentials *creds) {
+  return 1;
+}
+
+static int test_creds_has_request_metadata_only(const grpc_credentials *creds) {
+  return 1;
+}
+
+static grpc_mdctx *test_creds_get_metadata_context(grpc_credentials *creds) {
+  return ((test_credentials *)creds)->md_ctx;
+}
+
+static void complete_request(test_credentials *c) {
+  grpc_mdelem *md =
+      grpc_mdelem_from_strings(c->md_ctx, "authorization", "Bearer token");
+  GPR_ASSERT(c->cb != NULL);
+  /* The url handed to the credentials is still valid. */
+  GPR_ASSERT(strcmp(c->service_url, c->service_url_copy) == 0);
+  c->cb(c->user_data, &md, 1, GRPC_CREDENTIALS_OK);
+  c->cb = NULL;
+  grpc_mdelem_unref(md);
+}
+
+static void test_creds_get_request_metadata(grpc_credentials *creds,
+                                            const char *service_url,
+                                            grpc_credentials_metadata_cb cb,
+                                            void *user_data) {
+  test_credentials *c = (test_credentials *)creds;
+  gpr_free(c->service_url_copy);
+  c->service_url = service_url;
+  c->service_url_copy = gpr_strdup(service_url);
+  c->cb = cb;
+  c->user_data = user_data;
+  if (!c->is_async) complete_request(c);
+}
+
+static grpc_credentials_vtable test_creds_vtable = {
+    test_creds_destroy, test_creds_has_request_metadata,
+    test_creds_has_request_metadata_only, test_creds_get_metadata_context,
+    test_creds_get_request_metadata, NULL};
+
+static test_credentials *test_creds_create(grpc_mdctx *md_ctx, int is_async) {
+  test_credentials *c = gpr_malloc(sizeof(test_credentials));
+  memset(c, 0, sizeof(test_credentials));
+  c->base.vtable = &test_creds_vtable;
+  c->base.type = "test";
+  gpr_ref_init(&c->base.refcount, 1);
+  c->md_ctx = md_ctx;
+  c->is_async = is_async;
+  return c;
+}
+
+/* Pass-through filter: the auth filter may be neither first nor last. */
+static void first_start_transport_op(grpc_call_element *elem,
+                                     grpc_transport_op *op) {
+  grpc_call_next_op(elem, op);
+}
+
+static void first_channel_op(grpc_channel_element *elem,
+                             grpc_channel_element *from_elem,
+                             grpc_channel_op *op) {
+  grpc_channel_next_op(elem, op);
+}
+
+/* Last filter: counts the ops reaching it and whether their metadata carries
+   the credentials. */
+typedef struct {
+  int ops;
+  int authorized;
+} last_call_data;
+
+static void last_start_transport_op(grpc_call_element *elem,
+                                    grpc_transport_op *op) {
+  last_call_data *calld = elem->call_data;
+  grpc_linked_mdelem *l;
+  calld->ops++;
+  GPR_ASSERT(op->send_ops != NULL && op->send_ops->nops == 1);
+  GPR_ASSERT(op->send_ops->ops[0].type == GRPC_OP_METADATA);
+  for (l = op->send_ops->ops[0].data.metadata.list.head; l != NULL;
+       l = l->next) {
+    if (strcmp(grpc_mdstr_as_c_string(l->md->key), "authorization") == 0) {
+      calld->authorized = 1;
+    }
+  }
+}
+
+static void last_channel_op(grpc_channel_element *elem,
+                            grpc_channel_element *from_elem,
+                            grpc_channel_op *op) {}
+
+static void init_call_elem(grpc_call_element *elem,
+                           const void *server_transport_data,
+                           grpc_transport_op *initial_op) {
+  memset(elem->call_data, 0, sizeof(last_call_data));
+}
+
+static void destroy_call_elem(grpc_call_element *elem) {}
+
+static void init_channel_elem(grpc_channel_element *elem,
+                              const grpc_channel_args *args,
+                              grpc_mdctx *metadata_context, int is_first,
+                              int is_last) {}
+
+static void destroy_channel_elem(grpc_channel_element *elem) {}
+
+static const grpc_channel_filter first_filter = {
+    first_start_transport_op, first_channel_op, 0, init_call_elem,
+    destroy_call_elem, 0, init_channel_elem, destroy_channel_elem,
+    "first"};
+
+static const grpc_channel_filter last_filter = {
+    last_start_transport_op, last_channel_op, sizeof(last_call_data),
+    init_call_elem, destroy_call_elem, 0, init_channel_elem,
+    destroy_channel_elem, "last"};
+
+/* Starts a call to method on host through the auth filter, and checks the
+   service url handed to the credentials. */
+static void run_call(int creds_are_async, const char *host, const char *method,
+                     const char *expected_service_url) {
+  const grpc_channel_filter *filters[] = {&first_filter,
+                                          &grpc_client_auth_filter,
+                                          &last_filter};
+  grpc_mdctx *md_ctx = grpc_mdctx_create();
+  test_credentials *creds = test_creds_create(md_ctx, creds_are_async);
+  grpc_channel_security_connector *sc =
+      grpc_fake_channel_security_connector_create(&creds->base, 0);
+  grpc_arg arg = grpc_security_connector_to_arg(&sc->base);
+  grpc_channel_args args;
+  grpc_channel_stack *channel_stack;
+  grpc_call_stack *call_stack;
+  grpc_call_element *first;
+  last_call_data *last;
+  grpc_stream_op_buffer sopb;
+  grpc_metadata_batch md;
+  grpc_linked_mdelem links[2];
+  grpc_transport_op op;
+
+  args.num_args = 1;
+  args.args = &arg;
+  channel_stack = gpr_malloc(grpc_channel_stack_size(filters, 3));
+  grpc_channel_stack_init(filters, 3, &args, md_ctx, channel_stack);
+  call_stack = gpr_malloc(channel_stack->call_stack_size);
+  grpc_call_stack_init(channel_stack, NULL, NULL, call_stack);
+  first = grpc_call_stack_element(call_stack, 0);
+  last = grpc_call_stack_element(call_stack, 2)->call_data;
+
+  grpc_metadata_batch_init(&md);
+  grpc_metadata_batch_add_tail(
+      &md, &links[0], grpc_mdelem_from_strings(md_ctx, ":authority", host));
+  grpc_metadata_batch_add_tail(
+      &md, &links[1], grpc_mdelem_from_strings(md_ctx, ":path", method));
+  grpc_sopb_init(&sopb);
+  grpc_sopb_add_metadata(&sopb, md);
+  memset(&op, 0, sizeof(op));
+  op.send_ops = &sopb;
+  first->filter->start_transport_op(first, &op);
+
+  GPR_ASSERT(creds->service_url != NULL);
+  GPR_ASSERT(strcmp(creds->service_url, expected_service_url) == 0);
+  if (creds_are_async) {
+    GPR_ASSERT(last->ops == 0);
+    complete_request(creds);
+  }
+  GPR_ASSERT(last->ops == 1);
+  GPR_ASSERT(last->authorized);
+
+  grpc_sopb_destroy(&sopb);
+  grpc_call_stack_destroy(call_stack);
+  gpr_free(call_stack);
+  grpc_channel_stack_destroy(channel_stack);
+  gpr_free(channel_stack);
+  grpc_security_connector_unref(&sc->base);
+  grpc_credentials_unref(&creds->base);
+  grpc_mdctx_unref(md_ctx);
+}
+
+static void test_service_url(void) {
+  LOG_TEST_NAME();
+  run_call(0, "foo.test.google.fr", "/grpc.testing.TestService/UnaryCall",
+           GRPC_FAKE_SECURITY_URL_SCHEME
+           "://foo.test.google.fr/grpc.testing.TestService");
+  run_call(0, "foo.test.google.fr:443", "/UnaryCall",
+           GRPC_FAKE_SECURITY_URL_SCHEME "://foo.test.google.fr:443/");
+}
+
+static void test_long_service_url(void) {
+  char host[300];
+  char *expected;
+  LOG_TEST_NAME();
+  memset(host, 'a', sizeof(host) - 1);
+  host[sizeof(host) - 1] = '\0';
+  gpr_asprintf(&expected, "%s://%s/foo.Bar", GRPC_FAKE_SECURITY_URL_SCHEME,
+               host);
+  run_call(0, host, "/foo.Bar/Baz", expected);
+  run_call(1, host, "/foo.Bar/Baz", expected);
+  gpr_free(expected);
+}
+
+/* The service url outlives asynchronous credentials requests. */
+static void test_async_credentials(void) {
+  LOG_TEST_NAME();
+  run_call(1, "foo.test.google.fr", "/grpc.testing.TestService/UnaryCall",
+           GRPC_FAKE_SECURITY_URL_SCHEME
+           "://foo.test.google.fr/grpc.testing.TestService");
+}
+
+int main(int argc, char **argv) {
+  grpc_test_init(argc, argv);
+  test_service_url();
+  test_long_service_url();
+  test_async_credentials();
+  return 0;
+}
@@ -96,6 +96,13 @@ static const char valid_oauth2_json_response[] =
     " \"expires_in\":3599, "
     " \"token_type\":\"Bearer\"}";
 
+/* Inside the proactive refresh window, but not yet due for a blocking
+   refresh. */
+static const char short_lived_oauth2_json_response[] =
+    "{\"access_token\":\"ya29.AHES6ZRN3-HlhAPya30GnW_bHSb_\","
+    " \"expires_in\":120, "
+    " \"token_type\":\"Bearer\"}";
+
 static const char test_user_data[] = "user data";
 
 static const char test_scope[] = "perm1 perm2";
@@ -479,6 +486,111 @@ static void test_compute_engine_creds_failure(void) {
   grpc_httpcli_set_override(NULL, NULL);
 }
 
+/* A metadata server stand-in that holds on to requests until
+   complete_deferred_fetch is called. */
+static int g_deferred_fetches;
+static grpc_httpcli_response_cb g_deferred_on_response;
+static void *g_deferred_user_data;
+static int g_metadata_callbacks;
+
+static int compute_engine_httpcli_get_deferred_override(
+    const grpc_httpcli_request *request, gpr_timespec deadline,
+    grpc_httpcli_response_cb on_response, void *user_data) {
+  validate_compute_engine_http_request(request);
+  g_deferred_fetches++;
+  g_deferred_on_response = on_response;
+  g_deferred_user_data = user_data;
+  return 1;
+}
+
+static int compute_engine_httpcli_get_short_lived_override(
+    const grpc_httpcli_request *request, gpr_timespec deadline,
+    grpc_httpcli_response_cb on_response, void *user_data) {
+  grpc_httpcli_response response =
+      http_response(200, short_lived_oauth2_json_response);
+  validate_compute_engine_http_request(request);
+  on_response(user_data, &response);
+  return 1;
+}
+
+static void complete_deferred_fetch(const char *body) {
+  grpc_httpcli_response response = http_response(200, body);
+  g_deferred_on_response(g_deferred_user_data, &response);
+}
+
+static void on_oauth2_creds_get_metadata_counted(
+    void *user_data, grpc_mdelem **md_elems, size_t num_md,
+    grpc_credentials_status status) {
+  on_oauth2_creds_get_metadata_success(user_data, md_elems, num_md, status);
+  g_metadata_callbacks++;
+}
+
+static void test_compute_engine_creds_coalesce_fetches(void) {
+  int i;
+  grpc_credentials *compute_engine_creds =
+      grpc_compute_engine_credentials_create();
+  g_deferred_fetches = 0;
+  g_metadata_callbacks = 0;
+
+  /* Concurrent requests with no token share a single fetch... */
+  grpc_httpcli_set_override(compute_engine_httpcli_get_deferred_override,
+                            httpcli_post_should_not_be_called);
+  for (i = 0; i < 10; i++) {
+    grpc_credentials_get_request_metadata(
+        compute_engine_creds, test_service_url,
+        on_oauth2_creds_get_metadata_counted, (void *)test_user_data);
+  }
+  GPR_ASSERT(g_deferred_fetches == 1);
+  GPR_ASSERT(g_metadata_callbacks == 0);
+
+  /* ...and are all released when it completes. */
+  complete_deferred_fetch(valid_oauth2_json_response);
+  GPR_ASSERT(g_metadata_callbacks == 10);
+
+  grpc_credentials_unref(compute_engine_creds);
+  grpc_httpcli_set_override(NULL, NULL);
+}
+
+static void test_compute_engine_creds_refresh_ahead_of_expiry(void) {
+  grpc_credentials *compute_engine_creds =
+      grpc_compute_engine_credentials_create();
+  g_deferred_fetches = 0;
+  g_metadata_callbacks = 0;
+
+  /* Get a token that will soon need refreshing. */
+  grpc_httpcli_set_override(compute_engine_httpcli_get_short_lived_override,
+                            httpcli_post_should_not_be_called);
+  grpc_credentials_get_request_metadata(compute_engine_creds, test_service_url,
+                                        on_oauth2_creds_get_metadata_counted,
+                                        (void *)test_user_data);
+  GPR_ASSERT(g_metadata_callbacks == 1);
+
+  /* Requests are still served straight from the cache, while a single new
+     token is fetched in the background. */
+  grpc_httpcli_set_override(compute_engine_httpcli_get_deferred_override,
+                            httpcli_post_should_not_be_called);
+  grpc_credentials_get_request_metadata(compute_engine_creds, test_service_url,
+                                        on_oauth2_creds_get_metadata_counted,
+                                        (void *)test_user_data);
+  grpc_credentials_get_request_metadata(compute_engine_creds, test_service_url,
+                                        on_oauth2_creds_get_metadata_counted,
+                                        (void *)test_user_data);
+  GPR_ASSERT(g_metadata_callbacks == 3);
+  GPR_ASSERT(g_deferred_fetches == 1);
+  complete_deferred_fetch(valid_oauth2_json_response);
+
+  /* The refreshed token is long lived: no more fetches. */
+  grpc_httpcli_set_override(httpcli_get_should_not_be_called,
+                            httpcli_post_should_not_be_called);
+  grpc_credentials_get_request_metadata(compute_engine_creds, test_service_url,
+                                        on_oauth2_creds_get_metadata_counted,
+                                        (void *)test_user_data);
+  GPR_ASSERT(g_metadata_callbacks == 4);
+
+  grpc_credentials_unref(compute_engine_creds);
+  grpc_httpcli_set_override(NULL, NULL);
+}
+
 static void validate_refresh_token_http_request(
     const grpc_httpcli_request *request, const char *body, size_t body_size) {
   /* The content of the assertion is tested extensively in json_token_test. */
@@ -605,6 +717,20 @@ static char *encode_and_sign_jwt_should_not_be_called(
   GPR_ASSERT("grpc_jwt_encode_and_sign should not be called" == NULL);
 }
 
+static int g_jwt_sign_count;
+static char *g_last_jwt_audience;
+
+static char *encode_and_sign_jwt_counting(const grpc_auth_json_key *json_key,
+                                          const char *audience,
+                                          gpr_timespec token_lifetime,
+                                          const char *scope) {
+  g_jwt_sign_count++;
+  gpr_free(g_last_jwt_audience);
+  g_last_jwt_audience = gpr_strdup(audience);
+  return encode_and_sign_jwt_success(json_key, audience, token_lifetime,
+                                     scope);
+}
+
 static void validate_service_account_http_request(
     const grpc_httpcli_request *request, const char *body, size_t body_size) {
   /* The content of the assertion is tested extensively in json_token_test. */
@@ -772,6 +898,65 @@ static void test_jwt_creds_success(void) {
                                         on_jwt_creds_get_metadata_success,
                                         (void *)test_user_data);
 
+  /* Fourth and fifth requests: both service urls are now cached. */
+  grpc_jwt_encode_and_sign_set_override(
+      encode_and_sign_jwt_should_not_be_called);
+  grpc_credentials_get_request_metadata(jwt_creds, test_service_url,
+                                        on_jwt_creds_get_metadata_success,
+                                        (void *)test_user_data);
+  grpc_credentials_get_request_metadata(jwt_creds, other_test_service_url,
+                                        on_jwt_creds_get_metadata_success,
+                                        (void *)test_user_data);
+
+  gpr_free(json_key_string);
+  grpc_credentials_unref(jwt_creds);
+  grpc_jwt_encode_and_sign_set_override(NULL);
+}
+
+static void jwt_creds_get_metadata_for_url_index(grpc_credentials *jwt_creds,
+                                                 size_t index) {
+  char *service_url;
+  gpr_asprintf(&service_url, "https://foo%d.com/foo.v1", (int)index);
+  grpc_credentials_get_request_metadata(jwt_creds, service_url,
+                                        on_jwt_creds_get_metadata_success,
+                                        (void *)test_user_data);
+  gpr_free(service_url);
+}
+
+static void test_jwt_creds_cache_eviction(void) {
+  char *json_key_string = test_json_key_str();
+  grpc_credentials *jwt_creds = grpc_jwt_credentials_create(
+      json_key_string, grpc_max_auth_token_lifetime);
+  size_t i;
+
+  grpc_jwt_encode_and_sign_set_override(encode_and_sign_jwt_counting);
+  g_jwt_sign_count = 0;
+
+  /* Fill the cache, then add one more url: the oldest jwt (url 0) is
+     evicted. */
+  for (i = 0; i <= GRPC_JWT_CACHE_SIZE; i++) {
+    jwt_creds_get_metadata_for_url_index(jwt_creds, i);
+  }
+  GPR_ASSERT(g_jwt_sign_count == GRPC_JWT_CACHE_SIZE + 1);
+
+  /* Every other url is still cached. */
+  for (i = 1; i <= GRPC_JWT_CACHE_SIZE; i++) {
+    jwt_creds_get_metadata_for_url_index(jwt_creds, i);
+  }
+  GPR_ASSERT(g_jwt_sign_count == GRPC_JWT_CACHE_SIZE + 1);
+
+  /* Url 0 is signed again, evicting url 1 which now expires first. */
+  jwt_creds_get_metadata_for_url_index(jwt_creds, 0);
+  GPR_ASSERT(g_jwt_sign_count == GRPC_JWT_CACHE_SIZE + 2);
+  GPR_ASSERT(strcmp(g_last_jwt_audience, "https://foo0.com/foo.v1") == 0);
+  jwt_creds_get_metadata_for_url_index(jwt_creds, 2);
+  GPR_ASSERT(g_jwt_sign_count == GRPC_JWT_CACHE_SIZE + 2);
+  jwt_creds_get_metadata_for_url_index(jwt_creds, 1);
+  GPR_ASSERT(g_jwt_sign_count == GRPC_JWT_CACHE_SIZE + 3);
+  GPR_ASSERT(strcmp(g_last_jwt_audience, "https://foo1.com/foo.v1") == 0);
+
+  gpr_free(g_last_jwt_audience);
+  g_last_jwt_audience = NULL;
   gpr_free(json_key_string);
   grpc_credentials_unref(jwt_creds);
   grpc_jwt_encode_and_sign_set_override(NULL);
@@ -808,12 +993,15 @@ int main(int argc, char **argv) {
   test_ssl_oauth2_iam_composite_creds();
   test_compute_engine_creds_success();
   test_compute_engine_creds_failure();
+  test_compute_engine_creds_coalesce_fetches();
+  test_compute_engine_creds_refresh_ahead_of_expiry();
   test_refresh_token_creds_success();
   test_refresh_token_creds_failure();
   test_service_account_creds_success();
   test_service_account_creds_http_failure();
   test_service_account_creds_signing_failure();
   test_jwt_creds_success();
+  test_jwt_creds_cache_eviction();
   test_jwt_creds_signing_failure();
   return 0;
 }
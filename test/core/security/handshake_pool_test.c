@@ -0,0 +1,140 @@
+/*
+ *
+ * Copyright 2015, Google Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer
+ * in the documentation and/or other materials provided with the
+ * distribution.
+ *     * Neither the name of Google Inc. nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include "src/core/security/handshake_pool.h"
+
+#include <grpc/grpc.h>
+#include <grpc/grpc_security.h>
+#include <grpc/support/log.h>
+#include <grpc/support/sync.h>
+#include "test/core/util/test_config.h"
+
+#define STARTED ((void *)1)
+#define FAILED ((void *)2)
+
+static void on_start(void *arg, int success) {
+  gpr_event_set(arg, success ? STARTED : FAILED);
+}
+
+static void *wait_for_start(gpr_event *ev) {
+  return gpr_event_wait(ev, GRPC_TIMEOUT_SECONDS_TO_DEADLINE(5));
+}
+
+static void check_stats(size_t in_progress, size_t waiting,
+                        gpr_uint64 rejected) {
+  grpc_handshake_offload_stats stats;
+  grpc_get_handshake_offload_stats(&stats);
+  GPR_ASSERT(stats.handshakes_in_progress == in_progress);
+  GPR_ASSERT(stats.handshakes_waiting == waiting);
+  GPR_ASSERT(stats.handshakes_rejected == rejected);
+}
+
+/* Server handshakes past the concurrency limit wait, but only so many of them
+   and for so long */
+static void test_queue_limits(void) {
+  gpr_event ev[5];
+  int i;
+
+  gpr_log(GPR_INFO, "test_queue_limits");
+  for (i = 0; i < 5; i++) gpr_event_init(&ev[i]);
+  grpc_init();
+  grpc_set_handshake_offload_limits(1, 1);
+  grpc_set_handshake_offload_queue_limits(2, gpr_time_from_millis(200));
+
+  grpc_handshake_pool_begin(0, on_start, &ev[0]);
+  GPR_ASSERT(gpr_event_get(&ev[0]) == STARTED);
+  /* client handshakes are never held back */
+  grpc_handshake_pool_begin(1, on_start, &ev[1]);
+  GPR_ASSERT(gpr_event_get(&ev[1]) == STARTED);
+  grpc_handshake_pool_end(1, gpr_now(), 1);
+
+  grpc_handshake_pool_begin(0, on_start, &ev[2]);
+  grpc_handshake_pool_begin(0, on_start, &ev[3]);
+  GPR_ASSERT(gpr_event_get(&ev[2]) == NULL);
+  GPR_ASSERT(gpr_event_get(&ev[3]) == NULL);
+  /* the queue is full */
+  grpc_handshake_pool_begin(0, on_start, &ev[4]);
+  GPR_ASSERT(gpr_event_get(&ev[4]) == FAILED);
+  check_stats(1, 2, 1);
+
+  /* the waiting handshakes time out */
+  GPR_ASSERT(wait_for_start(&ev[2]) == FAILED);
+  GPR_ASSERT(wait_for_start(&ev[3]) == FAILED);
+  check_stats(1, 0, 3);
+
+  /* a waiting handshake starts when the running one ends */
+  gpr_event_init(&ev[2]);
+  grpc_handshake_pool_begin(0, on_start, &ev[2]);
+  GPR_ASSERT(gpr_event_get(&ev[2]) == NULL);
+  grpc_handshake_pool_end(0, gpr_now(), 1);
+  GPR_ASSERT(wait_for_start(&ev[2]) == STARTED);
+  check_stats(1, 0, 3);
+  grpc_handshake_pool_end(0, gpr_now(), 1);
+  check_stats(0, 0, 3);
+
+  grpc_shutdown();
+}
+
+/* Handshakes still waiting on shutdown fail, and the pool starts afresh on
+   the next init */
+static void test_shutdown(void) {
+  gpr_event ev[2];
+
+  gpr_log(GPR_INFO, "test_shutdown");
+  gpr_event_init(&ev[0]);
+  gpr_event_init(&ev[1]);
+  grpc_init();
+  check_stats(0, 0, 0);
+  grpc_set_handshake_offload_limits(1, 1);
+
+  grpc_handshake_pool_begin(0, on_start, &ev[0]);
+  GPR_ASSERT(gpr_event_get(&ev[0]) == STARTED);
+  grpc_handshake_pool_begin(0, on_start, &ev[1]);
+  GPR_ASSERT(gpr_event_get(&ev[1]) == NULL);
+  grpc_handshake_pool_end(0, gpr_now(), 0);
+  GPR_ASSERT(wait_for_start(&ev[1]) == STARTED);
+
+  gpr_event_init(&ev[0]);
+  grpc_handshake_pool_begin(0, on_start, &ev[0]);
+  GPR_ASSERT(gpr_event_get(&ev[0]) == NULL);
+  grpc_shutdown();
+  GPR_ASSERT(gpr_event_get(&ev[0]) == FAILED);
+  check_stats(1, 0, 1);
+}
+
+int main(int argc, char **argv) {
+  grpc_test_init(argc, argv);
+  test_queue_limits();
+  test_shutdown();
+  return 0;
+}
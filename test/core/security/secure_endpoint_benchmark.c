@@ -0,0 +1,302 @@
+/*
+ *
+ * Copyright 2015, Google Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer
+ * in the documentation and/or other materials provided with the
+ * distribution.
+ *     * Neither the name of Google Inc. nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/*
+   Secure endpoint throughput benchmark.
+
+   Streams data from one secure endpoint to another over a socket pair, with
+   the fake frame protector and with the SSL frame protector, and reports the
+   throughput. The reader runs on the polling thread and the writer on its own
+   thread. Uses the test credentials in src/core/tsi/test_creds by default.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "src/core/iomgr/endpoint_pair.h"
+#include "src/core/iomgr/iomgr.h"
+#include "src/core/iomgr/pollset.h"
+#include "src/core/security/secure_endpoint.h"
+#include "src/core/support/file.h"
+#include "src/core/support/string.h"
+#include "src/core/tsi/fake_transport_security.h"
+#include "src/core/tsi/ssl_transport_security.h"
+#include <grpc/support/alloc.h>
+#include <grpc/support/cmdline.h>
+#include <grpc/support/log.h>
+#include <grpc/support/slice.h>
+#include <grpc/support/sync.h>
+#include <grpc/support/thd.h>
+#include <grpc/support/time.h>
+
+/* Matches the *.test.google.fr SAN of server1.pem. */
+#define SERVER_NAME "foo.test.google.fr"
+
+/* Size of the slices read from the socket pair. */
+#define READ_SLICE_SIZE 8192
+
+/* Number of slices each write is split into. */
+#define SLICES_PER_WRITE 4
+
+typedef struct {
+  grpc_endpoint *ep;
+  size_t bytes_to_read;
+  size_t bytes_read;
+  gpr_event done;
+} reader_state;
+
+typedef struct {
+  grpc_endpoint *ep;
+  size_t bytes_to_write;
+  size_t write_size;
+} writer_state;
+
+static gpr_slice load_creds_file(const char *dir, const char *name) {
+  char *path;
+  int success;
+  gpr_slice slice;
+  gpr_asprintf(&path, "%s/%s", dir, name);
+  slice = gpr_load_file(path, 0, &success);
+  if (!success) {
+    gpr_log(GPR_ERROR, "Could not load %s.", path);
+    abort();
+  }
+  gpr_free(path);
+  return slice;
+}
+
+/* Sends whatever from has to say to to. */
+static void pass_handshake_bytes(tsi_handshaker *from, tsi_handshaker *to) {
+  unsigned char buf[4096];
+  size_t size;
+  size_t consumed;
+  tsi_result result;
+  do {
+    size = sizeof(buf);
+    result = tsi_handshaker_get_bytes_to_send_to_peer(from, buf, &size);
+    if (size > 0) {
+      consumed = size;
+      GPR_ASSERT(tsi_handshaker_process_bytes_from_peer(to, buf, &consumed) !=
+                 TSI_PROTOCOL_FAILURE);
+      GPR_ASSERT(consumed == size);
+    }
+  } while (result == TSI_INCOMPLETE_DATA);
+  GPR_ASSERT(result == TSI_OK);
+}
+
+/* Runs an in-memory SSL handshake and creates the frame protectors of both
+   ends. */
+static void create_ssl_protectors(const char *creds_dir,
+                                  tsi_frame_protector **client_protector,
+                                  tsi_frame_protector **server_protector) {
+  gpr_slice ca_cert = load_creds_file(creds_dir, "ca.pem");
+  gpr_slice server_key = load_creds_file(creds_dir, "server1.key");
+  gpr_slice server_cert = load_creds_file(creds_dir, "server1.pem");
+  const unsigned char *key_bytes = GPR_SLICE_START_PTR(server_key);
+  const unsigned char *cert_bytes = GPR_SLICE_START_PTR(server_cert);
+  size_t key_size = GPR_SLICE_LENGTH(server_key);
+  size_t cert_size = GPR_SLICE_LENGTH(server_cert);
+  tsi_ssl_handshaker_factory *client_factory;
+  tsi_ssl_handshaker_factory *server_factory;
+  tsi_handshaker *client;
+  tsi_handshaker *server;
+
+  GPR_ASSERT(tsi_create_ssl_client_handshaker_factory(
+                 NULL, 0, NULL, 0, GPR_SLICE_START_PTR(ca_cert),
+                 GPR_SLICE_LENGTH(ca_cert), NULL, NULL, NULL, 0, NULL,
+                 &client_factory) == TSI_OK);
+  GPR_ASSERT(tsi_create_ssl_server_handshaker_factory(
+                 &key_bytes, &key_size, &cert_bytes, &cert_size, 1, NULL, 0,
+                 NULL, NULL, NULL, 0, 0, &server_factory) == TSI_OK);
+  GPR_ASSERT(tsi_ssl_handshaker_factory_create_handshaker(
+                 client_factory, SERVER_NAME, &client) == TSI_OK);
+  GPR_ASSERT(tsi_ssl_handshaker_factory_create_handshaker(
+                 server_factory, NULL, &server) == TSI_OK);
+  while (tsi_handshaker_is_in_progress(client) ||
+         tsi_handshaker_is_in_progress(server)) {
+    pass_handshake_bytes(client, server);
+    pass_handshake_bytes(server, client);
+  }
+  GPR_ASSERT(tsi_handshaker_get_result(client) == TSI_OK);
+  GPR_ASSERT(tsi_handshaker_get_result(server) == TSI_OK);
+  GPR_ASSERT(tsi_handshaker_create_frame_protector(
+                 client, NULL, client_protector) == TSI_OK);
+  GPR_ASSERT(tsi_handshaker_create_frame_protector(
+                 server, NULL, server_protector) == TSI_OK);
+
+  tsi_handshaker_destroy(client);
+  tsi_handshaker_destroy(server);
+  tsi_ssl_handshaker_factory_destroy(client_factory);
+  tsi_ssl_handshaker_factory_destroy(server_factory);
+  gpr_slice_unref(ca_cert);
+  gpr_slice_unref(server_key);
+  gpr_slice_unref(server_cert);
+}
+
+static void on_read(void *arg, gpr_slice *slices, size_t nslices,
+                    grpc_endpoint_cb_status error) {
+  reader_state *state = arg;
+  size_t i;
+  GPR_ASSERT(error == GRPC_ENDPOINT_CB_OK);
+  for (i = 0; i < nslices; i++) {
+    state->bytes_read += GPR_SLICE_LENGTH(slices[i]);
+    gpr_slice_unref(slices[i]);
+  }
+  if (state->bytes_read >= state->bytes_to_read) {
+    gpr_event_set(&state->done, (void *)1);
+  } else {
+    grpc_endpoint_notify_on_read(state->ep, on_read, state);
+  }
+}
+
+static void on_write(void *arg, grpc_endpoint_cb_status error) {
+  GPR_ASSERT(error == GRPC_ENDPOINT_CB_OK);
+  gpr_event_set(arg, (void *)1);
+}
+
+static void on_pollset_shutdown(void *arg) { gpr_event_set(arg, (void *)1); }
+
+static void writer_thread(void *arg) {
+  writer_state *state = arg;
+  size_t written = 0;
+  size_t slice_size = state->write_size / SLICES_PER_WRITE;
+  while (written < state->bytes_to_write) {
+    gpr_slice slices[SLICES_PER_WRITE];
+    gpr_event write_done;
+    size_t i;
+    for (i = 0; i < SLICES_PER_WRITE; i++) {
+      slices[i] = gpr_slice_malloc(slice_size);
+      memset(GPR_SLICE_START_PTR(slices[i]), (int)i, slice_size);
+    }
+    gpr_event_init(&write_done);
+    switch (grpc_endpoint_write(state->ep, slices, SLICES_PER_WRITE, on_write,
+                                &write_done)) {
+      case GRPC_ENDPOINT_WRITE_DONE:
+        break;
+      case GRPC_ENDPOINT_WRITE_PENDING:
+        gpr_event_wait(&write_done, gpr_inf_future);
+        break;
+      case GRPC_ENDPOINT_WRITE_ERROR:
+        gpr_log(GPR_ERROR, "Write failed.");
+        abort();
+    }
+    written += slice_size * SLICES_PER_WRITE;
+  }
+}
+
+static void run_benchmark(const char *name,
+                          tsi_frame_protector *client_protector,
+                          tsi_frame_protector *server_protector,
+                          size_t megabytes, size_t write_size) {
+  grpc_endpoint_pair pair = grpc_iomgr_create_endpoint_pair(READ_SLICE_SIZE);
+  grpc_pollset pollset;
+  gpr_event pollset_shutdown;
+  reader_state reader;
+  writer_state writer;
+  gpr_thd_id id;
+  gpr_timespec start;
+  double elapsed;
+
+  writer.ep = grpc_secure_endpoint_create(client_protector, pair.client,
+                                          NULL, 0);
+  writer.bytes_to_write = megabytes << 20;
+  writer.write_size = write_size;
+  reader.ep = grpc_secure_endpoint_create(server_protector, pair.server,
+                                          NULL, 0);
+  reader.bytes_to_read = writer.bytes_to_write;
+  reader.bytes_read = 0;
+  gpr_event_init(&reader.done);
+
+  grpc_pollset_init(&pollset);
+  grpc_endpoint_add_to_pollset(writer.ep, &pollset);
+  grpc_endpoint_add_to_pollset(reader.ep, &pollset);
+  grpc_endpoint_notify_on_read(reader.ep, on_read, &reader);
+
+  start = gpr_now();
+  GPR_ASSERT(gpr_thd_new(&id, writer_thread, &writer, NULL));
+  gpr_mu_lock(GRPC_POLLSET_MU(&pollset));
+  while (!gpr_event_get(&reader.done)) {
+    grpc_pollset_work(&pollset,
+                      gpr_time_add(gpr_now(), gpr_time_from_millis(100)));
+  }
+  gpr_mu_unlock(GRPC_POLLSET_MU(&pollset));
+  elapsed = gpr_timespec_to_micros(gpr_time_sub(gpr_now(), start)) / 1e6;
+
+  gpr_log(GPR_INFO, "%s: %d MB in %d byte writes in %.3fs, %.1f MB/s", name,
+          (int)megabytes, (int)write_size, elapsed, megabytes / elapsed);
+
+  grpc_endpoint_shutdown(writer.ep);
+  grpc_endpoint_shutdown(reader.ep);
+  grpc_endpoint_destroy(writer.ep);
+  grpc_endpoint_destroy(reader.ep);
+  gpr_event_init(&pollset_shutdown);
+  grpc_pollset_shutdown(&pollset, on_pollset_shutdown, &pollset_shutdown);
+  GPR_ASSERT(gpr_event_wait(&pollset_shutdown, gpr_inf_future));
+  grpc_pollset_destroy(&pollset);
+}
+
+int main(int argc, char **argv) {
+  char *creds_dir = "src/core/tsi/test_creds";
+  int megabytes = 256;
+  int write_size = 65536;
+  tsi_frame_protector *client_protector;
+  tsi_frame_protector *server_protector;
+  gpr_cmdline *cmdline =
+      gpr_cmdline_create("secure_endpoint_benchmark throughput tool");
+
+  gpr_cmdline_add_string(cmdline, "creds_dir",
+                         "Directory holding ca.pem, server1.pem and "
+                         "server1.key",
+                         &creds_dir);
+  gpr_cmdline_add_int(cmdline, "megabytes", "Megabytes to send per run",
+                      &megabytes);
+  gpr_cmdline_add_int(cmdline, "write_size", "Bytes per endpoint write",
+                      &write_size);
+  gpr_cmdline_parse(cmdline, argc, argv);
+  GPR_ASSERT(megabytes > 0);
+  GPR_ASSERT(write_size >= SLICES_PER_WRITE &&
+             write_size % SLICES_PER_WRITE == 0);
+
+  grpc_iomgr_init();
+
+  run_benchmark("fake", tsi_create_fake_protector(NULL),
+                tsi_create_fake_protector(NULL), (size_t)megabytes,
+                (size_t)write_size);
+  create_ssl_protectors(creds_dir, &client_protector, &server_protector);
+  run_benchmark("ssl", client_protector, server_protector, (size_t)megabytes,
+                (size_t)write_size);
+
+  grpc_iomgr_shutdown();
+  gpr_cmdline_destroy(cmdline);
+  return 0;
+}
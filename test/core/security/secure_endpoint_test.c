@@ -45,6 +45,7 @@
 #include <grpc/support/log.h>
 #include "test/core/util/test_config.h"
 #include "src/core/tsi/fake_transport_security.h"
+#include "src/core/tsi/transport_security.h"
 
 static grpc_endpoint_test_fixture secure_endpoint_create_fixture_tcp_socketpair(
     size_t slice_size, gpr_slice *leftover_slices, size_t leftover_nslices) {
@@ -192,6 +193,114 @@ static void test_destroy_ep_early(grpc_endpoint_test_config config,
   clean_up();
 }
 
+/* A frame protector failing every operation */
+static tsi_result failing_protect(tsi_frame_protector *self,
+                                  const unsigned char *unprotected_bytes,
+                                  size_t *unprotected_bytes_size,
+                                  unsigned char *protected_output_frames,
+                                  size_t *protected_output_frames_size) {
+  return TSI_INTERNAL_ERROR;
+}
+
+static tsi_result failing_protect_flush(tsi_frame_protector *self,
+                                        unsigned char *protected_output_frames,
+                                        size_t *protected_output_frames_size,
+                                        size_t *still_pending_size) {
+  return TSI_INTERNAL_ERROR;
+}
+
+static tsi_result failing_unprotect(tsi_frame_protector *self,
+                                    const unsigned char *protected_frames_bytes,
+                                    size_t *protected_frames_bytes_size,
+                                    unsigned char *unprotected_bytes,
+                                    size_t *unprotected_bytes_size) {
+  return TSI_DATA_CORRUPTED;
+}
+
+static tsi_result failing_protect_slices(tsi_frame_protector *self,
+                                         gpr_slice_buffer *unprotected_slices,
+                                         gpr_slice_buffer *protected_slices) {
+  gpr_slice_buffer_reset_and_unref(unprotected_slices);
+  return TSI_INTERNAL_ERROR;
+}
+
+static tsi_result failing_unprotect_slices(
+    tsi_frame_protector *self, gpr_slice_buffer *protected_slices,
+    gpr_slice_buffer *unprotected_slices) {
+  gpr_slice_buffer_reset_and_unref(protected_slices);
+  return TSI_DATA_CORRUPTED;
+}
+
+static void failing_destroy(tsi_frame_protector *self) { gpr_free(self); }
+
+static const tsi_frame_protector_vtable failing_vtable = {
+    failing_protect, failing_protect_flush, failing_unprotect, NULL, NULL,
+    failing_destroy};
+
+static const tsi_frame_protector_vtable failing_slices_vtable = {
+    failing_protect,        failing_protect_flush,    failing_unprotect,
+    failing_protect_slices, failing_unprotect_slices, failing_destroy};
+
+static void on_failed_read(void *user_data, gpr_slice *slices, size_t nslices,
+                           grpc_endpoint_cb_status error) {
+  size_t i;
+  for (i = 0; i < nslices; i++) gpr_slice_unref(slices[i]);
+  gpr_event_set(user_data, (void *)(gpr_intptr)(error + 1));
+}
+
+static void on_failed_write(void *user_data, grpc_endpoint_cb_status error) {
+  GPR_ASSERT(0);
+}
+
+/* wait for a read started on ep and return its status */
+static grpc_endpoint_cb_status read_status(grpc_endpoint *ep) {
+  gpr_event ev;
+  void *status;
+  gpr_event_init(&ev);
+  grpc_endpoint_notify_on_read(ep, on_failed_read, &ev);
+  status = gpr_event_wait(&ev, GRPC_TIMEOUT_SECONDS_TO_DEADLINE(5));
+  GPR_ASSERT(status != NULL);
+  return (grpc_endpoint_cb_status)((gpr_intptr)status - 1);
+}
+
+/* Protection errors fail the read or write and shut the endpoint down, so
+   that the next read completes without waiting for the peer */
+static void test_protector_errors(const tsi_frame_protector_vtable *vtable) {
+  grpc_endpoint_pair tcp;
+  grpc_endpoint *ep;
+  tsi_frame_protector *protector;
+  gpr_slice data = gpr_slice_from_copied_string("garbage");
+  gpr_log(GPR_INFO, "Start test protector errors");
+
+  /* unprotect error */
+  tcp = grpc_iomgr_create_endpoint_pair(1024);
+  protector = gpr_malloc(sizeof(tsi_frame_protector));
+  protector->vtable = vtable;
+  ep = grpc_secure_endpoint_create(protector, tcp.client, NULL, 0);
+  GPR_ASSERT(grpc_endpoint_write(tcp.server, &data, 1, on_failed_write,
+                                 NULL) == GRPC_ENDPOINT_WRITE_DONE);
+  GPR_ASSERT(read_status(ep) == GRPC_ENDPOINT_CB_ERROR);
+  GPR_ASSERT(read_status(ep) != GRPC_ENDPOINT_CB_OK);
+  grpc_endpoint_destroy(ep);
+  grpc_endpoint_shutdown(tcp.server);
+  grpc_endpoint_destroy(tcp.server);
+
+  /* protect error */
+  tcp = grpc_iomgr_create_endpoint_pair(1024);
+  protector = gpr_malloc(sizeof(tsi_frame_protector));
+  protector->vtable = vtable;
+  ep = grpc_secure_endpoint_create(protector, tcp.client, NULL, 0);
+  data = gpr_slice_from_copied_string("hello");
+  GPR_ASSERT(grpc_endpoint_write(ep, &data, 1, on_failed_write, NULL) ==
+             GRPC_ENDPOINT_WRITE_ERROR);
+  GPR_ASSERT(read_status(ep) != GRPC_ENDPOINT_CB_OK);
+  /* shutting down again is harmless */
+  grpc_endpoint_shutdown(ep);
+  grpc_endpoint_destroy(ep);
+  grpc_endpoint_shutdown(tcp.server);
+  grpc_endpoint_destroy(tcp.server);
+}
+
 int main(int argc, char **argv) {
   grpc_test_init(argc, argv);
 
@@ -199,6 +308,8 @@ int main(int argc, char **argv) {
   grpc_endpoint_tests(configs[0]);
   test_leftover(configs[1], 1);
   test_destroy_ep_early(configs[1], 1);
+  test_protector_errors(&failing_vtable);
+  test_protector_errors(&failing_slices_vtable);
   grpc_iomgr_shutdown();
 
   return 0;
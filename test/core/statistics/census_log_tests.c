@@ -560,6 +560,33 @@ void test_small_log(void) {
   census_log_shutdown();
 }
 
+/* Tests that a created log is independent from the process wide one. */
+void test_separate_logs(void) {
+  census_log* log;
+  void* record;
+  size_t bytes_available;
+  const void* read;
+  printf("Starting test: separate logs\n");
+  census_log_initialize(0, 0);
+  log = census_log_create(0, 0);
+  GPR_ASSERT(census_log_remaining_space_in(log) ==
+             census_log_remaining_space());
+  record = census_log_start_write_in(log, 10);
+  GPR_ASSERT(record != NULL);
+  memset(record, 'x', 10);
+  census_log_end_write_in(log, record, 10);
+  /* the process wide log stays empty */
+  census_log_init_reader();
+  GPR_ASSERT(census_log_read_next(&bytes_available) == NULL);
+  census_log_init_reader_in(log);
+  read = census_log_read_next_in(log, &bytes_available);
+  GPR_ASSERT(read == record && bytes_available == 10);
+  GPR_ASSERT(census_log_read_next_in(log, &bytes_available) == NULL);
+  GPR_ASSERT(census_log_out_of_space_count_in(log) == 0);
+  census_log_destroy(log);
+  census_log_shutdown();
+}
+
 void test_performance(void) {
   int write_size = 1;
   for (; write_size < CENSUS_LOG_MAX_RECORD_SIZE; write_size *= 2) {
@@ -47,5 +47,6 @@ void test_multiple_writers_circular_log();
 void test_multiple_writers();
 void test_performance();
 void test_small_log();
+void test_separate_logs();
 
 #endif  /* GRPC_TEST_CORE_STATISTICS_CENSUS_LOG_TESTS_H */
@@ -33,14 +33,260 @@
 
 #include "test/core/statistics/census_log_tests.h"
 
+#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
+#include "src/core/statistics/census_interface.h"
+#include "src/core/statistics/census_rpc_stats.h"
+#include "src/core/statistics/census_tracing.h"
+#include "src/core/statistics/hash_table.h"
+#include "src/core/statistics/window_stats.h"
+#include "src/core/support/murmur_hash.h"
+#include "src/core/support/string.h"
+#include <grpc/support/alloc.h>
+#include <grpc/support/log.h>
+#include <grpc/support/sync.h>
+#include <grpc/support/thd.h>
 #include <grpc/support/time.h>
 #include "test/core/util/test_config.h"
 
+#define STATS_NUM_METHODS 4
+#define STATS_MAX_THREADS 16
+#define STATS_RECORDS_PER_THREAD 50000
+
+static const char *g_method_names[STATS_NUM_METHODS] = {
+    "/perf.Service/A", "/perf.Service/B", "/perf.Service/C",
+    "/perf.Service/D"};
+
+/* How record_stats_thread records stats. */
+typedef enum {
+  /* census_record_rpc_client_stats_by_method */
+  RECORD_BY_METHOD_ID,
+  /* census_record_rpc_client_stats, looking up the method of an op in the
+     trace store */
+  RECORD_BY_OP_ID,
+  /* the stats store as it was before method ids: one lock around a hash
+     table keyed by method name, looked up from the trace store */
+  RECORD_BY_NAME_UNDER_GLOBAL_LOCK,
+  NUM_RECORD_MODES
+} record_mode;
+
+static const char *g_record_mode_names[NUM_RECORD_MODES] = {
+    "method id", "op id", "method name under a global lock"};
+
+/* Reference implementation of the previous stats store, to compare the
+   current recording paths against. */
+static gpr_mu g_ref_mu;
+static census_ht *g_ref_store;
+
+static int ref_cmp_str_keys(const void *k1, const void *k2) {
+  return strcmp((const char *)k1, (const char *)k2);
+}
+
+static gpr_uint64 ref_simple_hash(const void *k) {
+  size_t len = strlen(k);
+  gpr_uint64 higher = gpr_murmur_hash3((const char *)k, len / 2, 0);
+  return higher << 32 |
+         gpr_murmur_hash3((const char *)k + len / 2, len - len / 2, 0);
+}
+
+static void ref_delete_stats(void *stats) {
+  census_window_stats_destroy((struct census_window_stats *)stats);
+}
+
+static void ref_delete_key(void *key) { gpr_free(key); }
+
+static const census_ht_option g_ref_ht_opt = {
+    CENSUS_HT_POINTER, 1999, ref_simple_hash, ref_cmp_str_keys,
+    ref_delete_stats, ref_delete_key};
+
+static void ref_init_rpc_stats(void *stats) {
+  memset(stats, 0, sizeof(census_rpc_stats));
+}
+
+static void ref_stat_add_proportion(double p, void *base, const void *addme) {
+  census_rpc_stats *b = (census_rpc_stats *)base;
+  const census_rpc_stats *a = (const census_rpc_stats *)addme;
+  b->cnt += p * a->cnt;
+  b->rpc_error_cnt += p * a->rpc_error_cnt;
+  b->app_error_cnt += p * a->app_error_cnt;
+  b->elapsed_time_ms += p * a->elapsed_time_ms;
+  b->api_request_bytes += p * a->api_request_bytes;
+  b->wire_request_bytes += p * a->wire_request_bytes;
+  b->api_response_bytes += p * a->api_response_bytes;
+  b->wire_response_bytes += p * a->wire_response_bytes;
+}
+
+static void ref_stat_add(void *base, const void *addme) {
+  ref_stat_add_proportion(1.0, base, addme);
+}
+
+static gpr_timespec g_ref_intervals[3] = {{60, 0}, {3600, 0}, {36000000, 0}};
+
+static const census_window_stats_stat_info g_ref_stat_info = {
+    sizeof(census_rpc_stats), ref_init_rpc_stats, ref_stat_add,
+    ref_stat_add_proportion};
+
+static void ref_record_stats(census_op_id op_id,
+                             const census_rpc_stats *stats) {
+  census_trace_obj *trace;
+  gpr_mu_lock(&g_ref_mu);
+  census_internal_lock_trace_store();
+  trace = census_get_trace_obj_locked(op_id);
+  if (trace != NULL) {
+    struct census_window_stats *window_stats;
+    census_ht_key key;
+    key.ptr = (void *)census_get_trace_method_name(trace);
+    window_stats = census_ht_find(g_ref_store, key);
+    census_internal_unlock_trace_store();
+    if (window_stats == NULL) {
+      window_stats = census_window_stats_create(3, g_ref_intervals, 30,
+                                                &g_ref_stat_info);
+      key.ptr = gpr_strdup(key.ptr);
+      census_ht_insert(g_ref_store, key, window_stats);
+    }
+    census_window_stats_add(window_stats, gpr_now(), stats);
+  } else {
+    census_internal_unlock_trace_store();
+  }
+  gpr_mu_unlock(&g_ref_mu);
+}
+
+/* Returns the number of records in the reference store. */
+static double ref_total_count(void) {
+  census_rpc_stats totals[3];
+  census_window_stats_sums sums[3];
+  census_ht_kv *kv;
+  size_t n;
+  size_t i;
+  double cnt = 0;
+  int j;
+  for (j = 0; j < 3; j++) {
+    sums[j].statistic = &totals[j];
+  }
+  kv = census_ht_get_all_elements(g_ref_store, &n);
+  for (i = 0; i < n; i++) {
+    census_window_stats_get_sums(kv[i].v, gpr_now(), sums);
+    cnt += totals[2].cnt;
+  }
+  gpr_free(kv);
+  return cnt;
+}
+
+typedef struct {
+  gpr_mu mu;
+  gpr_cv done;
+  int threads_running;
+  record_mode mode;
+  census_method_id method_ids[STATS_NUM_METHODS];
+} stats_test_state;
+
+static void record_stats_thread(void *arg) {
+  stats_test_state *state = arg;
+  census_rpc_stats stats = {1, 0, 0, 1.5, 100, 110, 200, 210};
+  census_op_id op_ids[STATS_NUM_METHODS];
+  int by_op = state->mode != RECORD_BY_METHOD_ID;
+  int i;
+  if (by_op) {
+    for (i = 0; i < STATS_NUM_METHODS; i++) {
+      op_ids[i] = census_tracing_start_op();
+      census_add_method_tag(op_ids[i], g_method_names[i]);
+    }
+  }
+  for (i = 0; i < STATS_RECORDS_PER_THREAD; i++) {
+    switch (state->mode) {
+      case RECORD_BY_METHOD_ID:
+        census_record_rpc_client_stats_by_method(
+            state->method_ids[i % STATS_NUM_METHODS], &stats);
+        break;
+      case RECORD_BY_OP_ID:
+        census_record_rpc_client_stats(op_ids[i % STATS_NUM_METHODS], &stats);
+        break;
+      default:
+        ref_record_stats(op_ids[i % STATS_NUM_METHODS], &stats);
+        break;
+    }
+  }
+  if (by_op) {
+    for (i = 0; i < STATS_NUM_METHODS; i++) {
+      census_tracing_end_op(op_ids[i]);
+    }
+  }
+  gpr_mu_lock(&state->mu);
+  if (--state->threads_running == 0) gpr_cv_signal(&state->done);
+  gpr_mu_unlock(&state->mu);
+}
+
+/* Measures stats recording throughput with a growing number of threads, by
+   method id and by op id, against the previous stats store. */
+static void test_stats_recording_performance(void) {
+  int mode;
+  int num_threads;
+  gpr_mu_init(&g_ref_mu);
+  for (mode = 0; mode < NUM_RECORD_MODES; mode++) {
+    for (num_threads = 1; num_threads <= STATS_MAX_THREADS; num_threads *= 2) {
+      stats_test_state state;
+      census_aggregated_rpc_stats agg_stats = {0, NULL};
+      gpr_timespec start_time;
+      double elapsed_micro;
+      double total_cnt = 0;
+      int nrecords = num_threads * STATS_RECORDS_PER_THREAD;
+      gpr_thd_id id;
+      int i;
+
+      census_init();
+      g_ref_store = census_ht_create(&g_ref_ht_opt);
+      gpr_mu_init(&state.mu);
+      gpr_cv_init(&state.done);
+      state.threads_running = num_threads;
+      state.mode = (record_mode)mode;
+      for (i = 0; i < STATS_NUM_METHODS; i++) {
+        state.method_ids[i] = census_stats_register_method(g_method_names[i]);
+      }
+      start_time = gpr_now();
+      for (i = 0; i < num_threads; i++) {
+        GPR_ASSERT(gpr_thd_new(&id, record_stats_thread, &state, NULL));
+      }
+      gpr_mu_lock(&state.mu);
+      while (state.threads_running > 0) {
+        gpr_cv_wait(&state.done, &state.mu, gpr_inf_future);
+      }
+      gpr_mu_unlock(&state.mu);
+      elapsed_micro =
+          gpr_timespec_to_micros(gpr_time_sub(gpr_now(), start_time));
+
+      if (mode == RECORD_BY_NAME_UNDER_GLOBAL_LOCK) {
+        GPR_ASSERT(census_ht_get_size(g_ref_store) == STATS_NUM_METHODS);
+        total_cnt = ref_total_count();
+      } else {
+        census_get_client_stats(&agg_stats);
+        GPR_ASSERT(agg_stats.num_entries == STATS_NUM_METHODS);
+        for (i = 0; i < agg_stats.num_entries; i++) {
+          total_cnt += agg_stats.stats[i].total_stats.cnt;
+        }
+        census_aggregated_rpc_stats_set_empty(&agg_stats);
+      }
+      GPR_ASSERT(total_cnt == nrecords);
+      census_ht_destroy(g_ref_store);
+      census_shutdown();
+      gpr_cv_destroy(&state.done);
+      gpr_mu_destroy(&state.mu);
+
+      printf(
+          "Recorded %d rpc stats by %s from %d threads in %.3g microseconds: "
+          "%g records/us (%g ns/record)\n",
+          nrecords, g_record_mode_names[mode], num_threads, elapsed_micro,
+          nrecords / elapsed_micro, 1000 * elapsed_micro / nrecords);
+    }
+  }
+  gpr_mu_destroy(&g_ref_mu);
+}
+
 int main(int argc, char **argv) {
   grpc_test_init(argc, argv);
   srand(gpr_now().tv_nsec);
   test_performance();
+  test_stats_recording_performance();
   return 0;
 }
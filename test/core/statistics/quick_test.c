@@ -50,5 +50,6 @@ int main(int argc, char **argv) {
   test_fill_circular_log_no_fragmentation();
   test_fill_log_with_straddling_records();
   test_fill_circular_log_with_straddling_records();
+  test_separate_logs();
   return 0;
 }
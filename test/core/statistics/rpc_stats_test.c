@@ -36,12 +36,13 @@
 #include "src/core/statistics/census_interface.h"
 #include "src/core/statistics/census_rpc_stats.h"
 #include "src/core/statistics/census_tracing.h"
+#include "src/core/support/string.h"
 #include <grpc/support/alloc.h>
 #include <grpc/support/log.h>
 #include <grpc/support/port_platform.h>
-#include <grpc/support/string.h>
 #include <grpc/support/thd.h>
 #include <grpc/support/time.h>
+#include <grpc/support/useful.h>
 #include "test/core/util/test_config.h"
 
 /* Ensure all possible state transitions are called without causing problem */
@@ -186,6 +187,72 @@ static void test_record_stats_with_trace_store_uninitialized(void) {
   census_stats_store_shutdown();
 }
 
+/* Test that method ids survive a store restart, while the stats recorded
+   before the restart don't. */
+static void test_method_ids_across_reinit(void) {
+  census_rpc_stats stats = {1, 2, 3, 4, 5.1, 6.2, 7.3, 8.4};
+  census_aggregated_rpc_stats agg_stats = {0, NULL};
+  census_method_id before_init;
+  census_method_id id;
+  census_op_id op_id;
+
+  /* methods can be registered, and ops tagged, before the store is up */
+  before_init = census_stats_register_method("reinit/before_init");
+  GPR_ASSERT(before_init != CENSUS_INVALID_METHOD_ID);
+  census_init();
+  GPR_ASSERT(census_stats_register_method("reinit/before_init") ==
+             before_init);
+  op_id = census_tracing_start_op();
+  census_add_method_tag_with_id(op_id, "reinit/before_init", before_init);
+  census_record_rpc_client_stats(op_id, &stats);
+  census_tracing_end_op(op_id);
+  id = census_stats_register_method("reinit/m");
+  census_record_rpc_client_stats_by_method(id, &stats);
+  census_get_client_stats(&agg_stats);
+  GPR_ASSERT(agg_stats.num_entries == 2);
+  census_aggregated_rpc_stats_set_empty(&agg_stats);
+  census_shutdown();
+
+  /* recording while shut down is dropped */
+  census_record_rpc_client_stats_by_method(id, &stats);
+
+  census_init();
+  GPR_ASSERT(census_stats_register_method("reinit/m") == id);
+  GPR_ASSERT(census_stats_register_method("reinit/before_init") ==
+             before_init);
+  census_get_client_stats(&agg_stats);
+  GPR_ASSERT(agg_stats.num_entries == 0);
+  /* an id cached before the restart still records against its method */
+  census_record_rpc_client_stats_by_method(id, &stats);
+  census_get_client_stats(&agg_stats);
+  GPR_ASSERT(agg_stats.num_entries == 1);
+  GPR_ASSERT(strcmp(agg_stats.stats[0].method, "reinit/m") == 0);
+  GPR_ASSERT(agg_stats.stats[0].total_stats.cnt == 1);
+  census_aggregated_rpc_stats_set_empty(&agg_stats);
+  census_shutdown();
+}
+
+/* Test that recording against ids that name no registered method is noop. */
+static void test_record_stats_on_unknown_method_id(void) {
+  census_rpc_stats stats = {1, 2, 3, 4, 5.1, 6.2, 7.3, 8.4};
+  census_aggregated_rpc_stats agg_stats = {0, NULL};
+  census_method_id unknown_ids[] = {CENSUS_INVALID_METHOD_ID, -2, 1000,
+                                    1 << 20};
+  size_t i;
+
+  census_init();
+  for (i = 0; i < GPR_ARRAY_SIZE(unknown_ids); i++) {
+    census_record_rpc_client_stats_by_method(unknown_ids[i], &stats);
+    census_record_rpc_server_stats_by_method(unknown_ids[i], &stats);
+  }
+  census_get_client_stats(&agg_stats);
+  GPR_ASSERT(agg_stats.num_entries == 0);
+  census_get_server_stats(&agg_stats);
+  GPR_ASSERT(agg_stats.num_entries == 0);
+  GPR_ASSERT(census_stats_register_method(NULL) == CENSUS_INVALID_METHOD_ID);
+  census_shutdown();
+}
+
 int main(int argc, char** argv) {
   grpc_test_init(argc, argv);
   test_init_shutdown();
@@ -193,5 +260,7 @@ int main(int argc, char** argv) {
   test_record_and_get_stats();
   test_record_stats_on_unknown_op_id();
   test_record_stats_with_trace_store_uninitialized();
+  test_method_ids_across_reinit();
+  test_record_stats_on_unknown_method_id();
   return 0;
 }
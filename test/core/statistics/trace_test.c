@@ -35,7 +35,7 @@
 #include <stdio.h>
 
 #include "src/core/statistics/census_interface.h"
-#include "src/core/statistics/census_tracing.h"
+#include "src/core/statistics/census_log.h"
 #include "src/core/statistics/census_tracing.h"
 #include <grpc/support/alloc.h>
 #include <grpc/support/log.h>
@@ -111,7 +111,7 @@ static void mimic_trace_op_sequences(void* arg) {
     id = census_tracing_start_op();
     census_add_method_tag(id, method_name);
     /* pretend doing 1us work. */
-    gpr_sleep_until(GRPC_TIMEOUT_MICROS_TO_DEADLINE(1));
+    gpr_sleep_until(gpr_time_add(gpr_now(), gpr_time_from_micros(1)));
     census_tracing_end_op(id);
   }
   gpr_log(GPR_INFO, "End trace op sequence thread.");
@@ -242,6 +242,104 @@ static void test_get_active_ops(void) {
   census_tracing_shutdown();
 }
 
+static void test_get_completed_ops(void) {
+  census_op_id id_1, id_2;
+  census_trace_obj** completed_ops;
+  census_trace_annotation* anno;
+  int i = 0;
+  int n = 0;
+
+  gpr_log(GPR_INFO, "test_get_completed_ops");
+  census_tracing_init();
+  completed_ops = census_get_completed_ops(&n);
+  GPR_ASSERT(completed_ops == NULL);
+  GPR_ASSERT(n == 0);
+
+  id_1 = census_tracing_start_op();
+  census_add_method_tag(id_1, "foo_1");
+  census_tracing_print(id_1, "a1");
+  census_tracing_print(id_1, "a2");
+  id_2 = census_tracing_start_op();
+  for (i = 0; i < CENSUS_MAX_TRACE_ANNOTATIONS + 10; i++) {
+    census_tracing_print(id_2, "a");
+  }
+  /* Ops still in progress are not reported. */
+  completed_ops = census_get_completed_ops(&n);
+  GPR_ASSERT(completed_ops == NULL);
+  GPR_ASSERT(n == 0);
+
+  census_tracing_end_op(id_1);
+  census_tracing_end_op(id_2);
+  completed_ops = census_get_completed_ops(&n);
+  GPR_ASSERT(completed_ops != NULL);
+  GPR_ASSERT(n == 2);
+  for (i = 0; i < 2; i++) {
+    census_trace_obj* op = completed_ops[i];
+    int num_annotations = 0;
+    for (anno = op->annotations; anno != NULL; anno = anno->next) {
+      num_annotations++;
+    }
+    if (ids_equal(op->id, id_1)) {
+      GPR_ASSERT(strcmp(op->method, "foo_1") == 0);
+      GPR_ASSERT(num_annotations == 2);
+      /* newest first */
+      GPR_ASSERT(strcmp(op->annotations->txt, "a2") == 0);
+    } else {
+      GPR_ASSERT(ids_equal(op->id, id_2));
+      GPR_ASSERT(op->method == NULL);
+      GPR_ASSERT(num_annotations == CENSUS_MAX_TRACE_ANNOTATIONS);
+    }
+    census_trace_obj_destroy(op);
+  }
+  gpr_free(completed_ops);
+
+  /* Completed ops are only reported once. */
+  completed_ops = census_get_completed_ops(&n);
+  GPR_ASSERT(completed_ops == NULL);
+  GPR_ASSERT(n == 0);
+
+  census_tracing_shutdown();
+}
+
+/* Test that tracing works alongside another user of the process wide census
+   log, and keeps its records apart. */
+static void test_completed_ops_with_census_log_in_use(void) {
+  census_op_id id;
+  census_trace_obj** completed_ops;
+  const char other_record[] = "not a trace";
+  const char* read;
+  size_t bytes_available;
+  void* record;
+  int n = 0;
+
+  gpr_log(GPR_INFO, "test_completed_ops_with_census_log_in_use");
+  census_log_initialize(0, 1);
+  census_tracing_init();
+  record = census_log_start_write(sizeof(other_record));
+  GPR_ASSERT(record != NULL);
+  memcpy(record, other_record, sizeof(other_record));
+  census_log_end_write(record, sizeof(other_record));
+
+  id = census_tracing_start_op();
+  census_add_method_tag(id, "foo");
+  census_tracing_end_op(id);
+  completed_ops = census_get_completed_ops(&n);
+  GPR_ASSERT(n == 1);
+  GPR_ASSERT(ids_equal(completed_ops[0]->id, id));
+  census_trace_obj_destroy(completed_ops[0]);
+  gpr_free(completed_ops);
+  census_tracing_shutdown();
+
+  /* the other record is still there, and only it */
+  census_log_init_reader();
+  read = census_log_read_next(&bytes_available);
+  GPR_ASSERT(read != NULL);
+  GPR_ASSERT(bytes_available == sizeof(other_record));
+  GPR_ASSERT(memcmp(read, other_record, sizeof(other_record)) == 0);
+  GPR_ASSERT(census_log_read_next(&bytes_available) == NULL);
+  census_log_shutdown();
+}
+
 int main(int argc, char** argv) {
   grpc_test_init(argc, argv);
   test_init_shutdown();
@@ -251,5 +349,7 @@ int main(int argc, char** argv) {
   test_add_method_tag_to_unknown_op_id();
   test_trace_print();
   test_get_active_ops();
+  test_get_completed_ops();
+  test_completed_ops_with_census_log_in_use();
   return 0;
 }
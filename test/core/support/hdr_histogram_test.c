@@ -0,0 +1,311 @@
+/*
+ *
+ * Copyright 2015, Google Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer
+ * in the documentation and/or other materials provided with the
+ * distribution.
+ *     * Neither the name of Google Inc. nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+
+#include "src/core/support/hdr_histogram.h"
+
+#include <grpc/support/log.h>
+#include <grpc/support/sync.h>
+#include <grpc/support/thd.h>
+#include "test/core/util/test_config.h"
+
+#define LOG_TEST() gpr_log(GPR_INFO, "%s", __FUNCTION__);
+
+static void test_no_op(void) {
+  gpr_hdr_histogram_destroy(gpr_hdr_histogram_create(0.01, 60e9));
+}
+
+static void expect_percentile(gpr_hdr_histogram *h, double percentile,
+                              double min_expect, double max_expect) {
+  double got = gpr_hdr_histogram_percentile(h, percentile);
+  gpr_log(GPR_INFO, "@%f%%, expect %f <= %f <= %f", percentile, min_expect, got,
+          max_expect);
+  GPR_ASSERT(min_expect <= got);
+  GPR_ASSERT(got <= max_expect);
+}
+
+static void test_bucket_resolution(void) {
+  gpr_hdr_histogram *h;
+  double x;
+  size_t i;
+  size_t n;
+
+  LOG_TEST();
+
+  /* every value lands in a single bucket whose width is within resolution of
+     the value, and buckets are ordered by value */
+  h = gpr_hdr_histogram_create(0.01, 1e12);
+  for (x = 1; x < 1e12; x *= 1.01) {
+    gpr_hdr_histogram_add(h, x);
+    i = gpr_hdr_histogram_next_nonempty_bucket(h, 0);
+    GPR_ASSERT(gpr_hdr_histogram_next_nonempty_bucket(h, i + 1) ==
+               gpr_hdr_histogram_num_buckets(h));
+    GPR_ASSERT(gpr_hdr_histogram_minimum(h) <= x);
+    GPR_ASSERT(gpr_hdr_histogram_maximum(h) >= (double)(gpr_uint64)x);
+    GPR_ASSERT(gpr_hdr_histogram_maximum(h) - gpr_hdr_histogram_minimum(h) <=
+               x * 0.01);
+    gpr_hdr_histogram_destroy(h);
+    h = gpr_hdr_histogram_create(0.01, 1e12);
+  }
+  gpr_hdr_histogram_destroy(h);
+
+  /* values past max_value are clamped into the last bucket, but still count
+     towards the exact statistics */
+  h = gpr_hdr_histogram_create(0.05, 1e6);
+  n = gpr_hdr_histogram_num_buckets(h);
+  gpr_hdr_histogram_add(h, 1e9);
+  GPR_ASSERT(gpr_hdr_histogram_next_nonempty_bucket(h, 0) == n - 1);
+  GPR_ASSERT(gpr_hdr_histogram_maximum(h) == 1e9);
+  GPR_ASSERT(gpr_hdr_histogram_percentile(h, 100) == 1e6);
+  gpr_hdr_histogram_destroy(h);
+}
+
+static void test_simple(void) {
+  gpr_hdr_histogram *h;
+
+  LOG_TEST();
+
+  h = gpr_hdr_histogram_create(0.01, 60e9);
+  gpr_hdr_histogram_add(h, 10000);
+  gpr_hdr_histogram_add(h, 10000);
+  gpr_hdr_histogram_add(h, 11000);
+  gpr_hdr_histogram_add(h, 11000);
+
+  GPR_ASSERT(gpr_hdr_histogram_count(h) == 4);
+  expect_percentile(h, 50, 10001, 10999);
+  GPR_ASSERT(gpr_hdr_histogram_mean(h) >= 10500 * 0.99);
+  GPR_ASSERT(gpr_hdr_histogram_mean(h) <= 10500 * 1.01);
+
+  gpr_hdr_histogram_destroy(h);
+}
+
+static void test_exact_stats(void) {
+  gpr_hdr_histogram *h;
+
+  LOG_TEST();
+
+  h = gpr_hdr_histogram_create(0.05, 1e9);
+  GPR_ASSERT(gpr_hdr_histogram_minimum(h) == 0);
+  GPR_ASSERT(gpr_hdr_histogram_maximum(h) == 0);
+  GPR_ASSERT(gpr_hdr_histogram_sum(h) == 0);
+
+  /* fractions and values sharing a bucket are not rounded */
+  gpr_hdr_histogram_add(h, 1000.25);
+  gpr_hdr_histogram_add(h, 1001.5);
+  gpr_hdr_histogram_add(h, 1020.75);
+  GPR_ASSERT(gpr_hdr_histogram_minimum(h) == 1000.25);
+  GPR_ASSERT(gpr_hdr_histogram_maximum(h) == 1020.75);
+  GPR_ASSERT(gpr_hdr_histogram_sum(h) == 3022.5);
+  GPR_ASSERT(gpr_hdr_histogram_sum_of_squares(h) ==
+             1000.25 * 1000.25 + 1001.5 * 1001.5 + 1020.75 * 1020.75);
+  GPR_ASSERT(gpr_hdr_histogram_mean(h) == 1007.5);
+  expect_percentile(h, 0, 1000.25, 1000.25);
+  expect_percentile(h, 100, 1020.75, 1020.75);
+
+  gpr_hdr_histogram_destroy(h);
+}
+
+static void test_large_bucket_counts(void) {
+  gpr_hdr_histogram *h;
+  gpr_uint64 big = (gpr_uint64)1 << 33;
+  size_t bucket;
+
+  LOG_TEST();
+
+  /* bucket counts are as wide as gpr_atm */
+  if (sizeof(gpr_atm) < sizeof(gpr_uint64)) return;
+
+  h = gpr_hdr_histogram_create(0.05, 1e9);
+  gpr_hdr_histogram_add(h, 100);
+  bucket = gpr_hdr_histogram_next_nonempty_bucket(h, 0);
+  GPR_ASSERT(gpr_hdr_histogram_add_to_bucket(h, bucket, big));
+  GPR_ASSERT(gpr_hdr_histogram_bucket_count(h, bucket) == big + 1);
+  GPR_ASSERT(gpr_hdr_histogram_count(h) == (double)(big + 1));
+  gpr_hdr_histogram_add(h, 1000);
+  GPR_ASSERT(gpr_hdr_histogram_count(h) == (double)(big + 2));
+  expect_percentile(h, 50, 100, 101);
+  gpr_hdr_histogram_destroy(h);
+}
+
+static void test_percentile(void) {
+  gpr_hdr_histogram *h;
+  double last;
+  double i;
+  double cur;
+
+  LOG_TEST();
+
+  /* small values are recorded exactly */
+  h = gpr_hdr_histogram_create(0.05, 1e9);
+  gpr_hdr_histogram_add(h, 2);
+  gpr_hdr_histogram_add(h, 2);
+  gpr_hdr_histogram_add(h, 8);
+  gpr_hdr_histogram_add(h, 4);
+
+  GPR_ASSERT(gpr_hdr_histogram_count(h) == 4);
+  GPR_ASSERT(gpr_hdr_histogram_minimum(h) == 2);
+  GPR_ASSERT(gpr_hdr_histogram_maximum(h) == 8);
+  GPR_ASSERT(gpr_hdr_histogram_sum(h) == 16);
+  GPR_ASSERT(gpr_hdr_histogram_sum_of_squares(h) == 88);
+  GPR_ASSERT(gpr_hdr_histogram_mean(h) == 4);
+
+  expect_percentile(h, -10, 2, 2);
+  expect_percentile(h, 0, 2, 2);
+  expect_percentile(h, 25, 2, 2);
+  expect_percentile(h, 50, 2, 4);
+  expect_percentile(h, 75, 4, 8);
+  expect_percentile(h, 100, 8, 8);
+  expect_percentile(h, 110, 8, 8);
+
+  /* test monotonicity */
+  last = 0.0;
+  for (i = 0; i < 100.0; i += 0.01) {
+    cur = gpr_hdr_histogram_percentile(h, i);
+    GPR_ASSERT(cur >= last);
+    last = cur;
+  }
+
+  gpr_hdr_histogram_destroy(h);
+}
+
+static void test_merge(void) {
+  gpr_hdr_histogram *h1, *h2;
+  size_t i;
+
+  LOG_TEST();
+
+  h1 = gpr_hdr_histogram_create(0.05, 1e9);
+  gpr_hdr_histogram_add(h1, 2);
+  gpr_hdr_histogram_add(h1, 1e6);
+
+  h2 = gpr_hdr_histogram_create(0.01, 1e9);
+  GPR_ASSERT(gpr_hdr_histogram_merge(h1, h2) == 0);
+  gpr_hdr_histogram_destroy(h2);
+
+  h2 = gpr_hdr_histogram_create(0.05, 1e12);
+  GPR_ASSERT(gpr_hdr_histogram_merge(h1, h2) == 0);
+  gpr_hdr_histogram_destroy(h2);
+
+  h2 = gpr_hdr_histogram_create(0.05, 1e9);
+  gpr_hdr_histogram_add(h2, 1);
+  gpr_hdr_histogram_add(h2, 1e6);
+  gpr_hdr_histogram_add(h2, 1e8);
+  GPR_ASSERT(gpr_hdr_histogram_merge(h1, h2) == 1);
+  GPR_ASSERT(gpr_hdr_histogram_count(h1) == 5);
+  GPR_ASSERT(gpr_hdr_histogram_minimum(h1) == 1);
+  GPR_ASSERT(gpr_hdr_histogram_maximum(h1) == 1e8);
+  GPR_ASSERT(gpr_hdr_histogram_sum(h1) == 1 + 2 + 2e6 + 1e8);
+
+  /* rebuilding from the sparse buckets gives the same histogram */
+  gpr_hdr_histogram_destroy(h2);
+  h2 = gpr_hdr_histogram_create(0.05, 1e9);
+  for (i = gpr_hdr_histogram_next_nonempty_bucket(h1, 0);
+       i < gpr_hdr_histogram_num_buckets(h1);
+       i = gpr_hdr_histogram_next_nonempty_bucket(h1, i + 1)) {
+    GPR_ASSERT(gpr_hdr_histogram_add_to_bucket(
+        h2, i, gpr_hdr_histogram_bucket_count(h1, i)));
+  }
+  GPR_ASSERT(!gpr_hdr_histogram_add_to_bucket(
+      h2, gpr_hdr_histogram_num_buckets(h2), 1));
+  gpr_hdr_histogram_merge_stats(h2, gpr_hdr_histogram_sum(h1),
+                                gpr_hdr_histogram_sum_of_squares(h1),
+                                gpr_hdr_histogram_minimum(h1),
+                                gpr_hdr_histogram_maximum(h1));
+  GPR_ASSERT(gpr_hdr_histogram_count(h2) == 5);
+  GPR_ASSERT(gpr_hdr_histogram_sum(h2) == gpr_hdr_histogram_sum(h1));
+  GPR_ASSERT(gpr_hdr_histogram_minimum(h2) == 1);
+  GPR_ASSERT(gpr_hdr_histogram_maximum(h2) == 1e8);
+  GPR_ASSERT(gpr_hdr_histogram_percentile(h2, 50) ==
+             gpr_hdr_histogram_percentile(h1, 50));
+
+  gpr_hdr_histogram_destroy(h1);
+  gpr_hdr_histogram_destroy(h2);
+}
+
+#define NUM_THREADS 10
+#define NUM_ADDS_PER_THREAD 10000
+
+typedef struct {
+  gpr_hdr_histogram *h;
+  gpr_event done;
+} thd_arg;
+
+static void add_values(void *arg) {
+  thd_arg *a = arg;
+  int i;
+  for (i = 0; i < NUM_ADDS_PER_THREAD; i++) {
+    gpr_hdr_histogram_add(a->h, i);
+  }
+  gpr_event_set(&a->done, (void *)1);
+}
+
+static void test_concurrent_adds(void) {
+  thd_arg args[NUM_THREADS];
+  gpr_hdr_histogram *h;
+  gpr_thd_id id;
+  int i;
+
+  LOG_TEST();
+
+  h = gpr_hdr_histogram_create(0.01, 60e9);
+  for (i = 0; i < NUM_THREADS; i++) {
+    args[i].h = h;
+    gpr_event_init(&args[i].done);
+    GPR_ASSERT(gpr_thd_new(&id, add_values, &args[i], NULL));
+  }
+  for (i = 0; i < NUM_THREADS; i++) {
+    gpr_event_wait(&args[i].done, gpr_inf_future);
+  }
+  GPR_ASSERT(gpr_hdr_histogram_count(h) == NUM_THREADS * NUM_ADDS_PER_THREAD);
+  GPR_ASSERT(gpr_hdr_histogram_minimum(h) == 0);
+  GPR_ASSERT(gpr_hdr_histogram_maximum(h) == NUM_ADDS_PER_THREAD - 1);
+  GPR_ASSERT(gpr_hdr_histogram_sum(h) ==
+             (double)NUM_THREADS * NUM_ADDS_PER_THREAD *
+                 (NUM_ADDS_PER_THREAD - 1) / 2);
+  expect_percentile(h, 50, NUM_ADDS_PER_THREAD * 0.49,
+                    NUM_ADDS_PER_THREAD * 0.51);
+  gpr_hdr_histogram_destroy(h);
+}
+
+int main(int argc, char **argv) {
+  grpc_test_init(argc, argv);
+  test_no_op();
+  test_bucket_resolution();
+  test_simple();
+  test_exact_stats();
+  test_large_bucket_counts();
+  test_percentile();
+  test_merge();
+  test_concurrent_adds();
+  return 0;
+}
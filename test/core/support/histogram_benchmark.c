@@ -0,0 +1,277 @@
+/*
+ *
+ * Copyright 2015, Google Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer
+ * in the documentation and/or other materials provided with the
+ * distribution.
+ *     * Neither the name of Google Inc. nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+
+/*
+   Histogram benchmark.
+
+   Compares gpr_histogram with gpr_hdr_histogram on latency-like samples
+   (nanoseconds, spread log-uniformly from 10us to 100ms), using the
+   resolution and range the qps tools use:
+   - add: cost of recording one sample. gpr_histogram is not thread safe, so
+     its threads each record into their own histogram, as the qps client
+     does, and the time to merge them is included. gpr_hdr_histogram threads
+     share one histogram.
+   - merge: cost of merging one histogram of samples into another.
+   - percentile: cost of computing a percentile.
+   - memory: bytes used by a histogram, and buckets that have to be
+     serialized (all of them for gpr_histogram, non empty ones only for
+     gpr_hdr_histogram).
+ */
+
+#include <math.h>
+#include <stdio.h>
+
+#include "src/core/support/hdr_histogram.h"
+#include <grpc/support/alloc.h>
+#include <grpc/support/cmdline.h>
+#include <grpc/support/histogram.h>
+#include <grpc/support/log.h>
+#include <grpc/support/sync.h>
+#include <grpc/support/thd.h>
+#include <grpc/support/time.h>
+
+#define RESOLUTION 0.01
+#define MAX_VALUE 60e9
+#define NUM_SAMPLES 4096
+
+static double g_samples[NUM_SAMPLES];
+
+typedef struct {
+  gpr_mu mu;
+  gpr_cv done;
+  int threads_running;
+  int iterations;
+  /* one per thread for gpr_histogram, NULL when using hdr */
+  gpr_histogram **histograms;
+  gpr_hdr_histogram *hdr;
+  int next_thread;
+} benchmark_state;
+
+static void init_samples(void) {
+  gpr_uint32 seed = 12345;
+  int i;
+  for (i = 0; i < NUM_SAMPLES; i++) {
+    seed = seed * 1103515245 + 12345;
+    g_samples[i] = 1e4 * exp(log(1e4) * (seed >> 8) / (double)(1 << 24));
+  }
+}
+
+static double micros_since(gpr_timespec start) {
+  return gpr_timespec_to_micros(gpr_time_sub(gpr_now(), start));
+}
+
+static void add_thread(void *arg) {
+  benchmark_state *state = arg;
+  gpr_histogram *h = NULL;
+  int i;
+
+  gpr_mu_lock(&state->mu);
+  if (state->histograms != NULL) {
+    h = state->histograms[state->next_thread];
+  }
+  state->next_thread++;
+  gpr_mu_unlock(&state->mu);
+
+  if (h != NULL) {
+    for (i = 0; i < state->iterations; i++) {
+      gpr_histogram_add(h, g_samples[i % NUM_SAMPLES]);
+    }
+  } else {
+    for (i = 0; i < state->iterations; i++) {
+      gpr_hdr_histogram_add(state->hdr, g_samples[i % NUM_SAMPLES]);
+    }
+  }
+
+  gpr_mu_lock(&state->mu);
+  if (--state->threads_running == 0) {
+    gpr_cv_signal(&state->done);
+  }
+  gpr_mu_unlock(&state->mu);
+}
+
+static void run_add_benchmark(int use_hdr, int num_threads, int iterations) {
+  benchmark_state state;
+  gpr_timespec start_time;
+  double elapsed_micro;
+  double nops = (double)num_threads * iterations;
+  gpr_histogram *merged = NULL;
+  gpr_thd_id id;
+  int i;
+
+  gpr_mu_init(&state.mu);
+  gpr_cv_init(&state.done);
+  state.threads_running = num_threads;
+  state.iterations = iterations;
+  state.next_thread = 0;
+  state.histograms = NULL;
+  state.hdr = NULL;
+  if (use_hdr) {
+    state.hdr = gpr_hdr_histogram_create(RESOLUTION, MAX_VALUE);
+  } else {
+    state.histograms = gpr_malloc(sizeof(gpr_histogram *) * num_threads);
+    for (i = 0; i < num_threads; i++) {
+      state.histograms[i] = gpr_histogram_create(RESOLUTION, MAX_VALUE);
+    }
+  }
+
+  start_time = gpr_now();
+  for (i = 0; i < num_threads; i++) {
+    GPR_ASSERT(gpr_thd_new(&id, add_thread, &state, NULL));
+  }
+  gpr_mu_lock(&state.mu);
+  while (state.threads_running > 0) {
+    gpr_cv_wait(&state.done, &state.mu, gpr_inf_future);
+  }
+  gpr_mu_unlock(&state.mu);
+  if (use_hdr) {
+    GPR_ASSERT(gpr_hdr_histogram_count(state.hdr) == nops);
+  } else {
+    merged = gpr_histogram_create(RESOLUTION, MAX_VALUE);
+    for (i = 0; i < num_threads; i++) {
+      GPR_ASSERT(gpr_histogram_merge(merged, state.histograms[i]));
+    }
+    GPR_ASSERT(gpr_histogram_count(merged) == nops);
+  }
+  elapsed_micro = micros_since(start_time);
+
+  if (use_hdr) {
+    gpr_hdr_histogram_destroy(state.hdr);
+  } else {
+    gpr_histogram_destroy(merged);
+    for (i = 0; i < num_threads; i++) {
+      gpr_histogram_destroy(state.histograms[i]);
+    }
+    gpr_free(state.histograms);
+  }
+  gpr_cv_destroy(&state.done);
+  gpr_mu_destroy(&state.mu);
+
+  printf("add         %-5s  %2d threads  %8.1f ns/add\n",
+         use_hdr ? "hdr" : "dense", num_threads, 1000 * elapsed_micro / nops);
+}
+
+static void run_query_benchmarks(int iterations) {
+  gpr_histogram *h = gpr_histogram_create(RESOLUTION, MAX_VALUE);
+  gpr_histogram *dst = gpr_histogram_create(RESOLUTION, MAX_VALUE);
+  gpr_hdr_histogram *hdr = gpr_hdr_histogram_create(RESOLUTION, MAX_VALUE);
+  gpr_hdr_histogram *hdr_dst = gpr_hdr_histogram_create(RESOLUTION, MAX_VALUE);
+  gpr_timespec start_time;
+  double sink = 0;
+  size_t num_buckets;
+  size_t nonempty = 0;
+  size_t b;
+  int i;
+
+  for (i = 0; i < NUM_SAMPLES; i++) {
+    gpr_histogram_add(h, g_samples[i]);
+    gpr_hdr_histogram_add(hdr, g_samples[i]);
+  }
+
+  start_time = gpr_now();
+  for (i = 0; i < iterations; i++) {
+    GPR_ASSERT(gpr_histogram_merge(dst, h));
+  }
+  printf("merge       dense  %8.1f us/merge\n",
+         micros_since(start_time) / iterations);
+  start_time = gpr_now();
+  for (i = 0; i < iterations; i++) {
+    GPR_ASSERT(gpr_hdr_histogram_merge(hdr_dst, hdr));
+  }
+  printf("merge       hdr    %8.1f us/merge\n",
+         micros_since(start_time) / iterations);
+
+  start_time = gpr_now();
+  for (i = 0; i < iterations; i++) {
+    sink += gpr_histogram_percentile(h, 99);
+  }
+  printf("percentile  dense  %8.1f us/query\n",
+         micros_since(start_time) / iterations);
+  start_time = gpr_now();
+  for (i = 0; i < iterations; i++) {
+    sink += gpr_hdr_histogram_percentile(hdr, 99);
+  }
+  printf("percentile  hdr    %8.1f us/query\n",
+         micros_since(start_time) / iterations);
+  printf("p50/p99     dense  %.0f/%.0f  hdr  %.0f/%.0f\n",
+         gpr_histogram_percentile(h, 50), gpr_histogram_percentile(h, 99),
+         gpr_hdr_histogram_percentile(hdr, 50),
+         gpr_hdr_histogram_percentile(hdr, 99));
+
+  gpr_histogram_get_contents(h, &num_buckets);
+  printf("memory      dense  %8lu bytes  %6lu buckets serialized\n",
+         (unsigned long)(num_buckets * sizeof(gpr_uint32)),
+         (unsigned long)num_buckets);
+  for (b = gpr_hdr_histogram_next_nonempty_bucket(hdr, 0);
+       b < gpr_hdr_histogram_num_buckets(hdr);
+       b = gpr_hdr_histogram_next_nonempty_bucket(hdr, b + 1)) {
+    nonempty++;
+  }
+  printf("memory      hdr    %8lu bytes  %6lu buckets serialized\n",
+         (unsigned long)gpr_hdr_histogram_memory_size(hdr),
+         (unsigned long)nonempty);
+
+  gpr_histogram_destroy(h);
+  gpr_histogram_destroy(dst);
+  gpr_hdr_histogram_destroy(hdr);
+  gpr_hdr_histogram_destroy(hdr_dst);
+  GPR_ASSERT(sink > 0);
+}
+
+int main(int argc, char **argv) {
+  int max_threads = 8;
+  int iterations = 10000000;
+  int query_iterations = 1000;
+  int num_threads;
+  gpr_cmdline *cmdline = gpr_cmdline_create("histogram benchmark tool");
+
+  gpr_cmdline_add_int(cmdline, "max_threads",
+                      "Largest number of threads to run with", &max_threads);
+  gpr_cmdline_add_int(cmdline, "iterations", "Samples each thread adds",
+                      &iterations);
+  gpr_cmdline_add_int(cmdline, "query_iterations",
+                      "Merges and percentile queries to time",
+                      &query_iterations);
+  gpr_cmdline_parse(cmdline, argc, argv);
+  GPR_ASSERT(max_threads > 0 && iterations > 0 && query_iterations > 0);
+
+  init_samples();
+  for (num_threads = 1; num_threads <= max_threads; num_threads *= 2) {
+    run_add_benchmark(0, num_threads, iterations);
+    run_add_benchmark(1, num_threads, iterations);
+  }
+  run_query_benchmarks(query_iterations);
+
+  gpr_cmdline_destroy(cmdline);
+  return 0;
+}
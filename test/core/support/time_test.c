@@ -243,6 +243,41 @@ static void test_similar(void) {
                                    gpr_time_from_micros(10)));
 }
 
+static void test_clocks(void) {
+  gpr_timespec threshold = gpr_time_from_millis(100);
+  gpr_timespec prev = gpr_clock_now(GPR_CLOCK_MONOTONIC);
+  gpr_timespec now;
+  int i;
+
+  for (i = 0; i < 1000; i++) {
+    now = gpr_clock_now(GPR_CLOCK_MONOTONIC);
+    GPR_ASSERT(gpr_time_cmp(prev, now) <= 0);
+    prev = now;
+  }
+  GPR_ASSERT(gpr_time_similar(gpr_clock_now(GPR_CLOCK_REALTIME), gpr_now(),
+                              threshold));
+
+  GPR_ASSERT(gpr_time_similar(
+      gpr_clock_convert(gpr_clock_now(GPR_CLOCK_MONOTONIC),
+                        GPR_CLOCK_MONOTONIC, GPR_CLOCK_REALTIME),
+      gpr_now(), threshold));
+  GPR_ASSERT(gpr_time_similar(
+      gpr_clock_convert(gpr_now(), GPR_CLOCK_REALTIME, GPR_CLOCK_MONOTONIC),
+      gpr_clock_now(GPR_CLOCK_MONOTONIC), threshold));
+  GPR_ASSERT(0 == gpr_time_cmp(gpr_clock_convert(gpr_inf_future,
+                                                 GPR_CLOCK_REALTIME,
+                                                 GPR_CLOCK_MONOTONIC),
+                               gpr_inf_future));
+  GPR_ASSERT(0 == gpr_time_cmp(gpr_clock_convert(gpr_inf_past,
+                                                 GPR_CLOCK_MONOTONIC,
+                                                 GPR_CLOCK_REALTIME),
+                               gpr_inf_past));
+  now = gpr_time_from_seconds(12345);
+  GPR_ASSERT(0 == gpr_time_cmp(gpr_clock_convert(now, GPR_CLOCK_MONOTONIC,
+                                                 GPR_CLOCK_MONOTONIC),
+                               now));
+}
+
 int main(int argc, char *argv[]) {
   grpc_test_init(argc, argv);
 
@@ -251,5 +286,6 @@ int main(int argc, char *argv[]) {
   test_overflow();
   test_sticky_infinities();
   test_similar();
+  test_clocks();
   return 0;
 }
@@ -65,6 +65,16 @@ int main(int argc, char **argv) {
   GPR_ASSERT(call);
   cqv = cq_verifier_create(cq);
 
+  /* a lame channel can never connect, and a watch on any other state sees
+     that straight away */
+  GPR_ASSERT(grpc_channel_check_connectivity_state(chan, 1) ==
+             GRPC_CHANNEL_FATAL_FAILURE);
+  grpc_channel_watch_connectivity_state(chan, GRPC_CHANNEL_READY,
+                                        GRPC_TIMEOUT_SECONDS_TO_DEADLINE(100),
+                                        cq, tag(2));
+  cq_expect_completion(cqv, tag(2), GRPC_OP_OK);
+  cq_verify(cqv);
+
   op = ops;
   op->op = GRPC_OP_SEND_INITIAL_METADATA;
   op->data.send_initial_metadata.count = 0;
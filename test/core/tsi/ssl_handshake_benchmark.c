@@ -0,0 +1,284 @@
+/*
+ *
+ * Copyright 2015, Google Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer
+ * in the documentation and/or other materials provided with the
+ * distribution.
+ *     * Neither the name of Google Inc. nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/*
+   TLS handshake rate benchmark.
+
+   Measures how many handshakes per second a client and a server can complete
+   over loopback TCP, with full handshakes and with handshakes resuming a
+   cached session (session tickets). Each handshake uses a new connection.
+   Uses the test credentials in src/core/tsi/test_creds by default.
+ */
+
+#include <netinet/in.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "src/core/support/file.h"
+#include "src/core/support/string.h"
+#include "src/core/tsi/ssl_transport_security.h"
+#include <grpc/support/alloc.h>
+#include <grpc/support/cmdline.h>
+#include <grpc/support/log.h>
+#include <grpc/support/slice.h>
+#include <grpc/support/sync.h>
+#include <grpc/support/thd.h>
+#include <grpc/support/time.h>
+
+/* Matches the *.test.google.fr SAN of server1.pem. */
+#define SERVER_NAME "foo.test.google.fr"
+
+typedef struct {
+  gpr_slice ca_cert;
+  gpr_slice server_key;
+  gpr_slice server_cert;
+} creds;
+
+typedef struct {
+  tsi_ssl_handshaker_factory *factory;
+  int listen_fd;
+  int num_handshakes;
+  int num_failures;
+  gpr_event done;
+} server_args;
+
+static gpr_slice load_creds_file(const char *dir, const char *name) {
+  char *path;
+  int success;
+  gpr_slice slice;
+  gpr_asprintf(&path, "%s/%s", dir, name);
+  slice = gpr_load_file(path, 0, &success);
+  if (!success) {
+    gpr_log(GPR_ERROR, "Could not load %s.", path);
+    abort();
+  }
+  gpr_free(path);
+  return slice;
+}
+
+static int create_listener(int *port) {
+  struct sockaddr_in addr;
+  socklen_t len = sizeof(addr);
+  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  GPR_ASSERT(fd >= 0);
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  GPR_ASSERT(bind(fd, (struct sockaddr *)&addr, sizeof(addr)) == 0);
+  GPR_ASSERT(listen(fd, 128) == 0);
+  GPR_ASSERT(getsockname(fd, (struct sockaddr *)&addr, &len) == 0);
+  *port = ntohs(addr.sin_port);
+  return fd;
+}
+
+static int connect_to(int port) {
+  struct sockaddr_in addr;
+  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  GPR_ASSERT(fd >= 0);
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  addr.sin_port = htons(port);
+  GPR_ASSERT(connect(fd, (struct sockaddr *)&addr, sizeof(addr)) == 0);
+  return fd;
+}
+
+static int write_all(int fd, const unsigned char *buf, size_t size) {
+  while (size > 0) {
+    ssize_t written = write(fd, buf, size);
+    if (written <= 0) return 0;
+    buf += written;
+    size -= (size_t)written;
+  }
+  return 1;
+}
+
+/* Drives handshaker to completion over the blocking socket fd. */
+static int do_handshake(tsi_handshaker *handshaker, int fd) {
+  unsigned char buf[4096];
+  size_t size;
+  ssize_t bytes_read;
+  tsi_result result;
+  for (;;) {
+    do {
+      size = sizeof(buf);
+      result = tsi_handshaker_get_bytes_to_send_to_peer(handshaker, buf, &size);
+      if (size > 0 && !write_all(fd, buf, size)) return 0;
+    } while (result == TSI_INCOMPLETE_DATA);
+    if (result != TSI_OK) return 0;
+    if (!tsi_handshaker_is_in_progress(handshaker)) break;
+    bytes_read = read(fd, buf, sizeof(buf));
+    if (bytes_read <= 0) return 0;
+    size = (size_t)bytes_read;
+    result = tsi_handshaker_process_bytes_from_peer(handshaker, buf, &size);
+    if (result != TSI_OK && result != TSI_INCOMPLETE_DATA) return 0;
+  }
+  return tsi_handshaker_get_result(handshaker) == TSI_OK;
+}
+
+static int session_was_reused(tsi_handshaker *handshaker) {
+  tsi_peer peer;
+  const tsi_peer_property *property;
+  int reused;
+  GPR_ASSERT(tsi_handshaker_extract_peer(handshaker, &peer) == TSI_OK);
+  property =
+      tsi_peer_get_property_by_name(&peer, TSI_SSL_SESSION_REUSED_PEER_PROPERTY);
+  GPR_ASSERT(property != NULL);
+  reused = strncmp(property->value.string.data, "true",
+                   property->value.string.length) == 0;
+  tsi_peer_destruct(&peer);
+  return reused;
+}
+
+static void server_thread(void *arg) {
+  server_args *args = arg;
+  int i;
+  for (i = 0; i < args->num_handshakes; i++) {
+    tsi_handshaker *handshaker;
+    int fd = accept(args->listen_fd, NULL, NULL);
+    GPR_ASSERT(fd >= 0);
+    GPR_ASSERT(tsi_ssl_handshaker_factory_create_handshaker(
+                   args->factory, NULL, &handshaker) == TSI_OK);
+    if (!do_handshake(handshaker, fd)) args->num_failures++;
+    tsi_handshaker_destroy(handshaker);
+    close(fd);
+  }
+  gpr_event_set(&args->done, (void *)1);
+}
+
+/* Runs num_handshakes handshakes and returns the number of them that resumed a
+   session. */
+static int run_handshakes(tsi_ssl_handshaker_factory *client_factory,
+                          tsi_ssl_handshaker_factory *server_factory,
+                          int num_handshakes) {
+  server_args args;
+  gpr_thd_id id;
+  int port;
+  int i;
+  int reused = 0;
+
+  args.factory = server_factory;
+  args.listen_fd = create_listener(&port);
+  args.num_handshakes = num_handshakes;
+  args.num_failures = 0;
+  gpr_event_init(&args.done);
+  GPR_ASSERT(gpr_thd_new(&id, server_thread, &args, NULL));
+
+  for (i = 0; i < num_handshakes; i++) {
+    tsi_handshaker *handshaker;
+    int fd = connect_to(port);
+    GPR_ASSERT(tsi_ssl_handshaker_factory_create_handshaker(
+                   client_factory, SERVER_NAME, &handshaker) == TSI_OK);
+    GPR_ASSERT(do_handshake(handshaker, fd));
+    reused += session_was_reused(handshaker);
+    tsi_handshaker_destroy(handshaker);
+    close(fd);
+  }
+
+  GPR_ASSERT(gpr_event_wait(&args.done, gpr_inf_future));
+  GPR_ASSERT(args.num_failures == 0);
+  close(args.listen_fd);
+  return reused;
+}
+
+static void run_benchmark(const char *name, const creds *c,
+                          int num_handshakes, int resume) {
+  const unsigned char *server_key = GPR_SLICE_START_PTR(c->server_key);
+  const unsigned char *server_cert = GPR_SLICE_START_PTR(c->server_cert);
+  size_t server_key_size = GPR_SLICE_LENGTH(c->server_key);
+  size_t server_cert_size = GPR_SLICE_LENGTH(c->server_cert);
+  tsi_ssl_session_cache *cache = NULL;
+  tsi_ssl_handshaker_factory *client_factory;
+  tsi_ssl_handshaker_factory *server_factory;
+  gpr_timespec start;
+  double elapsed;
+  int reused;
+
+  if (resume) cache = tsi_ssl_session_cache_create(1);
+  GPR_ASSERT(tsi_create_ssl_client_handshaker_factory(
+                 NULL, 0, NULL, 0, GPR_SLICE_START_PTR(c->ca_cert),
+                 GPR_SLICE_LENGTH(c->ca_cert), NULL, NULL, NULL, 0, cache,
+                 &client_factory) == TSI_OK);
+  GPR_ASSERT(tsi_create_ssl_server_handshaker_factory(
+                 &server_key, &server_key_size, &server_cert,
+                 &server_cert_size, 1, NULL, 0, NULL, NULL, NULL, 0, 3600,
+                 &server_factory) == TSI_OK);
+
+  /* Warm up, which also populates the session cache. */
+  run_handshakes(client_factory, server_factory, 1);
+
+  start = gpr_now();
+  reused = run_handshakes(client_factory, server_factory, num_handshakes);
+  elapsed = gpr_timespec_to_micros(gpr_time_sub(gpr_now(), start)) / 1e6;
+
+  gpr_log(GPR_INFO, "%s: %d handshakes in %.3fs, %.1f handshakes/s, %d resumed",
+          name, num_handshakes, elapsed, num_handshakes / elapsed, reused);
+  GPR_ASSERT(reused == (resume ? num_handshakes : 0));
+
+  tsi_ssl_handshaker_factory_destroy(client_factory);
+  tsi_ssl_handshaker_factory_destroy(server_factory);
+  tsi_ssl_session_cache_unref(cache);
+}
+
+int main(int argc, char **argv) {
+  char *creds_dir = "src/core/tsi/test_creds";
+  int num_handshakes = 1000;
+  creds c;
+  gpr_cmdline *cmdline =
+      gpr_cmdline_create("ssl_handshake_benchmark handshake rate tool");
+
+  gpr_cmdline_add_string(cmdline, "creds_dir",
+                         "Directory holding ca.pem, server1.pem and "
+                         "server1.key",
+                         &creds_dir);
+  gpr_cmdline_add_int(cmdline, "handshakes", "Number of handshakes per run",
+                      &num_handshakes);
+  gpr_cmdline_parse(cmdline, argc, argv);
+  GPR_ASSERT(num_handshakes > 0);
+
+  c.ca_cert = load_creds_file(creds_dir, "ca.pem");
+  c.server_key = load_creds_file(creds_dir, "server1.key");
+  c.server_cert = load_creds_file(creds_dir, "server1.pem");
+
+  run_benchmark("full", &c, num_handshakes, 0);
+  run_benchmark("resumed", &c, num_handshakes, 1);
+
+  gpr_slice_unref(c.ca_cert);
+  gpr_slice_unref(c.server_key);
+  gpr_slice_unref(c.server_cert);
+  gpr_cmdline_destroy(cmdline);
+  return 0;
+}
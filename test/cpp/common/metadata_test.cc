@@ -0,0 +1,176 @@
+/*
+ *
+ * Copyright 2015, Google Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer
+ * in the documentation and/or other materials provided with the
+ * distribution.
+ *     * Neither the name of Google Inc. nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+
+#include <grpc++/metadata.h>
+
+#include <grpc/grpc.h>
+#include <gtest/gtest.h>
+
+namespace grpc {
+namespace testing {
+
+namespace {
+grpc_metadata MakeMetadata(const char* key, const char* value) {
+  grpc_metadata md;
+  md.key = key;
+  md.value = value;
+  md.value_length = strlen(value);
+  return md;
+}
+}  // namespace
+
+TEST(StringRefTest, Compare) {
+  grpc::string s("abc");
+  string_ref ref(s);
+  EXPECT_EQ(ref, "abc");
+  EXPECT_EQ(grpc::string("abc"), ref);
+  EXPECT_NE(ref, "ab");
+  EXPECT_LT(string_ref("ab"), ref);
+  EXPECT_GT(string_ref("abd"), ref);
+  EXPECT_TRUE(ref.starts_with("ab"));
+  EXPECT_EQ(static_cast<size_t>(2), ref.find('c'));
+  EXPECT_EQ(string_ref::npos, ref.find('d'));
+  EXPECT_EQ("bc", ref.substr(1));
+  EXPECT_EQ(s, ref.ToString());
+  EXPECT_TRUE(string_ref().empty());
+}
+
+TEST(MetadataMapTest, FillRefersToReceivedBytes) {
+  // Values are not NUL terminated on the wire.
+  const char value[] = {'v', '1', 'x'};
+  grpc_metadata md[3];
+  md[0] = MakeMetadata("k1", "");
+  md[0].value = value;
+  md[0].value_length = 2;
+  md[1] = MakeMetadata("k2", "v2");
+  md[2] = MakeMetadata("k1", "v3");
+
+  MetadataMap map;
+  EXPECT_TRUE(map.empty());
+  map.Fill(md, 3);
+  EXPECT_EQ(static_cast<size_t>(3), map.size());
+  auto it = map.find("k1");
+  ASSERT_TRUE(it != map.end());
+  EXPECT_EQ("v1", it->second);
+  EXPECT_EQ(value, it->second.data());
+  EXPECT_EQ("v2", map.find("k2")->second);
+  EXPECT_TRUE(map.find("k3") == map.end());
+  EXPECT_EQ(static_cast<size_t>(2), map.count("k1"));
+  EXPECT_EQ(static_cast<size_t>(0), map.count("k"));
+
+  // Copies share the referenced bytes.
+  MetadataMap copy = map;
+  EXPECT_EQ(map.begin()->first.data(), copy.begin()->first.data());
+
+  map.Fill(md + 1, 1);
+  EXPECT_EQ(static_cast<size_t>(1), map.size());
+  EXPECT_TRUE(map.find("k1") == map.end());
+}
+
+TEST(OutgoingMetadataTest, Fill) {
+  OutgoingMetadata metadata;
+  EXPECT_TRUE(metadata.empty());
+  EXPECT_TRUE(metadata.Fill() == nullptr);
+
+  grpc::string key("key0");
+  metadata.Add(key, grpc::string("va\0ue", 5));
+  // Clear key early to make sure metadata takes a copy
+  key = "";
+  metadata.Add("key1", "");
+  EXPECT_EQ(static_cast<size_t>(2), metadata.size());
+
+  grpc_metadata* md = metadata.Fill();
+  ASSERT_TRUE(md != nullptr);
+  EXPECT_STREQ("key0", md[0].key);
+  EXPECT_EQ(grpc::string("va\0ue", 5),
+            grpc::string(md[0].value, md[0].value_length));
+  EXPECT_STREQ("key1", md[1].key);
+  EXPECT_EQ(static_cast<size_t>(0), md[1].value_length);
+}
+
+TEST(OutgoingMetadataTest, ConstantEntriesComeFirst) {
+  OutgoingMetadata constant;
+  constant.Add("c0", "x");
+  constant.Add("c1", "y");
+
+  OutgoingMetadata metadata;
+  metadata.Add("key", "value");
+  metadata.set_constant(&constant);
+  EXPECT_EQ(static_cast<size_t>(3), metadata.size());
+
+  grpc_metadata* md = metadata.Fill();
+  EXPECT_STREQ("c0", md[0].key);
+  EXPECT_STREQ("c1", md[1].key);
+  EXPECT_EQ("y", string_ref(md[1].value, md[1].value_length));
+  EXPECT_STREQ("key", md[2].key);
+  EXPECT_EQ("value", string_ref(md[2].value, md[2].value_length));
+
+  // The constant entries are not copied.
+  grpc_metadata* constant_md = constant.Fill();
+  EXPECT_EQ(constant_md[0].key, md[0].key);
+
+  // Only constant entries.
+  OutgoingMetadata empty;
+  empty.set_constant(&constant);
+  EXPECT_FALSE(empty.empty());
+  md = empty.Fill();
+  EXPECT_EQ(static_cast<size_t>(2), empty.size());
+  EXPECT_STREQ("c1", md[1].key);
+}
+
+TEST(OutgoingMetadataTest, CopyDoesNotShareStorage) {
+  OutgoingMetadata metadata;
+  metadata.Add("key", "value");
+  grpc_metadata* md = metadata.Fill();
+
+  OutgoingMetadata copy;
+  copy.Add("other", "x");
+  copy = metadata;
+  EXPECT_EQ(static_cast<size_t>(1), copy.size());
+  grpc_metadata* copy_md = copy.Fill();
+  EXPECT_STREQ("key", copy_md[0].key);
+  EXPECT_EQ("value", string_ref(copy_md[0].value, copy_md[0].value_length));
+  EXPECT_NE(md[0].key, copy_md[0].key);
+
+  OutgoingMetadata constructed(metadata);
+  EXPECT_STREQ("key", constructed.Fill()[0].key);
+}
+
+}  // namespace testing
+}  // namespace grpc
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
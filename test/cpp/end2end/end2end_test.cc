@@ -31,6 +31,8 @@
  *
  */
 
+#include <condition_variable>
+#include <mutex>
 #include <thread>
 
 #include "test/core/util/port.h"
@@ -190,11 +192,12 @@ class End2endTest : public ::testing::Test {
   void TearDown() GRPC_OVERRIDE { server_->Shutdown(); }
 
   void ResetStub() {
-    std::shared_ptr<ChannelInterface> channel = CreateChannel(
-        server_address_.str(), InsecureCredentials(), ChannelArguments());
-    stub_ = std::move(grpc::cpp::test::util::TestService::NewStub(channel));
+    channel_ = CreateChannel(server_address_.str(), InsecureCredentials(),
+                             ChannelArguments());
+    stub_ = std::move(grpc::cpp::test::util::TestService::NewStub(channel_));
   }
 
+  std::shared_ptr<ChannelInterface> channel_;
   std::unique_ptr<grpc::cpp::test::util::TestService::Stub> stub_;
   std::unique_ptr<Server> server_;
   std::ostringstream server_address_;
@@ -543,6 +546,30 @@ TEST_F(End2endTest, ClientCancelsResponseStream) {
   EXPECT_GE(grpc::StatusCode::CANCELLED, s.code());
 }
 
+// Client drops a response stream before reading it to the end
+TEST_F(End2endTest, ClientDestroysResponseStreamBeforeFinish) {
+  ResetStub();
+  EchoRequest request;
+  EchoResponse response;
+  ClientContext context;
+  request.set_message("hello");
+
+  auto stream = stub_->ResponseStream(&context, request);
+  EXPECT_TRUE(stream->Read(&response));
+  EXPECT_EQ(response.message(), request.message() + "0");
+  stream.reset();
+
+  // The channel is still usable.
+  ClientContext context2;
+  stream = stub_->ResponseStream(&context2, request);
+  EXPECT_TRUE(stream->Read(&response));
+  EXPECT_EQ(response.message(), request.message() + "0");
+  EXPECT_TRUE(stream->Read(&response));
+  EXPECT_TRUE(stream->Read(&response));
+  EXPECT_FALSE(stream->Read(&response));
+  EXPECT_TRUE(stream->Finish().IsOk());
+}
+
 // Client cancels bidi stream after sending some messages
 TEST_F(End2endTest, ClientCancelsBidi) {
   ResetStub();
@@ -576,6 +603,15 @@ TEST_F(End2endTest, ClientCancelsBidi) {
   EXPECT_EQ(grpc::StatusCode::CANCELLED, s.code());
 }
 
+TEST_F(End2endTest, ConnectBeforeFirstRpc) {
+  ResetStub();
+  EXPECT_EQ(GRPC_CHANNEL_IDLE, channel_->GetState(false));
+  EXPECT_TRUE(channel_->WaitForReady(std::chrono::system_clock::now() +
+                                     std::chrono::seconds(10)));
+  EXPECT_EQ(GRPC_CHANNEL_READY, channel_->GetState(false));
+  SendRpc(stub_.get(), 1);
+}
+
 TEST_F(End2endTest, ThreadStress) {
   ResetStub();
   std::vector<std::thread*> threads;
@@ -588,6 +624,229 @@ TEST_F(End2endTest, ThreadStress) {
   }
 }
 
+// Echo calls with the message "wait" block until Open() is called.
+class GatedTestServiceImpl
+    : public ::grpc::cpp::test::util::TestService::Service {
+ public:
+  GatedTestServiceImpl() : waiting_(0), open_(false) {}
+
+  Status Echo(ServerContext* context, const EchoRequest* request,
+              EchoResponse* response) GRPC_OVERRIDE {
+    if (request->message() == "wait") {
+      std::unique_lock<std::mutex> lock(mu_);
+      waiting_++;
+      cv_.notify_all();
+      while (!open_) {
+        cv_.wait(lock);
+      }
+    }
+    response->set_message(request->message());
+    return Status::OK;
+  }
+
+  void WaitForCalls(int calls) {
+    std::unique_lock<std::mutex> lock(mu_);
+    while (waiting_ < calls) {
+      cv_.wait(lock);
+    }
+  }
+
+  void Open() {
+    std::lock_guard<std::mutex> lock(mu_);
+    open_ = true;
+    cv_.notify_all();
+  }
+
+ private:
+  std::mutex mu_;
+  std::condition_variable cv_;
+  int waiting_;
+  bool open_;
+};
+
+static void SendWaitingRpc(grpc::cpp::test::util::TestService::Stub* stub) {
+  EchoRequest request;
+  EchoResponse response;
+  ClientContext context;
+  request.set_message("wait");
+  Status s = stub->Echo(&context, request, &response);
+  EXPECT_TRUE(s.IsOk());
+  EXPECT_EQ("wait", response.message());
+}
+
+// A sync server that keeps several calls per method requested from the core
+// serves concurrent calls, and Shutdown() lets the calls in flight finish and
+// releases the requests that never got a call.
+TEST(SyncRequestDepthTest, ConcurrentRpcsAndShutdown) {
+  const int kThreads = 4;
+  int port = grpc_pick_unused_port_or_die();
+  std::ostringstream server_address;
+  server_address << "localhost:" << port;
+  GatedTestServiceImpl service;
+  ThreadPool thread_pool(kThreads);
+  ServerBuilder builder;
+  builder.AddListeningPort(server_address.str(), InsecureServerCredentials());
+  builder.RegisterService(&service);
+  builder.SetThreadPool(&thread_pool);
+  builder.SetSyncRequestDepth(8);
+  std::unique_ptr<Server> server = builder.BuildAndStart();
+  std::shared_ptr<ChannelInterface> channel = CreateChannel(
+      server_address.str(), InsecureCredentials(), ChannelArguments());
+  std::unique_ptr<grpc::cpp::test::util::TestService::Stub> stub(
+      grpc::cpp::test::util::TestService::NewStub(channel));
+
+  std::vector<std::thread*> threads;
+  for (int i = 0; i < 20; ++i) {
+    threads.push_back(new std::thread(SendRpc, stub.get(), 50));
+  }
+  for (size_t i = 0; i < threads.size(); ++i) {
+    threads[i]->join();
+    delete threads[i];
+  }
+  threads.clear();
+
+  // Occupy every server thread, then shut down while the calls are running.
+  for (int i = 0; i < kThreads; ++i) {
+    threads.push_back(new std::thread(SendWaitingRpc, stub.get()));
+  }
+  service.WaitForCalls(kThreads);
+  std::thread shutdown([&server]() { server->Shutdown(); });
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  service.Open();
+  for (size_t i = 0; i < threads.size(); ++i) {
+    threads[i]->join();
+    delete threads[i];
+  }
+  shutdown.join();
+}
+
+class CallbackTestServiceImpl
+    : public ::grpc::cpp::test::util::TestService::CallbackService {
+ public:
+  void Echo(ServerContext* context, const EchoRequest* request,
+            EchoResponse* response,
+            ServerUnaryReactor* reactor) GRPC_OVERRIDE {
+    if (request->message() == "later") {
+      // Finish from another thread after the handler has returned.
+      std::thread([response, reactor]() {
+        response->set_message("later");
+        reactor->Finish(Status::OK);
+      }).detach();
+      return;
+    }
+    response->set_message(request->message());
+    reactor->Finish(Status::OK);
+  }
+};
+
+TEST(CallbackServiceTest, UnaryRpcs) {
+  int port = grpc_pick_unused_port_or_die();
+  std::ostringstream server_address;
+  server_address << "localhost:" << port;
+  CallbackTestServiceImpl service;
+  ServerBuilder builder;
+  builder.AddListeningPort(server_address.str(), InsecureServerCredentials());
+  builder.RegisterCallbackService(&service);
+  builder.SetCallbackThreads(2);
+  std::unique_ptr<Server> server = builder.BuildAndStart();
+  std::shared_ptr<ChannelInterface> channel = CreateChannel(
+      server_address.str(), InsecureCredentials(), ChannelArguments());
+  std::unique_ptr<grpc::cpp::test::util::TestService::Stub> stub(
+      grpc::cpp::test::util::TestService::NewStub(channel));
+
+  SendRpc(stub.get(), 10);
+
+  EchoRequest request;
+  EchoResponse response;
+  request.set_message("later");
+  {
+    ClientContext context;
+    Status s = stub->Echo(&context, request, &response);
+    EXPECT_TRUE(s.IsOk());
+    EXPECT_EQ("later", response.message());
+  }
+
+  // Methods without a callback handler are unimplemented.
+  {
+    ClientContext context;
+    std::unique_ptr<ClientReader<EchoResponse>> stream =
+        stub->ResponseStream(&context, request);
+    EXPECT_FALSE(stream->Read(&response));
+    EXPECT_EQ(grpc::StatusCode::UNIMPLEMENTED, stream->Finish().code());
+  }
+
+  // Callback form of the client stub.
+  std::mutex mu;
+  std::condition_variable cv;
+  bool done = false;
+  Status status;
+  ClientContext context;
+  request.set_message("Hello");
+  response.Clear();
+  stub->Echo(&context, request, &response, [&](Status s) {
+    std::lock_guard<std::mutex> lock(mu);
+    status = s;
+    done = true;
+    cv.notify_one();
+  });
+  {
+    std::unique_lock<std::mutex> lock(mu);
+    while (!done) {
+      cv.wait(lock);
+    }
+  }
+  EXPECT_TRUE(status.IsOk());
+  EXPECT_EQ("Hello", response.message());
+
+  server->Shutdown();
+}
+
+// The callback of the last call drops the last reference to the channel, so
+// the channel is destroyed on one of its own callback threads.
+TEST(CallbackServiceTest, CallbackDestroysChannel) {
+  int port = grpc_pick_unused_port_or_die();
+  std::ostringstream server_address;
+  server_address << "localhost:" << port;
+  CallbackTestServiceImpl service;
+  ServerBuilder builder;
+  builder.AddListeningPort(server_address.str(), InsecureServerCredentials());
+  builder.RegisterCallbackService(&service);
+  std::unique_ptr<Server> server = builder.BuildAndStart();
+
+  for (int i = 0; i < 10; i++) {
+    std::shared_ptr<ChannelInterface> channel = CreateChannel(
+        server_address.str(), InsecureCredentials(), ChannelArguments());
+    grpc::cpp::test::util::TestService::Stub* stub =
+        grpc::cpp::test::util::TestService::NewStub(channel).release();
+    channel.reset();
+
+    std::mutex mu;
+    std::condition_variable cv;
+    bool done = false;
+    Status status;
+    ClientContext* context = new ClientContext;
+    EchoRequest request;
+    EchoResponse response;
+    request.set_message("Hello");
+    stub->Echo(context, request, &response, [&](Status s) {
+      delete context;
+      delete stub;
+      std::lock_guard<std::mutex> lock(mu);
+      status = s;
+      done = true;
+      cv.notify_one();
+    });
+    std::unique_lock<std::mutex> lock(mu);
+    while (!done) {
+      cv.wait(lock);
+    }
+    EXPECT_TRUE(status.IsOk());
+    EXPECT_EQ("Hello", response.message());
+  }
+
+  server->Shutdown();
+}
+
 }  // namespace testing
 }  // namespace grpc
 
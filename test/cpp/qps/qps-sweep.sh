@@ -12,10 +12,13 @@ for channels in 1 2 4 8
 do
   for client in SYNCHRONOUS_CLIENT ASYNC_CLIENT
   do
-    for server in SYNCHRONOUS_SERVER ASYNC_SERVER
+    for server in SYNCHRONOUS_SERVER ASYNC_SERVER CALLBACK_SERVER
     do
       for rpc in UNARY STREAMING
       do
+        if [ $server = CALLBACK_SERVER -a $rpc = STREAMING ]; then
+          continue
+        fi
         echo "Test $rpc $client $server , $channels channels"
         "$bins"/opt/qps_driver --rpc_type=$rpc \
           --client_type=$client --server_type=$server
@@ -52,6 +52,10 @@ DEFINE_string(rpc_type, "UNARY", "Type of RPC: UNARY or STREAMING");
 // Server config
 DEFINE_int32(server_threads, 1, "Number of server threads");
 DEFINE_string(server_type, "SYNCHRONOUS_SERVER", "Server type");
+DEFINE_bool(server_cache_responses, false,
+            "Serve unary responses from a pre-serialized response cache");
+DEFINE_int32(server_sync_request_depth, 1,
+             "Calls of each method the sync server requests ahead of time");
 
 // Client config
 DEFINE_int32(outstanding_rpcs_per_channel, 1,
@@ -93,6 +97,8 @@ int main(int argc, char** argv) {
   server_config.set_server_type(server_type);
   server_config.set_threads(FLAGS_server_threads);
   server_config.set_enable_ssl(FLAGS_enable_ssl);
+  server_config.set_cache_responses(FLAGS_server_cache_responses);
+  server_config.set_sync_request_depth(FLAGS_server_sync_request_depth);
 
   auto result = RunScenario(client_config, FLAGS_num_clients,
                             server_config, FLAGS_num_servers,
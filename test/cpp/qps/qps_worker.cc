@@ -80,6 +80,8 @@ std::unique_ptr<Server> CreateServer(const ServerConfig& config, int server_port
       return CreateSynchronousServer(config, server_port);
     case ServerType::ASYNC_SERVER:
       return CreateAsyncServer(config, server_port);
+    case ServerType::CALLBACK_SERVER:
+      return CreateCallbackServer(config, server_port);
   }
   abort();
 }
@@ -77,6 +77,8 @@ class Server {
 std::unique_ptr<Server> CreateSynchronousServer(const ServerConfig& config,
                                                 int port);
 std::unique_ptr<Server> CreateAsyncServer(const ServerConfig& config, int port);
+std::unique_ptr<Server> CreateCallbackServer(const ServerConfig& config,
+                                             int port);
 
 }  // namespace testing
 }  // namespace grpc
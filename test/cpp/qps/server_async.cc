@@ -44,6 +44,7 @@
 #include <grpc/support/host_port.h>
 #include <grpc++/async_unary_call.h>
 #include <grpc++/config.h>
+#include <grpc++/response_cache.h>
 #include <grpc++/server.h>
 #include <grpc++/server_builder.h>
 #include <grpc++/server_context.h>
@@ -77,6 +78,10 @@ class AsyncQpsServerTest : public Server {
 
     server_ = builder.BuildAndStart();
 
+    if (config.cache_responses()) {
+      cache_.reset(new ResponseCache(gpr_time_from_seconds(1), 1000));
+    }
+
     using namespace std::placeholders;
     request_unary_ = std::bind(&TestService::AsyncService::RequestUnaryCall,
                                &async_service_, _1, _2, _3, &srv_cq_, _4);
@@ -86,7 +91,7 @@ class AsyncQpsServerTest : public Server {
     for (int i = 0; i < 100; i++) {
       contexts_.push_front(
           new ServerRpcContextUnaryImpl<SimpleRequest, SimpleResponse>(
-              request_unary_, ProcessRPC));
+              request_unary_, ProcessRPC, cache_.get()));
       contexts_.push_front(
           new ServerRpcContextStreamingImpl<SimpleRequest, SimpleResponse>(
               request_streaming_, ProcessRPC));
@@ -150,10 +155,12 @@ class AsyncQpsServerTest : public Server {
                            grpc::ServerAsyncResponseWriter<ResponseType>*,
                            void*)> request_method,
         std::function<grpc::Status(const RequestType*, ResponseType*)>
-            invoke_method)
+            invoke_method,
+        ResponseCache* cache)
         : next_state_(&ServerRpcContextUnaryImpl::invoker),
           request_method_(request_method),
           invoke_method_(invoke_method),
+          cache_(cache),
           response_writer_(&srv_ctx_) {
       request_method_(&srv_ctx_, &req_, &response_writer_,
                       AsyncQpsServerTest::tag(this));
@@ -179,14 +186,30 @@ class AsyncQpsServerTest : public Server {
         return false;
       }
 
+      next_state_ = &ServerRpcContextUnaryImpl::finisher;
+
+      // Send a cached response as is
+      ByteBuffer serialized;
+      if (cache_ && cache_->Lookup(req_, &serialized)) {
+        response_writer_.FinishSerialized(serialized, Status::OK,
+                                          AsyncQpsServerTest::tag(this));
+        return true;
+      }
+
       ResponseType response;
 
       // Call the RPC processing function
       grpc::Status status = invoke_method_(&req_, &response);
 
       // Have the response writer work and invoke on_finish when done
-      next_state_ = &ServerRpcContextUnaryImpl::finisher;
-      response_writer_.Finish(response, status, AsyncQpsServerTest::tag(this));
+      if (cache_ && status.IsOk() &&
+          cache_->Insert(req_, response, &serialized)) {
+        response_writer_.FinishSerialized(serialized, status,
+                                          AsyncQpsServerTest::tag(this));
+      } else {
+        response_writer_.Finish(response, status,
+                                AsyncQpsServerTest::tag(this));
+      }
       return true;
     }
     ServerContext srv_ctx_;
@@ -197,6 +220,7 @@ class AsyncQpsServerTest : public Server {
         request_method_;
     std::function<grpc::Status(const RequestType*, ResponseType*)>
         invoke_method_;
+    ResponseCache* const cache_;
     grpc::ServerAsyncResponseWriter<ResponseType> response_writer_;
   };
 
@@ -290,6 +314,7 @@ class AsyncQpsServerTest : public Server {
     }
     return Status::OK;
   }
+  std::unique_ptr<ResponseCache> cache_;
   CompletionQueue srv_cq_;
   TestService::AsyncService async_service_;
   std::vector<std::thread> threads_;
@@ -92,10 +92,11 @@ class TestServiceImpl GRPC_FINAL : public TestService::Service {
 class SynchronousServer GRPC_FINAL : public grpc::testing::Server {
  public:
   SynchronousServer(const ServerConfig& config, int port)
-      : thread_pool_(config.threads()), impl_(MakeImpl(port)) {}
+      : thread_pool_(config.threads()), impl_(MakeImpl(config, port)) {}
 
  private:
-  std::unique_ptr<grpc::Server> MakeImpl(int port) {
+  std::unique_ptr<grpc::Server> MakeImpl(const ServerConfig& config,
+                                         int port) {
     ServerBuilder builder;
 
     char* server_address = NULL;
@@ -106,6 +107,7 @@ class SynchronousServer GRPC_FINAL : public grpc::testing::Server {
     builder.RegisterService(&service_);
 
     builder.SetThreadPool(&thread_pool_);
+    builder.SetSyncRequestDepth(config.sync_request_depth());
 
     return builder.BuildAndStart();
   }
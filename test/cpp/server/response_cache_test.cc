@@ -0,0 +1,112 @@
+/*
+ *
+ * Copyright 2015, Google Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer
+ * in the documentation and/or other materials provided with the
+ * distribution.
+ *     * Neither the name of Google Inc. nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include <grpc++/response_cache.h>
+
+#include <vector>
+
+#include <grpc/grpc.h>
+#include <grpc++/slice.h>
+#include <gtest/gtest.h>
+
+namespace grpc {
+namespace testing {
+
+namespace {
+
+ByteBuffer MakeBuffer(const char* bytes) {
+  Slice slice(gpr_slice_from_copied_string(bytes), Slice::STEAL_REF);
+  return ByteBuffer(&slice, 1);
+}
+
+grpc::string BufferToString(ByteBuffer* buffer) {
+  std::vector<Slice> slices;
+  buffer->Dump(&slices);
+  grpc::string result;
+  for (auto s = slices.begin(); s != slices.end(); s++) {
+    result.append(reinterpret_cast<const char*>(s->begin()), s->size());
+  }
+  return result;
+}
+
+}  // namespace
+
+TEST(ByteBufferTest, CopySharesContents) {
+  ByteBuffer original = MakeBuffer("response");
+  ByteBuffer copy(original);
+  ByteBuffer assigned;
+  assigned = copy;
+  original.Clear();
+  EXPECT_EQ("response", BufferToString(&copy));
+  EXPECT_EQ("response", BufferToString(&assigned));
+}
+
+TEST(ResponseCacheTest, HitAndMiss) {
+  ResponseCache cache(gpr_time_from_seconds(60), 10);
+  ByteBuffer response;
+  EXPECT_FALSE(cache.Lookup("a", &response));
+  cache.Insert("a", MakeBuffer("first"));
+  EXPECT_TRUE(cache.Lookup("a", &response));
+  EXPECT_EQ("first", BufferToString(&response));
+  cache.Insert("a", MakeBuffer("second"));
+  EXPECT_TRUE(cache.Lookup("a", &response));
+  EXPECT_EQ("second", BufferToString(&response));
+  EXPECT_EQ(static_cast<size_t>(1), cache.size());
+}
+
+TEST(ResponseCacheTest, EntriesExpire) {
+  ResponseCache cache(gpr_time_0, 10);
+  ByteBuffer response;
+  cache.Insert("a", MakeBuffer("first"));
+  EXPECT_FALSE(cache.Lookup("a", &response));
+  EXPECT_EQ(static_cast<size_t>(0), cache.size());
+}
+
+TEST(ResponseCacheTest, SizeIsBounded) {
+  ResponseCache cache(gpr_time_from_seconds(60), 2);
+  cache.Insert("a", MakeBuffer("1"));
+  cache.Insert("b", MakeBuffer("2"));
+  cache.Insert("c", MakeBuffer("3"));
+  EXPECT_EQ(static_cast<size_t>(2), cache.size());
+  ByteBuffer response;
+  EXPECT_TRUE(cache.Lookup("c", &response));
+  EXPECT_EQ("3", BufferToString(&response));
+}
+
+}  // namespace testing
+}  // namespace grpc
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
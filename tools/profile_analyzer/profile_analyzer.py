@@ -0,0 +1,157 @@
+#!/usr/bin/env python
+# Copyright 2015, Google Inc.
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met:
+#
+#     * Redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer.
+#     * Redistributions in binary form must reproduce the above
+# copyright notice, this list of conditions and the following disclaimer
+# in the documentation and/or other materials provided with the
+# distribution.
+#     * Neither the name of Google Inc. nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+"""Turns binary latency traces of the basic profiler into per tag latency
+histograms.
+
+Build with CONFIG=basicprof (and optionally -DGRPC_TIMERS_RDTSC), run, then:
+  profile_analyzer.py latency_trace.bin
+
+If events get dropped, give threads bigger buffers with
+GRPC_LATENCY_TRACE_RING_SIZE (events per thread, 8192 by default).
+
+Begin/end pairs (GRPC_TIMER_BEGIN/END) are reported per tag, marks
+(GRPC_TIMER_MARK) per pair of consecutive tags marked on the same id. See
+src/core/profiling/basic_timers.c for the trace format.
+"""
+
+import argparse
+import collections
+import math
+import struct
+import sys
+
+MAGIC = b'GRPCLAT1'
+EVENT = struct.Struct('=qQQiIi')
+FILE_HEADER = struct.Struct('=IH')
+DROPPED = struct.Struct('=QI')
+
+
+def read_trace(f):
+  """Returns the ticks per second, the (ticks, type, thread, id, tag,
+  location) events in time order, and the dropped events per thread."""
+  if f.read(len(MAGIC)) != MAGIC:
+    raise ValueError('not a latency trace')
+  ticks_per_second, = struct.unpack('=d', f.read(8))
+  files = {}
+  events = []
+  dropped = collections.Counter()
+  while True:
+    kind = f.read(1)
+    if not kind:
+      break
+    if kind == b'F':
+      index, length = FILE_HEADER.unpack(f.read(FILE_HEADER.size))
+      files[index] = f.read(length).decode('utf-8', 'replace')
+    elif kind == b'D':
+      thread, count = DROPPED.unpack(f.read(DROPPED.size))
+      dropped[thread] += count
+    elif kind in (b'{', b'}', b'.'):
+      ticks, thread, op_id, tag, file_index, line = EVENT.unpack(
+          f.read(EVENT.size))
+      events.append((ticks, kind, thread, op_id, tag,
+                     '%s:%d' % (files.get(file_index, '?'), line)))
+    else:
+      raise ValueError('corrupt trace: record type %r' % kind)
+  # threads are flushed one after the other: put events back in time order
+  events.sort(key=lambda e: e[0])
+  return ticks_per_second, events, dropped
+
+
+def collect_latencies(ticks_per_second, events):
+  """Returns {name: [latency in microseconds]}."""
+  to_us = 1e6 / ticks_per_second
+  latencies = collections.defaultdict(list)
+  open_timers = collections.defaultdict(list)
+  last_mark = {}
+  for ticks, kind, thread, op_id, tag, location in events:
+    if kind == b'{':
+      open_timers[thread].append((tag, op_id, ticks, location))
+    elif kind == b'}':
+      stack = open_timers[thread]
+      for i in range(len(stack) - 1, -1, -1):
+        if stack[i][0] == tag and stack[i][1] == op_id:
+          latencies['tag %d (%s)' % (tag, stack[i][3])].append(
+              (ticks - stack[i][2]) * to_us)
+          del stack[i]
+          break
+    else:
+      if op_id in last_mark:
+        prev_tag, prev_ticks = last_mark[op_id]
+        latencies['mark %d -> %d' % (prev_tag, tag)].append(
+            (ticks - prev_ticks) * to_us)
+      last_mark[op_id] = (tag, ticks)
+  return latencies
+
+
+def percentile(sorted_values, p):
+  return sorted_values[min(len(sorted_values) - 1,
+                           int(p / 100.0 * len(sorted_values)))]
+
+
+def print_histogram(sorted_values, width=50):
+  """Power of two buckets, in microseconds."""
+  buckets = collections.Counter(
+      int(math.floor(math.log(v, 2))) if v >= 1 else 0 for v in sorted_values)
+  most = max(buckets.values())
+  for b in range(min(buckets), max(buckets) + 1):
+    low = 0 if b == 0 else 2 ** b
+    bar = '#' * int(math.ceil(width * buckets[b] / float(most)))
+    print('  %10d us %8d %s' % (low, buckets[b], bar))
+
+
+def main():
+  argp = argparse.ArgumentParser(description=__doc__.split('\n')[0])
+  argp.add_argument('trace', help='binary latency trace file')
+  argp.add_argument('--histograms', action='store_true',
+                    help='print a histogram for every timer')
+  args = argp.parse_args()
+
+  with open(args.trace, 'rb') as f:
+    ticks_per_second, events, dropped = read_trace(f)
+  latencies = collect_latencies(ticks_per_second, events)
+
+  print('%d events, %d dropped, %g ticks per second' % (
+      len(events), sum(dropped.values()), ticks_per_second))
+  print('%-50s %8s %10s %10s %10s %10s %10s' % (
+      'timer', 'count', 'mean us', 'p50 us', 'p90 us', 'p99 us', 'max us'))
+  for name in sorted(latencies):
+    values = sorted(latencies[name])
+    print('%-50s %8d %10.2f %10.2f %10.2f %10.2f %10.2f' % (
+        name, len(values), sum(values) / len(values),
+        percentile(values, 50), percentile(values, 90),
+        percentile(values, 99), values[-1]))
+    if args.histograms:
+      print_histogram(values)
+  return 0
+
+
+if __name__ == '__main__':
+  sys.exit(main())